@@ -664,6 +664,7 @@ void builder::add_ticket(const std::string& ticket_id,
 
     auto ticket_state_v = boost::add_vertex(ticket_state, data->fare->g);
     boost::add_edge(data->fare->begin_v, ticket_state_v, ticket_transition, data->fare->g);
+    data->fare->modified();
 }
 
 static double get_co2_emission(const std::string& uri) {
@@ -441,13 +441,24 @@ void StopTimeFusioHandler::init(Data& data) {
     alighting_duration_c = csv.get_pos_col("alighting_duration");
 }
 
-void StopTimeFusioHandler::handle_line(Data& data, const csv_row& row, bool is_first_line) {
-    auto stop_times = StopTimeGtfsHandler::handle_line(data, row, is_first_line);
+void StopTimeFusioHandler::handle_line(Data& data, const csv_row& row, bool) {
+    auto line = parse_line(data, row);
+    add_line(data, line);
+}
+
+StopTimeFusioHandler::parsed_line StopTimeFusioHandler::parse_line(const Data& data, const csv_row& row) const {
+    auto line = StopTimeGtfsHandler::parse_line(data, row);
     // gtfs can return many stoptimes for one line because of DST periods
-    if (stop_times.empty()) {
-        return;
+    if (line.stop_times.empty()) {
+        return line;
+    }
+    if (is_valid(id_c, row)) {
+        line.stop_time_id = row[id_c];
     }
-    for (auto stop_time : stop_times) {
+    if (is_valid(desc_c, row)) {
+        line.comment_id = row[desc_c];
+    }
+    for (auto stop_time : line.stop_times) {
         if (is_valid(date_time_estimated_c, row))
             // For backward retrocompatibility
             if (is_stop_time_precision) {
@@ -458,18 +469,6 @@ void StopTimeFusioHandler::handle_line(Data& data, const csv_row& row, bool is_f
         else
             stop_time->date_time_estimated = false;
 
-        if (is_valid(id_c, row)) {
-            // if we have an id, we store the stoptime for futur use
-            gtfs_data.stop_time_map[row[id_c]].push_back(stop_time);
-        }
-
-        if (is_valid(desc_c, row)) {
-            auto it_comment = data.comment_by_id.find(row[desc_c]);
-            if (it_comment != data.comment_by_id.end()) {
-                data.add_pt_object_comment(stop_time, row[desc_c]);
-            }
-        }
-
         if (is_valid(itl_c, row)) {
             uint16_t local_traffic_zone = boost::lexical_cast<uint16_t>(row[itl_c]);
             if (local_traffic_zone > 0) {
@@ -512,6 +511,21 @@ void StopTimeFusioHandler::handle_line(Data& data, const csv_row& row, bool is_f
             stop_time->alighting_time += alighting_duration;
         }
     }
+    return line;
+}
+
+// the stop times are added to the data in the order of the file, with what can not be done in parallel
+void StopTimeFusioHandler::add_line(Data& data, parsed_line& line) {
+    StopTimeGtfsHandler::add_line(data, line);
+    for (auto stop_time : line.stop_times) {
+        if (!line.stop_time_id.empty()) {
+            // if we have an id, we store the stoptime for futur use
+            gtfs_data.stop_time_map[line.stop_time_id].push_back(stop_time);
+        }
+        if (!line.comment_id.empty() && data.comment_by_id.count(line.comment_id)) {
+            data.add_pt_object_comment(stop_time, line.comment_id);
+        }
+    }
 }
 
 template <typename T>
@@ -1941,7 +1955,7 @@ void FusioParser::parse_files(Data& data, const std::string& beginning_date) {
     parse<TripPropertiesFusioHandler>(data, "trip_properties.txt");
     parse<OdtConditionsFusioHandler>(data, "odt_conditions.txt");
     parse<TripsFusioHandler>(data, "trips.txt", true);
-    parse<StopTimeFusioHandler>(data, "stop_times.txt", true);
+    parse_in_parallel<StopTimeFusioHandler>(data, "stop_times.txt", true);
     parse<FrequenciesGtfsHandler>(data, "frequencies.txt");
     parse<ObjectCodesFusioHandler>(data, "object_codes.txt");
     parse<grid_calendar::GridCalendarFusioHandler>(data, "grid_calendars.txt");
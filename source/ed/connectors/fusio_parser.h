@@ -131,6 +131,8 @@ struct StopTimeFusioHandler : public StopTimeGtfsHandler {
     bool is_stop_time_precision;
     void init(Data&);
     void handle_line(Data& data, const csv_row& line, bool is_first_line);
+    parsed_line parse_line(const Data& data, const csv_row& line) const;
+    void add_line(Data& data, parsed_line& line);
 };
 
 struct ContributorFusioHandler : public GenericHandler {
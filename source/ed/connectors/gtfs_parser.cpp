@@ -1058,18 +1058,24 @@ static int to_utc(const std::string& local_time, int utc_offset) {
 }
 
 std::vector<nm::StopTime*> StopTimeGtfsHandler::handle_line(Data& data, const csv_row& row, bool) {
+    auto line = parse_line(data, row);
+    add_line(data, line);
+    return line.stop_times;
+}
+
+StopTimeGtfsHandler::parsed_line StopTimeGtfsHandler::parse_line(const Data& data, const csv_row& row) const {
+    parsed_line line;
     auto stop_it = gtfs_data.stop_point_map.find(row[stop_c]);
     if (stop_it == gtfs_data.stop_point_map.end()) {
         LOG4CPLUS_WARN(logger, "Impossible to find the stop_point " + row[stop_c] + "!");
-        return {};
+        return line;
     }
 
     auto vj_it = gtfs_data.tz.vj_by_name.lower_bound(row[trip_c]);
     if (vj_it == gtfs_data.tz.vj_by_name.end()) {
         LOG4CPLUS_WARN(logger, "Impossible to find the vehicle_journey '" << row[trip_c] << "'");
-        return {};
+        return line;
     }
-    std::vector<nm::StopTime*> stop_times;
 
     // the validity pattern may have been split because of DST, so we need to create one vj for each
     for (auto vj_end_it = gtfs_data.tz.vj_by_name.upper_bound(row[trip_c]); vj_it != vj_end_it; ++vj_it) {
@@ -1102,14 +1108,19 @@ std::vector<nm::StopTime*> StopTimeGtfsHandler::handle_line(Data& data, const cs
         else
             stop_time->drop_off_allowed = true;
 
-        stop_time->vehicle_journey->stop_time_list.push_back(stop_time);
         stop_time->wheelchair_boarding = stop_time->vehicle_journey->wheelchair_boarding;
+        line.stop_times.push_back(stop_time);
+    }
+    return line;
+}
+
+void StopTimeGtfsHandler::add_line(Data& data, parsed_line& line) {
+    for (auto* stop_time : line.stop_times) {
+        stop_time->vehicle_journey->stop_time_list.push_back(stop_time);
         stop_time->idx = data.stops.size();
         data.stops.push_back(stop_time);
         count++;
-        stop_times.push_back(stop_time);
     }
-    return stop_times;
 }
 
 void FrequenciesGtfsHandler::init(Data&) {
@@ -1464,7 +1475,7 @@ void GtfsParser::parse_files(Data& data, const std::string& beginning_date) {
     split_validity_pattern_over_dst(data, gtfs_data);
 
     parse<TripsGtfsHandler>(data, "trips.txt", true);
-    parse<StopTimeGtfsHandler>(data, "stop_times.txt", true);
+    parse_in_parallel<StopTimeGtfsHandler>(data, "stop_times.txt", true);
     parse<FrequenciesGtfsHandler>(data, "frequencies.txt");
 }
 
@@ -31,7 +31,10 @@ www.navitia.io
 #pragma once
 #include "ed/data.h"
 #include <boost/unordered_map.hpp>
+#include <atomic>
+#include <exception>
 #include <queue>
+#include <thread>
 #include "utils/csv.h"
 #include "utils/logger.h"
 #include "utils/functions.h"
@@ -39,6 +42,7 @@ www.navitia.io
 #include <boost/date_time/time_zone_base.hpp>
 #include <boost/date_time/local_time/local_time.hpp>
 #include "tz_db_wrapper.h"
+#include "mapped_csv.h"
 
 /**
  * Read General Transit Feed Specifications Files
@@ -155,6 +159,10 @@ std::string generate_unique_vj_uri(const GtfsData& gtfs_data, const std::string
  * - init(Data&) called before reading the file to init what needs to be inited
  * - finish(Data&) called after reading the file to clean and log if needed
  * - handle_line(Data& data, const csv_row& line, bool is_first_line): called at each line
+ *
+ * fill_in_parallel(Data&, nb_threads) is for the handlers splitting handle_line in
+ * - parse_line(const Data&, const csv_row&) const: called by several threads, returning a parsed_line
+ * - add_line(Data&, parsed_line&): called with the parsed lines in the order of the file
  */
 template <typename Handler>
 class FileParser {
@@ -170,6 +178,10 @@ public:
         : csv(ss, ',', true), fail_if_no_file(fail), handler(gdata, csv) {}
 
     bool fill(Data& data);
+    bool fill_in_parallel(Data& data, size_t nb_threads);
+
+private:
+    bool check_file();
 };
 
 /**
@@ -333,6 +345,13 @@ struct StopTimeGtfsHandler : public GenericHandler {
     void init(Data& data);
     void finish(Data& data);
     std::vector<ed::types::StopTime*> handle_line(Data& data, const csv_row& line, bool is_first_line);
+
+    struct parsed_line {
+        std::vector<ed::types::StopTime*> stop_times;  // not yet in the data nor in their vj
+        std::string stop_time_id, comment_id;          // for the fusio stop times
+    };
+    parsed_line parse_line(const Data& data, const csv_row& line) const;
+    void add_line(Data& data, parsed_line& line);
     const std::vector<std::string> required_headers() const {
         return {"trip_id", "arrival_time", "departure_time", "stop_id", "stop_sequence"};
     }
@@ -360,11 +379,15 @@ protected:
     bool parse(Data&, std::string file_name, bool fail_if_no_file = false);
     template <typename Handler>
     void parse(Data&);  // some parser do not need a file since they just add default data
+    // for the big files, with a handler able to parse its lines in parallel
+    template <typename Handler>
+    bool parse_in_parallel(Data&, std::string file_name, bool fail_if_no_file = false);
 
     virtual void parse_files(Data&, const std::string& beginning_date = "") = 0;
 
 public:
     GtfsData gtfs_data;
+    size_t nb_threads = 0;  // of parse_in_parallel, 0 for the hardware concurrency
 
     /// Constructeur qui prend en paramètre le chemin vers les fichiers
     GenericGtfsParser(std::string path);
@@ -396,6 +419,11 @@ inline void GenericGtfsParser::parse(Data& data) {
     FileParser<Handler> parser(this->gtfs_data, "");
     parser.fill(data);
 }
+template <typename Handler>
+inline bool GenericGtfsParser::parse_in_parallel(Data& data, std::string file_name, bool fail_if_no_file) {
+    FileParser<Handler> parser(this->gtfs_data, path + "/" + file_name, fail_if_no_file);
+    return parser.fill_in_parallel(data, nb_threads);
+}
 
 /**
  * GTFS parser
@@ -428,7 +456,7 @@ struct InvalidHeaders {
 };
 
 template <typename Handler>
-inline bool FileParser<Handler>::fill(Data& data) {
+inline bool FileParser<Handler>::check_file() {
     auto logger = log4cplus::Logger::getInstance("log");
     if (!csv.is_open() && !csv.filename.empty()) {
         if (fail_if_no_file) {
@@ -445,6 +473,14 @@ inline bool FileParser<Handler>::fill(Data& data) {
             logger, "Error while reading " << csv.filename << " missing headers : " << csv.missing_headers(headers));
         throw InvalidHeaders(csv.filename);
     }
+    return true;
+}
+
+template <typename Handler>
+inline bool FileParser<Handler>::fill(Data& data) {
+    if (!check_file()) {
+        return false;
+    }
     handler.init(data);
 
     bool line_read = true;
@@ -460,6 +496,78 @@ inline bool FileParser<Handler>::fill(Data& data) {
     return true;
 }
 
+/*
+ * The file is mapped and its rows split in ranges, parsed by the threads, then the parsed
+ * lines are added range by range, as fill would have.
+ */
+template <typename Handler>
+inline bool FileParser<Handler>::fill_in_parallel(Data& data, size_t nb_threads) {
+    if (csv.filename.empty()) {
+        // a stream can't be mapped
+        return fill(data);
+    }
+    if (!check_file()) {
+        return false;
+    }
+    handler.init(data);
+
+    if (nb_threads == 0) {
+        nb_threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+    }
+    const MappedCsv file(csv.filename);
+    // more ranges than threads, as their rows do not take the same time
+    const auto ranges = file.split_rows(4 * nb_threads);
+    std::vector<std::vector<typename Handler::parsed_line>> parsed_ranges(ranges.size());
+
+    std::atomic<size_t> next_range{0};
+    const auto work = [&]() {
+        std::vector<boost::string_ref> fields;
+        typename Handler::csv_row row;
+        for (size_t r = next_range++; r < ranges.size(); r = next_range++) {
+            auto tokenizer = file.tokenizer(ranges[r]);
+            while (tokenizer.next(fields)) {
+                assign_row(fields, row);
+                parsed_ranges[r].push_back(handler.parse_line(data, row));
+            }
+        }
+    };
+    nb_threads = std::min(nb_threads, ranges.size());
+    if (nb_threads <= 1) {
+        work();
+    } else {
+        std::vector<std::exception_ptr> errors(nb_threads);
+        std::vector<std::thread> threads;
+        for (size_t t = 0; t < nb_threads; ++t) {
+            threads.emplace_back([&work, &errors, &next_range, &ranges, t] {
+                try {
+                    work();
+                } catch (...) {
+                    errors[t] = std::current_exception();
+                    next_range = ranges.size();
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        for (const auto& error : errors) {
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+    }
+
+    for (auto& parsed_lines : parsed_ranges) {
+        for (auto& line : parsed_lines) {
+            handler.add_line(data, line);
+        }
+        std::vector<typename Handler::parsed_line>().swap(parsed_lines);
+    }
+    handler.finish(data);
+
+    return true;
+}
+
 template <typename T>
 bool empty(const std::pair<T, T>& r) {
     return r.first == r.second;
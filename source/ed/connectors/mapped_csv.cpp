@@ -0,0 +1,206 @@
+/* Copyright © 2001-2014, Canal TP and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+channel `#navitia` on riot https://riot.im/app/#/room/#navitia:matrix.org
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+#include "ed/connectors/mapped_csv.h"
+
+#include "utils/exception.h"
+
+#include <algorithm>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace ed {
+namespace connectors {
+
+namespace {
+
+bool is_blank(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+// the end of the row starting at begin, on its line break, out of the quotes
+const char* find_row_end(const char* begin, const char* end) {
+    bool quoted = false;
+    for (const char* c = begin; c < end; ++c) {
+        if (*c == '\\') {
+            ++c;
+        } else if (*c == '"') {
+            quoted = !quoted;
+        } else if (*c == '\n' && !quoted) {
+            return c;
+        }
+    }
+    return end;
+}
+
+}  // namespace
+
+MappedCsv::MappedCsv(const std::string& filename, char separator) : separator(separator) {
+    const int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw navitia::exception("impossible to open " + filename);
+    }
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) != 0) {
+        close(fd);
+        throw navitia::exception("impossible to read the size of " + filename);
+    }
+    size = file_stat.st_size;
+    if (size > 0) {
+        void* mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapped == MAP_FAILED) {
+            close(fd);
+            throw navitia::exception("impossible to map " + filename);
+        }
+        madvise(mapped, size, MADV_SEQUENTIAL);
+        data = static_cast<const char*>(mapped);
+    }
+    close(fd);
+}
+
+MappedCsv::~MappedCsv() {
+    if (data != nullptr) {
+        munmap(const_cast<char*>(data), size);
+    }
+}
+
+std::vector<MappedCsv::Range> MappedCsv::split_rows(size_t nb_ranges) const {
+    const char* const end = data + size;
+    const char* begin = data == nullptr ? end : find_row_end(data, end);
+    if (begin != end) {
+        ++begin;  // the header is skipped
+    }
+    std::vector<Range> ranges;
+    if (begin == end) {
+        return ranges;
+    }
+    nb_ranges = std::max<size_t>(1, nb_ranges);
+    const size_t range_size = (end - begin) / nb_ranges + 1;
+    const char* range_begin = begin;
+    while (range_begin < end) {
+        // the range ends with the row going over its size
+        const char* range_end = range_begin;
+        while (range_end < end && range_end - range_begin < std::ptrdiff_t(range_size)) {
+            range_end = find_row_end(range_end, end);
+            if (range_end < end) {
+                ++range_end;
+            }
+        }
+        ranges.push_back({range_begin, range_end});
+        range_begin = range_end;
+    }
+    return ranges;
+}
+
+bool MappedCsv::Tokenizer::next(std::vector<boost::string_ref>& fields) {
+    while (current < end) {
+        const char* const row_end = find_row_end(current, end);
+        const char* const row_begin = current;
+        current = row_end == end ? end : row_end + 1;
+
+        fields.clear();
+        size_t nb_buffers = 0;
+        bool blank_row = true;
+        const char* field_begin = row_begin;
+        while (true) {
+            // the field ends on a separator out of the quotes
+            const char* field_end = field_begin;
+            bool quoted = false, escaped = false;
+            for (; field_end < row_end && (quoted || *field_end != separator); ++field_end) {
+                if (*field_end == '"' || *field_end == '\\') {
+                    escaped = true;
+                    if (*field_end == '"') {
+                        quoted = !quoted;
+                    } else if (field_end + 1 < row_end) {
+                        ++field_end;
+                    }
+                }
+            }
+            const char* b = field_begin;
+            const char* e = field_end;
+            while (b < e && is_blank(*b)) {
+                ++b;
+            }
+            while (e > b && is_blank(*(e - 1))) {
+                --e;
+            }
+            if (b != e) {
+                blank_row = false;
+            }
+            if (!escaped) {
+                fields.emplace_back(b, e - b);
+            } else {
+                if (buffers.size() <= nb_buffers) {
+                    buffers.emplace_back();
+                }
+                auto& buffer = buffers[nb_buffers++];
+                buffer.clear();
+                for (const char* c = b; c < e; ++c) {
+                    if (*c == '"') {
+                        continue;
+                    }
+                    if (*c == '\\' && c + 1 < e) {
+                        ++c;
+                    }
+                    buffer.push_back(*c);
+                }
+                const auto first = buffer.find_first_not_of(" \t\r");
+                const auto last = buffer.find_last_not_of(" \t\r");
+                if (first == std::string::npos) {
+                    buffer.clear();
+                } else {
+                    buffer = buffer.substr(first, last - first + 1);
+                }
+                fields.emplace_back(buffer.data(), buffer.size());
+            }
+            if (field_end >= row_end) {
+                break;
+            }
+            field_begin = field_end + 1;
+        }
+        if (!blank_row) {
+            return true;
+        }
+    }
+    fields.clear();
+    return false;
+}
+
+void assign_row(const std::vector<boost::string_ref>& fields, std::vector<std::string>& row) {
+    row.resize(fields.size());
+    for (size_t f = 0; f < fields.size(); ++f) {
+        row[f].assign(fields[f].data(), fields[f].size());
+    }
+}
+
+}  // namespace connectors
+}  // namespace ed
@@ -0,0 +1,93 @@
+/* Copyright © 2001-2014, Canal TP and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+channel `#navitia` on riot https://riot.im/app/#/room/#navitia:matrix.org
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+#pragma once
+
+#include <boost/utility.hpp>
+#include <boost/utility/string_ref.hpp>
+
+#include <deque>
+#include <string>
+#include <vector>
+
+namespace ed {
+namespace connectors {
+
+/*
+ * A csv file mapped in memory, its rows being split in ranges to be tokenized by several
+ * threads.
+ *
+ * The fields are separated by the separator out of the double quotes, which are removed, and
+ * trimmed as CsvReader does.  A field is a view of the mapped file unless it holds quotes or
+ * escapes, in which case it is unescaped in a buffer of the tokenizer.
+ */
+class MappedCsv : boost::noncopyable {
+public:
+    struct Range {
+        const char* begin;
+        const char* end;
+    };
+
+    class Tokenizer {
+    public:
+        Tokenizer(const Range& range, char separator) : current(range.begin), end(range.end), separator(separator) {}
+
+        // the fields of the next non blank row, valid until the next call; false at the end of the range
+        bool next(std::vector<boost::string_ref>& fields);
+
+    private:
+        const char* current;
+        const char* end;
+        const char separator;
+        std::deque<std::string> buffers;  // the unescaped fields, a deque for their views to stay valid
+    };
+
+    // throws navitia::exception if the file can't be mapped
+    explicit MappedCsv(const std::string& filename, char separator = ',');
+    ~MappedCsv();
+
+    /*
+     * The rows after the header, split in at most nb_ranges ranges of about the same size.
+     * A range only holds whole rows, even with line breaks in quoted fields.
+     */
+    std::vector<Range> split_rows(size_t nb_ranges) const;
+
+    Tokenizer tokenizer(const Range& range) const { return Tokenizer(range, separator); }
+
+private:
+    const char* data = nullptr;
+    size_t size = 0;
+    const char separator;
+};
+
+// copies the fields in row, reusing the storage of its strings
+void assign_row(const std::vector<boost::string_ref>& fields, std::vector<std::string>& row);
+
+}  // namespace connectors
+}  // namespace ed
@@ -37,7 +37,6 @@ www.navitia.io
 
 #include <boost/geometry.hpp>
 #include <boost/geometry/geometry.hpp>
-#include <boost/range/algorithm/find_if.hpp>
 #include <boost/range/algorithm/max_element.hpp>
 
 #include <iostream>
@@ -50,6 +49,7 @@ void Data::sort() {
     std::sort(collection_name.begin(), collection_name.end(), Less()); \
     std::for_each(collection_name.begin(), collection_name.end(), Indexer<nt::idx_t>());
     ITERATE_NAVITIA_PT_TYPES(SORT_AND_INDEX)
+    validity_patterns_index.reset();
 
     std::for_each(shapes_from_prev.begin(), shapes_from_prev.end(), Indexer<nt::idx_t>());
     std::sort(stops.begin(), stops.end(), Less());
@@ -160,10 +160,8 @@ static std::map<std::string, std::vector<types::StopPoint*>> make_stop_area_stop
 }
 
 types::ValidityPattern* Data::get_or_create_validity_pattern(const types::ValidityPattern& vp) {
-    auto find_vp_predicate = [&vp](types::ValidityPattern* vp2) { return vp.days == vp2->days; };
-    auto it = boost::find_if(validity_patterns, find_vp_predicate);
-    if (it != validity_patterns.end()) {
-        return *(it);
+    if (auto* found = validity_patterns_index.find(validity_patterns, vp)) {
+        return found;
     }
     validity_patterns.push_back(new types::ValidityPattern(vp));
     return validity_patterns.back();
@@ -182,6 +180,7 @@ void Data::shift_vp_left(types::ValidityPattern& vp) {
             end_date = begin_date + boost::gregorian::days(365);
         }
         meta.production_date = {begin_date, end_date};
+        validity_patterns_index.reset();
         for (auto& vp_ : validity_patterns) {
             // The first day is not active.
             vp_->days <<= 1;
@@ -276,6 +275,32 @@ void Data::build_route_destination() {
     }
 }
 
+void Data::patch_odt_stop_times() {
+    auto logger = log4cplus::Logger::getInstance("log");
+    LOG4CPLUS_INFO(logger, "Starting da ugly ODT hack...");
+    size_t nb_hacked = 0;
+    for (auto* vj : vehicle_journeys) {
+        if (vj->stop_time_list.size() != 2) {
+            continue;
+        }
+        if (vj->stop_time_list[0]->stop_point != vj->stop_time_list[1]->stop_point) {
+            continue;
+        }
+        if (vj->stop_time_list[0]->departure_time != vj->stop_time_list[1]->arrival_time) {
+            continue;
+        }
+
+        // No, teleportation can't exist, even on a null distance!
+        // You'll take 10 min, I said!
+        ++nb_hacked;
+        vj->stop_time_list[1]->arrival_time += 10 * 60;
+        vj->stop_time_list[1]->departure_time += 10 * 60;
+        vj->stop_time_list[1]->alighting_time += 10 * 60;
+        vj->stop_time_list[1]->boarding_time += 10 * 60;
+    }
+    LOG4CPLUS_INFO(logger, "Da ugly ODT hack: " << nb_hacked << " patched");
+}
+
 void Data::complete() {
     build_block_id();
     auto start = boost::posix_time::microsec_clock::local_time();
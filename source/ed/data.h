@@ -167,6 +167,9 @@ public:
 
     double simplify_tolerance = 0.00003;
 
+    // validity_patterns by days, for get_or_create_validity_pattern
+    navitia::type::ValidityPatternIndex<navitia::type::ValidityPatternDaysEqual> validity_patterns_index;
+
     /**
      * trie les différentes donnée et affecte l'idx
      *
@@ -210,6 +213,12 @@ public:
 
     void build_route_destination();
 
+    /**
+     * The old ODT vjs with 2 stop times on the same stop point at the same time
+     * get 10 minutes between their stop times
+     */
+    void patch_odt_stop_times();
+
     /**
      * supprime les objets inutiles
      */
@@ -232,6 +241,7 @@ public:
     void remove_reference_to_object(const T*);
     void remove_reference_to_object(const ed::types::StopTime*);
 
+    // the validity patterns of the vjs are compared on their days only
     types::ValidityPattern* get_or_create_validity_pattern(const types::ValidityPattern& vp);
 
     /**
@@ -496,3 +496,100 @@ BOOST_FIXTURE_TEST_CASE(ntfs_dst_test, ArgsFixture) {
     // they should have the same meta vj
     BOOST_CHECK_EQUAL(vj_dst2->meta_vj, vj_dst1->meta_vj);
 }
+
+// every object of the database nav must be in the feed nav, with the same uri
+template <typename T, typename Map>
+static void check_same_uris(const std::vector<T*>& db_objects, const Map& feed_map) {
+    BOOST_CHECK_EQUAL(db_objects.size(), feed_map.size());
+    for (const auto* obj : db_objects) {
+        BOOST_CHECK_MESSAGE(feed_map.count(obj->uri), obj->uri << " is missing from the feed2nav output");
+    }
+}
+
+// the nav written by feed2nav must contain the same public transport as the one of fusio2ed/gtfs2ed + ed2nav
+static void check_same_pt_data(const nt::Data& db_data, const nt::Data& feed_data) {
+    const auto& db = *db_data.pt_data;
+    const auto& feed = *feed_data.pt_data;
+
+    BOOST_CHECK_EQUAL(db_data.meta->production_date, feed_data.meta->production_date);
+
+    check_same_uris(db.networks, feed.networks_map);
+    check_same_uris(db.companies, feed.companies_map);
+    check_same_uris(db.commercial_modes, feed.commercial_modes_map);
+    check_same_uris(db.physical_modes, feed.physical_modes_map);
+    check_same_uris(db.lines, feed.lines_map);
+    check_same_uris(db.routes, feed.routes_map);
+    check_same_uris(db.stop_areas, feed.stop_areas_map);
+    check_same_uris(db.stop_points, feed.stop_points_map);
+    check_same_uris(db.vehicle_journeys, feed.vehicle_journeys_map);
+    BOOST_CHECK_EQUAL(db.calendars.size(), feed.calendars.size());
+    BOOST_CHECK_EQUAL(db.stop_point_connections.size(), feed.stop_point_connections.size());
+    BOOST_CHECK_EQUAL(db.nb_stop_times(), feed.nb_stop_times());
+
+    for (const auto* sp : db.stop_points) {
+        const auto* feed_sp = find_or_default(sp->uri, feed.stop_points_map);
+        if (!feed_sp) {
+            continue;
+        }
+        BOOST_CHECK_EQUAL(sp->name, feed_sp->name);
+        BOOST_CHECK_LT(sp->coord.distance_to(feed_sp->coord), 0.1);
+        BOOST_REQUIRE(sp->stop_area && feed_sp->stop_area);
+        BOOST_CHECK_EQUAL(sp->stop_area->uri, feed_sp->stop_area->uri);
+    }
+
+    for (const auto* line : db.lines) {
+        const auto* feed_line = find_or_default(line->uri, feed.lines_map);
+        if (!feed_line) {
+            continue;
+        }
+        BOOST_CHECK_EQUAL(line->name, feed_line->name);
+        BOOST_CHECK_EQUAL(line->code, feed_line->code);
+        BOOST_CHECK_EQUAL(line->color, feed_line->color);
+        BOOST_REQUIRE(line->network && feed_line->network);
+        BOOST_CHECK_EQUAL(line->network->uri, feed_line->network->uri);
+    }
+
+    for (const auto* vj : db.vehicle_journeys) {
+        const auto* feed_vj = find_or_default(vj->uri, feed.vehicle_journeys_map);
+        if (!feed_vj) {
+            continue;
+        }
+        BOOST_CHECK_EQUAL(vj->name, feed_vj->name);
+        BOOST_CHECK_EQUAL(vj->headsign, feed_vj->headsign);
+        BOOST_CHECK_EQUAL(vj->route->uri, feed_vj->route->uri);
+        BOOST_CHECK_EQUAL(vj->base_validity_pattern()->beginning_date,
+                          feed_vj->base_validity_pattern()->beginning_date);
+        BOOST_CHECK_EQUAL(vj->base_validity_pattern()->days, feed_vj->base_validity_pattern()->days);
+        BOOST_REQUIRE_EQUAL(vj->stop_time_list.size(), feed_vj->stop_time_list.size());
+        for (size_t pos = 0; pos < vj->stop_time_list.size(); ++pos) {
+            const auto& st = vj->stop_time_list[pos];
+            const auto& feed_st = feed_vj->stop_time_list[pos];
+            BOOST_CHECK_EQUAL(st.stop_point->uri, feed_st.stop_point->uri);
+            BOOST_CHECK_EQUAL(st.arrival_time, feed_st.arrival_time);
+            BOOST_CHECK_EQUAL(st.departure_time, feed_st.departure_time);
+            BOOST_CHECK_EQUAL(st.boarding_time, feed_st.boarding_time);
+            BOOST_CHECK_EQUAL(st.alighting_time, feed_st.alighting_time);
+            BOOST_CHECK_EQUAL(st.pick_up_allowed(), feed_st.pick_up_allowed());
+            BOOST_CHECK_EQUAL(st.drop_off_allowed(), feed_st.drop_off_allowed());
+            BOOST_CHECK_EQUAL(db.headsign_handler.get_headsign(st), feed.headsign_handler.get_headsign(feed_st));
+        }
+    }
+}
+
+BOOST_FIXTURE_TEST_CASE(feed2nav_ntfs_is_the_same_as_fusio2ed, ArgsFixture) {
+    nt::Data db_data;
+    db_data.load_nav(input_file_paths.at("ntfs_file"));
+    nt::Data feed_data;
+    feed_data.load_nav(input_file_paths.at("ntfs_feed_file"));
+
+    check_same_pt_data(db_data, feed_data);
+}
+
+BOOST_FIXTURE_TEST_CASE(feed2nav_gtfs_is_the_same_as_gtfs2ed, ArgsFixture) {
+    nt::Data db_data;
+    db_data.load_nav(input_file_paths.at("gtfs_google_example_file"));
+    nt::Data feed_data;
+    feed_data.load_nav(input_file_paths.at("gtfs_google_example_feed_file"));
+
+    check_same_pt_data(db_data, feed_data);
+}
@@ -33,6 +33,7 @@ www.navitia.io
 #include "conf.h"
 #include "ed_reader.h"
 #include "type/meta_data.h"
+#include "type/nav_delta.h"
 #include "utils/exception.h"
 #include "utils/functions.h"
 #include "utils/init.h"
@@ -297,8 +298,36 @@ bool write_data_to_file(const std::string& output_filename, const T& data) {
     return remove_file(backup_output_filename);
 }
 
+boost::optional<navitia::type::NavDelta> make_delta(const std::string& base_filename,
+                                                    const navitia::type::Data& data) {
+    auto logger = log4cplus::Logger::getInstance("ed2nav::make_delta");
+    LOG4CPLUS_INFO(logger, "Computing the delta from " << base_filename);
+    try {
+        navitia::type::Data base;
+        base.load_nav(base_filename);
+        auto delta = navitia::type::make_nav_delta(base, data);
+        if (delta) {
+            delta->base_hash = base.nav_hash;
+        }
+        return delta;
+    } catch (const std::exception& e) {
+        LOG4CPLUS_WARN(logger, "No delta from " << base_filename << ": " << e.what());
+        return boost::none;
+    }
+}
+
+bool write_delta(boost::optional<navitia::type::NavDelta> delta, const std::string& output_filename) {
+    const std::string delta_filename = output_filename + ".delta";
+    if (!delta) {
+        // kraken wouldn't apply it on the new nav, but it must not be mistaken for a delta of this nav
+        return remove_file(delta_filename);
+    }
+    delta->target_hash = navitia::type::hash_file(output_filename);
+    return write_data_to_file(delta_filename, *delta);
+}
+
 int ed2nav(int argc, const char* argv[]) {
-    std::string output, connection_string, region_name, cities_connection_string;
+    std::string output, connection_string, region_name, cities_connection_string, delta_base;
     double min_non_connected_graph_ratio;
     po::options_description desc("Allowed options");
 
@@ -321,6 +350,9 @@ int ed2nav(int argc, const char* argv[]) {
          "database connection parameters: host=localhost user=navitia dbname=navitia password=navitia")
         ("cities-connection-string", po::value<std::string>(&cities_connection_string)->default_value(""),
          "cities database connection parameters: host=localhost user=navitia dbname=cities password=navitia")
+        ("delta-base", po::value<std::string>(&delta_base),
+         "Nav file (usually the previous output) from which a delta is written in <output>.delta, "
+         "for kraken to apply it without a full reload. The base is loaded in memory along with the new data.")
         ("local_syslog", "activate log redirection within local syslog")
         ("log_comment", po::value<std::string>(), "optional field to add extra information like coverage name");
     // clang-format on
@@ -401,6 +433,11 @@ int ed2nav(int argc, const char* argv[]) {
     LOG4CPLUS_INFO(logger, "fare tickets: " << data.fare->fare_map.size());
     LOG4CPLUS_INFO(logger, "fare transitions: " << data.fare->nb_transitions());
     LOG4CPLUS_INFO(logger, "fare od: " << data.fare->od_tickets.size());
+    boost::optional<navitia::type::NavDelta> delta;
+    if (!delta_base.empty()) {
+        delta = make_delta(delta_base, data);
+    }
+
     LOG4CPLUS_INFO(logger, "Begin to save ...");
 
     start = pt::microsec_clock::local_time();
@@ -409,6 +446,10 @@ int ed2nav(int argc, const char* argv[]) {
         LOG4CPLUS_ERROR(logger, "Exiting ed2nav with errors");
         return 1;
     }
+    if (!delta_base.empty() && !write_delta(std::move(delta), output)) {
+        LOG4CPLUS_ERROR(logger, "Exiting ed2nav with errors");
+        return 1;
+    }
     save = (pt::microsec_clock::local_time() - start).total_milliseconds();
 
     LOG4CPLUS_INFO(logger, "Computing times");
@@ -418,4 +459,7 @@ int ed2nav(int argc, const char* argv[]) {
     return 0;
 }
 
+// used by feed2nav
+template bool write_data_to_file<navitia::type::Data>(const std::string&, const navitia::type::Data&);
+
 }  // namespace ed
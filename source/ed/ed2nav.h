@@ -31,6 +31,7 @@ www.navitia.io
 
 #include "utils/exception.h"
 
+#include <boost/optional.hpp>
 #include <log4cplus/logger.h>
 #include <log4cplus/loggingmacros.h>
 
@@ -39,6 +40,7 @@ www.navitia.io
 namespace navitia {
 namespace type {
 class Data;
+struct NavDelta;
 }  // namespace type
 }  // namespace navitia
 
@@ -61,6 +63,13 @@ bool try_save_file(const std::string& filename, const T& data) {
 
 template <class T = navitia::type::Data>
 bool write_data_to_file(const std::string& output_filename, const T& data);
+
+/// Delta from the base nav to the data, none if the data can't be obtained with a delta.
+/// It is computed before the data is written as the base is often the previous version of the output.
+boost::optional<navitia::type::NavDelta> make_delta(const std::string& base_filename,
+                                                    const navitia::type::Data& data);
+/// Writes the delta next to the written nav, or removes the previous delta if there is none
+bool write_delta(boost::optional<navitia::type::NavDelta> delta, const std::string& output_filename);
 int ed2nav(int argc, const char** argv);
 
 }  // namespace ed
@@ -0,0 +1,783 @@
+/* Copyright © 2001-2014, Canal TP and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+channel `#navitia` on riot https://riot.im/app/#/room/#navitia:matrix.org
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#include "ed_converter.h"
+
+#include "type/meta_data.h"
+#include "type/network.h"
+#include "type/company.h"
+#include "type/contributor.h"
+#include "type/commercial_mode.h"
+#include "type/dataset.h"
+#include "utils/base64_encode.h"
+#include "utils/functions.h"
+
+#include <boost/make_shared.hpp>
+#include <boost/range/algorithm/find.hpp>
+
+namespace ed {
+
+namespace bt = boost::posix_time;
+namespace nt = navitia::type;
+namespace ng = navitia::georef;
+namespace nf = navitia::fare;
+
+// The persistor writes the coordinates with std::to_string, thus the
+// database only keeps 6 decimals. We round them the same way to get
+// the same nav file as with the database.
+static double as_persisted(const double d) {
+    return std::stod(std::to_string(d));
+}
+
+static nt::GeographicalCoord as_persisted(const nt::GeographicalCoord& coord) {
+    return {as_persisted(coord.lon()), as_persisted(coord.lat())};
+}
+
+void EdConverter::fill(const ed::Data& ed_data, navitia::type::Data& data) {
+    this->fill_meta(ed_data, data);
+    this->fill_feed_infos(ed_data, data);
+    this->fill_timezones(ed_data, data);
+    this->fill_networks(ed_data, data);
+    this->fill_commercial_modes(ed_data, data);
+    this->fill_physical_modes(ed_data, data);
+    this->fill_companies(ed_data, data);
+    this->fill_contributors(ed_data, data);
+    this->fill_datasets(ed_data, data);
+
+    this->fill_stop_areas(ed_data, data);
+    this->fill_stop_points(ed_data, data);
+
+    this->fill_lines(ed_data, data);
+    this->fill_line_groups(ed_data, data);
+    this->fill_routes(ed_data, data);
+    this->fill_validity_patterns(ed_data, data);
+
+    this->fill_shapes(ed_data, data);
+    this->fill_vehicle_journeys(ed_data, data);
+    this->fill_comments(ed_data, data);
+
+    /// grid calendar
+    this->fill_calendars(ed_data, data);
+
+    /// meta vj associated calendars
+    this->fill_meta_vehicle_journeys(ed_data, data);
+
+    this->fill_admin_stop_areas(ed_data, data);
+    this->fill_object_codes(ed_data, data);
+    this->fill_stop_point_connections(ed_data, data);
+
+    this->fill_prices(ed_data, data);
+    this->fill_transitions(ed_data, data);
+    this->fill_origin_destinations(ed_data, data);
+}
+
+void EdConverter::fill_meta(const ed::Data& ed_data, navitia::type::Data& data) {
+    if (ed_data.meta.production_date.is_null()) {
+        throw navitia::exception("the production period is empty, we cannot create a nav file");
+    }
+    data.meta->production_date = ed_data.meta.production_date;
+}
+
+void EdConverter::fill_feed_infos(const ed::Data& ed_data, navitia::type::Data& data) {
+    for (const auto& feed_info : ed_data.feed_infos) {
+        if (feed_info.first == "feed_publisher_name") {
+            data.meta->publisher_name = feed_info.second;
+        }
+        if (feed_info.first == "feed_publisher_url") {
+            data.meta->publisher_url = feed_info.second;
+        }
+        if (feed_info.first == "feed_license") {
+            data.meta->license = feed_info.second;
+        }
+        if (feed_info.first == "feed_creation_datetime" && !feed_info.second.empty()) {
+            try {
+                data.meta->dataset_created_at = bt::from_iso_string(feed_info.second);
+            } catch (const std::out_of_range&) {
+                LOG4CPLUS_INFO(log, "feed_creation_datetime is not valid");
+            }
+        }
+    }
+}
+
+void EdConverter::fill_timezones(const ed::Data& ed_data, navitia::type::Data& data) {
+    // in the ED part there can be only one TZ by construction
+    const auto& tz_handler = ed_data.tz_wrapper.tz_handler;
+    timezone = data.pt_data->tz_manager.get_or_create(tz_handler.tz_name, data.meta->production_date.begin(),
+                                                      tz_handler.get_periods_and_shift());
+}
+
+void EdConverter::fill_networks(const ed::Data& ed_data, navitia::type::Data& data) {
+    for (const types::Network* ed_network : ed_data.networks) {
+        auto* network = new nt::Network();
+        network->uri = navitia::encode_uri(ed_network->uri);
+        network->name = ed_network->name;
+        network->sort = ed_network->sort;
+        network->website = ed_network->website;
+        network->idx = data.pt_data->networks.size();
+
+        data.pt_data->networks.push_back(network);
+        this->network_map[ed_network] = network;
+    }
+}
+
+void EdConverter::fill_commercial_modes(const ed::Data& ed_data, navitia::type::Data& data) {
+    for (const types::CommercialMode* ed_mode : ed_data.commercial_modes) {
+        auto* mode = new nt::CommercialMode();
+        mode->uri = navitia::encode_uri(ed_mode->uri);
+        mode->name = ed_mode->name;
+        mode->idx = data.pt_data->commercial_modes.size();
+
+        data.pt_data->commercial_modes.push_back(mode);
+        this->commercial_mode_map[ed_mode] = mode;
+    }
+}
+
+void EdConverter::fill_physical_modes(const ed::Data& ed_data, navitia::type::Data& data) {
+    for (const types::PhysicalMode* ed_mode : ed_data.physical_modes) {
+        auto* mode = new nt::PhysicalMode();
+        mode->uri = navitia::encode_uri(ed_mode->uri);
+        mode->name = ed_mode->name;
+        if (ed_mode->co2_emission) {
+            mode->co2_emission = as_persisted(*ed_mode->co2_emission);
+        }
+        mode->idx = data.pt_data->physical_modes.size();
+
+        data.pt_data->physical_modes.push_back(mode);
+        this->physical_mode_map[ed_mode] = mode;
+    }
+}
+
+void EdConverter::fill_companies(const ed::Data& ed_data, navitia::type::Data& data) {
+    for (const types::Company* ed_company : ed_data.companies) {
+        auto* company = new nt::Company();
+        company->uri = navitia::encode_uri(ed_company->uri);
+        company->name = ed_company->name;
+        company->website = ed_company->website;
+        company->idx = data.pt_data->companies.size();
+
+        data.pt_data->companies.push_back(company);
+        this->company_map[ed_company] = company;
+    }
+}
+
+void EdConverter::fill_contributors(const ed::Data& ed_data, navitia::type::Data& data) {
+    for (const types::Contributor* ed_contributor : ed_data.contributors) {
+        auto* contributor = new nt::Contributor();
+        contributor->uri = navitia::encode_uri(ed_contributor->uri);
+        contributor->name = ed_contributor->name;
+        contributor->website = ed_contributor->website;
+        contributor->license = ed_contributor->license;
+        contributor->idx = data.pt_data->contributors.size();
+
+        data.pt_data->contributors.push_back(contributor);
+        this->contributor_map[ed_contributor] = contributor;
+    }
+}
+
+void EdConverter::fill_datasets(const ed::Data& ed_data, navitia::type::Data& data) {
+    size_t nb_unknown_contributor(0);
+    for (const types::Dataset* ed_dataset : ed_data.datasets) {
+        auto* contributor = find_or_default(static_cast<const types::Contributor*>(ed_dataset->contributor),
+                                            this->contributor_map);
+        if (!contributor) {
+            LOG4CPLUS_TRACE(log, "impossible to find the contributor of the dataset " << ed_dataset->uri);
+            nb_unknown_contributor++;
+            continue;
+        }
+
+        auto* dataset = new nt::Dataset();
+        dataset->uri = navitia::encode_uri(ed_dataset->uri);
+        dataset->desc = ed_dataset->desc;
+        dataset->system = ed_dataset->system;
+        dataset->validation_period = ed_dataset->validation_period;
+        dataset->contributor = contributor;
+        dataset->idx = data.pt_data->datasets.size();
+
+        dataset->contributor->dataset_list.insert(dataset);
+        data.pt_data->datasets.push_back(dataset);
+        this->dataset_map[ed_dataset] = dataset;
+    }
+    if (nb_unknown_contributor) {
+        LOG4CPLUS_WARN(log, nb_unknown_contributor << " contributor not found for dataset");
+    }
+}
+
+void EdConverter::fill_stop_areas(const ed::Data& ed_data, navitia::type::Data& data) {
+    for (const types::StopArea* ed_sa : ed_data.stop_areas) {
+        auto* sa = new nt::StopArea();
+        sa->uri = navitia::encode_uri(ed_sa->uri);
+        sa->name = ed_sa->name;
+        sa->timezone = ed_sa->time_zone_with_name.first;
+        sa->coord = as_persisted(ed_sa->coord);
+        sa->visible = ed_sa->visible;
+        sa->set_properties(ed_sa->properties());
+        sa->idx = data.pt_data->stop_areas.size();
+
+        data.pt_data->stop_areas.push_back(sa);
+        this->stop_area_map[ed_sa] = sa;
+    }
+}
+
+void EdConverter::fill_stop_points(const ed::Data& ed_data, navitia::type::Data& data) {
+    for (const types::StopPoint* ed_sp : ed_data.stop_points) {
+        auto* sp = new nt::StopPoint();
+        sp->uri = navitia::encode_uri(ed_sp->uri);
+        sp->name = ed_sp->name;
+        sp->fare_zone = ed_sp->fare_zone;
+        sp->platform_code = ed_sp->platform_code;
+        sp->is_zonal = ed_sp->is_zonal;
+        sp->coord = as_persisted(ed_sp->coord);
+        sp->set_properties(ed_sp->properties());
+        sp->stop_area = find_or_default(static_cast<const types::StopArea*>(ed_sp->stop_area), stop_area_map);
+        if (sp->stop_area) {
+            sp->stop_area->stop_point_list.push_back(sp);
+        }
+        if (ed_sp->area && sp->is_zonal) {
+            data.pt_data->add_stop_point_area(*ed_sp->area, sp);
+        }
+
+        data.pt_data->stop_points.push_back(sp);
+        this->stop_point_map[ed_sp] = sp;
+    }
+}
+
+void EdConverter::fill_lines(const ed::Data& ed_data, navitia::type::Data& data) {
+    for (const types::Line* ed_line : ed_data.lines) {
+        auto* network = find_or_default(static_cast<const types::Network*>(ed_line->network), network_map);
+        if (!network) {
+            // the persistor does not insert them
+            LOG4CPLUS_INFO(log, "Line " + ed_line->uri + " ignored because it doesn't have any network");
+            continue;
+        }
+        auto* line = new nt::Line();
+        line->uri = navitia::encode_uri(ed_line->uri);
+        line->name = ed_line->name;
+        line->code = ed_line->code;
+        line->color = ed_line->color;
+        line->text_color = ed_line->text_color;
+        line->sort = ed_line->sort;
+        line->opening_time = ed_line->opening_time;
+        line->closing_time = ed_line->closing_time;
+
+        line->network = network;
+        line->network->line_list.push_back(line);
+
+        line->commercial_mode =
+            find_or_default(static_cast<const types::CommercialMode*>(ed_line->commercial_mode), commercial_mode_map);
+        if (line->commercial_mode) {
+            line->commercial_mode->line_list.push_back(line);
+        }
+
+        line->shape = ed_line->shape;
+
+        data.pt_data->lines.push_back(line);
+        this->line_map[ed_line] = line;
+    }
+
+    // Add Object properties on lines
+    for (const auto& pt_property : ed_data.object_properties) {
+        if (pt_property.first.type != nt::Type_e::Line) {
+            continue;
+        }
+        auto* line = find_or_default(static_cast<const types::Line*>(pt_property.first.pt_object), line_map);
+        if (line) {
+            for (const auto& property : pt_property.second) {
+                line->properties[property.first] = property.second;
+            }
+        }
+    }
+}
+
+void EdConverter::fill_line_groups(const ed::Data& ed_data, navitia::type::Data& data) {
+    for (const types::LineGroup* ed_line_group : ed_data.line_groups) {
+        auto* line_group = new nt::LineGroup();
+        line_group->uri = navitia::encode_uri(ed_line_group->uri);
+        line_group->name = ed_line_group->name;
+        line_group->main_line = find_or_default(static_cast<const types::Line*>(ed_line_group->main_line), line_map);
+        this->line_group_map[ed_line_group] = line_group;
+        data.pt_data->line_groups.push_back(line_group);
+    }
+
+    for (const auto& group_link : ed_data.line_group_links) {
+        auto* line_group = find_or_default(static_cast<const types::LineGroup*>(group_link.line_group), line_group_map);
+        auto* line = find_or_default(static_cast<const types::Line*>(group_link.line), line_map);
+        if (line_group && line) {
+            line_group->line_list.push_back(line);
+            line->line_group_list.push_back(line_group);
+        }
+    }
+}
+
+void EdConverter::fill_routes(const ed::Data& ed_data, navitia::type::Data& data) {
+    size_t nb_unknown_line(0);
+    for (const types::Route* ed_route : ed_data.routes) {
+        auto* line = find_or_default(static_cast<const types::Line*>(ed_route->line), line_map);
+        if (!line) {
+            nb_unknown_line++;
+            continue;
+        }
+        auto* route = new nt::Route();
+        route->uri = navitia::encode_uri(ed_route->uri);
+        route->name = ed_route->name;
+        route->direction_type = ed_route->direction_type;
+        route->shape = ed_route->shape;
+
+        route->line = line;
+        route->line->route_list.push_back(route);
+
+        route->destination = find_or_default(static_cast<const types::StopArea*>(ed_route->destination), stop_area_map);
+
+        data.pt_data->routes.push_back(route);
+        this->route_map[ed_route] = route;
+    }
+    if (nb_unknown_line) {
+        LOG4CPLUS_WARN(log, nb_unknown_line << " routes ignored because their line is unknown");
+    }
+}
+
+void EdConverter::fill_validity_patterns(const ed::Data& ed_data, navitia::type::Data& data) {
+    for (const types::ValidityPattern* ed_vp : ed_data.validity_patterns) {
+        // only the days are stored in the database, they are relative to the production period
+        auto* validity_pattern = new nt::ValidityPattern(data.meta->production_date.begin(), ed_vp->days.to_string());
+        validity_pattern->idx = data.pt_data->validity_patterns.size();
+
+        data.pt_data->validity_patterns.push_back(validity_pattern);
+        this->validity_pattern_map[ed_vp] = validity_pattern;
+    }
+}
+
+void EdConverter::fill_shapes(const ed::Data& ed_data, navitia::type::Data& /*unused*/) {
+    for (const auto& ed_shape : ed_data.shapes_from_prev) {
+        this->shapes_map[ed_shape.get()] = boost::make_shared<nt::LineString>(ed_shape->geom);
+    }
+}
+
+void EdConverter::fill_vehicle_journeys(const ed::Data& ed_data, navitia::type::Data& data) {
+    // the stop times are needed to create the vjs, they are put at their order
+    std::unordered_map<const types::VehicleJourney*, std::vector<nt::StopTime>> sts_from_vj;
+    for (const types::StopTime* ed_st : ed_data.stops) {
+        if (!ed_st->vehicle_journey) {
+            continue;
+        }
+        auto& sts = sts_from_vj[ed_st->vehicle_journey];
+        if (ed_st->order + 1 > sts.size()) {
+            sts.resize(ed_st->order + 1);
+        }
+        nt::StopTime& stop = sts[ed_st->order];
+
+        stop.arrival_time = ed_st->arrival_time;
+        stop.departure_time = ed_st->departure_time;
+        stop.boarding_time = ed_st->boarding_time;
+        stop.alighting_time = ed_st->alighting_time;
+        stop.local_traffic_zone = ed_st->local_traffic_zone;
+        stop.set_date_time_estimated(ed_st->date_time_estimated);
+        stop.set_odt(ed_st->ODT);
+        stop.set_pick_up_allowed(ed_st->pick_up_allowed);
+        stop.set_drop_off_allowed(ed_st->drop_off_allowed);
+        stop.set_is_frequency(ed_st->is_frequency);
+        stop.stop_point = find_or_default(static_cast<const types::StopPoint*>(ed_st->stop_point), stop_point_map);
+        if (ed_st->shape_from_prev) {
+            stop.shape_from_prev =
+                find_or_default(static_cast<const types::Shape*>(ed_st->shape_from_prev.get()), shapes_map);
+        }
+    }
+
+    size_t nb_unknown_route(0);
+    for (const types::VehicleJourney* ed_vj : ed_data.vehicle_journeys) {
+        auto* route = find_or_default(static_cast<const types::Route*>(ed_vj->route), route_map);
+        auto* vp = find_or_default(static_cast<const types::ValidityPattern*>(ed_vj->validity_pattern),
+                                   validity_pattern_map);
+        if (!route || !vp) {
+            nb_unknown_route++;
+            continue;
+        }
+        std::string mvj_name = ed_vj->meta_vj_name;
+        if (mvj_name.empty()) {
+            mvj_name = ed_vj->name;
+        }
+        auto mvj = data.pt_data->meta_vjs.get_or_create(mvj_name);
+        const auto uri = navitia::encode_uri(ed_vj->uri);
+
+        navitia::type::VehicleJourney* vj = nullptr;
+        if (ed_vj->is_frequency()) {
+            auto f_vj = mvj->create_frequency_vj(uri, ed_vj->name, ed_vj->headsign, ed_vj->realtime_level, *vp, route,
+                                                 std::move(sts_from_vj[ed_vj]), *data.pt_data);
+            f_vj->start_time = ed_vj->start_time;
+            f_vj->end_time = ed_vj->end_time;
+            f_vj->headway_secs = ed_vj->headway_secs;
+            vj = f_vj;
+        } else {
+            vj = mvj->create_discrete_vj(uri, ed_vj->name, ed_vj->headsign, ed_vj->realtime_level, *vp, route,
+                                         std::move(sts_from_vj[ed_vj]), *data.pt_data);
+        }
+        vj->odt_message = ed_vj->odt_message;
+        vj->vehicle_journey_type = ed_vj->vehicle_journey_type;
+        vj->physical_mode =
+            find_or_default(static_cast<const types::PhysicalMode*>(ed_vj->physical_mode), physical_mode_map);
+        vj->company = find_or_default(static_cast<const types::Company*>(ed_vj->company), company_map);
+
+        if (vj->company && vj->route->line) {
+            if (boost::range::find(vj->route->line->company_list, vj->company) == vj->route->line->company_list.end()) {
+                vj->route->line->company_list.push_back(vj->company);
+            }
+            if (boost::range::find(vj->company->line_list, vj->route->line) == vj->company->line_list.end()) {
+                vj->company->line_list.push_back(vj->route->line);
+            }
+        }
+
+        vj->set_vehicles(ed_vj->vehicles());
+
+        data.pt_data->headsign_handler.change_name_and_register_as_headsign(*vj, vj->headsign);
+        vehicle_journey_map[ed_vj] = vj;
+
+        vj->dataset = find_or_default(static_cast<const types::Dataset*>(ed_vj->dataset), dataset_map);
+        if (vj->dataset) {
+            vj->dataset->vehiclejourney_list.insert(vj);
+        }
+    }
+    if (nb_unknown_route) {
+        LOG4CPLUS_WARN(log, nb_unknown_route << " vehicle journeys ignored because their route is unknown");
+    }
+
+    for (const auto& ed_vj_vj : vehicle_journey_map) {
+        ed_vj_vj.second->prev_vj =
+            find_or_default(static_cast<const types::VehicleJourney*>(ed_vj_vj.first->prev_vj), vehicle_journey_map);
+        ed_vj_vj.second->next_vj =
+            find_or_default(static_cast<const types::VehicleJourney*>(ed_vj_vj.first->next_vj), vehicle_journey_map);
+    }
+
+    for (const types::StopTime* ed_st : ed_data.stops) {
+        if (ed_st->headsign.empty()) {
+            continue;
+        }
+        const auto* vj = find_or_default(static_cast<const types::VehicleJourney*>(ed_st->vehicle_journey),
+                                         vehicle_journey_map);
+        if (vj) {
+            data.pt_data->headsign_handler.affect_headsign_to_stop_time(vj->stop_time_list.at(ed_st->order),
+                                                                        ed_st->headsign);
+        }
+    }
+}
+
+template <typename Map>
+static size_t add_comment(nt::Data& data, const nt::Header* obj, const Map& map, const nt::Comment& comment) {
+    const auto found = find_or_default(static_cast<typename Map::key_type>(obj), map);
+
+    if (!found) {
+        return 1;
+    }
+
+    data.pt_data->comments.add(found, comment);
+
+    return 0;
+}
+
+void EdConverter::fill_comments(const ed::Data& ed_data, navitia::type::Data& data) {
+    size_t cpt_not_found(0);
+    for (const auto& pt_obj_com : ed_data.comments) {
+        const auto* obj = pt_obj_com.first.pt_object;
+        for (const auto& comment_id : pt_obj_com.second) {
+            const auto it = ed_data.comment_by_id.find(comment_id);
+            if (it == ed_data.comment_by_id.end()) {
+                LOG4CPLUS_WARN(log, "impossible to find comment " << comment_id << " skipping comment for "
+                                                                  << pt_obj_com.first);
+                continue;
+            }
+            const auto& comment = it->second;
+
+            switch (pt_obj_com.first.type) {
+                case nt::Type_e::Route:
+                    cpt_not_found += add_comment(data, obj, route_map, comment);
+                    break;
+                case nt::Type_e::Line:
+                    cpt_not_found += add_comment(data, obj, line_map, comment);
+                    break;
+                case nt::Type_e::LineGroup:
+                    cpt_not_found += add_comment(data, obj, line_group_map, comment);
+                    break;
+                case nt::Type_e::StopArea:
+                    cpt_not_found += add_comment(data, obj, stop_area_map, comment);
+                    break;
+                case nt::Type_e::StopPoint:
+                    cpt_not_found += add_comment(data, obj, stop_point_map, comment);
+                    break;
+                case nt::Type_e::VehicleJourney:
+                    cpt_not_found += add_comment(data, obj, vehicle_journey_map, comment);
+                    break;
+                default:
+                    LOG4CPLUS_WARN(log, "invalid type, skipping object comment: " << pt_obj_com.first);
+                    break;
+            }
+        }
+    }
+
+    for (const auto& st_com : ed_data.stoptime_comments) {
+        const auto* vj = find_or_default(static_cast<const types::VehicleJourney*>(st_com.first->vehicle_journey),
+                                         vehicle_journey_map);
+        if (!vj) {
+            ++cpt_not_found;
+            continue;
+        }
+        const auto& st = vj->stop_time_list.at(st_com.first->order);
+        for (const auto& comment_id : st_com.second) {
+            const auto it = ed_data.comment_by_id.find(comment_id);
+            if (it != ed_data.comment_by_id.end()) {
+                data.pt_data->comments.add(st, it->second);
+            }
+        }
+    }
+    if (cpt_not_found) {
+        LOG4CPLUS_WARN(log, cpt_not_found << " pt object not found for comments");
+    }
+}
+
+void EdConverter::fill_calendars(const ed::Data& ed_data, navitia::type::Data& data) {
+    for (const types::Calendar* ed_cal : ed_data.calendars) {
+        auto* cal = new nt::Calendar(data.meta->production_date.begin());
+        cal->name = ed_cal->name;
+        cal->uri = navitia::base64_encode(ed_cal->uri);
+        cal->week_pattern = ed_cal->week_pattern;
+        for (const auto& period : ed_cal->period_list) {
+            cal->active_periods.emplace_back(period.begin(), period.end());
+        }
+        cal->exceptions = ed_cal->exceptions;
+        for (const types::Line* ed_line : ed_cal->line_list) {
+            if (auto* line = find_or_default(ed_line, line_map)) {
+                line->calendar_list.push_back(cal);
+            }
+        }
+
+        data.pt_data->calendars.push_back(cal);
+        calendar_map[ed_cal] = cal;
+    }
+}
+
+void EdConverter::fill_meta_vehicle_journeys(const ed::Data& ed_data, navitia::type::Data& data) {
+    for (const auto& name_meta_vj : ed_data.meta_vj_map) {
+        nt::MetaVehicleJourney* meta_vj = data.pt_data->meta_vjs.get_mut(name_meta_vj.first);
+        if (meta_vj == nullptr) {
+            throw navitia::exception("impossible to find metavj " + name_meta_vj.first + " data are not valid");
+        }
+
+        for (const auto& name_associated_calendar : name_meta_vj.second.associated_calendars) {
+            const types::AssociatedCalendar* ed_associated_calendar = name_associated_calendar.second;
+            auto* calendar = find_or_default(ed_associated_calendar->calendar, calendar_map);
+            if (!calendar) {
+                LOG4CPLUS_ERROR(log, "Impossible to find the calendar of the associated calendar "
+                                         << name_associated_calendar.first << ", we won't add it to meta vj");
+                continue;
+            }
+
+            auto it_ac = associated_calendar_map.find(ed_associated_calendar);
+            if (it_ac == associated_calendar_map.end()) {
+                auto* associated_calendar = new nt::AssociatedCalendar();
+                associated_calendar->calendar = calendar;
+                associated_calendar->exceptions = ed_associated_calendar->exceptions;
+                data.pt_data->associated_calendars.push_back(associated_calendar);
+                it_ac = associated_calendar_map.emplace(ed_associated_calendar, associated_calendar).first;
+            }
+            // the associated calendars are read back by the uri of their calendar
+            meta_vj->associated_calendars[calendar->uri] = it_ac->second;
+        }
+        meta_vj->tz_handler = timezone;
+    }
+}
+
+void EdConverter::fill_admin_stop_areas(const ed::Data& ed_data, navitia::type::Data& data) {
+    std::unordered_map<std::string, ng::Admin*> admin_by_insee_code;
+    for (auto* admin : data.geo_ref->admins) {
+        admin_by_insee_code[admin->insee] = admin;
+    }
+
+    size_t nb_unknown_admin(0), nb_valid_admin(0);
+    for (const types::AdminStopArea* ed_asa : ed_data.admin_stop_areas) {
+        auto* admin = find_or_default(ed_asa->admin, admin_by_insee_code);
+        if (!admin) {
+            LOG4CPLUS_TRACE(log, "impossible to find admin " << ed_asa->admin
+                                                             << ", we cannot associate stop_areas to it");
+            nb_unknown_admin++;
+            continue;
+        }
+        for (const types::StopArea* ed_sa : ed_asa->stop_area) {
+            if (auto* sa = find_or_default(ed_sa, stop_area_map)) {
+                admin->main_stop_areas.push_back(sa);
+                nb_valid_admin++;
+            }
+        }
+    }
+    LOG4CPLUS_INFO(log, nb_valid_admin << " admin with at least one main stop");
+
+    if (nb_unknown_admin) {
+        LOG4CPLUS_WARN(log, nb_unknown_admin << " admin not found for admin main stops");
+    }
+}
+
+template <typename Map>
+static void add_codes(const Map& map,
+                      const types::pt_object_header& header,
+                      const std::map<std::string, std::vector<std::string>>& codes,
+                      nt::Data& data) {
+    auto* obj = find_or_default(static_cast<typename Map::key_type>(header.pt_object), map);
+    if (!obj) {
+        return;
+    }
+    for (const auto& key_values : codes) {
+        for (const auto& value : key_values.second) {
+            data.pt_data->codes.add(obj, key_values.first, value);
+        }
+    }
+}
+
+void EdConverter::fill_object_codes(const ed::Data& ed_data, navitia::type::Data& data) {
+    size_t count = 0;
+    for (const auto& object_code_map : ed_data.object_codes) {
+        const auto& header = object_code_map.first;
+        if (header.pt_object->idx == nt::invalid_idx) {
+            ++count;
+            continue;
+        }
+        switch (header.type) {
+            case nt::Type_e::StopArea:
+                add_codes(this->stop_area_map, header, object_code_map.second, data);
+                break;
+            case nt::Type_e::Network:
+                add_codes(this->network_map, header, object_code_map.second, data);
+                break;
+            case nt::Type_e::Company:
+                add_codes(this->company_map, header, object_code_map.second, data);
+                break;
+            case nt::Type_e::Line:
+                add_codes(this->line_map, header, object_code_map.second, data);
+                break;
+            case nt::Type_e::Route:
+                add_codes(this->route_map, header, object_code_map.second, data);
+                break;
+            case nt::Type_e::VehicleJourney:
+                add_codes(this->vehicle_journey_map, header, object_code_map.second, data);
+                break;
+            case nt::Type_e::StopPoint:
+                add_codes(this->stop_point_map, header, object_code_map.second, data);
+                break;
+            case nt::Type_e::Calendar:
+                add_codes(this->calendar_map, header, object_code_map.second, data);
+                break;
+            default:
+                break;
+        }
+    }
+    if (count > 0) {
+        LOG4CPLUS_INFO(log, count << "/" << ed_data.object_codes.size() << " object codes ignored.");
+    }
+}
+
+void EdConverter::fill_stop_point_connections(const ed::Data& ed_data, navitia::type::Data& data) {
+    for (const types::StopPointConnection* ed_connection : ed_data.stop_point_connections) {
+        auto* departure =
+            find_or_default(static_cast<const types::StopPoint*>(ed_connection->departure), stop_point_map);
+        auto* destination =
+            find_or_default(static_cast<const types::StopPoint*>(ed_connection->destination), stop_point_map);
+        if (!departure || !destination) {
+            continue;
+        }
+        auto* stop_point_connection = new nt::StopPointConnection();
+        stop_point_connection->departure = departure;
+        stop_point_connection->destination = destination;
+        stop_point_connection->connection_type = ed_connection->connection_kind;
+        stop_point_connection->display_duration = ed_connection->display_duration;
+        stop_point_connection->duration = ed_connection->duration;
+        stop_point_connection->max_duration = ed_connection->max_duration;
+        stop_point_connection->set_properties(ed_connection->properties());
+
+        data.pt_data->stop_point_connections.push_back(stop_point_connection);
+
+        // add the connection in the stop points
+        stop_point_connection->departure->stop_point_connection_list.push_back(stop_point_connection);
+        stop_point_connection->destination->stop_point_connection_list.push_back(stop_point_connection);
+    }
+}
+
+void EdConverter::fill_prices(const ed::Data& ed_data, navitia::type::Data& data) {
+    for (const auto& ticket_it : ed_data.fare_map) {
+        const nf::DateTicket& tickets = ticket_it.second;
+        if (tickets.tickets.empty()) {
+            continue;
+        }
+        // the title and the comment are stored once by ticket key, with the values of the first ticket
+        const auto& first_ticket = tickets.tickets.front().ticket;
+        nf::DateTicket& date_ticket = data.fare->fare_map[ticket_it.first];
+        for (const auto& dated_ticket : tickets.tickets) {
+            nf::Ticket ticket;
+            ticket.key = ticket_it.first;
+            ticket.caption = first_ticket.caption;
+            ticket.comment = first_ticket.comment;
+            ticket.currency = dated_ticket.ticket.currency;
+            ticket.value.value = dated_ticket.ticket.value.value;
+
+            date_ticket.add(dated_ticket.validity_period.begin(), dated_ticket.validity_period.end(), ticket);
+        }
+    }
+}
+
+void EdConverter::fill_transitions(const ed::Data& ed_data, navitia::type::Data& data) {
+    // we build the transition graph
+    std::map<nf::State, nf::Fare::vertex_t> state_map;
+    nf::State begin;  // Start is an empty node (and the node is already is the fare graph, since it has been added in
+                      // the constructor with the default ticket)
+    state_map[begin] = data.fare->begin_v;
+
+    auto get_or_create_vertex = [&](const nf::State& state) {
+        const auto it = state_map.find(state);
+        if (it != state_map.end()) {
+            return it->second;
+        }
+        const auto v = boost::add_vertex(state, data.fare->g);
+        state_map[state] = v;
+        return v;
+    };
+
+    for (const auto& transition_tuple : ed_data.transitions) {
+        const auto start_v = get_or_create_vertex(std::get<0>(transition_tuple));
+        const auto end_v = get_or_create_vertex(std::get<1>(transition_tuple));
+
+        // add the edge to the fare graph
+        boost::add_edge(start_v, end_v, std::get<2>(transition_tuple), data.fare->g);
+    }
+}
+
+void EdConverter::fill_origin_destinations(const ed::Data& ed_data, navitia::type::Data& data) {
+    for (const auto& origin_ticket : ed_data.od_tickets) {
+        for (const auto& destination_ticket : origin_ticket.second) {
+            auto& tickets = data.fare->od_tickets[origin_ticket.first][destination_ticket.first];
+            tickets.insert(tickets.end(), destination_ticket.second.begin(), destination_ticket.second.end());
+        }
+    }
+}
+
+}  // namespace ed
@@ -0,0 +1,112 @@
+/* Copyright © 2001-2014, Canal TP and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+channel `#navitia` on riot https://riot.im/app/#/room/#navitia:matrix.org
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#pragma once
+
+#include "data.h"
+#include "utils/exception.h"
+
+#include <boost/smart_ptr/shared_ptr.hpp>
+#include <log4cplus/logger.h>
+
+#include <unordered_map>
+
+namespace ed {
+
+/**
+ * Builds the navitia data from the ed data, without going through the database
+ *
+ * It is the in-process counterpart of EdPersistor followed by EdReader: each fill_* mirrors
+ * the matching EdReader::fill_*, and the values are transformed the way the database round
+ * trip transforms them (encoded uris, coordinates with 6 decimals...), so that both paths
+ * give the same nav file.
+ *
+ * The street network (geo_ref) is not built here, it has to be in the navitia data before
+ * the call if the admins main stop areas are wanted.
+ */
+struct EdConverter {
+    void fill(const ed::Data& ed_data, navitia::type::Data& data);
+
+private:
+    // maps of the ed objects to the navitia objects
+    std::unordered_map<const types::Network*, navitia::type::Network*> network_map;
+    std::unordered_map<const types::CommercialMode*, navitia::type::CommercialMode*> commercial_mode_map;
+    std::unordered_map<const types::PhysicalMode*, navitia::type::PhysicalMode*> physical_mode_map;
+    std::unordered_map<const types::Company*, navitia::type::Company*> company_map;
+    std::unordered_map<const types::Contributor*, navitia::type::Contributor*> contributor_map;
+    std::unordered_map<const types::Dataset*, navitia::type::Dataset*> dataset_map;
+    std::unordered_map<const types::StopArea*, navitia::type::StopArea*> stop_area_map;
+    std::unordered_map<const types::StopPoint*, navitia::type::StopPoint*> stop_point_map;
+    std::unordered_map<const types::Line*, navitia::type::Line*> line_map;
+    std::unordered_map<const types::LineGroup*, navitia::type::LineGroup*> line_group_map;
+    std::unordered_map<const types::Route*, navitia::type::Route*> route_map;
+    std::unordered_map<const types::ValidityPattern*, navitia::type::ValidityPattern*> validity_pattern_map;
+    std::unordered_map<const types::VehicleJourney*, navitia::type::VehicleJourney*> vehicle_journey_map;
+    std::unordered_map<const types::Calendar*, navitia::type::Calendar*> calendar_map;
+    std::unordered_map<const types::AssociatedCalendar*, navitia::type::AssociatedCalendar*> associated_calendar_map;
+    std::unordered_map<const types::Shape*, boost::shared_ptr<nt::LineString>> shapes_map;
+    const navitia::type::TimeZoneHandler* timezone = nullptr;
+
+    void fill_meta(const ed::Data& ed_data, navitia::type::Data& data);
+    void fill_feed_infos(const ed::Data& ed_data, navitia::type::Data& data);
+    void fill_timezones(const ed::Data& ed_data, navitia::type::Data& data);
+    void fill_networks(const ed::Data& ed_data, navitia::type::Data& data);
+    void fill_commercial_modes(const ed::Data& ed_data, navitia::type::Data& data);
+    void fill_physical_modes(const ed::Data& ed_data, navitia::type::Data& data);
+    void fill_companies(const ed::Data& ed_data, navitia::type::Data& data);
+    void fill_contributors(const ed::Data& ed_data, navitia::type::Data& data);
+    void fill_datasets(const ed::Data& ed_data, navitia::type::Data& data);
+
+    void fill_stop_areas(const ed::Data& ed_data, navitia::type::Data& data);
+    void fill_stop_points(const ed::Data& ed_data, navitia::type::Data& data);
+    void fill_lines(const ed::Data& ed_data, navitia::type::Data& data);
+    void fill_line_groups(const ed::Data& ed_data, navitia::type::Data& data);
+    void fill_routes(const ed::Data& ed_data, navitia::type::Data& data);
+    void fill_validity_patterns(const ed::Data& ed_data, navitia::type::Data& data);
+
+    void fill_shapes(const ed::Data& ed_data, navitia::type::Data& data);
+    void fill_vehicle_journeys(const ed::Data& ed_data, navitia::type::Data& data);
+    void fill_comments(const ed::Data& ed_data, navitia::type::Data& data);
+
+    void fill_calendars(const ed::Data& ed_data, navitia::type::Data& data);
+    void fill_meta_vehicle_journeys(const ed::Data& ed_data, navitia::type::Data& data);
+
+    void fill_admin_stop_areas(const ed::Data& ed_data, navitia::type::Data& data);
+    void fill_object_codes(const ed::Data& ed_data, navitia::type::Data& data);
+    void fill_stop_point_connections(const ed::Data& ed_data, navitia::type::Data& data);
+
+    void fill_prices(const ed::Data& ed_data, navitia::type::Data& data);
+    void fill_transitions(const ed::Data& ed_data, navitia::type::Data& data);
+    void fill_origin_destinations(const ed::Data& ed_data, navitia::type::Data& data);
+
+    log4cplus::Logger log = log4cplus::Logger::getInstance("log");
+};
+
+}  // namespace ed
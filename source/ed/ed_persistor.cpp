@@ -33,12 +33,65 @@ www.navitia.io
 #include "ed/connectors/fare_utils.h"
 
 #include <boost/geometry.hpp>
+#include <future>
+#include <iterator>
 #include <memory>
 
 namespace bg = boost::gregorian;
 
 namespace ed {
 
+using Rows = std::vector<std::vector<std::string>>;
+
+// Bulk inserts the rows of the objects in [begin, end), by batches of
+// batch_size objects. The rows of the next batch are formatted in a
+// background thread while the current one is sent to the database, thus
+// make_rows must not use lotus.
+template <typename It, typename MakeRows>
+static void pipelined_bulk_insert(Lotus& lotus,
+                                  log4cplus::Logger& logger,
+                                  const std::string& table,
+                                  const std::vector<std::string>& columns,
+                                  const It begin,
+                                  const It end,
+                                  MakeRows make_rows,
+                                  const size_t batch_size = 150000) {
+    const size_t nb_objects = std::distance(begin, end);
+    if (nb_objects == 0) {
+        return;
+    }
+    auto format_batch = [&make_rows](It batch_begin, const It batch_end) {
+        Rows rows;
+        for (; batch_begin != batch_end; ++batch_begin) {
+            make_rows(*batch_begin, rows);
+        }
+        return rows;
+    };
+
+    size_t nb_formatted = std::min(batch_size, nb_objects);
+    It batch_end = std::next(begin, nb_formatted);
+    auto next_rows = std::async(std::launch::async, format_batch, begin, batch_end);
+    for (size_t nb_inserted = 0; nb_inserted < nb_objects;) {
+        const Rows rows = next_rows.get();
+        const size_t nb_in_batch = nb_formatted - nb_inserted;
+        if (nb_formatted < nb_objects) {
+            const It batch_begin = batch_end;
+            const size_t nb_in_next_batch = std::min(batch_size, nb_objects - nb_formatted);
+            batch_end = std::next(batch_begin, nb_in_next_batch);
+            nb_formatted += nb_in_next_batch;
+            next_rows = std::async(std::launch::async, format_batch, batch_begin, batch_end);
+        }
+
+        lotus.prepare_bulk_insert(table, columns);
+        for (const auto& row : rows) {
+            lotus.insert(row);
+        }
+        lotus.finish_bulk_insert();
+        nb_inserted += nb_in_batch;
+        LOG4CPLUS_INFO(logger, nb_inserted << "/" << nb_objects << " inserted in " << table);
+    }
+}
+
 EdPersistor::EdPersistor(const std::string& connection_string, const bool is_osm_reader)
     : lotus(connection_string), logger(log4cplus::Logger::getInstance("log")), is_osm_reader(is_osm_reader) {
     if (!is_osm_reader) {
@@ -193,34 +246,24 @@ static std::string coord_to_string(const navitia::type::GeographicalCoord& coord
 }
 
 void EdPersistor::insert_edges(const ed::Georef& data) {
-    this->lotus.prepare_bulk_insert("georef.edge", {"source_node_id", "target_node_id", "way_id", "the_geog",
-                                                    "pedestrian_allowed", "cycles_allowed", "cars_allowed"});
     const auto bool_str = std::to_string(true);
-    size_t to_insert_count = 0;
-    size_t all_count = data.edges.size();
-    for (const auto& edge : data.edges) {
-        const auto source_str = std::to_string(edge.second->source->id);
-        const auto target_str = std::to_string(edge.second->target->id);
-        const auto way_str = std::to_string(edge.second->way->id);
-        const auto source_coord = coord_to_string(edge.second->source->coord);
-        const auto target_coord = coord_to_string(edge.second->target->coord);
-
-        this->lotus.insert({source_str, target_str, way_str,
-                            std::string("LINESTRING(" + source_coord + ",").append(target_coord + ")"), bool_str,
-                            bool_str, bool_str});
-        this->lotus.insert({target_str, source_str, way_str,
-                            std::string("LINESTRING(" + target_coord + ",").append(source_coord + ")"), bool_str,
-                            bool_str, bool_str});
-        ++to_insert_count;
-        if (to_insert_count % 150000 == 0) {
-            lotus.finish_bulk_insert();
-            LOG4CPLUS_INFO(logger, to_insert_count << "/" << all_count << " edges inserées");
-            this->lotus.prepare_bulk_insert("georef.edge", {"source_node_id", "target_node_id", "way_id", "the_geog",
-                                                            "pedestrian_allowed", "cycles_allowed", "cars_allowed"});
-        }
-    }
-    lotus.finish_bulk_insert();
-    LOG4CPLUS_INFO(logger, to_insert_count << "/" << all_count << " edges inserées");
+    pipelined_bulk_insert(this->lotus, this->logger, "georef.edge",
+                          {"source_node_id", "target_node_id", "way_id", "the_geog", "pedestrian_allowed",
+                           "cycles_allowed", "cars_allowed"},
+                          data.edges.begin(), data.edges.end(), [&](const auto& edge, Rows& rows) {
+                              const auto source_str = std::to_string(edge.second->source->id);
+                              const auto target_str = std::to_string(edge.second->target->id);
+                              const auto way_str = std::to_string(edge.second->way->id);
+                              const auto source_coord = coord_to_string(edge.second->source->coord);
+                              const auto target_coord = coord_to_string(edge.second->target->coord);
+
+                              rows.push_back({source_str, target_str, way_str,
+                                              "LINESTRING(" + source_coord + "," + target_coord + ")", bool_str,
+                                              bool_str, bool_str});
+                              rows.push_back({target_str, source_str, way_str,
+                                              "LINESTRING(" + target_coord + "," + source_coord + ")", bool_str,
+                                              bool_str, bool_str});
+                          });
 }
 
 void EdPersistor::insert_poi_types(const Georef& data) {
@@ -917,52 +960,44 @@ void EdPersistor::insert_stop_times(const std::vector<types::StopTime*>& stop_ti
                                         "boarding_time",
                                         "alighting_time"};
 
-    this->lotus.prepare_bulk_insert("navitia.stop_time", columns);
-    size_t inserted_count = 0;
-    size_t size_st = stop_times.size();
-    std::vector<std::string> values;
-    for (types::StopTime* stop : stop_times) {
-        values.clear();
-        values.push_back(std::to_string(stop->idx));
-        values.push_back(std::to_string(stop->arrival_time));
-        values.push_back(std::to_string(stop->departure_time));
-        if (stop->local_traffic_zone != std::numeric_limits<uint16_t>::max()) {
-            values.push_back(std::to_string(stop->local_traffic_zone));
-        } else {
-            values.push_back(lotus.null_value);
-        }
-        values.push_back(std::to_string(stop->ODT));
-        values.push_back(std::to_string(stop->pick_up_allowed));
-        values.push_back(std::to_string(stop->drop_off_allowed));
-        values.push_back(std::to_string(stop->is_frequency));
-
-        values.push_back(std::to_string(stop->order));
-        values.push_back(std::to_string(stop->stop_point->idx));
-        if (!stop->shape_from_prev) {
-            values.push_back(lotus.null_value);
-        } else {
-            values.push_back(std::to_string(stop->shape_from_prev->idx));
-        }
-
-        if (stop->vehicle_journey != nullptr) {
-            values.push_back(std::to_string(stop->vehicle_journey->idx));
-        } else {
-            values.push_back(lotus.null_value);
-        }
-        values.push_back(std::to_string(stop->date_time_estimated));
-        values.push_back(stop->headsign);
-        values.push_back(std::to_string(stop->boarding_time));
-        values.push_back(std::to_string(stop->alighting_time));
+    const std::string null_value = lotus.null_value;
+    pipelined_bulk_insert(
+        this->lotus, this->logger, "navitia.stop_time", columns, stop_times.begin(), stop_times.end(),
+        [&](const types::StopTime* stop, Rows& rows) {
+            rows.emplace_back();
+            auto& values = rows.back();
+            values.reserve(columns.size());
+            values.push_back(std::to_string(stop->idx));
+            values.push_back(std::to_string(stop->arrival_time));
+            values.push_back(std::to_string(stop->departure_time));
+            if (stop->local_traffic_zone != std::numeric_limits<uint16_t>::max()) {
+                values.push_back(std::to_string(stop->local_traffic_zone));
+            } else {
+                values.push_back(null_value);
+            }
+            values.push_back(std::to_string(stop->ODT));
+            values.push_back(std::to_string(stop->pick_up_allowed));
+            values.push_back(std::to_string(stop->drop_off_allowed));
+            values.push_back(std::to_string(stop->is_frequency));
+
+            values.push_back(std::to_string(stop->order));
+            values.push_back(std::to_string(stop->stop_point->idx));
+            if (!stop->shape_from_prev) {
+                values.push_back(null_value);
+            } else {
+                values.push_back(std::to_string(stop->shape_from_prev->idx));
+            }
 
-        this->lotus.insert(values);
-        ++inserted_count;
-        if (inserted_count % 150000 == 0) {
-            lotus.finish_bulk_insert();
-            LOG4CPLUS_INFO(logger, inserted_count << "/" << size_st << " inserted stop times");
-            this->lotus.prepare_bulk_insert("navitia.stop_time", columns);
-        }
-    }
-    this->lotus.finish_bulk_insert();
+            if (stop->vehicle_journey != nullptr) {
+                values.push_back(std::to_string(stop->vehicle_journey->idx));
+            } else {
+                values.push_back(null_value);
+            }
+            values.push_back(std::to_string(stop->date_time_estimated));
+            values.push_back(stop->headsign);
+            values.push_back(std::to_string(stop->boarding_time));
+            values.push_back(std::to_string(stop->alighting_time));
+        });
 }
 
 void EdPersistor::insert_vehicle_properties(const std::vector<types::VehicleJourney*>& vehicle_journeys) {
@@ -43,6 +43,9 @@ www.navitia.io
 #include <boost/make_shared.hpp>
 #include <boost/range/algorithm/find.hpp>
 #include <boost/smart_ptr/shared_ptr.hpp>
+
+#include <future>
+
 namespace ed {
 
 namespace bg = boost::gregorian;
@@ -60,12 +63,62 @@ static void release(T& a) {
     a.swap(b);
 }
 
+// Reads the rows of the request with a cursor, by chunks of chunk_size rows,
+// thus the whole result is never in memory. The next chunk is fetched in the
+// background while the current one is converted, so convert must not use
+// the transaction.
+template <typename Convert>
+static void read_by_chunks(pqxx::work& work,
+                           const std::string& request,
+                           const std::string& cursor_name,
+                           Convert convert,
+                           const size_t chunk_size = 100000) {
+    pqxx::stateless_cursor<pqxx::cursor_base::read_only, pqxx::cursor_base::owned> cursor(work, request, cursor_name,
+                                                                                          false);
+    const size_t nb_rows = cursor.size();
+    auto fetch = [&](const size_t begin) { return cursor.retrieve(begin, std::min(begin + chunk_size, nb_rows)); };
+
+    std::future<pqxx::result> next_chunk;
+    if (nb_rows > 0) {
+        next_chunk = std::async(std::launch::async, fetch, 0);
+    }
+    for (size_t current_idx = 0; current_idx < nb_rows; current_idx += chunk_size) {
+        const pqxx::result result = next_chunk.get();
+        if (current_idx + chunk_size < nb_rows) {
+            next_chunk = std::async(std::launch::async, fetch, current_idx + chunk_size);
+        }
+        convert(result);
+    }
+}
+
 void EdReader::fill(navitia::type::Data& data,
                     const double min_non_connected_graph_ratio,
                     const bool export_georef_edges_geometries) {
+    // the street network does not depend on the public transport, it is
+    // read on its own connection while the public transport is read
+    auto georef = std::async(std::launch::async, [&]() {
+        auto georef_conn = make_connection(connection_string);
+        pqxx::work georef_work(*georef_conn, "loading ED street network");
+        this->fill_georef(data, georef_work, min_non_connected_graph_ratio, export_georef_edges_geometries);
+    });
+
     pqxx::work work(*conn, "loading ED");
+    try {
+        this->fill_pt_data(data, work);
+    } catch (...) {
+        // the street network part uses this, we have to wait for it
+        georef.wait();
+        throw;
+    }
+    georef.get();
 
-    this->fill_vector_to_ignore(work, min_non_connected_graph_ratio);
+    // the link between the admins and the stop areas needs both parts
+    this->fill_admin_stop_areas(data, work);
+
+    check_coherence(data);
+}
+
+void EdReader::fill_pt_data(navitia::type::Data& data, pqxx::work& work) {
     this->fill_meta(data, work);
     // TODO merge fill_feed_infos, fill_meta
     this->fill_feed_infos(data, work);
@@ -105,13 +158,25 @@ void EdReader::fill(navitia::type::Data& data,
     this->fill_associated_calendar(data, work);
     this->fill_meta_vehicle_journeys(data, work);
 
-    this->fill_admins(data, work);
-    this->fill_admins_postal_codes(data, work);
-    this->fill_admin_stop_areas(data, work);
     this->fill_object_codes(data, work);
 
     //@TODO: les connections ont des doublons, en attendant que ce soit corrigé, on ne les enregistre pas
     this->fill_stop_point_connections(data, work);
+
+    this->fill_prices(data, work);
+    this->fill_transitions(data, work);
+    this->fill_origin_destinations(data, work);
+}
+
+void EdReader::fill_georef(navitia::type::Data& data,
+                           pqxx::work& work,
+                           const double min_non_connected_graph_ratio,
+                           const bool export_georef_edges_geometries) {
+    this->fill_vector_to_ignore(work, min_non_connected_graph_ratio);
+
+    this->fill_admins(data, work);
+    this->fill_admins_postal_codes(data, work);
+
     this->fill_poi_types(data, work);
     this->fill_pois(data, work);
     this->fill_poi_properties(data, work);
@@ -131,12 +196,6 @@ void EdReader::fill(navitia::type::Data& data,
     /// les relations admin et les autres objets
     this->build_rel_way_admin(data, work);
     this->build_rel_admin_admin(data, work);
-
-    this->fill_prices(data, work);
-    this->fill_transitions(data, work);
-    this->fill_origin_destinations(data, work);
-
-    check_coherence(data);
 }
 
 void EdReader::fill_admins(navitia::type::Data& nav_data, pqxx::work& work) {
@@ -839,105 +898,137 @@ void EdReader::fill_vehicle_journeys(nt::Data& data, pqxx::work& work) {
         "FROM navitia.vehicle_journey as vj, navitia.vehicle_properties as vp "
         "WHERE vj.vehicle_properties_id = vp.id";
 
-    pqxx::result result = work.exec(request);
     std::multimap<idx_t, nt::VehicleJourney*> prev_vjs, next_vjs;
-    for (auto const_it = result.begin(); const_it != result.end(); ++const_it) {
-        auto* route = route_map[const_it["route_id"].as<idx_t>()];
-        navitia::type::VehicleJourney* vj = nullptr;
-        std::string vj_name;
-        const_it["name"].to(vj_name);
-        std::string mvj_name;
-        const_it["meta_vj_name"].to(mvj_name);
-        if (mvj_name.empty()) {
-            mvj_name = vj_name;
-        }
-
-        auto mvj = data.pt_data->meta_vjs.get_or_create(mvj_name);
-        auto rt_level = navitia::type::get_rt_level_from_string(const_it["vj_class"].as<std::string>());
-        const auto& vp = *validity_pattern_map[const_it["validity_pattern_id"].as<idx_t>()];
-        const auto uri = const_it["uri"].as<std::string>();
-        const auto name = const_it["name"].as<std::string>();
-        const auto headsign = const_it["headsign"].as<std::string>();
-
-        const auto vj_id = const_it["id"].as<idx_t>();
-        if (const_it["is_frequency"].as<bool>()) {
-            auto f_vj = mvj->create_frequency_vj(uri, name, headsign, rt_level, vp, route,
-                                                 std::move(sts_from_vj[vj_id]), *data.pt_data);
-            const_it["start_time"].to(f_vj->start_time);
-            const_it["end_time"].to(f_vj->end_time);
-            const_it["headway_sec"].to(f_vj->headway_secs);
-            vj = f_vj;
-        } else {
-            vj = mvj->create_discrete_vj(uri, name, headsign, rt_level, vp, route, std::move(sts_from_vj[vj_id]),
-                                         *data.pt_data);
-        }
-        const_it["odt_message"].to(vj->odt_message);
-        // TODO ODT NTFSv0.3: remove that when we stop to support NTFSv0.1
-        vj->vehicle_journey_type = static_cast<nt::VehicleJourneyType>(const_it["odt_type_id"].as<int>());
-        vj->physical_mode = physical_mode_map[const_it["physical_mode_id"].as<idx_t>()];
+    read_by_chunks(work, request, "vjcursor", [&](const pqxx::result& result) {
+        const int id_c = result.column_number("id");
+        const int name_c = result.column_number("name");
+        const int uri_c = result.column_number("uri");
+        const int headsign_c = result.column_number("headsign");
+        const int company_id_c = result.column_number("company_id");
+        const int validity_pattern_id_c = result.column_number("validity_pattern_id");
+        const int physical_mode_id_c = result.column_number("physical_mode_id");
+        const int route_id_c = result.column_number("route_id");
+        const int odt_type_id_c = result.column_number("odt_type_id");
+        const int odt_message_c = result.column_number("odt_message");
+        const int next_vj_id_c = result.column_number("next_vj_id");
+        const int prev_vj_id_c = result.column_number("prev_vj_id");
+        const int start_time_c = result.column_number("start_time");
+        const int end_time_c = result.column_number("end_time");
+        const int headway_sec_c = result.column_number("headway_sec");
+        const int is_frequency_c = result.column_number("is_frequency");
+        const int meta_vj_name_c = result.column_number("meta_vj_name");
+        const int vj_class_c = result.column_number("vj_class");
+        const int dataset_id_c = result.column_number("dataset_id");
+        const int wheelchair_accessible_c = result.column_number("wheelchair_accessible");
+        const int bike_accepted_c = result.column_number("bike_accepted");
+        const int air_conditioned_c = result.column_number("air_conditioned");
+        const int visual_announcement_c = result.column_number("visual_announcement");
+        const int audible_announcement_c = result.column_number("audible_announcement");
+        const int appropriate_escort_c = result.column_number("appropriate_escort");
+        const int appropriate_signage_c = result.column_number("appropriate_signage");
+        const int school_vehicle_c = result.column_number("school_vehicle");
 
-        vj->company = company_map[const_it["company_id"].as<idx_t>()];
-        assert(vj->company);
-        assert(vj->route);
+        for (auto const_it = result.begin(); const_it != result.end(); ++const_it) {
+            std::string uri, name, headsign, mvj_name, vj_class;
+            auto* route = route_map[const_it[route_id_c].as<idx_t>()];
+            navitia::type::VehicleJourney* vj = nullptr;
+            const_it[uri_c].to(uri);
+            const_it[name_c].to(name);
+            const_it[headsign_c].to(headsign);
+            const_it[meta_vj_name_c].to(mvj_name);
+            if (mvj_name.empty()) {
+                mvj_name = name;
+            }
 
-        if (vj->route && vj->route->line) {
-            if (boost::range::find(vj->route->line->company_list, vj->company) == vj->route->line->company_list.end()) {
-                vj->route->line->company_list.push_back(vj->company);
+            auto mvj = data.pt_data->meta_vjs.get_or_create(mvj_name);
+            const_it[vj_class_c].to(vj_class);
+            auto rt_level = navitia::type::get_rt_level_from_string(vj_class);
+            const auto& vp = *validity_pattern_map[const_it[validity_pattern_id_c].as<idx_t>()];
+
+            const auto vj_id = const_it[id_c].as<idx_t>();
+            if (const_it[is_frequency_c].as<bool>()) {
+                auto f_vj = mvj->create_frequency_vj(uri, name, headsign, rt_level, vp, route,
+                                                     std::move(sts_from_vj[vj_id]), *data.pt_data);
+                const_it[start_time_c].to(f_vj->start_time);
+                const_it[end_time_c].to(f_vj->end_time);
+                const_it[headway_sec_c].to(f_vj->headway_secs);
+                vj = f_vj;
+            } else {
+                vj = mvj->create_discrete_vj(uri, name, headsign, rt_level, vp, route, std::move(sts_from_vj[vj_id]),
+                                             *data.pt_data);
             }
-            if (boost::range::find(vj->company->line_list, vj->route->line) == vj->company->line_list.end()) {
-                vj->company->line_list.push_back(vj->route->line);
+            // the stop times of the vj are no longer needed
+            sts_from_vj.erase(vj_id);
+
+            const_it[odt_message_c].to(vj->odt_message);
+            // TODO ODT NTFSv0.3: remove that when we stop to support NTFSv0.1
+            vj->vehicle_journey_type = static_cast<nt::VehicleJourneyType>(const_it[odt_type_id_c].as<int>());
+            vj->physical_mode = physical_mode_map[const_it[physical_mode_id_c].as<idx_t>()];
+
+            vj->company = company_map[const_it[company_id_c].as<idx_t>()];
+            assert(vj->company);
+            assert(vj->route);
+
+            if (vj->route && vj->route->line) {
+                if (boost::range::find(vj->route->line->company_list, vj->company)
+                    == vj->route->line->company_list.end()) {
+                    vj->route->line->company_list.push_back(vj->company);
+                }
+                if (boost::range::find(vj->company->line_list, vj->route->line) == vj->company->line_list.end()) {
+                    vj->company->line_list.push_back(vj->route->line);
+                }
             }
-        }
 
-        if (const_it["wheelchair_accessible"].as<bool>()) {
-            vj->set_vehicle(navitia::type::hasVehicleProperties::WHEELCHAIR_ACCESSIBLE);
-        }
-        if (const_it["bike_accepted"].as<bool>()) {
-            vj->set_vehicle(navitia::type::hasVehicleProperties::BIKE_ACCEPTED);
-        }
-        if (const_it["air_conditioned"].as<bool>()) {
-            vj->set_vehicle(navitia::type::hasVehicleProperties::AIR_CONDITIONED);
-        }
-        if (const_it["visual_announcement"].as<bool>()) {
-            vj->set_vehicle(navitia::type::hasVehicleProperties::VISUAL_ANNOUNCEMENT);
-        }
-        if (const_it["audible_announcement"].as<bool>()) {
-            vj->set_vehicle(navitia::type::hasVehicleProperties::AUDIBLE_ANNOUNCEMENT);
-        }
-        if (const_it["appropriate_escort"].as<bool>()) {
-            vj->set_vehicle(navitia::type::hasVehicleProperties::APPOPRIATE_ESCORT);
-        }
-        if (const_it["appropriate_signage"].as<bool>()) {
-            vj->set_vehicle(navitia::type::hasVehicleProperties::APPOPRIATE_SIGNAGE);
-        }
-        if (const_it["school_vehicle"].as<bool>()) {
-            vj->set_vehicle(navitia::type::hasVehicleProperties::SCHOOL_VEHICLE);
-        }
-        if (!const_it["prev_vj_id"].is_null()) {
-            prev_vjs.insert(std::make_pair(const_it["prev_vj_id"].as<idx_t>(), vj));
-        }
-        if (!const_it["next_vj_id"].is_null()) {
-            next_vjs.insert(std::make_pair(const_it["next_vj_id"].as<idx_t>(), vj));
-        }
+            if (const_it[wheelchair_accessible_c].as<bool>()) {
+                vj->set_vehicle(navitia::type::hasVehicleProperties::WHEELCHAIR_ACCESSIBLE);
+            }
+            if (const_it[bike_accepted_c].as<bool>()) {
+                vj->set_vehicle(navitia::type::hasVehicleProperties::BIKE_ACCEPTED);
+            }
+            if (const_it[air_conditioned_c].as<bool>()) {
+                vj->set_vehicle(navitia::type::hasVehicleProperties::AIR_CONDITIONED);
+            }
+            if (const_it[visual_announcement_c].as<bool>()) {
+                vj->set_vehicle(navitia::type::hasVehicleProperties::VISUAL_ANNOUNCEMENT);
+            }
+            if (const_it[audible_announcement_c].as<bool>()) {
+                vj->set_vehicle(navitia::type::hasVehicleProperties::AUDIBLE_ANNOUNCEMENT);
+            }
+            if (const_it[appropriate_escort_c].as<bool>()) {
+                vj->set_vehicle(navitia::type::hasVehicleProperties::APPOPRIATE_ESCORT);
+            }
+            if (const_it[appropriate_signage_c].as<bool>()) {
+                vj->set_vehicle(navitia::type::hasVehicleProperties::APPOPRIATE_SIGNAGE);
+            }
+            if (const_it[school_vehicle_c].as<bool>()) {
+                vj->set_vehicle(navitia::type::hasVehicleProperties::SCHOOL_VEHICLE);
+            }
+            if (!const_it[prev_vj_id_c].is_null()) {
+                prev_vjs.insert(std::make_pair(const_it[prev_vj_id_c].as<idx_t>(), vj));
+            }
+            if (!const_it[next_vj_id_c].is_null()) {
+                next_vjs.insert(std::make_pair(const_it[next_vj_id_c].as<idx_t>(), vj));
+            }
 
-        data.pt_data->headsign_handler.change_name_and_register_as_headsign(*vj, vj->headsign);
-        vehicle_journey_map[vj_id] = vj;
+            data.pt_data->headsign_handler.change_name_and_register_as_headsign(*vj, vj->headsign);
+            vehicle_journey_map[vj_id] = vj;
 
-        // we check if we have some comments
-        const auto& it_comments = vehicle_journey_comments.find(vj_id);
-        if (it_comments != vehicle_journey_comments.end()) {
-            for (const auto& comment : it_comments->second) {
-                data.pt_data->comments.add(vj, comment);
+            // we check if we have some comments
+            const auto& it_comments = vehicle_journey_comments.find(vj_id);
+            if (it_comments != vehicle_journey_comments.end()) {
+                for (const auto& comment : it_comments->second) {
+                    data.pt_data->comments.add(vj, comment);
+                }
             }
-        }
-        if (!const_it["dataset_id"].is_null()) {
-            auto dataset_it = this->dataset_map.find(const_it["dataset_id"].as<idx_t>());
-            if (dataset_it != this->dataset_map.end()) {
-                vj->dataset = dataset_it->second;
-                vj->dataset->vehiclejourney_list.insert(vj);
+            if (!const_it[dataset_id_c].is_null()) {
+                auto dataset_it = this->dataset_map.find(const_it[dataset_id_c].as<idx_t>());
+                if (dataset_it != this->dataset_map.end()) {
+                    vj->dataset = dataset_it->second;
+                    vj->dataset->vehiclejourney_list.insert(vj);
+                }
             }
         }
-    }
+    });
 
     for (auto vjid_vj : prev_vjs) {
         vjid_vj.second->prev_vj = vehicle_journey_map[vjid_vj.first];
@@ -1073,13 +1164,7 @@ void EdReader::fill_stop_times(nt::Data& /*unused*/, pqxx::work& work) {
         "st.alighting_time as alighting_time "
         "FROM navitia.stop_time as st ";
 
-    pqxx::stateless_cursor<pqxx::cursor_base::read_only, pqxx::cursor_base::owned> cursor(work, request, "stcursor",
-                                                                                          false);
-
-    size_t chunk_limit = 100000;
-    size_t nb_rows = cursor.size();
-    for (size_t current_idx = 0; current_idx < nb_rows; current_idx += chunk_limit) {
-        pqxx::result result = cursor.retrieve(current_idx, std::min(current_idx + chunk_limit, nb_rows));
+    read_by_chunks(work, request, "stcursor", [&](const pqxx::result& result) {
         const int vehicle_journey_id_c = result.column_number("vehicle_journey_id");
         const int st_order_c = result.column_number("st_order");
         const int arrival_time_c = result.column_number("arrival_time");
@@ -1094,6 +1179,8 @@ void EdReader::fill_stop_times(nt::Data& /*unused*/, pqxx::work& work) {
         const int shape_from_prev_id_c = result.column_number("shape_from_prev_id");
         const int id_c = result.column_number("id");
         const int headsign_c = result.column_number("headsign");
+        const int boarding_time_c = result.column_number("boarding_time");
+        const int alighting_time_c = result.column_number("alighting_time");
 
         for (auto const_it = result.begin(); const_it != result.end(); ++const_it) {
             const auto vj_id = const_it[vehicle_journey_id_c].as<idx_t>();
@@ -1121,8 +1208,8 @@ void EdReader::fill_stop_times(nt::Data& /*unused*/, pqxx::work& work) {
                 stop.shape_from_prev = this->shapes_map[const_it[shape_from_prev_id_c].as<idx_t>()];
             }
 
-            const_it["boarding_time"].to(stop.boarding_time);
-            const_it["alighting_time"].to(stop.alighting_time);
+            const_it[boarding_time_c].to(stop.boarding_time);
+            const_it[alighting_time_c].to(stop.alighting_time);
 
             const auto st_id = const_it[id_c].as<nt::idx_t>();
             const StKey st_key = {vj_id, sts.size() - 1};
@@ -1140,7 +1227,7 @@ void EdReader::fill_stop_times(nt::Data& /*unused*/, pqxx::work& work) {
                 id_to_stop_time_key[st_id] = st_key;
             }
         }
-    }
+    });
 }
 
 void EdReader::finish_stop_times(nt::Data& data) {
@@ -1482,24 +1569,29 @@ void EdReader::fill_vector_to_ignore(pqxx::work& work, const double min_non_conn
 }
 
 void EdReader::fill_vertex(navitia::type::Data& data, pqxx::work& work) {
-    std::string request = "select id, ST_X(coord::geometry) as lon, ST_Y(coord::geometry) as lat from georef.node;";
-    pqxx::result result = work.exec(request);
+    std::string request = "select id, ST_X(coord::geometry) as lon, ST_Y(coord::geometry) as lat from georef.node";
     uint64_t idx = 0;
-    for (auto const_it = result.begin(); const_it != result.end(); ++const_it) {
-        auto id = const_it["id"].as<uint64_t>();
+    read_by_chunks(work, request, "nodecursor", [&](const pqxx::result& result) {
+        const int id_c = result.column_number("id");
+        const int lon_c = result.column_number("lon");
+        const int lat_c = result.column_number("lat");
 
-        if (node_to_ignore.find(id) != node_to_ignore.end()) {
-            this->node_map[id] = std::numeric_limits<uint64_t>::max();
-            continue;
-        }
+        for (auto const_it = result.begin(); const_it != result.end(); ++const_it) {
+            auto id = const_it[id_c].as<uint64_t>();
 
-        navitia::georef::Vertex v;
-        v.coord.set_lon(const_it["lon"].as<double>());
-        v.coord.set_lat(const_it["lat"].as<double>());
-        boost::add_vertex(v, data.geo_ref->graph);
-        this->node_map[id] = idx;
-        idx++;
-    }
+            if (node_to_ignore.find(id) != node_to_ignore.end()) {
+                this->node_map[id] = std::numeric_limits<uint64_t>::max();
+                continue;
+            }
+
+            navitia::georef::Vertex v;
+            v.coord.set_lon(const_it[lon_c].as<double>());
+            v.coord.set_lat(const_it[lat_c].as<double>());
+            boost::add_vertex(v, data.geo_ref->graph);
+            this->node_map[id] = idx;
+            idx++;
+        }
+    });
     data.geo_ref->init();
 }
 
@@ -1542,92 +1634,104 @@ void EdReader::fill_graph(navitia::type::Data& data, pqxx::work& work, bool expo
     if (export_georef_edges_geometries) {
         request += ", ST_ASTEXT(the_geog) AS geometry";
     }
-    request += " from georef.edge e;";
-    pqxx::result result = work.exec(request);
+    request += " from georef.edge e";
     size_t nb_edges_no_way = 0, nb_useless_edges = 0;
     size_t nb_walking_edges(0), nb_biking_edges(0), nb_driving_edges(0);
 
-    for (auto const_it = result.begin(); const_it != result.end(); ++const_it) {
-        navitia::georef::Way* way = this->way_map[const_it["way_id"].as<uint64_t>()];
-        const auto source_node_id = const_it["source_node_id"].as<uint64_t>();
-        const auto target_node_id = const_it["target_node_id"].as<uint64_t>();
-        auto it_source = node_map.find(source_node_id);
-        auto it_target = node_map.find(target_node_id);
-
-        if (it_source == node_map.end() || it_target == node_map.end()) {
-            continue;
-        }
+    read_by_chunks(work, request, "edgecursor", [&](const pqxx::result& result) {
+        const int way_id_c = result.column_number("way_id");
+        const int source_node_id_c = result.column_number("source_node_id");
+        const int target_node_id_c = result.column_number("target_node_id");
+        const int leng_c = result.column_number("leng");
+        const int pede_c = result.column_number("pede");
+        const int bike_c = result.column_number("bike");
+        const int car_c = result.column_number("car");
+        const int car_speed_c = result.column_number("car_speed");
+        const int geometry_c = export_georef_edges_geometries ? result.column_number("geometry") : -1;
 
-        uint64_t source = it_source->second;
-        uint64_t target = it_target->second;
-
-        if (source == std::numeric_limits<uint64_t>::max() || target == std::numeric_limits<uint64_t>::max()) {
-            continue;
-        }
+        for (auto const_it = result.begin(); const_it != result.end(); ++const_it) {
+            navitia::georef::Way* way = this->way_map[const_it[way_id_c].as<uint64_t>()];
+            const auto source_node_id = const_it[source_node_id_c].as<uint64_t>();
+            const auto target_node_id = const_it[target_node_id_c].as<uint64_t>();
+            auto it_source = node_map.find(source_node_id);
+            auto it_target = node_map.find(target_node_id);
+
+            if (it_source == node_map.end() || it_target == node_map.end()) {
+                continue;
+            }
 
-        if (!way) {
-            nb_edges_no_way++;
-            continue;
-        }
+            uint64_t source = it_source->second;
+            uint64_t target = it_target->second;
 
-        navitia::georef::Edge e;
-        auto len = const_it["leng"].as<double>();
-        e.way_idx = way->idx;
-        if (export_georef_edges_geometries) {
-            nt::LineString geometry;
-            boost::geometry::read_wkt(const_it["geometry"].as<std::string>(), geometry);
-            if (!geometry.empty()) {
-                e.geom_idx = way->geoms.size();
-                way->geoms.push_back(geometry);
+            if (source == std::numeric_limits<uint64_t>::max() || target == std::numeric_limits<uint64_t>::max()) {
+                continue;
             }
-        }
-        auto edge_id = std::make_pair(source_node_id, target_node_id);
-        bool walkable =
-            const_it["pede"].as<bool>() && this->edge_to_ignore_by_modes[nt::Mode_e::Walking].count(edge_id) == 0;
-        bool ridable =
-            const_it["bike"].as<bool>() && this->edge_to_ignore_by_modes[nt::Mode_e::Bike].count(edge_id) == 0;
-        bool carable = const_it["car"].as<bool>() && this->edge_to_ignore_by_modes[nt::Mode_e::Car].count(edge_id) == 0;
 
-        if (!walkable && !ridable && !carable) {
-            nb_useless_edges++;
-            continue;
-        }
+            if (!way) {
+                nb_edges_no_way++;
+                continue;
+            }
 
-        if (walkable) {
-            if (auto dur = get_duration(nt::Mode_e::Walking, len, source, target)) {
-                e.duration = navitia::seconds(*dur);
-                boost::add_edge(source, target, e, data.geo_ref->graph);
-                way->edges.emplace_back(source, target);
-                nb_walking_edges++;
+            navitia::georef::Edge e;
+            auto len = const_it[leng_c].as<double>();
+            e.way_idx = way->idx;
+            if (export_georef_edges_geometries) {
+                nt::LineString geometry;
+                boost::geometry::read_wkt(const_it[geometry_c].as<std::string>(), geometry);
+                if (!geometry.empty()) {
+                    e.geom_idx = way->geoms.size();
+                    way->geoms.push_back(geometry);
+                }
             }
-        }
-        if (ridable) {
-            if (auto dur = get_duration(nt::Mode_e::Bike, len, source, target)) {
-                e.duration = navitia::seconds(*dur);
-                auto bike_source = data.geo_ref->offsets[nt::Mode_e::Bike] + source;
-                auto bike_target = data.geo_ref->offsets[nt::Mode_e::Bike] + target;
-                boost::add_edge(bike_source, bike_target, e, data.geo_ref->graph);
-                way->edges.emplace_back(bike_source, bike_target);
-                nb_biking_edges++;
+            auto edge_id = std::make_pair(source_node_id, target_node_id);
+            bool walkable =
+                const_it[pede_c].as<bool>() && this->edge_to_ignore_by_modes[nt::Mode_e::Walking].count(edge_id) == 0;
+            bool ridable =
+                const_it[bike_c].as<bool>() && this->edge_to_ignore_by_modes[nt::Mode_e::Bike].count(edge_id) == 0;
+            bool carable =
+                const_it[car_c].as<bool>() && this->edge_to_ignore_by_modes[nt::Mode_e::Car].count(edge_id) == 0;
+
+            if (!walkable && !ridable && !carable) {
+                nb_useless_edges++;
+                continue;
             }
-        }
-        if (carable) {
-            boost::optional<navitia::time_res_traits::sec_type> dur;
-            if (!const_it["car_speed"].is_null()) {
-                dur = get_duration(nt::Mode_e::Car, len, const_it["car_speed"].as<double>(), source, target);
-            } else {
-                dur = get_duration(nt::Mode_e::Car, len, source, target);
+
+            if (walkable) {
+                if (auto dur = get_duration(nt::Mode_e::Walking, len, source, target)) {
+                    e.duration = navitia::seconds(*dur);
+                    boost::add_edge(source, target, e, data.geo_ref->graph);
+                    way->edges.emplace_back(source, target);
+                    nb_walking_edges++;
+                }
             }
-            if (dur) {
-                e.duration = navitia::seconds(*dur);
-                auto car_source = data.geo_ref->offsets[nt::Mode_e::Car] + source;
-                auto car_target = data.geo_ref->offsets[nt::Mode_e::Car] + target;
-                boost::add_edge(car_source, car_target, e, data.geo_ref->graph);
-                way->edges.emplace_back(car_source, car_target);
-                nb_driving_edges++;
+            if (ridable) {
+                if (auto dur = get_duration(nt::Mode_e::Bike, len, source, target)) {
+                    e.duration = navitia::seconds(*dur);
+                    auto bike_source = data.geo_ref->offsets[nt::Mode_e::Bike] + source;
+                    auto bike_target = data.geo_ref->offsets[nt::Mode_e::Bike] + target;
+                    boost::add_edge(bike_source, bike_target, e, data.geo_ref->graph);
+                    way->edges.emplace_back(bike_source, bike_target);
+                    nb_biking_edges++;
+                }
+            }
+            if (carable) {
+                boost::optional<navitia::time_res_traits::sec_type> dur;
+                if (!const_it[car_speed_c].is_null()) {
+                    dur = get_duration(nt::Mode_e::Car, len, const_it[car_speed_c].as<double>(), source, target);
+                } else {
+                    dur = get_duration(nt::Mode_e::Car, len, source, target);
+                }
+                if (dur) {
+                    e.duration = navitia::seconds(*dur);
+                    auto car_source = data.geo_ref->offsets[nt::Mode_e::Car] + source;
+                    auto car_target = data.geo_ref->offsets[nt::Mode_e::Car] + target;
+                    boost::add_edge(car_source, car_target, e, data.geo_ref->graph);
+                    way->edges.emplace_back(car_source, car_target);
+                    nb_driving_edges++;
+                }
             }
         }
-    }
+    });
 
     if (nb_edges_no_way) {
         LOG4CPLUS_WARN(log, nb_edges_no_way << " edges have an unknown way");
@@ -46,13 +46,8 @@ namespace ed {
 struct EdReader {
     std::unique_ptr<pqxx::connection> conn;
 
-    EdReader(const std::string& connection_string) {
-        try {
-            conn = std::unique_ptr<pqxx::connection>(new pqxx::connection(connection_string));
-        } catch (const pqxx::pqxx_exception& e) {
-            throw navitia::exception(e.base().what());
-        }
-    }
+    EdReader(const std::string& connection_string)
+        : conn(make_connection(connection_string)), connection_string(connection_string) {}
 
     void fill(navitia::type::Data& data,
               const double min_non_connected_graph_ratio,
@@ -63,6 +58,17 @@ struct EdReader {
     std::unordered_map<std::string, navitia::georef::Admin*> admin_by_insee_code;
 
 private:
+    // the street network is read on a second connection, concurrently with the public transport
+    std::string connection_string;
+
+    static std::unique_ptr<pqxx::connection> make_connection(const std::string& connection_string) {
+        try {
+            return std::unique_ptr<pqxx::connection>(new pqxx::connection(connection_string));
+        } catch (const pqxx::pqxx_exception& e) {
+            throw navitia::exception(e.base().what());
+        }
+    }
+
     // map d'id en base vers le poiteur de l'objet instancié
     std::unordered_map<idx_t, navitia::type::Network*> network_map;
     std::unordered_map<idx_t, navitia::type::CommercialMode*> commercial_mode_map;
@@ -106,6 +112,14 @@ private:
     using EdgeId = std::pair<uint64_t, uint64_t>;
     navitia::flat_enum_map<navitia::type::Mode_e, std::set<EdgeId>> edge_to_ignore_by_modes;
 
+    /// the public transport and the street network tables are independent,
+    /// each part is read with its own transaction
+    void fill_pt_data(navitia::type::Data& data, pqxx::work& work);
+    void fill_georef(navitia::type::Data& data,
+                     pqxx::work& work,
+                     const double min_non_connected_graph_ratio,
+                     const bool export_georef_edges_geometries);
+
     void fill_meta(navitia::type::Data& nav_data, pqxx::work& work);
     void fill_feed_infos(navitia::type::Data& data, pqxx::work& work);
     void fill_timezones(navitia::type::Data& data, pqxx::work& work);
@@ -0,0 +1,281 @@
+/* Copyright © 2001-2014, Canal TP and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+channel `#navitia` on riot https://riot.im/app/#/room/#navitia:matrix.org
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#include "feed2nav.h"
+
+#include "conf.h"
+#include "ed/connectors/fare_parser.h"
+#include "ed/connectors/fusio_parser.h"
+#include "ed/connectors/gtfs_parser.h"
+#include "ed2nav.h"
+#include "ed_converter.h"
+#include "fare/fare.h"
+#include "georef/adminref.h"
+#include "type/meta_data.h"
+#include "type/nav_delta.h"
+#include "type/pt_data.h"
+#include "utils/exception.h"
+#include "utils/init.h"
+
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/program_options.hpp>
+
+#include <fstream>
+#include <iostream>
+
+namespace po = boost::program_options;
+namespace pt = boost::posix_time;
+
+namespace ed {
+
+// Only keeps the street network of the nav file, everything linked to
+// the public transport is rebuilt from the feed.
+static void load_street_network(const std::string& filename, navitia::type::Data& data) {
+    data.load_nav(filename);
+
+    data.pt_data = std::make_unique<navitia::type::PT_Data>();
+    data.fare = std::make_unique<navitia::fare::Fare>();
+
+    auto meta = std::make_unique<navitia::type::MetaData>();
+    meta->street_network_source = data.meta->street_network_source;
+    meta->poi_source = data.meta->poi_source;
+    meta->shape = data.meta->shape;
+    data.meta = std::move(meta);
+
+    for (auto* admin : data.geo_ref->admins) {
+        admin->main_stop_areas.clear();
+        admin->odt_stop_points.clear();
+    }
+
+    data.loaded = false;
+    data.last_load_succeeded = false;
+    data.last_load_at = pt::ptime();
+}
+
+int feed2nav(int argc, const char** argv) {
+    std::string input, date, output, street_network, fare_dir, region_name, delta_base;
+    double simplify_tolerance;
+    size_t nb_threads;
+    po::options_description desc("Allowed options");
+
+    // clang-format off
+    desc.add_options()
+        ("help,h", "Show this message")
+        ("version,v", "Show version")
+        ("date,d", po::value<std::string>(&date), "Beginning date")
+        ("input,i", po::value<std::string>(&input), "Input directory")
+        ("gtfs", "The input directory contains gtfs files, ntfs files otherwise")
+        ("output,o", po::value<std::string>(&output)->default_value("data.nav.lz4"), "Output file")
+        ("name,n", po::value<std::string>(&region_name)->default_value("default"),
+            "Name of the region you are extracting")
+        ("street-network", po::value<std::string>(&street_network),
+         "nav file whose street network (ways, admins, pois) is kept in the output")
+        ("delta-base", po::value<std::string>(&delta_base),
+         "nav file (usually the previous output) from which a delta is written in <output>.delta")
+        ("simplify_tolerance,s", po::value<double>(&simplify_tolerance)->default_value(0.00003),
+         "Distance in unit of coordinate used to simplify geometries and reduce memory usage. Default is "
+         "0.00003 (~ 3m). Pass 0 to disable any simplification.")
+        ("nb-threads", po::value<size_t>(&nb_threads)->default_value(0),
+         "number of threads parsing the stop times, 0 for the number of cores")
+        ("fare,f", po::value<std::string>(&fare_dir), "Directory of fare files (ntfs only)")
+        ("config-file", po::value<std::string>(), "Path to configuration file")
+        ("local_syslog", "activate log redirection within local syslog")
+        ("log_comment", po::value<std::string>(), "optional field to add extra information like coverage name");
+    // clang-format on
+
+    po::variables_map vm;
+    po::store(po::parse_command_line(argc, argv, desc), vm);
+
+    if (vm.count("version")) {
+        std::cout << argv[0] << " " << navitia::config::project_version << " " << navitia::config::navitia_build_type
+                  << std::endl;
+        return 0;
+    }
+
+    // Construct logger and signal handling
+    std::string log_comment;
+    if (vm.count("log_comment")) {
+        log_comment = vm["log_comment"].as<std::string>();
+    }
+    navitia::init_app("feed2nav", "DEBUG", vm.count("local_syslog"), log_comment);
+    auto logger = log4cplus::Logger::getInstance("log");
+
+    if (vm.count("config-file")) {
+        std::ifstream stream;
+        stream.open(vm["config-file"].as<std::string>());
+        if (!stream.is_open()) {
+            throw navitia::exception("loading config file failed");
+        }
+        po::store(po::parse_config_file(stream, desc), vm);
+    }
+
+    if (vm.count("help") || !vm.count("input")) {
+        std::cout << "Reads gtfs or ntfs files and writes a file readable by kraken, without database" << std::endl;
+        std::cout << desc << "\n";
+        return 1;
+    }
+    po::notify(vm);
+
+    const bool is_gtfs = vm.count("gtfs");
+    if (fare_dir.empty()) {
+        fare_dir = input;
+    }
+
+    pt::ptime start;
+    int read, complete, clean, sort, fare(0), main_destination(0), street_network_read(0), convert, save;
+
+    ed::Data ed_data;
+    ed_data.simplify_tolerance = simplify_tolerance;
+
+    start = pt::microsec_clock::local_time();
+    if (is_gtfs) {
+        ed::connectors::GtfsParser gtfs_parser(input);
+        gtfs_parser.nb_threads = nb_threads;
+        gtfs_parser.fill(ed_data, date);
+    } else {
+        ed::connectors::FusioParser fusio_parser(input);
+        fusio_parser.nb_threads = nb_threads;
+        fusio_parser.fill(ed_data, date);
+    }
+    read = (pt::microsec_clock::local_time() - start).total_milliseconds();
+
+    LOG4CPLUS_INFO(logger, "We excluded " << ed_data.count_too_long_connections
+                                          << " connections "
+                                             " because they were too long");
+    LOG4CPLUS_INFO(logger, "We excluded " << ed_data.count_empty_connections
+                                          << " connections "
+                                             " because they had no duration time");
+
+    start = pt::microsec_clock::local_time();
+    ed_data.complete();
+    complete = (pt::microsec_clock::local_time() - start).total_milliseconds();
+
+    if (!is_gtfs) {
+        ed_data.patch_odt_stop_times();
+    }
+
+    start = pt::microsec_clock::local_time();
+    ed_data.clean();
+    clean = (pt::microsec_clock::local_time() - start).total_milliseconds();
+
+    start = pt::microsec_clock::local_time();
+    ed_data.sort();
+    sort = (pt::microsec_clock::local_time() - start).total_milliseconds();
+
+    start = pt::microsec_clock::local_time();
+    ed_data.build_route_destination();
+    main_destination = (pt::microsec_clock::local_time() - start).total_milliseconds();
+
+    ed_data.normalize_uri();
+
+    if (!is_gtfs && (vm.count("fare") || boost::filesystem::exists(fare_dir + "/fares.csv"))) {
+        start = pt::microsec_clock::local_time();
+        LOG4CPLUS_INFO(logger, "loading fare");
+
+        ed::connectors::fare_parser fareParser(ed_data, fare_dir + "/fares.csv", fare_dir + "/prices.csv",
+                                               fare_dir + "/od_fares.csv");
+        fareParser.load();
+        fare = (pt::microsec_clock::local_time() - start).total_milliseconds();
+    }
+
+    navitia::type::Data data;
+
+    if (!street_network.empty()) {
+        start = pt::microsec_clock::local_time();
+        LOG4CPLUS_INFO(logger, "loading the street network of " << street_network);
+        load_street_network(street_network, data);
+        street_network_read = (pt::microsec_clock::local_time() - start).total_milliseconds();
+    }
+
+    start = pt::microsec_clock::local_time();
+    try {
+        ed::EdConverter().fill(ed_data, data);
+    } catch (const navitia::exception& e) {
+        LOG4CPLUS_ERROR(logger, "error while converting the data " << e.what());
+        LOG4CPLUS_ERROR(logger, "stack: " << e.backtrace());
+        throw;
+    }
+    data.meta->instance_name = region_name;
+    data.complete();
+    data.meta->publication_date = pt::microsec_clock::universal_time();
+    convert = (pt::microsec_clock::local_time() - start).total_milliseconds();
+
+    LOG4CPLUS_INFO(logger, "line: " << data.pt_data->lines.size());
+    LOG4CPLUS_INFO(logger, "line_groups: " << data.pt_data->line_groups.size());
+    LOG4CPLUS_INFO(logger, "route: " << data.pt_data->routes.size());
+    LOG4CPLUS_INFO(logger, "stoparea: " << data.pt_data->stop_areas.size());
+    LOG4CPLUS_INFO(logger, "stoppoint: " << data.pt_data->stop_points.size());
+    LOG4CPLUS_INFO(logger, "vehiclejourney: " << data.pt_data->vehicle_journeys.size());
+    LOG4CPLUS_INFO(logger, "stop: " << data.pt_data->nb_stop_times());
+    LOG4CPLUS_INFO(logger, "connection: " << data.pt_data->stop_point_connections.size());
+    LOG4CPLUS_INFO(logger, "modes: " << data.pt_data->physical_modes.size());
+    LOG4CPLUS_INFO(logger, "validity pattern : " << data.pt_data->validity_patterns.size());
+    LOG4CPLUS_INFO(logger, "calendars: " << data.pt_data->calendars.size());
+    LOG4CPLUS_INFO(logger, "fare tickets: " << data.fare->fare_map.size());
+    LOG4CPLUS_INFO(logger, "fare transitions: " << data.fare->nb_transitions());
+    LOG4CPLUS_INFO(logger, "fare od: " << data.fare->od_tickets.size());
+    boost::optional<navitia::type::NavDelta> delta;
+    if (!delta_base.empty()) {
+        delta = make_delta(delta_base, data);
+    }
+
+    LOG4CPLUS_INFO(logger, "Begin to save ...");
+
+    start = pt::microsec_clock::local_time();
+    if (!write_data_to_file(output, data)) {
+        LOG4CPLUS_ERROR(logger, "Exiting feed2nav with errors");
+        return 1;
+    }
+    if (!delta_base.empty() && !write_delta(std::move(delta), output)) {
+        LOG4CPLUS_ERROR(logger, "Exiting feed2nav with errors");
+        return 1;
+    }
+    save = (pt::microsec_clock::local_time() - start).total_milliseconds();
+
+    LOG4CPLUS_INFO(logger, "Computing times");
+    LOG4CPLUS_INFO(logger, "\t File reading: " << read << "ms");
+    LOG4CPLUS_INFO(logger, "\t Data completion: " << complete << "ms");
+    LOG4CPLUS_INFO(logger, "\t Data cleaning: " << clean << "ms");
+    LOG4CPLUS_INFO(logger, "\t Data sorting: " << sort << "ms");
+    if (fare) {
+        LOG4CPLUS_INFO(logger, "\t Fares loading: " << fare << "ms");
+    }
+    LOG4CPLUS_INFO(logger, "\t Destination of routes: " << main_destination << "ms");
+    if (street_network_read) {
+        LOG4CPLUS_INFO(logger, "\t Street network reading: " << street_network_read << "ms");
+    }
+    LOG4CPLUS_INFO(logger, "\t Data conversion: " << convert << "ms");
+    LOG4CPLUS_INFO(logger, "\t Data writing: " << save << "ms");
+
+    return 0;
+}
+
+}  // namespace ed
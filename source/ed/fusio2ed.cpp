@@ -50,6 +50,7 @@ namespace pt = boost::posix_time;
 int main(int argc, char* argv[]) {
     std::string input, date, connection_string, fare_dir;
     double simplify_tolerance;
+    size_t nb_threads;
     po::options_description desc("Allowed options");
 
     // clang-format off
@@ -61,6 +62,8 @@ int main(int argc, char* argv[]) {
          "Distance in unit of coordinate used to simplify geometries and reduce memory usage. Default is "
          "0.00003 (~ 3m). Pass 0 to disable any simplification.")
         ("version,v", "Show version")
+        ("nb-threads", po::value<size_t>(&nb_threads)->default_value(0),
+         "number of threads parsing the stop times, 0 for the number of cores")
         ("fare,f", po::value<std::string>(&fare_dir), "Directory of fare files")
         ("config-file", po::value<std::string>(), "Path to configuration file")
         ("connection-string", po::value<std::string>(&connection_string)->required(),
@@ -116,6 +119,7 @@ int main(int argc, char* argv[]) {
     start = pt::microsec_clock::local_time();
 
     ed::connectors::FusioParser fusio_parser(input);
+    fusio_parser.nb_threads = nb_threads;
     fusio_parser.fill(data, date);
     read = (pt::microsec_clock::local_time() - start).total_milliseconds();
 
@@ -130,28 +134,7 @@ int main(int argc, char* argv[]) {
     data.complete();
     complete = (pt::microsec_clock::local_time() - start).total_milliseconds();
 
-    LOG4CPLUS_INFO(logger, "Starting da ugly ODT hack...");
-    size_t nb_hacked = 0;
-    for (auto* vj : data.vehicle_journeys) {
-        if (vj->stop_time_list.size() != 2) {
-            continue;
-        }
-        if (vj->stop_time_list[0]->stop_point != vj->stop_time_list[1]->stop_point) {
-            continue;
-        }
-        if (vj->stop_time_list[0]->departure_time != vj->stop_time_list[1]->arrival_time) {
-            continue;
-        }
-
-        // No, teleportation can't exist, even on a null distance!
-        // You'll take 10 min, I said!
-        ++nb_hacked;
-        vj->stop_time_list[1]->arrival_time += 10 * 60;
-        vj->stop_time_list[1]->departure_time += 10 * 60;
-        vj->stop_time_list[1]->alighting_time += 10 * 60;
-        vj->stop_time_list[1]->boarding_time += 10 * 60;
-    }
-    LOG4CPLUS_INFO(logger, "Da ugly ODT hack: " << nb_hacked << " patched");
+    data.patch_odt_stop_times();
 
     start = pt::microsec_clock::local_time();
     data.clean();
@@ -48,6 +48,7 @@ namespace pt = boost::posix_time;
 int main(int argc, char* argv[]) {
     std::string input, date, connection_string;
     double simplify_tolerance;
+    size_t nb_threads;
     po::options_description desc("Allowed options");
 
     // clang-format off
@@ -59,6 +60,8 @@ int main(int argc, char* argv[]) {
          "Distance in unit of coordinate used to simplify geometries and reduce memory usage. Default is "
          "0.00003 (~ 3m). Pass 0 to disable any simplification.")
         ("version,v", "Show version")
+        ("nb-threads", po::value<size_t>(&nb_threads)->default_value(0),
+         "number of threads parsing the stop times, 0 for the number of cores")
         ("config-file", po::value<std::string>(), "Path to a config file")
         ("connection-string", po::value<std::string>(&connection_string)->required(),
             "Database connection parameters: host=localhost user=navitia"
@@ -109,6 +112,7 @@ int main(int argc, char* argv[]) {
     start = pt::microsec_clock::local_time();
 
     ed::connectors::GtfsParser gtfs_parser(input);
+    gtfs_parser.nb_threads = nb_threads;
     gtfs_parser.fill(data, date);
     read = (pt::microsec_clock::local_time() - start).total_milliseconds();
     LOG4CPLUS_INFO(logger, "We excluded " << data.count_too_long_connections
@@ -46,6 +46,7 @@ www.navitia.io
 #include <boost/range/algorithm/find_if.hpp>
 #include <boost/range/algorithm/reverse.hpp>
 
+#include <algorithm>
 #include <cstdio>
 #include <iostream>
 #include <queue>
@@ -102,7 +103,7 @@ void ReadRelationsVisitor::relation_callback(uint64_t osm_id,
                     break;
                 case OSMPBF::Relation_MemberType::Relation_MemberType_NODE:
                     if (ref.role == "admin_centre" || ref.role == "admin_center") {
-                        cache.nodes.insert(OSMNode(ref.member_id));
+                        cache.nodes.add_reference(ref.member_id, false);
                     }
                     break;
                 case OSMPBF::Relation_MemberType::Relation_MemberType_RELATION:
@@ -205,13 +206,10 @@ void ReadWaysVisitor::way_callback(uint64_t osm_id,
         it_way = cache.ways.insert(OSMWay(osm_id, properties, name, speed)).first;
     }
     for (auto osm_id : nodes_refs) {
-        auto v = cache.nodes.insert(OSMNode(osm_id));
-        if (is_street && !v.second) {
-            v.first->set_used_more_than_once();
-        }
-        if (it_way != cache.ways.end()) {
-            it_way->add_node(v.first);
-        }
+        cache.nodes.add_reference(osm_id, is_street);
+    }
+    if (it_way != cache.ways.end()) {
+        it_way->node_ids.insert(it_way->node_ids.end(), nodes_refs.begin(), nodes_refs.end());
     }
 }
 
@@ -219,10 +217,57 @@ void ReadWaysVisitor::way_callback(uint64_t osm_id,
  * We fill needed nodes with their coordinates
  */
 void ReadNodesVisitor::node_callback(uint64_t osm_id, double lon, double lat, const CanalTP::Tags& /*unused*/) {
-    auto node_it = cache.nodes.find(OSMNode(osm_id));
-    if (node_it != cache.nodes.end()) {
-        node_it->set_coord(lon, lat);
+    if (const auto* node = cache.nodes.find(osm_id)) {
+        node->set_coord(lon, lat);
+    }
+}
+
+void OSMNodes::build() {
+    const auto id = [](uint64_t reference) { return reference & ~STREET_FLAG; };
+    // stable, the first reference of a node stays first
+    std::stable_sort(references.begin(), references.end(),
+                     [&](uint64_t a, uint64_t b) { return id(a) < id(b); });
+    size_t nb_nodes = 0;
+    for (size_t r = 0; r < references.size(); ++r) {
+        if (r == 0 || id(references[r]) != id(references[r - 1])) {
+            ++nb_nodes;
+        }
+    }
+    nodes.clear();
+    nodes.reserve(nb_nodes);
+    for (size_t r = 0; r < references.size(); ++r) {
+        if (r == 0 || id(references[r]) != id(references[r - 1])) {
+            nodes.emplace_back(id(references[r]));
+        } else if (references[r] & STREET_FLAG) {
+            nodes.back().set_used_more_than_once();
+        }
     }
+    std::vector<uint64_t>().swap(references);
+}
+
+const OSMNode* OSMNodes::find(uint64_t osm_id) const {
+    const auto it = std::lower_bound(nodes.begin(), nodes.end(), osm_id,
+                                     [](const OSMNode& node, uint64_t id) { return node.osm_id < id; });
+    if (it == nodes.end() || it->osm_id != osm_id) {
+        return nullptr;
+    }
+    return &*it;
+}
+
+/*
+ * Builds the nodes referenced by the relations and the ways, and links them to their ways
+ */
+void OSMCache::build_nodes() {
+    auto logger = log4cplus::Logger::getInstance("log");
+    nodes.build();
+    for (const auto& way : ways) {
+        way.nodes.reserve(way.node_ids.size());
+        for (const auto osm_id : way.node_ids) {
+            way.add_node(nodes.find(osm_id));
+        }
+        std::vector<uint64_t>().swap(way.node_ids);
+    }
+    LOG4CPLUS_INFO(logger, nodes.size() << " nodes referenced by " << ways.size() << " ways");
 }
 
 /*
@@ -431,7 +476,7 @@ void OSMCache::insert_edges() {
     size_t n_inserted = 0;
     const size_t max_n_inserted = 20000;
     for (const auto& way : ways) {
-        auto prev_node = nodes.end();
+        const OSMNode* prev_node = nullptr;
         const auto ref_way_id = way.way_ref == nullptr ? way.osm_id : way.way_ref->osm_id;
 
         std::string speed = lotus->null_value;
@@ -442,8 +487,8 @@ void OSMCache::insert_edges() {
             if (!node->is_defined()) {
                 continue;
             }
-            if ((node->is_used_more_than_once() && prev_node != nodes.end())
-                || (node == way.nodes.back() && prev_node != nodes.end())) {
+            if ((node->is_used_more_than_once() && prev_node != nullptr)
+                || (node == way.nodes.back() && prev_node != nullptr)) {
                 // If a node is used more than once, it is an intersection,
                 // hence it's a node of the street network graph
                 // If a node is only used by one way we can simplify the and reduce the number of edges, we don't need
@@ -468,10 +513,10 @@ void OSMCache::insert_edges() {
                                      std::to_string(way.properties[OSMWay::FOOT_BWD]),
                                      std::to_string(way.properties[OSMWay::CYCLE_BWD]),
                                      std::to_string(way.properties[OSMWay::CAR_BWD]), speed});
-                prev_node = nodes.end();
+                prev_node = nullptr;
                 n_inserted = n_inserted + 2;
             }
-            if (prev_node == nodes.end()) {
+            if (prev_node == nullptr) {
                 coords.clear();
                 prev_node = node;
             }
@@ -830,15 +875,15 @@ OSMAdminRelation::OSMAdminRelation(u_int64_t id,
 void OSMAdminRelation::build_geometry(OSMCache& cache) {
     for (const CanalTP::Reference& ref : references) {
         if (ref.member_type == OSMPBF::Relation_MemberType::Relation_MemberType_NODE) {
-            auto node_it = cache.nodes.find(ref.member_id);
-            if (node_it == cache.nodes.end()) {
+            const auto* node = cache.nodes.find(ref.member_id);
+            if (node == nullptr) {
                 continue;
             }
-            if (!node_it->is_defined()) {
+            if (!node->is_defined()) {
                 continue;
             }
             if (ref.role == "admin_centre" || ref.role == "admin_center") {
-                this->center = point(node_it->lon(), node_it->lat());
+                this->center = point(node->lon(), node->lat());
                 break;
             }
         }
@@ -868,19 +913,19 @@ void PoiHouseNumberVisitor::way_callback(uint64_t osm_id,
     }
     polygon_type tmp_polygon;
     for (auto ref : refs) {
-        auto node_it = cache.nodes.find(OSMNode(ref));
-        if (node_it == cache.nodes.end() || !node_it->is_defined()) {
+        const auto* node = cache.nodes.find(ref);
+        if (node == nullptr || !node->is_defined()) {
             continue;
         }
-        const auto p = point(node_it->lon(), node_it->lat());
+        const auto p = point(node->lon(), node->lat());
         tmp_polygon.outer().push_back(p);
     }
     if (tmp_polygon.outer().size() <= 2) {
         for (auto ref_id : refs) {
-            auto node_it = cache.nodes.find(OSMNode(ref_id));
-            if (node_it != cache.nodes.end() && node_it->is_defined()) {
-                this->fill_housenumber(osm_id, tags, node_it->lon(), node_it->lat());
-                this->fill_poi(osm_id, tags, node_it->lon(), node_it->lat(), OsmObjectType::Way);
+            const auto* node = cache.nodes.find(ref_id);
+            if (node != nullptr && node->is_defined()) {
+                this->fill_housenumber(osm_id, tags, node->lon(), node->lat());
+                this->fill_poi(osm_id, tags, node->lon(), node->lat(), OsmObjectType::Way);
                 break;
             }
         }
@@ -1119,6 +1164,7 @@ void OSMCache::flag_nodes() {
 int osm2ed(int argc, const char** argv) {
     pt::ptime start;
     std::string input, connection_string, json_poi_types;
+    size_t nb_threads;
 
     po::options_description desc("Allowed options");
 
@@ -1138,7 +1184,9 @@ int osm2ed(int argc, const char** argv) {
         ("log_comment", po::value<std::string>(), "optional field to add extra information like coverage name")
         ("cities-connection-string", po::value<std::string>(),
             "cities database connection string, to use admins from cities instead of osm's relations")
-        ("import-car-speed", "import car speed in ED");
+        ("import-car-speed", "import car speed in ED")
+        ("nb-threads", po::value<size_t>(&nb_threads)->default_value(0),
+            "number of threads decoding the osm file, 0 for the number of cores");
     // clang-format on
 
     po::variables_map vm;
@@ -1207,13 +1255,17 @@ int osm2ed(int argc, const char** argv) {
     persistor.clean_georef();
     persistor.clean_poi();
 
+    const ed::connectors::OsmPbfReader reader(input, nb_threads);
     ed::connectors::OSMCache cache(std::make_unique<Lotus>(connection_string), cities_cnx);
     ed::connectors::ReadRelationsVisitor relations_visitor(cache, use_cities);
-    CanalTP::read_osm_pbf(input, relations_visitor);
-    ed::connectors::ReadWaysVisitor ways_visitor(cache, poi_params, speed_parser);
-    CanalTP::read_osm_pbf(input, ways_visitor);
+    reader.read(relations_visitor, ed::connectors::OSM_RELATIONS);
+    {
+        ed::connectors::ReadWaysVisitor ways_visitor(cache, poi_params, speed_parser);
+        reader.read(ways_visitor, ed::connectors::OSM_WAYS);
+    }
+    cache.build_nodes();
     ed::connectors::ReadNodesVisitor node_visitor(cache);
-    CanalTP::read_osm_pbf(input, node_visitor);
+    reader.read(node_visitor, ed::connectors::OSM_NODES);
     cache.build_relations_geometries();
     cache.match_nodes_admin();
     cache.build_way_map();
@@ -1228,7 +1280,7 @@ int osm2ed(int argc, const char** argv) {
 
     ed::Georef data;
     ed::connectors::PoiHouseNumberVisitor poi_visitor(persistor, cache, data, persistor.parse_pois, poi_params);
-    CanalTP::read_osm_pbf(input, poi_visitor);
+    reader.read(poi_visitor, ed::connectors::OSM_NODES | ed::connectors::OSM_WAYS);
     poi_visitor.finish();
     LOG4CPLUS_INFO(logger, "compute bounding shape");
     persistor.compute_bounding_shape();
@@ -42,6 +42,7 @@ www.navitia.io
 #include <boost/geometry/multi/geometries/multi_point.hpp>
 #include <RTree/RTree.h>
 #include <osmpbfreader/osmpbfreader.h>
+#include "ed/osm_pbf_reader.h"
 
 #include <unordered_map>
 #include <set>
@@ -62,8 +63,8 @@ struct OSMCache;
 struct OSMNode {
     static const uint USED_MORE_THAN_ONCE = 0, FIRST_OR_LAST = 1;
     uint64_t osm_id = std::numeric_limits<uint64_t>::max();
-    // these attributes are mutable because this object would be use in a set, and
-    // all object in a set are const, since these attributes are not used in the key we can modify them
+    // these attributes are mutable because the nodes are const once sorted in OSMNodes,
+    // since these attributes are not used in the key we can modify them
 
     // We use int32_t to save memory, these are coordinates *  factor
     mutable int32_t ilon = std::numeric_limits<int32_t>::max(), ilat = std::numeric_limits<int32_t>::max();
@@ -116,6 +117,36 @@ private:
     mutable std::bitset<2> properties = 0;
 };
 
+/*
+ * The nodes of the ways and of the admins, in an array sorted by osm id.
+ *
+ * The references to the nodes are collected while reading the relations and the ways, then
+ * build() makes one node by referenced id, and the nodes are then found by their id.  A node
+ * referenced by a street after another reference is used more than once.
+ */
+class OSMNodes {
+public:
+    using const_iterator = std::vector<OSMNode>::const_iterator;
+
+    void add_reference(uint64_t osm_id, bool by_street) {
+        references.push_back(by_street ? osm_id | STREET_FLAG : osm_id);
+    }
+    void build();
+
+    // nullptr if the node is not referenced
+    const OSMNode* find(uint64_t osm_id) const;
+
+    const_iterator begin() const { return nodes.begin(); }
+    const_iterator end() const { return nodes.end(); }
+    size_t size() const { return nodes.size(); }
+
+private:
+    static constexpr uint64_t STREET_FLAG = uint64_t(1) << 63;
+
+    std::vector<uint64_t> references;  // in reading order, with STREET_FLAG when referenced by a street
+    std::vector<OSMNode> nodes;
+};
+
 struct Admin {
     Admin(u_int64_t id,
           std::string uri,
@@ -178,7 +209,8 @@ struct OSMWay {
     /// Properties of a way : can we use it
     mutable std::bitset<8> properties;
     mutable std::string name = "";
-    mutable std::vector<std::set<OSMNode>::const_iterator> nodes;
+    mutable std::vector<uint64_t> node_ids;  // until the nodes are built
+    mutable std::vector<const OSMNode*> nodes;
     mutable ls_type ls;
     mutable const OSMWay* way_ref = nullptr;
     mutable boost::optional<float> car_speed;
@@ -192,7 +224,7 @@ struct OSMWay {
            boost::optional<float> car_speed = boost::none)
         : osm_id(osm_id), properties(properties), name(name), car_speed(car_speed) {}
 
-    void add_node(std::set<OSMNode>::const_iterator node) const {
+    void add_node(const OSMNode* node) const {
         nodes.push_back(node);
         if (node->is_defined()) {
             ls.push_back(point(node->lon(), node->lat()));
@@ -270,7 +302,7 @@ constexpr double M_TO_DEG = 1.0 / 111320.0;  // approximate the convertion betwe
 
 struct OSMCache {
     std::map<uint64_t, std::unique_ptr<Admin>> admins;
-    std::set<OSMNode> nodes;
+    OSMNodes nodes;
     std::set<OSMWay> ways;
     std::set<AssociateStreetRelation> associated_streets;
     std::unordered_map<std::string, rel_ways> way_admin_map;
@@ -295,6 +327,7 @@ struct OSMCache {
         }
     }
 
+    void build_nodes();
     void build_relations_geometries();
     const Admin* match_coord_admin(const double lon, const double lat);
     const Admin* find_admin_in_cities(const double lon, const double lat);
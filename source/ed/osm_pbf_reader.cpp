@@ -0,0 +1,252 @@
+/* Copyright © 2001-2014, Canal TP and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+channel `#navitia` on riot https://riot.im/app/#/room/#navitia:matrix.org
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+#include "ed/osm_pbf_reader.h"
+
+#include "utils/exception.h"
+
+#include <zlib.h>
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <fstream>
+#include <thread>
+
+namespace ed {
+namespace connectors {
+
+namespace {
+
+// the largest blob header and blob allowed by the pbf format
+constexpr size_t MAX_BLOB_HEADER_SIZE = 64 * 1024;
+constexpr size_t MAX_BLOB_SIZE = 32 * 1024 * 1024;
+
+/*
+ * Reads the next blob of the file into blob, left empty when it is not a data blob.
+ * Returns false at the end of the file.
+ */
+bool read_blob(std::istream& file, const std::string& path, std::string& blob) {
+    unsigned char size_bytes[4];
+    if (!file.read(reinterpret_cast<char*>(size_bytes), sizeof(size_bytes))) {
+        return false;
+    }
+    const size_t header_size = (size_t(size_bytes[0]) << 24) | (size_t(size_bytes[1]) << 16)
+                               | (size_t(size_bytes[2]) << 8) | size_t(size_bytes[3]);
+    if (header_size > MAX_BLOB_HEADER_SIZE) {
+        throw navitia::exception(path + ": invalid blob header size " + std::to_string(header_size));
+    }
+    std::string buffer(header_size, '\0');
+    OSMPBF::BlobHeader header;
+    if (!file.read(&buffer[0], header_size) || !header.ParseFromString(buffer)) {
+        throw navitia::exception(path + ": unable to read a blob header");
+    }
+    const size_t blob_size = header.datasize();
+    if (blob_size > MAX_BLOB_SIZE) {
+        throw navitia::exception(path + ": invalid blob size " + std::to_string(blob_size));
+    }
+    if (header.type() != "OSMData") {
+        file.ignore(blob_size);
+        blob.clear();
+        return true;
+    }
+    blob.resize(blob_size);
+    if (!file.read(&blob[0], blob_size)) {
+        throw navitia::exception(path + ": unable to read a blob");
+    }
+    return true;
+}
+
+std::string unpack_blob(const std::string& data) {
+    OSMPBF::Blob blob;
+    if (!blob.ParseFromString(data)) {
+        throw navitia::exception("unable to parse a blob");
+    }
+    if (blob.has_raw()) {
+        return blob.raw();
+    }
+    if (!blob.has_zlib_data()) {
+        throw navitia::exception("unsupported blob compression, only zlib is handled");
+    }
+    std::string unpacked(blob.raw_size(), '\0');
+    uLongf unpacked_size = unpacked.size();
+    if (uncompress(reinterpret_cast<Bytef*>(&unpacked[0]), &unpacked_size,
+                   reinterpret_cast<const Bytef*>(blob.zlib_data().data()), blob.zlib_data().size())
+            != Z_OK
+        || unpacked_size != unpacked.size()) {
+        throw navitia::exception("unable to uncompress a blob");
+    }
+    return unpacked;
+}
+
+template <typename Message>
+CanalTP::Tags get_tags(const Message& message, const OSMPBF::StringTable& strings) {
+    CanalTP::Tags tags;
+    for (int i = 0; i < message.keys_size(); ++i) {
+        tags[strings.s(message.keys(i))] = strings.s(message.vals(i));
+    }
+    return tags;
+}
+
+}  // namespace
+
+OsmPbfReader::OsmPbfReader(std::string path, size_t nb_threads) : path(std::move(path)), nb_threads(nb_threads) {
+    if (this->nb_threads == 0) {
+        this->nb_threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+    }
+}
+
+void OsmPbfReader::decode_block(const std::string& data, int primitives, OsmBlock& block) {
+    OSMPBF::PrimitiveBlock primitive_block;
+    if (!primitive_block.ParseFromString(data)) {
+        throw navitia::exception("unable to parse a primitive block");
+    }
+    const auto& strings = primitive_block.stringtable();
+    const int64_t granularity = primitive_block.granularity();
+    const int64_t lon_offset = primitive_block.lon_offset(), lat_offset = primitive_block.lat_offset();
+    const auto to_degrees = [&](int64_t offset, int64_t value) { return 1e-9 * (offset + granularity * value); };
+
+    for (const auto& group : primitive_block.primitivegroup()) {
+        if (primitives & OSM_NODES) {
+            for (const auto& node : group.nodes()) {
+                block.nodes.push_back({uint64_t(node.id()), to_degrees(lon_offset, node.lon()),
+                                       to_degrees(lat_offset, node.lat()), get_tags(node, strings)});
+            }
+            if (group.has_dense()) {
+                const auto& dense = group.dense();
+                int64_t id = 0, lon = 0, lat = 0;
+                int key_val = 0;
+                for (int i = 0; i < dense.id_size(); ++i) {
+                    id += dense.id(i);
+                    lon += dense.lon(i);
+                    lat += dense.lat(i);
+                    // the keys and values of all the nodes, the ones of each node ended by a 0
+                    CanalTP::Tags tags;
+                    while (key_val + 1 < dense.keys_vals_size() && dense.keys_vals(key_val) != 0) {
+                        tags[strings.s(dense.keys_vals(key_val))] = strings.s(dense.keys_vals(key_val + 1));
+                        key_val += 2;
+                    }
+                    ++key_val;
+                    block.nodes.push_back(
+                        {uint64_t(id), to_degrees(lon_offset, lon), to_degrees(lat_offset, lat), std::move(tags)});
+                }
+            }
+        }
+        if (primitives & OSM_WAYS) {
+            for (const auto& way : group.ways()) {
+                std::vector<uint64_t> refs;
+                refs.reserve(way.refs_size());
+                int64_t ref = 0;
+                for (const auto delta : way.refs()) {
+                    ref += delta;
+                    refs.push_back(uint64_t(ref));
+                }
+                block.ways.push_back({uint64_t(way.id()), get_tags(way, strings), std::move(refs)});
+            }
+        }
+        if (primitives & OSM_RELATIONS) {
+            for (const auto& relation : group.relations()) {
+                CanalTP::References refs(relation.memids_size());
+                int64_t member_id = 0;
+                for (int i = 0; i < relation.memids_size(); ++i) {
+                    member_id += relation.memids(i);
+                    refs[i].member_type = relation.types(i);
+                    refs[i].member_id = uint64_t(member_id);
+                    refs[i].role = strings.s(relation.roles_sid(i));
+                }
+                block.relations.push_back({uint64_t(relation.id()), get_tags(relation, strings), std::move(refs)});
+            }
+        }
+    }
+}
+
+void OsmPbfReader::read_blocks(int primitives, const std::function<void(const OsmBlock&)>& on_block) const {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        throw navitia::exception("impossible to open the osm file " + path);
+    }
+    // the blobs are read by batches, decoded by the threads, then handed over in order
+    const size_t batch_size = 4 * nb_threads;
+    std::vector<std::string> blobs;
+    std::vector<OsmBlock> blocks;
+    bool end_of_file = false;
+    while (!end_of_file) {
+        blobs.clear();
+        std::string blob;
+        while (blobs.size() < batch_size) {
+            if (!read_blob(file, path, blob)) {
+                end_of_file = true;
+                break;
+            }
+            if (!blob.empty()) {
+                blobs.push_back(std::move(blob));
+            }
+        }
+        blocks.assign(blobs.size(), OsmBlock());
+
+        std::atomic<size_t> next_blob{0};
+        const auto work = [&]() {
+            for (size_t b = next_blob++; b < blobs.size(); b = next_blob++) {
+                decode_block(unpack_blob(blobs[b]), primitives, blocks[b]);
+            }
+        };
+        const size_t nb_workers = std::min(nb_threads, blobs.size());
+        if (nb_workers <= 1) {
+            work();
+        } else {
+            std::vector<std::exception_ptr> errors(nb_workers);
+            std::vector<std::thread> threads;
+            for (size_t t = 0; t < nb_workers; ++t) {
+                threads.emplace_back([&work, &errors, &next_blob, &blobs, t] {
+                    try {
+                        work();
+                    } catch (...) {
+                        errors[t] = std::current_exception();
+                        next_blob = blobs.size();
+                    }
+                });
+            }
+            for (auto& thread : threads) {
+                thread.join();
+            }
+            for (const auto& error : errors) {
+                if (error) {
+                    std::rethrow_exception(error);
+                }
+            }
+        }
+
+        for (const auto& block : blocks) {
+            on_block(block);
+        }
+    }
+}
+
+}  // namespace connectors
+}  // namespace ed
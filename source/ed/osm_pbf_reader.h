@@ -0,0 +1,104 @@
+/* Copyright © 2001-2014, Canal TP and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+channel `#navitia` on riot https://riot.im/app/#/room/#navitia:matrix.org
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+#pragma once
+
+#include <osmpbfreader/osmpbfreader.h>
+
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace ed {
+namespace connectors {
+
+/// The primitives of an osm file, to be combined into the ones a read needs
+enum OsmPrimitives { OSM_NODES = 1, OSM_WAYS = 2, OSM_RELATIONS = 4, OSM_ALL = OSM_NODES | OSM_WAYS | OSM_RELATIONS };
+
+/// The primitives of one block of a pbf file
+struct OsmBlock {
+    struct Node {
+        uint64_t osm_id;
+        double lon, lat;
+        CanalTP::Tags tags;
+    };
+    struct Way {
+        uint64_t osm_id;
+        CanalTP::Tags tags;
+        std::vector<uint64_t> refs;
+    };
+    struct Relation {
+        uint64_t osm_id;
+        CanalTP::Tags tags;
+        CanalTP::References refs;
+    };
+    std::vector<Node> nodes;
+    std::vector<Way> ways;
+    std::vector<Relation> relations;
+};
+
+/*
+ * Reads a pbf file with the blocks decompressed and decoded by nb_threads threads (0 for the
+ * hardware concurrency).
+ *
+ * Only the requested primitives are decoded.  The blocks are handed over in the order of the
+ * file, and the primitives of a block in the order of CanalTP::read_osm_pbf, so that the
+ * callbacks of the visitors are called from the calling thread in the same order.
+ */
+class OsmPbfReader {
+public:
+    explicit OsmPbfReader(std::string path, size_t nb_threads = 0);
+
+    void read_blocks(int primitives, const std::function<void(const OsmBlock&)>& on_block) const;
+
+    template <typename Visitor>
+    void read(Visitor& visitor, int primitives = OSM_ALL) const {
+        read_blocks(primitives, [&visitor](const OsmBlock& block) {
+            for (const auto& node : block.nodes) {
+                visitor.node_callback(node.osm_id, node.lon, node.lat, node.tags);
+            }
+            for (const auto& way : block.ways) {
+                visitor.way_callback(way.osm_id, way.tags, way.refs);
+            }
+            for (const auto& relation : block.relations) {
+                visitor.relation_callback(relation.osm_id, relation.tags, relation.refs);
+            }
+        });
+    }
+
+    // decodes a serialized OSMPBF::PrimitiveBlock
+    static void decode_block(const std::string& data, int primitives, OsmBlock& block);
+
+private:
+    const std::string path;
+    size_t nb_threads;
+};
+
+}  // namespace connectors
+}  // namespace ed
@@ -0,0 +1,133 @@
+/* Copyright © 2001-2014, Canal TP and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+channel `#navitia` on riot https://riot.im/app/#/room/#navitia:matrix.org
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#include "ed/data.h"
+#include "ed/ed_converter.h"
+#include "ed/connectors/fusio_parser.h"
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE test_ed_converter
+#include <boost/test/unit_test.hpp>
+#include "conf.h"
+#include "type/data.h"
+#include "type/meta_data.h"
+#include "type/pt_data.h"
+#include "utils/base64_encode.h"
+#include "tests/utils_test.h"
+
+struct logger_initialized {
+    logger_initialized() { navitia::init_logger(); }
+};
+BOOST_GLOBAL_FIXTURE(logger_initialized);
+
+const std::string ntfs_path = std::string(navitia::config::fixtures_dir) + "/ed/ntfs";
+
+namespace {
+
+// the same steps as fusio2ed
+void read_ntfs(ed::Data& ed_data) {
+    ed::connectors::FusioParser parser(ntfs_path);
+    parser.fill(ed_data);
+    ed_data.complete();
+    ed_data.patch_odt_stop_times();
+    ed_data.clean();
+    ed_data.sort();
+    ed_data.build_route_destination();
+    ed_data.normalize_uri();
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(convert_small_ntfs_dataset) {
+    ed::Data ed_data;
+    read_ntfs(ed_data);
+
+    navitia::type::Data data;
+    ed::EdConverter().fill(ed_data, data);
+
+    BOOST_CHECK_EQUAL(data.meta->production_date, ed_data.meta.production_date);
+
+    BOOST_REQUIRE_EQUAL(data.pt_data->networks.size(), ed_data.networks.size());
+    BOOST_REQUIRE_EQUAL(data.pt_data->stop_areas.size(), ed_data.stop_areas.size());
+    BOOST_REQUIRE_EQUAL(data.pt_data->stop_points.size(), ed_data.stop_points.size());
+    BOOST_REQUIRE_EQUAL(data.pt_data->lines.size(), ed_data.lines.size());
+    BOOST_REQUIRE_EQUAL(data.pt_data->routes.size(), ed_data.routes.size());
+    BOOST_REQUIRE_EQUAL(data.pt_data->vehicle_journeys.size(), ed_data.vehicle_journeys.size());
+    BOOST_CHECK_EQUAL(data.pt_data->nb_stop_times(), ed_data.stops.size());
+
+    // the uris are encoded and the coordinates rounded as with the database
+    for (size_t i = 0; i < ed_data.stop_points.size(); ++i) {
+        const auto* ed_sp = ed_data.stop_points[i];
+        const auto* sp = data.pt_data->stop_points[i];
+        BOOST_CHECK_EQUAL(sp->uri, navitia::encode_uri(ed_sp->uri));
+        BOOST_CHECK_EQUAL(sp->coord.lon(), std::stod(std::to_string(ed_sp->coord.lon())));
+        BOOST_CHECK_EQUAL(sp->coord.lat(), std::stod(std::to_string(ed_sp->coord.lat())));
+        BOOST_REQUIRE(sp->stop_area);
+        BOOST_CHECK_EQUAL(sp->stop_area->uri, navitia::encode_uri(ed_sp->stop_area->uri));
+    }
+
+    // the stop times and their headsigns
+    for (size_t i = 0; i < ed_data.vehicle_journeys.size(); ++i) {
+        const auto* ed_vj = ed_data.vehicle_journeys[i];
+        const auto* vj = data.pt_data->vehicle_journeys[i];
+        BOOST_CHECK_EQUAL(vj->uri, navitia::encode_uri(ed_vj->uri));
+        BOOST_CHECK_EQUAL(vj->route->uri, navitia::encode_uri(ed_vj->route->uri));
+        BOOST_CHECK_EQUAL(vj->dataset->uri, navitia::encode_uri(ed_vj->dataset->uri));
+        BOOST_REQUIRE_EQUAL(vj->stop_time_list.size(), ed_vj->stop_time_list.size());
+        for (size_t pos = 0; pos < vj->stop_time_list.size(); ++pos) {
+            const auto& st = vj->stop_time_list[pos];
+            const auto* ed_st = ed_vj->stop_time_list[pos];
+            BOOST_CHECK_EQUAL(st.arrival_time, ed_st->arrival_time);
+            BOOST_CHECK_EQUAL(st.departure_time, ed_st->departure_time);
+            BOOST_CHECK_EQUAL(st.local_traffic_zone, ed_st->local_traffic_zone);
+            BOOST_CHECK_EQUAL(st.stop_point->uri, navitia::encode_uri(ed_st->stop_point->uri));
+            if (!ed_st->headsign.empty()) {
+                BOOST_CHECK_EQUAL(data.pt_data->headsign_handler.get_headsign(st), ed_st->headsign);
+            }
+        }
+    }
+
+    // comments
+    const auto* route = data.pt_data->routes[0];
+    BOOST_CHECK_EQUAL(route->uri, navitia::encode_uri(ed_data.routes[0]->uri));
+    BOOST_REQUIRE_EQUAL(data.pt_data->comments.get(route).size(), 1);
+    BOOST_CHECK_EQUAL(data.pt_data->comments.get(route)[0].value, "bob is in the kitchen");
+
+    // object codes
+    BOOST_CHECK_EQUAL(data.pt_data->codes.get_codes(route).size(), 1);
+
+    // the calendars uris are base64 encoded
+    BOOST_REQUIRE_EQUAL(data.pt_data->calendars.size(), ed_data.calendars.size());
+    for (size_t i = 0; i < ed_data.calendars.size(); ++i) {
+        BOOST_CHECK_EQUAL(data.pt_data->calendars[i]->uri, navitia::base64_encode(ed_data.calendars[i]->uri));
+    }
+
+    // the data can be completed as the one read from the database
+    BOOST_CHECK_NO_THROW(data.complete());
+}
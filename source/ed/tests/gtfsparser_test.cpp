@@ -30,6 +30,7 @@ www.navitia.io
 
 #include "ed/data.h"
 #include "ed/connectors/gtfs_parser.h"
+#include "ed/connectors/fusio_parser.h"
 #define BOOST_TEST_DYN_LINK
 #define BOOST_TEST_MODULE test_ed
 #include <boost/test/unit_test.hpp>
@@ -38,6 +39,9 @@ www.navitia.io
 #include "ed/build_helper.h"
 #include "utils/csv.h"
 
+#include <boost/filesystem.hpp>
+#include <fstream>
+
 struct logger_initialized {
     logger_initialized() { navitia::init_logger(); }
 };
@@ -495,6 +499,98 @@ BOOST_AUTO_TEST_CASE(parse_gtfs) {
     check_gtfs_google_example(data);
 }
 
+BOOST_AUTO_TEST_CASE(parse_gtfs_stop_times_in_parallel) {
+    // the stop times must be the same, in the same order, whatever the number of threads
+    ed::Data data_1, data_4;
+    ed::connectors::GtfsParser parser_1(std::string(navitia::config::fixtures_dir) + gtfs_path + "_google_example");
+    parser_1.nb_threads = 1;
+    parser_1.fill(data_1);
+    ed::connectors::GtfsParser parser_4(std::string(navitia::config::fixtures_dir) + gtfs_path + "_google_example");
+    parser_4.nb_threads = 4;
+    parser_4.fill(data_4);
+
+    check_gtfs_google_example(data_4);
+    BOOST_REQUIRE_EQUAL(data_1.stops.size(), data_4.stops.size());
+    for (size_t i = 0; i < data_1.stops.size(); ++i) {
+        BOOST_CHECK_EQUAL(data_4.stops[i]->idx, i);
+        BOOST_CHECK_EQUAL(data_1.stops[i]->vehicle_journey->uri, data_4.stops[i]->vehicle_journey->uri);
+        BOOST_CHECK_EQUAL(data_1.stops[i]->stop_point->uri, data_4.stops[i]->stop_point->uri);
+        BOOST_CHECK_EQUAL(data_1.stops[i]->order, data_4.stops[i]->order);
+        BOOST_CHECK_EQUAL(data_1.stops[i]->arrival_time, data_4.stops[i]->arrival_time);
+        BOOST_CHECK_EQUAL(data_1.stops[i]->departure_time, data_4.stops[i]->departure_time);
+    }
+
+    // and with the fields of fusio
+    const std::string ntfs_path = std::string(navitia::config::fixtures_dir) + "/ed/ntfs";
+    ed::Data fusio_1, fusio_4;
+    ed::connectors::FusioParser fusio_parser_1(ntfs_path);
+    fusio_parser_1.nb_threads = 1;
+    fusio_parser_1.fill(fusio_1);
+    ed::connectors::FusioParser fusio_parser_4(ntfs_path);
+    fusio_parser_4.nb_threads = 4;
+    fusio_parser_4.fill(fusio_4);
+
+    BOOST_REQUIRE(!fusio_1.stops.empty());
+    BOOST_REQUIRE_EQUAL(fusio_1.stops.size(), fusio_4.stops.size());
+    for (size_t i = 0; i < fusio_1.stops.size(); ++i) {
+        const auto* st_1 = fusio_1.stops[i];
+        const auto* st_4 = fusio_4.stops[i];
+        BOOST_CHECK_EQUAL(st_4->idx, i);
+        BOOST_CHECK_EQUAL(st_1->vehicle_journey->uri, st_4->vehicle_journey->uri);
+        BOOST_CHECK_EQUAL(st_1->stop_point->uri, st_4->stop_point->uri);
+        BOOST_CHECK_EQUAL(st_1->order, st_4->order);
+        BOOST_CHECK_EQUAL(st_1->arrival_time, st_4->arrival_time);
+        BOOST_CHECK_EQUAL(st_1->departure_time, st_4->departure_time);
+        BOOST_CHECK_EQUAL(st_1->alighting_time, st_4->alighting_time);
+        BOOST_CHECK_EQUAL(st_1->boarding_time, st_4->boarding_time);
+        BOOST_CHECK_EQUAL(st_1->date_time_estimated, st_4->date_time_estimated);
+        BOOST_CHECK_EQUAL(st_1->pick_up_allowed, st_4->pick_up_allowed);
+        BOOST_CHECK_EQUAL(st_1->drop_off_allowed, st_4->drop_off_allowed);
+    }
+    BOOST_CHECK_EQUAL(fusio_1.stoptime_comments.size(), fusio_4.stoptime_comments.size());
+}
+
+BOOST_AUTO_TEST_CASE(mapped_csv_tokenizer) {
+    const auto filename = (boost::filesystem::temp_directory_path() / boost::filesystem::unique_path()).string();
+    {
+        std::ofstream file(filename, std::ios::binary);
+        file << "trip_id,stop_id,stop_headsign\r\n"
+             << "t1, sp1 ,\"Gare, quai 1\"\r\n"
+             << "\r\n"
+             << "t1,sp2,\"on two\nlines\"\n"
+             << "t2,sp3,\"with \\\"quotes\\\"\"\n"
+             << "t2,sp4,\n"
+             << "t3,sp5,last";
+    }
+    const std::vector<std::vector<std::string>> expected = {{"t1", "sp1", "Gare, quai 1"},
+                                                            {"t1", "sp2", "on two\nlines"},
+                                                            {"t2", "sp3", "with \"quotes\""},
+                                                            {"t2", "sp4", ""},
+                                                            {"t3", "sp5", "last"}};
+    {
+        ed::connectors::MappedCsv csv(filename);
+        for (size_t nb_ranges : {1, 2, 3, 10}) {
+            const auto ranges = csv.split_rows(nb_ranges);
+            BOOST_CHECK_LE(ranges.size(), nb_ranges);
+
+            std::vector<std::vector<std::string>> rows;
+            std::vector<boost::string_ref> fields;
+            std::vector<std::string> row;
+            for (const auto& range : ranges) {
+                auto tokenizer = csv.tokenizer(range);
+                while (tokenizer.next(fields)) {
+                    ed::connectors::assign_row(fields, row);
+                    rows.push_back(row);
+                }
+            }
+            BOOST_CHECK(rows == expected);
+        }
+    }
+    boost::filesystem::remove(filename);
+
+    BOOST_CHECK_THROW(ed::connectors::MappedCsv(filename), navitia::exception);
+}
+
 BOOST_AUTO_TEST_CASE(parse_gtfs_without_calendar) {
     // calendar.txt is not a mandatory file
     // we created the same data set than the standard one but with calendar_date.txt filled
@@ -36,6 +36,7 @@ www.navitia.io
 #include "utils/lotus.h"
 #include "ed/types.h"
 #include "ed/osm2ed.h"
+#include "ed/default_poi_types.h"
 
 struct logger_initialized {
     logger_initialized() { navitia::init_logger(); }
@@ -159,3 +160,99 @@ BOOST_AUTO_TEST_CASE(osm_admin_without_zero_in_month_in_end_date) {
     relations_visitor.relation_callback(5, tags, ref);
     BOOST_CHECK(relations_visitor.cache.admins.find(5) == relations_visitor.cache.admins.end());
 }
+
+// A node referenced by a street after another reference is used more than once
+BOOST_AUTO_TEST_CASE(osm_nodes_built_from_the_ways) {
+    OSMCache cache(std::unique_ptr<Lotus>(), boost::none);
+    {
+        ReadWaysVisitor ways_visitor(cache, PoiTypeParams(DEFAULT_JSON_POI_TYPES));
+        ways_visitor.way_callback(1, {{"highway", "residential"}, {"name", "rue 1"}}, {10, 11, 12});
+        ways_visitor.way_callback(2, {{"highway", "residential"}, {"name", "rue 2"}}, {12, 13});
+        ways_visitor.way_callback(3, {{"addr:housenumber", "3"}}, {13, 14});
+    }
+    cache.build_nodes();
+    ReadNodesVisitor nodes_visitor(cache);
+    nodes_visitor.node_callback(12, 2.35, 48.85, {});
+
+    BOOST_REQUIRE_EQUAL(cache.nodes.size(), 5);
+    std::vector<uint64_t> ids;
+    for (const auto& node : cache.nodes) {
+        ids.push_back(node.osm_id);
+    }
+    BOOST_CHECK(ids == (std::vector<uint64_t>{10, 11, 12, 13, 14}));
+    BOOST_CHECK(cache.nodes.find(15) == nullptr);
+    BOOST_CHECK(!cache.nodes.find(10)->is_used_more_than_once());
+    BOOST_CHECK(cache.nodes.find(12)->is_used_more_than_once());
+    BOOST_CHECK(!cache.nodes.find(13)->is_used_more_than_once());
+    BOOST_CHECK(cache.nodes.find(12)->is_defined());
+    BOOST_CHECK_CLOSE(cache.nodes.find(12)->lat(), 48.85, 1e-4);
+    BOOST_CHECK(!cache.nodes.find(11)->is_defined());
+
+    // only the streets are kept as ways
+    BOOST_REQUIRE_EQUAL(cache.ways.size(), 2);
+    const auto& way = *cache.ways.find(OSMWay(2));
+    BOOST_REQUIRE_EQUAL(way.nodes.size(), 2);
+    BOOST_CHECK_EQUAL(way.nodes[0], cache.nodes.find(12));
+    BOOST_CHECK_EQUAL(way.nodes[1], cache.nodes.find(13));
+    BOOST_CHECK(way.node_ids.empty());
+}
+
+BOOST_AUTO_TEST_CASE(osm_pbf_block_decoding) {
+    OSMPBF::PrimitiveBlock primitive_block;
+    for (const auto* s : {"", "highway", "residential", "name", "place", "street", "outer"}) {
+        primitive_block.mutable_stringtable()->add_s(s);
+    }
+    primitive_block.set_granularity(100);
+
+    auto* dense = primitive_block.add_primitivegroup()->mutable_dense();
+    // the ids and the coordinates are delta coded
+    for (const auto& id_lon_lat : std::vector<std::vector<int64_t>>{{10, 23500000, 488500000}, {2, 100, -100}}) {
+        dense->add_id(id_lon_lat[0]);
+        dense->add_lon(id_lon_lat[1]);
+        dense->add_lat(id_lon_lat[2]);
+    }
+    for (const int key_val : {3, 4, 0, 0}) {
+        dense->add_keys_vals(key_val);
+    }
+
+    auto* group = primitive_block.add_primitivegroup();
+    auto* way = group->add_ways();
+    way->set_id(1);
+    way->add_keys(1);
+    way->add_vals(2);
+    way->add_refs(10);
+    way->add_refs(2);
+    auto* relation = group->add_relations();
+    relation->set_id(5);
+    relation->add_memids(1);
+    relation->add_types(OSMPBF::Relation_MemberType::Relation_MemberType_WAY);
+    relation->add_roles_sid(6);
+
+    std::string data;
+    primitive_block.SerializeToString(&data);
+
+    OsmBlock block;
+    OsmPbfReader::decode_block(data, OSM_ALL, block);
+    BOOST_REQUIRE_EQUAL(block.nodes.size(), 2);
+    BOOST_CHECK_EQUAL(block.nodes[0].osm_id, 10);
+    BOOST_CHECK_CLOSE(block.nodes[0].lon, 2.35, 1e-6);
+    BOOST_CHECK_CLOSE(block.nodes[0].lat, 48.85, 1e-6);
+    BOOST_CHECK(block.nodes[0].tags == (Tags{{"name", "place"}}));
+    BOOST_CHECK_EQUAL(block.nodes[1].osm_id, 12);
+    BOOST_CHECK_CLOSE(block.nodes[1].lat, 48.84999, 1e-6);
+    BOOST_CHECK(block.nodes[1].tags.empty());
+    BOOST_REQUIRE_EQUAL(block.ways.size(), 1);
+    BOOST_CHECK(block.ways[0].refs == (std::vector<uint64_t>{10, 12}));
+    BOOST_CHECK(block.ways[0].tags == (Tags{{"highway", "residential"}}));
+    BOOST_REQUIRE_EQUAL(block.relations.size(), 1);
+    BOOST_REQUIRE_EQUAL(block.relations[0].refs.size(), 1);
+    BOOST_CHECK_EQUAL(block.relations[0].refs[0].member_id, 1);
+    BOOST_CHECK_EQUAL(block.relations[0].refs[0].role, "outer");
+
+    // only the requested primitives are decoded
+    OsmBlock ways_block;
+    OsmPbfReader::decode_block(data, OSM_WAYS, ways_block);
+    BOOST_CHECK(ways_block.nodes.empty());
+    BOOST_CHECK_EQUAL(ways_block.ways.size(), 1);
+    BOOST_CHECK(ways_block.relations.empty());
+}
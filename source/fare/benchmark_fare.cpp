@@ -0,0 +1,302 @@
+/* Copyright © 2001-2014, Canal TP and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+channel `#navitia` on riot https://riot.im/app/#/room/#navitia:matrix.org
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#include "fare/fare.h"
+#include "conf.h"
+#include "ed/connectors/fare_parser.h"
+#include "routing/routing.h"
+#include "type/line.h"
+#include "type/network.h"
+#include "type/physical_mode.h"
+#include "type/route.h"
+#include "type/stop_area.h"
+#include "type/stop_point.h"
+#include "type/stop_time.h"
+#include "type/vehicle_journey.h"
+#include "utils/init.h"
+#include "utils/timer.h"
+
+#include <boost/program_options.hpp>
+
+#include <iostream>
+#include <random>
+
+using namespace navitia;
+using namespace navitia::fare;
+namespace po = boost::program_options;
+
+namespace {
+
+struct Section {
+    std::string network;
+    std::string start_stop_area;
+    std::string line;
+    std::string dest_stop_area;
+    int start_time;
+    int dest_time;
+    std::string start_zone;
+    std::string dest_zone;
+    std::string mode;
+};
+
+/// Owns the mocked pt objects referenced by the path items
+struct PathBuilder {
+    std::vector<std::unique_ptr<nt::StopArea>> stop_areas;
+    std::vector<std::unique_ptr<nt::StopPoint>> stop_points;
+    std::vector<std::unique_ptr<nt::StopTime>> stop_times;
+    std::vector<std::unique_ptr<nt::DiscreteVehicleJourney>> vjs;
+    std::vector<std::unique_ptr<nt::Route>> routes;
+    std::vector<std::unique_ptr<nt::Line>> lines;
+    std::vector<std::unique_ptr<nt::Network>> networks;
+    std::vector<std::unique_ptr<nt::PhysicalMode>> modes;
+
+    template <typename T>
+    T* make(std::vector<std::unique_ptr<T>>& pool) {
+        pool.push_back(std::make_unique<T>());
+        return pool.back().get();
+    }
+
+    nt::StopPoint* make_sp(const std::string& stop_area, const std::string& zone) {
+        auto* sp = make(stop_points);
+        sp->stop_area = make(stop_areas);
+        sp->stop_area->uri = stop_area;
+        sp->fare_zone = zone;
+        return sp;
+    }
+
+    routing::Path make_path(const std::vector<Section>& sections, const boost::gregorian::date& date) {
+        routing::Path path;
+        for (const auto& section : sections) {
+            routing::PathItem item(routing::ItemType::public_transport,
+                                   boost::posix_time::ptime(date, boost::posix_time::seconds(section.start_time)),
+                                   boost::posix_time::ptime(date, boost::posix_time::seconds(section.dest_time)));
+            auto* first_st = make(stop_times);
+            auto* vj = make(vjs);
+            vj->route = make(routes);
+            vj->route->line = make(lines);
+            vj->route->line->uri = section.line;
+            vj->route->line->network = make(networks);
+            vj->route->line->network->uri = section.network;
+            vj->physical_mode = make(modes);
+            vj->physical_mode->uri = section.mode;
+            first_st->vehicle_journey = vj;
+
+            item.stop_points.push_back(make_sp(section.start_stop_area, section.start_zone));
+            item.stop_points.push_back(make_sp(section.dest_stop_area, section.dest_zone));
+            item.stop_times.push_back(first_st);
+            item.stop_times.push_back(make(stop_times));
+            path.items.push_back(item);
+        }
+        return path;
+    }
+};
+
+void fill_fare_from_ed(const ed::Data& ed_data, Fare& fare) {
+    fare.od_tickets = ed_data.od_tickets;
+    for (const auto& f : ed_data.fare_map) {
+        fare.fare_map.insert(f);
+    }
+    std::map<State, Fare::vertex_t> state_map;
+    state_map[State()] = fare.begin_v;
+    const auto get_vertex = [&](const State& state) {
+        const auto it = state_map.find(state);
+        if (it != state_map.end()) {
+            return it->second;
+        }
+        return state_map[state] = boost::add_vertex(state, fare.g);
+    };
+    for (const auto& transition : ed_data.transitions) {
+        const auto start_v = get_vertex(std::get<0>(transition));
+        const auto end_v = get_vertex(std::get<1>(transition));
+        boost::add_edge(start_v, end_v, std::get<2>(transition), fare.g);
+    }
+}
+
+Condition make_condition(const std::string& key, const Comp_e comparaison, const std::string& value) {
+    Condition cond;
+    cond.key = key;
+    cond.comparaison = comparaison;
+    cond.value = value;
+    return cond;
+}
+
+/*
+ * a synthetic fare model: one flat ticket by network, a state by line, and
+ * transfers allowed between the lines of a network during 90 minutes with at most 3 changes.
+ * Each zone has OD tickets towards the next zones.
+ */
+void fill_synthetic_fare(Fare& fare, int nb_networks, int nb_lines, int nb_zones, const boost::gregorian::date& date) {
+    const boost::gregorian::date end_date = date + boost::gregorian::days(365);
+    for (int n = 0; n < nb_networks; ++n) {
+        const auto network = "network:" + std::to_string(n);
+        const auto ticket_key = "ticket:" + network;
+        fare.fare_map[ticket_key].add(date, end_date, Ticket(ticket_key, "ticket " + network, 170 + n, ""));
+
+        for (int l = 0; l < nb_lines; ++l) {
+            State state;
+            state.network = network;
+            state.line = network + ":line:" + std::to_string(l);
+            state.ticket = "ticket " + network;
+            const auto line_v = boost::add_vertex(state, fare.g);
+
+            Transition buy;
+            buy.ticket_key = ticket_key;
+            buy.start_conditions.push_back(make_condition("zone", Comp_e::EQ, std::to_string(l % nb_zones)));
+            boost::add_edge(fare.begin_v, line_v, buy, fare.g);
+
+            Transition to_begin;
+            boost::add_edge(line_v, fare.begin_v, to_begin, fare.g);
+
+            Transition change;
+            change.start_conditions.push_back(make_condition("duration", Comp_e::LT, "90"));
+            change.start_conditions.push_back(make_condition("nb_changes", Comp_e::LT, "3"));
+            change.end_conditions.push_back(make_condition("duration", Comp_e::LT, "120"));
+            boost::add_edge(line_v, line_v, change, fare.g);
+        }
+    }
+
+    State od_state;
+    od_state.mode = "metro";
+    const auto od_v = boost::add_vertex(od_state, fare.g);
+    Transition od_transition;
+    od_transition.global_condition = Transition::GlobalCondition::with_changes;
+    boost::add_edge(fare.begin_v, od_v, od_transition, fare.g);
+    boost::add_edge(od_v, od_v, od_transition, fare.g);
+    for (int o = 0; o < nb_zones; ++o) {
+        for (int d = o; d < nb_zones; ++d) {
+            const auto ticket_key = "od:" + std::to_string(o) + ":" + std::to_string(d);
+            fare.fare_map[ticket_key].add(date, end_date, Ticket(ticket_key, ticket_key, 150 + 10 * (d - o), ""));
+            fare.od_tickets[OD_key(OD_key::Zone, std::to_string(o))][OD_key(OD_key::Zone, std::to_string(d))] = {
+                ticket_key};
+        }
+    }
+}
+
+std::vector<Section> random_sections(std::mt19937& rng, int nb_sections, int nb_networks, int nb_lines, int nb_zones) {
+    std::uniform_int_distribution<int> network_dist(0, nb_networks - 1);
+    std::uniform_int_distribution<int> line_dist(0, nb_lines - 1);
+    std::uniform_int_distribution<int> zone_dist(0, nb_zones - 1);
+    std::uniform_int_distribution<int> duration_dist(5 * 60, 40 * 60);
+    std::vector<Section> sections;
+    int time = 8 * 3600;
+    for (int s = 0; s < nb_sections; ++s) {
+        const auto network = "network:" + std::to_string(network_dist(rng));
+        const int duration = duration_dist(rng);
+        const auto start_stop_area = "sa:" + std::to_string(zone_dist(rng));
+        const auto line = network + ":line:" + std::to_string(line_dist(rng));
+        sections.push_back({network, start_stop_area, line, "sa:" + std::to_string(zone_dist(rng)), time,
+                            time + duration, std::to_string(zone_dist(rng)), std::to_string(zone_dist(rng)),
+                            s % 2 ? "metro" : "bus"});
+        time += duration + 5 * 60;
+    }
+    return sections;
+}
+
+void run(const std::string& name, Fare& fare, const std::vector<routing::Path>& paths, int nb_iterations) {
+    Cost total = 0;
+    {
+        Timer t(name + ", compiled once: " + std::to_string(paths.size() * nb_iterations) + " fares");
+        fare.compile();
+        for (int i = 0; i < nb_iterations; ++i) {
+            for (const auto& path : paths) {
+                total += fare.compute_fare(path).total;
+            }
+        }
+    }
+    std::cout << "  total cost: " << total << std::endl;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    navitia::init_app();
+    po::options_description desc("Options of the fare benchmark");
+    int nb_networks, nb_lines, nb_zones, nb_sections, nb_paths, nb_iterations;
+
+    // clang-format off
+    desc.add_options()
+            ("help", "Show this message")
+            ("networks,n", po::value<int>(&nb_networks)->default_value(20), "number of networks of the synthetic model")
+            ("lines,l", po::value<int>(&nb_lines)->default_value(50), "number of lines by network of the synthetic model")
+            ("zones,z", po::value<int>(&nb_zones)->default_value(8), "number of fare zones of the synthetic model")
+            ("sections,s", po::value<int>(&nb_sections)->default_value(3), "number of public transport sections by journey")
+            ("paths,p", po::value<int>(&nb_paths)->default_value(1000), "number of journeys")
+            ("iterations,i", po::value<int>(&nb_iterations)->default_value(10), "number of times each journey is priced");
+    // clang-format on
+
+    po::variables_map vm;
+    po::store(po::parse_command_line(argc, argv, desc), vm);
+    po::notify(vm);
+
+    if (vm.count("help")) {
+        std::cout << "This is used to benchmark Fare::compute_fare" << std::endl;
+        std::cout << desc << std::endl;
+        return 1;
+    }
+
+    const boost::gregorian::date date(2011, 7, 1);
+    PathBuilder builder;
+    std::mt19937 rng(42);
+
+    {
+        // the fixtures used by fare_test, with journeys over their networks
+        ed::Data ed_data;
+        ed::connectors::fare_parser parser(ed_data, std::string(navitia::config::fixtures_dir) + "/fare/idf.fares",
+                                           std::string(navitia::config::fixtures_dir) + "/fare/prix.csv",
+                                           std::string(navitia::config::fixtures_dir) + "/fare/tarifs_od.csv");
+        parser.load();
+        Fare fare;
+        fill_fare_from_ed(parser.data, fare);
+
+        const std::vector<std::string> networks = {"Filbleu", "network:0"};
+        std::vector<routing::Path> paths;
+        for (int p = 0; p < nb_paths; ++p) {
+            auto sections = random_sections(rng, nb_sections, 1, 5, 2);
+            for (auto& section : sections) {
+                section.network = networks[p % networks.size()];
+            }
+            paths.push_back(builder.make_path(sections, date));
+        }
+        run("fare_test fixtures (" + std::to_string(fare.nb_transitions()) + " transitions)", fare, paths,
+            nb_iterations);
+    }
+
+    {
+        Fare fare;
+        fill_synthetic_fare(fare, nb_networks, nb_lines, nb_zones, date);
+        std::vector<routing::Path> paths;
+        for (int p = 0; p < nb_paths; ++p) {
+            paths.push_back(
+                builder.make_path(random_sections(rng, nb_sections, nb_networks, nb_lines, nb_zones), date));
+        }
+        run("synthetic model (" + std::to_string(fare.nb_transitions()) + " transitions)", fare, paths,
+            nb_iterations);
+    }
+}
@@ -47,16 +47,222 @@ namespace greg = boost::gregorian;
 namespace navitia {
 namespace fare {
 
-static Label next_label(Label label, Ticket ticket, const SectionKey& section) {
+constexpr InternedId StringPool::empty;
+constexpr InternedId StringPool::unknown;
+
+InternedId StringPool::intern(const std::string& str) {
+    const auto it = ids.find(str);
+    if (it != ids.end()) {
+        return it->second;
+    }
+    const auto id = InternedId(strings.size());
+    ids.emplace(str, id);
+    strings.push_back(str);
+    return id;
+}
+
+InternedId StringPool::find(const std::string& str) const {
+    const auto it = ids.find(str);
+    return it == ids.end() ? unknown : it->second;
+}
+
+const std::string& StringPool::get(const InternedId id) const {
+    return id < strings.size() ? strings[id] : strings[empty];
+}
+
+/// A condition of a transition, with its key and value already parsed
+struct CompiledCondition {
+    enum class Key { zone, stop_area, duration, nb_changes, ticket, line, other };
+    Key key = Key::other;
+    Comp_e comparaison = Comp_e::True;
+    InternedId value = StringPool::unknown;  // for zone, stop_area and line
+    boost::optional<int> int_value;          // for duration (in seconds) and nb_changes
+    std::string str_value;                   // for ticket, the order comparisons on line and the logs
+
+    CompiledCondition(const Condition& cond, StringPool& pool) : comparaison(cond.comparaison), str_value(cond.value) {
+        if (cond.key == "zone") {
+            key = Key::zone;
+        } else if (cond.key == "stoparea") {
+            key = Key::stop_area;
+        } else if (cond.key == "duration") {
+            key = Key::duration;
+        } else if (cond.key == "nb_changes") {
+            key = Key::nb_changes;
+        } else if (cond.key == "ticket") {
+            key = Key::ticket;
+        } else if (cond.key == "line") {
+            key = Key::line;
+        }
+        value = pool.intern(cond.value);
+        if (key == Key::duration || key == Key::nb_changes) {
+            int parsed = 0;
+            if (boost::conversion::try_lexical_convert(cond.value, parsed)) {
+                // In the CSV file, time is displayed in minutes. It is handled here in seconds
+                int_value = key == Key::duration ? parsed * 60 : parsed;
+            }
+        }
+    }
+
+    int get_int_value() const {
+        if (!int_value) {
+            throw boost::bad_lexical_cast();
+        }
+        return *int_value;
+    }
+};
+
+/// The ids of the strings of a State used by compute_fare
+struct CompiledState {
+    InternedId mode;
+    InternedId network;
+    InternedId line;
+    const std::string* ticket;
+
+    CompiledState(const State& state, StringPool& pool)
+        : mode(pool.intern(state.mode)),
+          network(pool.intern(state.network)),
+          line(pool.intern(state.line)),
+          ticket(&state.ticket) {}
+};
+
+struct CompiledTransition {
+    Fare::vertex_t source;
+    Fare::vertex_t target;
+    const Transition* transition;
+    std::vector<CompiledCondition> start_conditions;
+    std::vector<CompiledCondition> end_conditions;
+    // ticket to buy, nullptr if the ticket key is not in the fare_map
+    const DateTicket* date_ticket = nullptr;
+};
+
+/// The ids of the strings of a SectionKey, computed once by section
+struct InternedSection {
+    InternedId network;
+    InternedId start_stop_area;
+    InternedId dest_stop_area;
+    InternedId line;
+    InternedId start_zone;
+    InternedId dest_zone;
+    InternedId mode;
+
+    InternedSection(const SectionKey& section, const StringPool& pool)
+        : network(pool.find(section.network)),
+          start_stop_area(pool.find(section.start_stop_area)),
+          dest_stop_area(pool.find(section.dest_stop_area)),
+          line(pool.find(section.line)),
+          start_zone(pool.find(section.start_zone)),
+          dest_zone(pool.find(section.dest_zone)),
+          mode(pool.find(section.mode)) {}
+};
+
+/**
+ * The fare graph compiled into interned ids.
+ *
+ * All the string comparisons of compute_fare become integer comparisons,
+ * the conditions are parsed once, and the OD tickets (sum of several tickets) are summed once.
+ */
+struct CompiledFare {
+    StringPool pool;
+    std::vector<CompiledState> states;
+    // in the same order as boost::edges(g)
+    std::vector<CompiledTransition> transitions;
+
+    // origin -> destination -> index in od_date_tickets
+    using OdTable = std::unordered_map<uint64_t, size_t>;
+    std::unordered_map<uint64_t, OdTable> od_tables;
+    std::vector<DateTicket> od_date_tickets;
+
+    // to check that the compiled graph corresponds to the fare (the pointers above are in the fare)
+    const Fare* owner;
+    uint64_t generation;
+
+    explicit CompiledFare(const Fare& fare);
+
+    bool is_up_to_date(const Fare& other) const { return owner == &other && generation == other.generation; }
+
+    static uint64_t od_key(const OD_key::od_type type, const InternedId value) {
+        return (uint64_t(type) << 32) | value;
+    }
+    uint64_t od_key(const OD_key& key) const { return od_key(key.type, pool.find(key.value)); }
+
+    /// Retourne le ticket OD qui va bien ou lève une exception no_ticket si on ne trouve pas
+    const DateTicket& get_od(const Label& label, const InternedSection& section) const;
+};
+
+CompiledFare::CompiledFare(const Fare& f) : owner(&f), generation(f.generation) {
+    // every ticket key must be known
+    for (const auto& key_ticket : f.fare_map) {
+        pool.intern(key_ticket.first);
+    }
+
+    const size_t nb_vertices = boost::num_vertices(f.g);
+    states.reserve(nb_vertices);
+    for (Fare::vertex_t v = 0; v < nb_vertices; ++v) {
+        states.emplace_back(f.g[v], pool);
+    }
+
+    transitions.reserve(boost::num_edges(f.g));
+    BOOST_FOREACH (Fare::edge_t e, boost::edges(f.g)) {
+        CompiledTransition compiled;
+        compiled.source = boost::source(e, f.g);
+        compiled.target = boost::target(e, f.g);
+        compiled.transition = &f.g[e];
+        for (const auto& cond : f.g[e].start_conditions) {
+            compiled.start_conditions.emplace_back(cond, pool);
+        }
+        for (const auto& cond : f.g[e].end_conditions) {
+            compiled.end_conditions.emplace_back(cond, pool);
+        }
+        if (!f.g[e].ticket_key.empty()) {
+            const auto it = f.fare_map.find(f.g[e].ticket_key);
+            if (it != f.fare_map.end()) {
+                compiled.date_ticket = &it->second;
+            }
+        }
+        transitions.push_back(std::move(compiled));
+    }
+
+    // We create the OD tickets, sum of all atomic elements
+    // A STIF OD-ticket is always the sum of multiple tickets
+    for (const auto& origin_destinations : f.od_tickets) {
+        const auto origin = pool.intern(origin_destinations.first.value);
+        auto& od_table = od_tables[od_key(origin_destinations.first.type, origin)];
+        for (const auto& destination_tickets : origin_destinations.second) {
+            const auto& vec_t = destination_tickets.second;
+            if (vec_t.empty()) {
+                continue;
+            }
+            DateTicket ticket;
+            auto it = f.fare_map.find(vec_t.at(0));
+            if (it != f.fare_map.end()) {
+                ticket = it->second;
+            }
+            for (size_t i = 1; i < vec_t.size(); ++i) {
+                it = f.fare_map.find(vec_t.at(i));
+                if (it != f.fare_map.end()) {
+                    ticket = ticket + it->second;
+                } else {
+                    auto new_ticket = DateTicket();
+                    ticket = ticket + new_ticket;
+                }
+            }
+            od_table[od_key(destination_tickets.first.type, pool.intern(destination_tickets.first.value))] =
+                od_date_tickets.size();
+            od_date_tickets.push_back(std::move(ticket));
+        }
+    }
+}
+
+static Label next_label(Label label, Ticket ticket, const SectionKey& section, const InternedSection& ids) {
     // we save the informations about the last mod used
-    label.line = section.line;
-    label.mode = section.mode;
-    label.network = section.network;
+    label.line = ids.line;
+    label.mode = ids.mode;
+    label.network = ids.network;
 
     if (ticket.type == Ticket::ODFare) {
-        if (label.stop_area.empty() || label.current_type != Ticket::ODFare) {  // It's a new OD ticket
-            label.stop_area = section.start_stop_area;
-            label.zone = section.start_zone;
+        if (label.stop_area == StringPool::empty || label.current_type != Ticket::ODFare) {  // It's a new OD ticket
+            label.stop_area = ids.start_stop_area;
+            label.zone = ids.start_zone;
             label.nb_changes = 0;
             label.start_time = section.start_time;
 
@@ -83,7 +289,7 @@ static Label next_label(Label label, Ticket ticket, const SectionKey& section) {
             label.tickets.push_back(ticket);
             label.nb_changes = 0;
             label.start_time = section.start_time;
-            label.stop_area = section.start_stop_area;
+            label.stop_area = ids.start_stop_area;
         }
         if (label.tickets.empty()) {
             throw navitia::recoverable_exception("internal problem");
@@ -94,17 +300,47 @@ static Label next_label(Label label, Ticket ticket, const SectionKey& section) {
     return label;
 }
 
-static bool valid(const State& state, const SectionKey& section) {
-    return !((!state.mode.empty() && state.mode != section.mode)
-             || (!state.network.empty() && state.network != section.network)
-             || (!state.line.empty() && state.line != section.line));
+static bool valid(const CompiledState& state, const InternedSection& section) {
+    return !((state.mode != StringPool::empty && state.mode != section.mode)
+             || (state.network != StringPool::empty && state.network != section.network)
+             || (state.line != StringPool::empty && state.line != section.line));
 }
 
-static bool valid(const State& state, const Label& label) {
-    return !((!state.mode.empty() && state.mode != label.mode)
-             || (!state.network.empty() && state.network != label.network)
-             || (!state.line.empty() && state.line != label.line)
-             || (!state.ticket.empty() && state.ticket != label.tickets.back().caption));
+static bool valid(const CompiledState& state, const Label& label) {
+    return !((state.mode != StringPool::empty && state.mode != label.mode)
+             || (state.network != StringPool::empty && state.network != label.network)
+             || (state.line != StringPool::empty && state.line != label.line)
+             || (!state.ticket->empty() && *state.ticket != label.tickets.back().caption));
+}
+
+const DateTicket& CompiledFare::get_od(const Label& label, const InternedSection& section) const {
+    const uint64_t d_sa = od_key(OD_key::StopArea, section.dest_stop_area);
+    const uint64_t d_mode = od_key(OD_key::Mode, section.mode);
+    const uint64_t d_zone = od_key(OD_key::Zone, section.dest_zone);
+
+    const auto get_od_dest = [&](const uint64_t origin) -> const DateTicket* {
+        const auto start_od_table = od_tables.find(origin);
+        if (start_od_table == od_tables.end()) {
+            return nullptr;
+        }
+        for (const uint64_t dest : {d_sa, d_mode, d_zone}) {
+            const auto od = start_od_table->second.find(dest);
+            if (od != start_od_table->second.end()) {
+                return &od_date_tickets[od->second];
+            }
+        }
+        return nullptr;
+    };
+
+    // if we have some OD-tickets on this origin stop_area, we look for a precise OD-ticket match destination also
+    // if we haven't found complete OD-ticket match we search on origin's mode, then on origin's zone
+    for (const uint64_t origin : {od_key(OD_key::StopArea, label.stop_area), od_key(OD_key::Mode, label.mode),
+                                  od_key(OD_key::Zone, label.zone)}) {
+        if (const auto* ticket = get_od_dest(origin)) {
+            return *ticket;
+        }
+    }
+    throw no_ticket();
 }
 
 std::string comp_to_string(const Comp_e comp) {
@@ -128,6 +364,215 @@ std::string comp_to_string(const Comp_e comp) {
     }
 }
 
+void DateTicket::add(boost::gregorian::date begin, boost::gregorian::date end, const Ticket& ticket) {
+    tickets.emplace_back(greg::date_period(begin, end), ticket);
+}
+
+SectionKey::SectionKey(const routing::PathItem& path_item, const size_t idx) : path_item_idx(idx) {
+    const navitia::type::StopPoint* first_sp = path_item.stop_points.front();
+    const navitia::type::StopPoint* last_sp = path_item.stop_points.back();
+    const navitia::type::VehicleJourney* vj = path_item.get_vj();
+
+    network = vj->route->line->network->uri;
+    start_stop_area = first_sp->stop_area->uri;
+    dest_stop_area = last_sp->stop_area->uri;
+    line = vj->route->line->uri;
+    date = path_item.departure.date();
+    start_time = path_item.departure.time_of_day().total_seconds();
+    dest_time = path_item.arrival.time_of_day().total_seconds();
+    start_zone = first_sp->fare_zone;
+    dest_zone = last_sp->fare_zone;
+    mode = vj->physical_mode->uri;
+}
+
+template <class T>
+bool compare(const T& a, const T& b, Comp_e comp) {
+    switch (comp) {
+        case Comp_e::LT:
+            return a < b;
+            break;
+        case Comp_e::GT:
+            return a > b;
+            break;
+        case Comp_e::GTE:
+            return a >= b;
+            break;
+        case Comp_e::LTE:
+            return a <= b;
+            break;
+        case Comp_e::EQ:
+            return a == b;
+            break;
+        case Comp_e::NEQ:
+            return a != b;
+            break;
+        default:
+            return true;
+    }
+}
+
+int SectionKey::duration_at_begin(int ticket_start_time) const {
+    if (ticket_start_time <= boost::lexical_cast<int>(start_time)) {
+        return start_time - ticket_start_time;
+    }
+
+    // Passe-minuit
+    return (start_time + 24 * 3600) - ticket_start_time;
+}
+
+int SectionKey::duration_at_end(int ticket_start_time) const {
+    if (ticket_start_time <= boost::lexical_cast<int>(dest_time)) {
+        return dest_time - ticket_start_time;
+    }
+
+    // Passe-minuit
+    return (dest_time + 24 * 3600) - ticket_start_time;
+}
+
+Ticket DateTicket::get_fare(boost::gregorian::date date) const {
+    for (const auto& dticket : tickets) {
+        if (dticket.validity_period.contains(date)) {
+            return dticket.ticket;
+        }
+    }
+
+    throw no_ticket();
+}
+
+DateTicket DateTicket::operator+(const DateTicket& other) const {
+    DateTicket new_ticket = *this;
+    if (this->tickets.size() != other.tickets.size())
+        LOG4CPLUS_ERROR(log4cplus::Logger::getInstance("fare"), "Tickets don't have the same number of dates");
+
+    for (size_t i = 0; i < std::min(this->tickets.size(), other.tickets.size()); ++i) {
+        if (this->tickets[i].validity_period != other.tickets[i].validity_period)
+            LOG4CPLUS_ERROR(log4cplus::Logger::getInstance("fare"),
+                            "Ticket n° " << i << " doesn't have the same dates; " << this->tickets[i].validity_period
+                                         << " as " << other.tickets[i].validity_period);
+        new_ticket.tickets[i].ticket.value = this->tickets[i].ticket.value + other.tickets[i].ticket.value;
+    }
+    return new_ticket;
+}
+
+/// Checks that the transition can extend the label on this section
+static bool valid(const CompiledTransition& compiled,
+                  const SectionKey& section,
+                  const InternedSection& ids,
+                  const Label& label) {
+    auto logger = log4cplus::Logger::getInstance("fare");
+    const Transition& transition = *compiled.transition;
+    if (label.tickets.empty() && transition.ticket_key.empty()
+        && transition.global_condition != Transition::GlobalCondition::with_changes) {
+        // the transition is a continuation and we don't have any
+        // ticket, thus this transition is not valid
+        return false;
+    }
+    if (label.current_type == Ticket::ODFare
+        && transition.global_condition != Transition::GlobalCondition::with_changes) {
+        // an OD need a with_changes rule to use a transition
+        return false;
+    }
+
+    for (const CompiledCondition& cond : compiled.start_conditions) {
+        switch (cond.key) {
+            case CompiledCondition::Key::zone:
+                if (cond.value != ids.start_zone) {
+                    LOG4CPLUS_TRACE(logger, "start_zone " << cond.str_value << " vs " << section.start_zone);
+                    return false;
+                }
+                break;
+            case CompiledCondition::Key::stop_area:
+                if (cond.value != ids.start_stop_area) {
+                    LOG4CPLUS_TRACE(logger, "start_stop_area " << cond.str_value << " vs " << section.start_stop_area);
+                    return false;
+                }
+                break;
+            case CompiledCondition::Key::duration: {
+                // if the ticket key is not empty, it means we are punching a new ticket
+                const int ticket_punch_date = transition.ticket_key.empty() ? label.start_time : section.start_time;
+                const int ticket_duration = section.duration_at_begin(ticket_punch_date);
+                LOG4CPLUS_TRACE(logger, "Boarding duration " << cond.get_int_value() << " vs " << ticket_duration);
+                if (!compare(ticket_duration, cond.get_int_value(), cond.comparaison)) {
+                    return false;
+                }
+                break;
+            }
+            case CompiledCondition::Key::nb_changes: {
+                // we are checking whether we can extend `label` using this Transition.
+                // we want to check that, after using this Transition, the number of changes will be
+                // less than the max number of changes of the condition
+                // Two cases can arise :
+                //  - either we are starting a new ticket (the ticket_key is not empty or label.tickets is empty)
+                //    In this case, after this transition, we will have make 0 changes with this ticket
+                //  - otherwise we keep using a ticket that was used on the previous section.
+                //     In this case, we already have made `label.nb_changes`, and after
+                //     the transition we will have `label.nb_changes + 1` changes
+                int nb_of_changes_after_transition = label.nb_changes + 1;
+                if (!transition.ticket_key.empty() || label.tickets.empty()) {
+                    assert(label.nb_changes == 0);
+                    nb_of_changes_after_transition = 0;
+                }
+                LOG4CPLUS_TRACE(logger,
+                                "nb changes " << cond.get_int_value() << " vs " << nb_of_changes_after_transition);
+                if (!compare(nb_of_changes_after_transition, cond.get_int_value(), cond.comparaison)) {
+                    return false;
+                }
+                break;
+            }
+            case CompiledCondition::Key::ticket:
+                if (label.tickets.empty()) {
+                    break;
+                }
+                LOG4CPLUS_TRACE(logger, "ticket " << cond.str_value << " " << comp_to_string(cond.comparaison) << " "
+                                                  << label.tickets.back().key);
+                if (!compare(label.tickets.back().key, cond.str_value, cond.comparaison)) {
+                    return false;
+                }
+                break;
+            case CompiledCondition::Key::line:
+                LOG4CPLUS_TRACE(logger, "line " << cond.str_value << " vs " << section.line);
+                if (cond.comparaison == Comp_e::EQ || cond.comparaison == Comp_e::NEQ) {
+                    if (!compare(ids.line, cond.value, cond.comparaison)) {
+                        return false;
+                    }
+                } else if (!compare(section.line, cond.str_value, cond.comparaison)) {
+                    return false;
+                }
+                break;
+            default:
+                break;
+        }
+    }
+    for (const CompiledCondition& cond : compiled.end_conditions) {
+        switch (cond.key) {
+            case CompiledCondition::Key::zone:
+                if (cond.value != ids.dest_zone) {
+                    LOG4CPLUS_TRACE(logger, "dest_zone " << cond.str_value << " vs " << section.dest_zone);
+                    return false;
+                }
+                break;
+            case CompiledCondition::Key::stop_area:
+                if (cond.value != ids.dest_stop_area) {
+                    LOG4CPLUS_TRACE(logger, "dest_stop_area " << cond.str_value << " vs " << section.dest_stop_area);
+                    return false;
+                }
+                break;
+            case CompiledCondition::Key::duration: {
+                const int ticket_punch_date = transition.ticket_key.empty() ? label.start_time : section.start_time;
+                const int ticket_duration = section.duration_at_end(ticket_punch_date);
+                LOG4CPLUS_TRACE(logger, "Alighting duration " << cond.get_int_value() << " vs " << ticket_duration);
+                if (!compare(ticket_duration, cond.get_int_value(), cond.comparaison)) {
+                    return false;
+                }
+                break;
+            }
+            default:
+                break;
+        }
+    }
+    return true;
+}
+
 results Fare::compute_fare(const routing::Path& path) const {
     results res;
     int nb_nodes = boost::num_vertices(g);
@@ -138,9 +583,17 @@ results Fare::compute_fare(const routing::Path& path) const {
         LOG4CPLUS_TRACE(logger, "no fare data loaded, cannot compute fare");
         return res;
     }
+    auto compiled_fare = std::atomic_load(&compiled);
+    if (!compiled_fare || !compiled_fare->is_up_to_date(*this)) {
+        // compiled once after a modification, the next calls use it
+        LOG4CPLUS_DEBUG(logger, "the fare model has been modified since its last compilation, compiling it");
+        compiled_fare = std::make_shared<const CompiledFare>(*this);
+        std::atomic_store(&compiled, compiled_fare);
+    }
+
     std::vector<std::vector<Label>> labels(nb_nodes);
     // Start label
-    labels[0].push_back(Label());
+    labels[0].push_back(Label(&compiled_fare->pool));
     size_t section_idx(0);
 
     for (const navitia::routing::PathItem& item : path.items) {
@@ -150,32 +603,34 @@ results Fare::compute_fare(const routing::Path& path) const {
         }
         LOG4CPLUS_TRACE(logger, "In section " << section_idx << " : \n" << item);
         SectionKey section_key(item, section_idx++);
+        const InternedSection section_ids(section_key, compiled_fare->pool);
 
         std::vector<std::vector<Label>> new_labels(nb_nodes);
         try {
-            BOOST_FOREACH (edge_t e, boost::edges(g)) {
-                vertex_t u = boost::source(e, g);
-                vertex_t v = boost::target(e, g);
+            for (const CompiledTransition& compiled_transition : compiled_fare->transitions) {
+                const vertex_t u = compiled_transition.source;
+                const vertex_t v = compiled_transition.target;
 
-                if (!valid(g[v], section_key)) {
+                if (!valid(compiled_fare->states[v], section_ids)) {
                     continue;
                 }
-                LOG4CPLUS_TRACE(logger, "Trying transition : \n " << g[e] << "\n from node : " << u << "\n  " << g[u]
+                LOG4CPLUS_TRACE(logger, "Trying transition : \n " << *compiled_transition.transition
+                                                                  << "\n from node : " << u << "\n  " << g[u]
                                                                   << "\n to node :   " << v << "\n  " << g[v]);
 
                 for (const Label& label : labels[u]) {
                     LOG4CPLUS_TRACE(logger, "Looking at label  : \n" << label);
                     Ticket ticket;
-                    const Transition& transition = g[e];
-                    if (valid(g[u], label) && transition.valid(section_key, label)) {
+                    const Transition& transition = *compiled_transition.transition;
+                    if (valid(compiled_fare->states[u], label)
+                        && valid(compiled_transition, section_key, section_ids, label)) {
                         LOG4CPLUS_TRACE(logger, " Transition accept this (section, label) \n");
                         if (!transition.ticket_key.empty()) {
                             LOG4CPLUS_TRACE(logger, " Transition ticket key is not blank : " << transition.ticket_key);
                             bool ticket_found = false;  // TODO refactor this, optional is way better
-                            auto it = fare_map.find(transition.ticket_key);
                             try {
-                                if (it != fare_map.end()) {
-                                    ticket = it->second.get_fare(section_key.date);
+                                if (compiled_transition.date_ticket) {
+                                    ticket = compiled_transition.date_ticket->get_fare(section_key.date);
                                     ticket_found = true;
                                 }
                             } catch (no_ticket) {  // the ticket_found bool is still false
@@ -195,13 +650,13 @@ results Fare::compute_fare(const routing::Path& path) const {
 
                             ticket.type = Ticket::ODFare;
                         }
-                        Label next = next_label(label, ticket, section_key);
+                        Label next = next_label(label, ticket, section_key, section_ids);
 
                         // we process the OD ticket: case where we'll not use this ticket anymore
                         if (label.current_type == Ticket::ODFare || ticket.type == Ticket::ODFare) {
                             try {
                                 Ticket ticket_od;
-                                ticket_od = get_od(next, section_key).get_fare(section_key.date);
+                                ticket_od = compiled_fare->get_od(next, section_ids).get_fare(section_key.date);
                                 if (!label.tickets.empty() && label.current_type == Ticket::ODFare) {
                                     ticket_od.sections = label.tickets.back().sections;
                                 }
@@ -215,7 +670,8 @@ results Fare::compute_fare(const routing::Path& path) const {
                                 new_labels[0].push_back(n);
                             } catch (no_ticket) {
                                 LOG4CPLUS_TRACE(logger, "Unable to get the OD ticket SA="
-                                                            << next.stop_area << ", zone=" << next.zone
+                                                            << compiled_fare->pool.get(next.stop_area)
+                                                            << ", zone=" << compiled_fare->pool.get(next.zone)
                                                             << ", section start_zone=" << section_key.start_zone
                                                             << ", dest_zone=" << section_key.dest_zone
                                                             << ", start_sa=" << section_key.start_stop_area
@@ -240,7 +696,7 @@ results Fare::compute_fare(const routing::Path& path) const {
             new_labels.clear();
             new_labels.resize(nb_nodes);
             for (const Label& label : labels.at(0)) {
-                new_labels.at(0).push_back(next_label(label, ticket, section_key));
+                new_labels.at(0).push_back(next_label(label, ticket, section_key, section_ids));
             }
         }
         labels = std::move(new_labels);
@@ -266,277 +722,14 @@ results Fare::compute_fare(const routing::Path& path) const {
     return res;
 }
 
-void DateTicket::add(boost::gregorian::date begin, boost::gregorian::date end, const Ticket& ticket) {
-    tickets.emplace_back(greg::date_period(begin, end), ticket);
-}
-
-SectionKey::SectionKey(const routing::PathItem& path_item, const size_t idx) : path_item_idx(idx) {
-    const navitia::type::StopPoint* first_sp = path_item.stop_points.front();
-    const navitia::type::StopPoint* last_sp = path_item.stop_points.back();
-    const navitia::type::VehicleJourney* vj = path_item.get_vj();
-
-    network = vj->route->line->network->uri;
-    start_stop_area = first_sp->stop_area->uri;
-    dest_stop_area = last_sp->stop_area->uri;
-    line = vj->route->line->uri;
-    date = path_item.departure.date();
-    start_time = path_item.departure.time_of_day().total_seconds();
-    dest_time = path_item.arrival.time_of_day().total_seconds();
-    start_zone = first_sp->fare_zone;
-    dest_zone = last_sp->fare_zone;
-    mode = vj->physical_mode->uri;
-}
-
-template <class T>
-bool compare(const T& a, const T& b, Comp_e comp) {
-    switch (comp) {
-        case Comp_e::LT:
-            return a < b;
-            break;
-        case Comp_e::GT:
-            return a > b;
-            break;
-        case Comp_e::GTE:
-            return a >= b;
-            break;
-        case Comp_e::LTE:
-            return a <= b;
-            break;
-        case Comp_e::EQ:
-            return a == b;
-            break;
-        case Comp_e::NEQ:
-            return a != b;
-            break;
-        default:
-            return true;
-    }
-}
-
-int SectionKey::duration_at_begin(int ticket_start_time) const {
-    if (ticket_start_time <= boost::lexical_cast<int>(start_time)) {
-        return start_time - ticket_start_time;
-    }
-
-    // Passe-minuit
-    return (start_time + 24 * 3600) - ticket_start_time;
-}
-
-int SectionKey::duration_at_end(int ticket_start_time) const {
-    if (ticket_start_time <= boost::lexical_cast<int>(dest_time)) {
-        return dest_time - ticket_start_time;
-    }
-
-    // Passe-minuit
-    return (dest_time + 24 * 3600) - ticket_start_time;
-}
-
-Ticket DateTicket::get_fare(boost::gregorian::date date) const {
-    for (const auto& dticket : tickets) {
-        if (dticket.validity_period.contains(date)) {
-            return dticket.ticket;
-        }
-    }
-
-    throw no_ticket();
-}
-
-DateTicket DateTicket::operator+(const DateTicket& other) const {
-    DateTicket new_ticket = *this;
-    if (this->tickets.size() != other.tickets.size())
-        LOG4CPLUS_ERROR(log4cplus::Logger::getInstance("fare"), "Tickets don't have the same number of dates");
-
-    for (size_t i = 0; i < std::min(this->tickets.size(), other.tickets.size()); ++i) {
-        if (this->tickets[i].validity_period != other.tickets[i].validity_period)
-            LOG4CPLUS_ERROR(log4cplus::Logger::getInstance("fare"),
-                            "Ticket n° " << i << " doesn't have the same dates; " << this->tickets[i].validity_period
-                                         << " as " << other.tickets[i].validity_period);
-        new_ticket.tickets[i].ticket.value = this->tickets[i].ticket.value + other.tickets[i].ticket.value;
-    }
-    return new_ticket;
-}
-
-bool Transition::valid(const SectionKey& section, const Label& label) const {
-    auto logger = log4cplus::Logger::getInstance("fare");
-    if (label.tickets.empty() && ticket_key.empty() && global_condition != Transition::GlobalCondition::with_changes) {
-        // the transition is a continuation and we don't have any
-        // ticket, thus this transition is not valid
-        return false;
-    }
-    if (label.current_type == Ticket::ODFare && global_condition != Transition::GlobalCondition::with_changes) {
-        // an OD need a with_changes rule to use a transition
-        return false;
-    }
-
-    for (const Condition& cond : this->start_conditions) {
-        if (cond.key == "zone" && cond.value != section.start_zone) {
-            LOG4CPLUS_TRACE(logger, "start_zone " << cond.value << " vs " << section.start_zone);
-            return false;
-        } else if (cond.key == "stoparea" && cond.value != section.start_stop_area) {
-            LOG4CPLUS_TRACE(logger, "start_stop_area " << cond.value << " vs " << section.start_stop_area);
-
-            return false;
-        }
-        if (cond.key == "duration") {
-            // In the CSV file, time is displayed in minutes. It is handled here in seconds
-            int duration = boost::lexical_cast<int>(cond.value) * 60;
-            int ticket_punch_date = label.start_time;
-            // if the ticket key is not empty, it means we are punching a new ticket
-            if (!this->ticket_key.empty()) {
-                ticket_punch_date = section.start_time;
-            }
-            int ticket_duration = section.duration_at_begin(ticket_punch_date);
-            LOG4CPLUS_TRACE(logger, "Boarding duration " << duration << " vs " << ticket_duration);
-            if (!compare(ticket_duration, duration, cond.comparaison)) {
-                return false;
-            }
-        } else if (cond.key == "nb_changes") {
-            auto max_nb_changes = boost::lexical_cast<int>(cond.value);
-
-            int current_nb_of_changes = label.nb_changes;
-            int nb_of_changes_after_transition = current_nb_of_changes + 1;
-            // if the ticket_key is not empty, it means we are punching a new ticket
-            // hence, after this transition, we will have made 0 changes with the last ticket
-            // similarly, if label->tickets is empty, it means that we are punching a new ticket
-            if (!this->ticket_key.empty() || label.tickets.empty()) {
-                assert(current_nb_of_changes == 0);
-                nb_of_changes_after_transition = 0;
-            }
-
-            // we are checking whether we can extend `label` using this Transition.
-            // we want to check that, after using this Transition, the number of changes will be
-            // less than `max_nb_changes`
-            // Two cases can arise :
-            //  - either we are starting a new ticket, so label.tickets is empty,
-            //     or last_ticket.sections is empty.
-            //    In this case, after this transition, we will have make 0 changes with this ticket
-            //  - otherwise we keep using a ticket that was used on the previous section.
-            //     In this case, we already have made `current_nb_of_changes`, and after
-            //     the transition we will have `current_nb_of_changes + 1` changes
-            //
-            LOG4CPLUS_TRACE(logger, "nb changes " << max_nb_changes << " vs " << nb_of_changes_after_transition);
-            if (!compare(nb_of_changes_after_transition, max_nb_changes, cond.comparaison)) {
-                return false;
-            }
-        } else if (cond.key == "ticket" && !label.tickets.empty()) {
-            LOG4CPLUS_TRACE(logger, "ticket " << cond.value << " " << comp_to_string(cond.comparaison) << " "
-                                              << label.tickets.back().key);
-
-            if (!compare(label.tickets.back().key, cond.value, cond.comparaison)) {
-                return false;
-            }
-        } else if (cond.key == "line") {
-            LOG4CPLUS_TRACE(logger, "line " << cond.value << " vs " << section.line);
-            if (!compare(section.line, cond.value, cond.comparaison)) {
-                return false;
-            }
-        }
-    }
-    for (const Condition& cond : this->end_conditions) {
-        if (cond.key == "zone" && cond.value != section.dest_zone) {
-            LOG4CPLUS_TRACE(logger, "dest_zone " << cond.value << " vs " << section.dest_zone);
-
-            return false;
-        } else if (cond.key == "stoparea" && cond.value != section.dest_stop_area) {
-            LOG4CPLUS_TRACE(logger, "dest_stop_are " << cond.value << " vs " << section.dest_stop_area);
-
-            return false;
-        }
-        if (cond.key == "duration") {
-            // In the CSV file, time is displayed in minutes. It is handled here in seconds
-            int duration = boost::lexical_cast<int>(cond.value) * 60;
-            int ticket_punch_date = label.start_time;
-            // if the ticket key is not empty, it means we are punching a new ticket
-            if (!this->ticket_key.empty()) {
-                ticket_punch_date = section.start_time;
-            }
-            int ticket_duration = section.duration_at_end(ticket_punch_date);
-            LOG4CPLUS_TRACE(logger, "Alighting duration " << duration << " vs " << ticket_duration);
-            if (!compare(ticket_duration, duration, cond.comparaison)) {
-                return false;
-            }
-        }
-    }
-    return true;
-}
-
-using OD_map = std::map<OD_key, std::vector<std::string>>;
-
-static boost::optional<OD_map::const_iterator> get_od_dest(const OD_map& od_map,
-                                                           const OD_key& sa,
-                                                           const OD_key& mode,
-                                                           const OD_key& zone) {
-    auto od_t = od_map.find(sa);
-    if (od_t == od_map.end()) {
-        od_t = od_map.find(mode);
-    }
-    if (od_t == od_map.end()) {
-        od_t = od_map.find(zone);
-    }
-    if (od_t == od_map.end()) {
-        return boost::none;
-    }
-    return od_t;
-}
-
-DateTicket Fare::get_od(const Label& label, const SectionKey& section) const {
-    OD_key o_sa(OD_key::StopArea, label.stop_area);
-    OD_key o_mode(OD_key::Mode, label.mode);
-    OD_key o_zone(OD_key::Zone, label.zone);
-
-    OD_key d_sa(OD_key::StopArea, section.dest_stop_area);
-    OD_key d_mode(OD_key::Mode, section.mode);
-    OD_key d_zone(OD_key::Zone, section.dest_zone);
-
-    boost::optional<OD_map::const_iterator> od;
-    auto start_od_map = od_tickets.find(o_sa);
-    // if we have some OD-tickets on this origin stop_area,
-    // we look for a precise OD-ticket match destination also
-    if (start_od_map != od_tickets.end()) {
-        od = get_od_dest(start_od_map->second, d_sa, d_mode, d_zone);
-    }
-    // if we haven't found complete OD-ticket match we search on origin's mode
-    if (!od) {
-        start_od_map = od_tickets.find(o_mode);
-        if (start_od_map != od_tickets.end()) {
-            od = get_od_dest(start_od_map->second, d_sa, d_mode, d_zone);
-        }
-    }
-    // if we haven't found complete OD-ticket match we search on origin's zone
-    if (!od) {
-        start_od_map = od_tickets.find(o_zone);
-        if (start_od_map != od_tickets.end()) {
-            od = get_od_dest(start_od_map->second, d_sa, d_mode, d_zone);
-        }
-    }
-    if (!od) {
-        throw no_ticket();
-    }
-
-    // We create a new ticket, sum of all atomic elements
-    // A STIF OD-ticket is always the sum of multiple tickets
-    DateTicket ticket;
-    std::vector<std::string> vec_t = (*od)->second;
-    auto it = fare_map.find(vec_t.at(0));
-    if (it != fare_map.end()) {
-        ticket = it->second;
-    }
-    for (size_t i = 1; i < vec_t.size(); ++i) {
-        it = fare_map.find(vec_t.at(i));
-        if (it != fare_map.end()) {
-            ticket = ticket + it->second;
-        } else {
-            auto new_ticket = DateTicket();
-            ticket = ticket + new_ticket;
-        }
-    }
-    return ticket;
-}
-
 Fare::Fare() {
     add_default_ticket();
 }
 
+void Fare::compile() const {
+    std::atomic_store(&compiled, std::make_shared<const CompiledFare>(*this));
+}
+
 size_t Fare::nb_transitions() const {
     return boost::num_edges(g);
 }
@@ -557,10 +750,11 @@ void Fare::add_default_ticket() {
 }
 
 std::ostream& operator<<(std::ostream& ss, const Label& l) {
+    const auto str = [&](const InternedId id) { return l.pool ? l.pool->get(id) : std::to_string(id); };
     ss << "  cost : " << l.cost << ", nb_undef_cost : " << l.nb_undefined_sub_cost << ", start time : " << l.start_time
-       << ", nb_changes : " << l.nb_changes << ", stop_area : " << l.stop_area << ", zone : " << l.zone
-       << ", mode : " << l.mode << ", line : " << l.line << ", network : " << l.network << ", current_type "
-       << l.current_type;
+       << ", nb_changes : " << l.nb_changes << ", stop_area : " << str(l.stop_area) << ", zone : " << str(l.zone)
+       << ", mode : " << str(l.mode) << ", line : " << str(l.line) << ", network : " << str(l.network)
+       << ", current_type " << l.current_type;
 
     ss << ", Tickets :\n";
     for (const auto& ticket : l.tickets) {
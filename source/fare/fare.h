@@ -41,6 +41,11 @@ www.navitia.io
 #include <boost/date_time/gregorian/greg_serialize.hpp>
 #include <boost/serialization/utility.hpp>
 
+#include <limits>
+#include <memory>
+#include <tuple>
+#include <unordered_map>
+
 namespace navitia {
 namespace fare {
 
@@ -187,9 +192,19 @@ struct State {
 
     State() {}
 
-    bool operator==(const State& other) const { return this->concat() == other.concat(); }
+    bool operator==(const State& other) const { return this->tie() == other.tie(); }
+
+    bool operator<(const State& other) const { return this->tie() < other.tie(); }
 
-    bool operator<(const State& other) const { return this->concat() < other.concat(); }
+    std::tuple<const std::string&,
+               const std::string&,
+               const std::string&,
+               const std::string&,
+               const std::string&,
+               const std::string&>
+    tie() const {
+        return std::tie(mode, zone, stop_area, line, network, ticket);
+    }
 
     std::string concat() const {
         std::stringstream res;
@@ -237,25 +252,50 @@ struct Condition {
 
 std::ostream& operator<<(std::ostream& ss, const Condition& k);
 
+/// Id of a string interned when compiling the fare graph
+using InternedId = uint32_t;
+
+/// Interned strings (modes, lines, zones, stop areas...) of the fare graph
+struct StringPool {
+    /// id of the empty string
+    static constexpr InternedId empty = 0;
+    /// id of every string unknown by the pool
+    static constexpr InternedId unknown = std::numeric_limits<InternedId>::max();
+
+    StringPool() { intern(""); }
+
+    InternedId intern(const std::string& str);
+    /// Returns the id of the string, or unknown if the string has not been interned
+    InternedId find(const std::string& str) const;
+    /// Returns the string of an id, and an empty string for unknown
+    const std::string& get(const InternedId id) const;
+
+private:
+    std::unordered_map<std::string, InternedId> ids;
+    std::vector<std::string> strings;
+};
+
 /// Structure représentant une étiquette
 struct Label {
     Cost cost = 0;  //< Coût cummulé
     size_t nb_undefined_sub_cost = 0;
     int start_time = 0;  //< Heure de compostage du billet
     // int duration;//< durée jusqu'à présent du trajet depuis le dernier ticket
-    int nb_changes = 0;     //< nombre de changement effectués depuis le dernier ticket
-    std::string stop_area;  //< stop_area d'achat du billet
-                            // std::string dest_stop_area; //< on est obligé de descendre à ce stop_area
-    std::string zone;
-    std::string mode;
-    std::string line;
-    std::string network;
+    int nb_changes = 0;                        //< nombre de changement effectués depuis le dernier ticket
+    InternedId stop_area = StringPool::empty;  //< stop_area d'achat du billet
+    InternedId zone = StringPool::empty;
+    InternedId mode = StringPool::empty;
+    InternedId line = StringPool::empty;
+    InternedId network = StringPool::empty;
 
     Ticket::ticket_type current_type = Ticket::FlatFare;
 
     std::vector<Ticket> tickets;  //< Ensemble de billets à acheter pour arriver à cette étiquette
+    // strings of the interned ids, only used to print the label
+    const StringPool* pool = nullptr;
     /// Constructeur par défaut
     Label() {}
+    explicit Label(const StringPool* pool) : pool(pool) {}
     bool operator==(const Label& l) const {
         return cost == l.cost && start_time == l.start_time && nb_changes == l.nb_changes && stop_area == l.stop_area
                && zone == l.zone && mode == l.mode && line == l.line && network == l.network;
@@ -306,8 +346,6 @@ struct Transition {
     std::string ticket_key;                                       //< clef vers le tarif correspondant
     GlobalCondition global_condition = GlobalCondition::nothing;  //< condition telle que exclusivité ou OD
 
-    bool valid(const SectionKey& section, const Label& label) const;
-
     template <class Archive>
     void serialize(Archive& ar, const unsigned int) {
         ar& start_conditions& end_conditions& ticket_key& global_condition;
@@ -341,6 +379,8 @@ struct results {
     bool not_found = true;
 };
 
+struct CompiledFare;
+
 /// Contient l'ensemble du système tarifaire
 struct Fare {
     /// Map qui associe les clefs de tarifs aux tarifs
@@ -371,14 +411,27 @@ struct Fare {
         // boost adjacency load does not seems to empty the graph, hence there was a memory leak
         g.clear();
         ar& fare_map& od_tickets& g;
+        modified();
+        compile();
     }
     BOOST_SERIALIZATION_SPLIT_MEMBER()
 
     size_t nb_transitions() const;
 
+    /// Compiles the graph, the tickets and the OD into interned ids used by compute_fare
+    /// Done at the end of the loading, and by the first compute_fare after a modification
+    void compile() const;
+
+    /// Must be called after any modification of fare_map, od_tickets or g:
+    /// the compiled version is outdated, the next compute_fare compiles it again
+    void modified() { ++generation; }
+
 private:
-    /// Retourne le ticket OD qui va bien ou lève une exception no_ticket si on ne trouve pas
-    DateTicket get_od(const Label& label, const SectionKey& section) const;
+    friend struct CompiledFare;
+    // shared by the concurrent compute_fare, only accessed with std::atomic_load/atomic_store
+    mutable std::shared_ptr<const CompiledFare> compiled;
+    // incremented at each modification of the fare model, the compiled version is up to date if it has the same
+    uint64_t generation = 0;
 
     void add_default_ticket();
 
@@ -562,6 +562,60 @@ BOOST_FIXTURE_TEST_CASE(mantis_sword_46044, fare_load_fixture) {
     BOOST_CHECK_EQUAL(res.tickets.at(0).value, 170);
 }
 
+/*
+ * the fare model compiled by Fare::compile() must give the same results as the one compiled by the first
+ * compute_fare, and must be compiled again when the fare model is modified (and Fare::modified() is called)
+ */
+BOOST_FIXTURE_TEST_CASE(compiled_fare_model, fare_load_fixture) {
+    const std::vector<std::vector<std::string>> journeys = {
+        {"Filbleu;FILURSE-2;FILNav31;FILGATO-2;2011|07|01;02|06;02|10;1;1;metro"},
+        {"440;8711389;800:T4;8743179;2012|04|23;14|28;14|29;4;4;Tramway",
+         "436;8727141;810:B;8727148;2012|06|26;19|41;19|50;4;4;rapidtransit"},
+        {"439;59591;100110001:1;59592;2012|01|03;11|13;11|17;1;1;metro",
+         "bob;morane;contre;tout;2011|07|01;02|06;02|10;1;1;chacal",
+         "437;8739100;800:N;8739156;2012|01|03;11|35;11|42;1;2;localtrain"}};
+
+    std::vector<results> lazy_results;
+    for (const auto& journey : journeys) {
+        lazy_results.push_back(f.compute_fare(string_to_path(journey)));
+    }
+    f.compile();
+    for (size_t i = 0; i < journeys.size(); ++i) {
+        const auto compiled_res = f.compute_fare(string_to_path(journeys[i]));
+        BOOST_CHECK_EQUAL(compiled_res.total, lazy_results[i].total);
+        BOOST_REQUIRE_EQUAL(compiled_res.tickets.size(), lazy_results[i].tickets.size());
+        for (size_t t = 0; t < compiled_res.tickets.size(); ++t) {
+            BOOST_CHECK_EQUAL(compiled_res.tickets[t].key, lazy_results[i].tickets[t].key);
+        }
+    }
+
+    // a new exclusive ticket on the Filbleu network, not yet compiled, must be taken into account
+    f.fare_map["filbleu_exclusive"].add(boost::gregorian::date(2011, 1, 1), boost::gregorian::date(2012, 1, 1),
+                                        Ticket("filbleu_exclusive", "Filbleu exclusive", 42, ""));
+    State filbleu;
+    filbleu.network = "Filbleu";
+    Transition transition;
+    transition.ticket_key = "filbleu_exclusive";
+    transition.global_condition = Transition::GlobalCondition::exclusive;
+    boost::add_edge(f.begin_v, boost::add_vertex(filbleu, f.g), transition, f.g);
+    f.modified();
+
+    res = f.compute_fare(string_to_path(journeys[0]));
+    BOOST_REQUIRE_EQUAL(res.tickets.size(), 1);
+    BOOST_CHECK_EQUAL(res.tickets.at(0).key, "filbleu_exclusive");
+
+    // a modification that keeps the size of the model must also be taken into account
+    f.compile();
+    f.fare_map["filbleu_exclusive"] = DateTicket();
+    f.fare_map["filbleu_exclusive"].add(boost::gregorian::date(2011, 1, 1), boost::gregorian::date(2012, 1, 1),
+                                        Ticket("filbleu_exclusive", "Filbleu exclusive", 21, ""));
+    f.modified();
+
+    res = f.compute_fare(string_to_path(journeys[0]));
+    BOOST_REQUIRE_EQUAL(res.tickets.size(), 1);
+    BOOST_CHECK_EQUAL(res.tickets.at(0).value, 21);
+}
+
 BOOST_FIXTURE_TEST_CASE(journeys_with_unknown_section, fare_load_fixture) {
     // tests with unknown section in the middle
     keys.clear();
@@ -312,6 +312,18 @@ ProjectionData::ProjectionData(const type::GeographicalCoord& coord, const GeoRe
     }
 }
 
+ProjectionData::ProjectionData(const type::GeographicalCoord& coord,
+                               const GeoRef& sn,
+                               const boost::optional<edge_t>& nearest_edge) {
+    found = bool(nearest_edge);
+    if (found) {
+        init(coord, sn, *nearest_edge);
+    } else {
+        vertices[Direction::Source] = std::numeric_limits<vertex_t>::max();
+        vertices[Direction::Target] = std::numeric_limits<vertex_t>::max();
+    }
+}
+
 void ProjectionData::init(const type::GeographicalCoord& coord, const GeoRef& sn, const edge_t& nearest_edge) {
     // We retrieve both vertices of nearest_edge from the graph to get their coordinates
     vertices[Direction::Source] = boost::source(nearest_edge, sn.graph);
@@ -550,6 +562,15 @@ std::vector<nf::Autocomplete<nt::idx_t>::fl_quality> GeoRef::find_ways(
     return to_return;
 }
 
+// for a given mode, in which layer the stop are projected
+static const flat_enum_map<nt::Mode_e, nt::Mode_e> stop_point_mode_to_layer{{{
+    nt::Mode_e::Walking,  // Walking -> Walking
+    nt::Mode_e::Bike,     // Bike -> Bike
+    nt::Mode_e::Walking,  // Car -> Walking
+    nt::Mode_e::Walking,  // Bss -> Walking
+    nt::Mode_e::Car       // CarNoPark -> Car
+}}};
+
 void GeoRef::project_stop_points(const std::vector<type::StopPoint*>& stop_points) {
     enum class error {
         matched = 0,
@@ -569,8 +590,34 @@ void GeoRef::project_stop_points(const std::vector<type::StopPoint*>& stop_point
     this->projected_coords.clear();
     this->projected_coords.reserve(stop_points.size());
 
+    // The nearest edges are searched with one batch of queries by layer (and not by mode,
+    // since several modes share the same layer)
+    std::vector<type::GeographicalCoord> coords;
+    coords.reserve(stop_points.size());
     for (const type::StopPoint* stop_point : stop_points) {
-        std::pair<GeoRef::ProjectionByMode, bool> pair = project_stop_point(stop_point);
+        coords.push_back(stop_point->coord);
+    }
+    flat_enum_map<nt::Mode_e, std::vector<boost::optional<edge_t>>> nearest_edges_by_layer;
+    proximitylist::BatchResult<vertex_t> nearest_vertices;
+    for (const auto layer : {nt::Mode_e::Walking, nt::Mode_e::Bike, nt::Mode_e::Car}) {
+        proximity_list(layer).find_within_batch<proximitylist::IndexOnly>(coords, nearest_vertices);
+        auto& nearest_edges = nearest_edges_by_layer[layer];
+        nearest_edges.reserve(coords.size());
+        for (size_t i = 0; i < coords.size(); ++i) {
+            nearest_edges.push_back(nearest_edge_among(coords[i], nearest_vertices[i]));
+        }
+    }
+
+    for (size_t sp_pos = 0; sp_pos < stop_points.size(); ++sp_pos) {
+        const type::StopPoint* stop_point = stop_points[sp_pos];
+        std::pair<GeoRef::ProjectionByMode, bool> pair = {{}, false};
+        for (auto const mode_layer : stop_point_mode_to_layer) {
+            ProjectionData proj(stop_point->coord, *this, nearest_edges_by_layer[mode_layer.second][sp_pos]);
+            pair.first[mode_layer.first] = proj;
+            if (proj.found) {
+                pair.second = true;
+            }
+        }
 
         /*
          * We build 2 different caches :
@@ -669,16 +716,7 @@ std::pair<GeoRef::ProjectionByMode, bool> GeoRef::project_stop_point(const type:
     bool one_proj_found = false;
     ProjectionByMode projections;
 
-    // for a given mode, in which layer the stop are projected
-    const flat_enum_map<nt::Mode_e, nt::Mode_e> mode_to_layer{{{
-        nt::Mode_e::Walking,  // Walking -> Walking
-        nt::Mode_e::Bike,     // Bike -> Bike
-        nt::Mode_e::Walking,  // Car -> Walking
-        nt::Mode_e::Walking,  // Bss -> Walking
-        nt::Mode_e::Car       // CarNoPark -> Car
-    }}};
-
-    for (auto const mode_layer : mode_to_layer) {
+    for (auto const mode_layer : stop_point_mode_to_layer) {
         nt::Mode_e mode = mode_layer.first;
         ProjectionData proj(stop_point->coord, *this, mode_layer.second);
         projections[mode] = proj;
@@ -700,15 +738,19 @@ edge_t GeoRef::nearest_edge(const type::GeographicalCoord& coordinates) const {
 }
 
 edge_t GeoRef::nearest_edge(const type::GeographicalCoord& coordinates, type::Mode_e mode) const {
+    return nearest_edge(coordinates, proximity_list(mode));
+}
+
+const proximitylist::ProximityList<vertex_t>& GeoRef::proximity_list(type::Mode_e mode) const {
     switch (mode) {
         case type::Mode_e::Walking:
         case type::Mode_e::Bss:
-            return nearest_edge(coordinates, pl_walking);
+            return pl_walking;
         case type::Mode_e::Bike:
-            return nearest_edge(coordinates, pl_bike);
+            return pl_bike;
         case type::Mode_e::Car:
         case type::Mode_e::CarNoPark:
-            return nearest_edge(coordinates, pl_car);
+            return pl_car;
         default:
             throw navitia::recoverable_exception("Unknown mode when looking for nearest edges");
     }
@@ -718,16 +760,26 @@ edge_t GeoRef::nearest_edge(const type::GeographicalCoord& coordinates, type::Mo
 edge_t GeoRef::nearest_edge(const type::GeographicalCoord& coordinates,
                             const proximitylist::ProximityList<vertex_t>& prox,
                             double horizon) const {
-    boost::optional<edge_t> res;
-    float min_dist = 0., cur_dist = 0.;
-    double coslat = ::cos(coordinates.lat() * type::GeographicalCoord::N_DEG_TO_RAD);
-
     // TODO: set different nb for different modes
     // we can set -1 for both walking and bike mode
     // set smaller number (ex: 50) for car
     constexpr int nb_nearest_vertices = -1;
 
-    for (const auto& u : prox.find_within<proximitylist::IndexOnly>(coordinates, horizon, nb_nearest_vertices)) {
+    const auto vertices = prox.find_within<proximitylist::IndexOnly>(coordinates, horizon, nb_nearest_vertices);
+    const auto res = nearest_edge_among(coordinates, boost::make_iterator_range(vertices.begin(), vertices.end()));
+    if (res) {
+        return *res;
+    }
+    throw proximitylist::NotFound();
+}
+
+boost::optional<edge_t> GeoRef::nearest_edge_among(const type::GeographicalCoord& coordinates,
+                                                   const VertexRange& vertices) const {
+    boost::optional<edge_t> res;
+    float min_dist = 0., cur_dist = 0.;
+    double coslat = ::cos(coordinates.lat() * type::GeographicalCoord::N_DEG_TO_RAD);
+
+    for (const auto& u : vertices) {
         BOOST_FOREACH (const edge_t& e, boost::out_edges(u, graph)) {
             const auto& v = target(e, graph);
             auto source_mode = get_mode(u);
@@ -749,10 +801,7 @@ edge_t GeoRef::nearest_edge(const type::GeographicalCoord& coordinates,
             }
         }
     }
-    if (res) {
-        return *res;
-    }
-    throw proximitylist::NotFound();
+    return res;
 }
 
 std::pair<int, const Way*> GeoRef::nearest_addr(const type::GeographicalCoord& coord) const {
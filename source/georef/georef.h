@@ -310,9 +310,16 @@ struct GeoRef {
     GeoRef(const GeoRef& other) = default;
 
 private:
+    using VertexRange = boost::iterator_range<std::vector<vertex_t>::const_iterator>;
+
     edge_t nearest_edge(const type::GeographicalCoord& coordinates,
                         const proximitylist::ProximityList<vertex_t>& prox,
                         double horizon = 500) const;
+    // the nearest edge with at least one of its vertices in the given ones
+    boost::optional<edge_t> nearest_edge_among(const type::GeographicalCoord& coordinates,
+                                               const VertexRange& vertices) const;
+    // the proximity list of the layer used by the mode
+    const proximitylist::ProximityList<vertex_t>& proximity_list(type::Mode_e mode) const;
 };
 
 /** Nommage d'un POI (point of interest). **/
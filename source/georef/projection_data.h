@@ -32,6 +32,8 @@ www.navitia.io
 #include "georef/georef_types.h"
 #include "georef/edge.h"
 
+#include <boost/optional.hpp>
+
 namespace navitia {
 namespace georef {
 
@@ -71,6 +73,10 @@ struct ProjectionData {
     ProjectionData() {}
     // Project the coordinate on the graph corresponding to the transportation mode of the offset
     ProjectionData(const type::GeographicalCoord& coord, const GeoRef& sn, type::Mode_e mode = type::Mode_e::Walking);
+    // Project the coordinate on an already found edge (not found if none)
+    ProjectionData(const type::GeographicalCoord& coord,
+                   const GeoRef& sn,
+                   const boost::optional<edge_t>& nearest_edge);
 
     template <class Archive>
     void serialize(Archive& ar, const unsigned int) {
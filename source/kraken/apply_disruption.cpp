@@ -773,6 +773,7 @@ void delete_disruption(const std::string& disruption_id, nt::PT_Data& pt_data, c
     // the disruption is deleted by RAII
     if (auto disruption = holder.pop_disruption(disruption_id)) {
         for (const auto& impact : disruption->get_impacts()) {
+            pt_data.changes.add_deleted_impact(*impact);
             delete_impact(impact, pt_data, meta);
         }
     }
@@ -0,0 +1,120 @@
+/* Copyright © 2001-2019, Canal TP and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+channel `#navitia` on riot https://riot.im/app/#/room/#navitia:matrix.org
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+#include "ed/build_helper.h"
+#include "kraken/apply_disruption.h"
+#include "type/data.h"
+#include "type/pt_data.h"
+#include "utils/init.h"
+#include "utils/timer.h"
+
+#include <boost/program_options.hpp>
+
+#include <iostream>
+#include <random>
+
+using namespace navitia;
+namespace po = boost::program_options;
+namespace bg = boost::gregorian;
+namespace bt = boost::posix_time;
+
+/*
+ * Applies a no service disruption on a whole line of a synthetic dataset with many validity
+ * patterns: every vj of the line gets new validity patterns, each of them found or created by
+ * PT_Data::get_or_create_validity_pattern.
+ */
+int main(int argc, char** argv) {
+    navitia::init_app();
+    po::options_description desc("Options of the apply disruption benchmark");
+    int nb_lines, nb_vjs, nb_stops, nb_patterns, nb_days;
+
+    // clang-format off
+    desc.add_options()
+            ("help", "Show this message")
+            ("lines,l", po::value<int>(&nb_lines)->default_value(50), "number of lines of the dataset")
+            ("vjs,v", po::value<int>(&nb_vjs)->default_value(2000), "number of vehicle journeys by line")
+            ("stops,s", po::value<int>(&nb_stops)->default_value(10), "number of stops by vehicle journey")
+            ("patterns,p", po::value<int>(&nb_patterns)->default_value(50000), "number of distinct validity patterns")
+            ("days,d", po::value<int>(&nb_days)->default_value(7), "number of days of the disruption");
+    // clang-format on
+
+    po::variables_map vm;
+    po::store(po::parse_command_line(argc, argv, desc), vm);
+    po::notify(vm);
+
+    if (vm.count("help")) {
+        std::cout << "This is used to benchmark the application of a line-wide disruption" << std::endl;
+        std::cout << desc << std::endl;
+        return 1;
+    }
+
+    std::mt19937 rng(42);
+    std::bernoulli_distribution active_day(0.7);
+    std::vector<std::string> patterns;
+    for (int p = 0; p < nb_patterns; ++p) {
+        std::string days(365, '0');
+        for (auto& day : days) {
+            day = active_day(rng) ? '1' : '0';
+        }
+        patterns.push_back(std::move(days));
+    }
+
+    ed::builder b("20180101");
+    {
+        Timer t("dataset building");
+        std::uniform_int_distribution<int> pattern_dist(0, nb_patterns - 1);
+        for (int l = 0; l < nb_lines; ++l) {
+            const auto line = "line:" + std::to_string(l);
+            for (int v = 0; v < nb_vjs; ++v) {
+                auto vj = b.vj(line, patterns[pattern_dist(rng)]);
+                const int start = 5 * 3600 + v * 30;
+                for (int s = 0; s < nb_stops; ++s) {
+                    vj(line + ":stop:" + std::to_string(s), start + s * 120, start + s * 120 + 30);
+                }
+            }
+        }
+        b.make();
+    }
+    auto& pt_data = *b.data->pt_data;
+    std::cout << pt_data.vehicle_journeys.size() << " vehicle journeys, " << pt_data.validity_patterns.size()
+              << " validity patterns" << std::endl;
+
+    const bt::ptime begin(b.begin + bg::days(30), bt::hours(0));
+    const auto& disruption = b.impact(type::RTLevel::Adapted, "line_disruption")
+                                 .severity(type::disruption::Effect::NO_SERVICE)
+                                 .on(type::Type_e::Line, "line:0", pt_data)
+                                 .application_periods(bt::time_period(begin, bt::hours(24 * nb_days)))
+                                 .get_disruption();
+    {
+        Timer t("apply the disruption on line:0");
+        navitia::apply_disruption(disruption, pt_data, *b.data->meta);
+    }
+    std::cout << pt_data.vehicle_journeys.size() << " vehicle journeys, " << pt_data.validity_patterns.size()
+              << " validity patterns" << std::endl;
+}
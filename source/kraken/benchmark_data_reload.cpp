@@ -0,0 +1,116 @@
+/* Copyright © 2001-2019, Canal TP and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+channel `#navitia` on riot https://riot.im/app/#/room/#navitia:matrix.org
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#include "kraken/data_manager.h"
+#include "type/data.h"
+#include "type/pt_data.h"
+#include "utils/init.h"
+#include "utils/timer.h"
+
+#include <boost/program_options.hpp>
+
+#include <fstream>
+#include <iostream>
+#include <unistd.h>
+
+using namespace navitia;
+namespace po = boost::program_options;
+
+namespace {
+
+size_t rss_mb() {
+    size_t size = 0, resident = 0;
+    std::ifstream("/proc/self/statm") >> size >> resident;
+    return resident * sysconf(_SC_PAGESIZE) / (1024 * 1024);
+}
+
+}  // namespace
+
+/*
+ * Replays the data swaps of a day of realtime updates: each update clones the current data,
+ * rebuilds it and replaces it, the previous data being destroyed.  The resident memory is
+ * printed along the updates, with or without the arenas of the data.
+ */
+int main(int argc, char** argv) {
+    navitia::init_app();
+    po::options_description desc("Options of the data reload benchmark");
+    std::string file;
+    int nb_updates, raptor_cache_size, print_every;
+
+    // clang-format off
+    desc.add_options()
+            ("help", "Show this message")
+            ("file,f", po::value<std::string>(&file)->default_value("data.nav.lz4"), "Path to data.nav.lz4")
+            ("updates,u", po::value<int>(&nb_updates)->default_value(100), "number of realtime updates")
+            ("size,s", po::value<int>(&raptor_cache_size)->default_value(10), "raptor cache size")
+            ("print,p", po::value<int>(&print_every)->default_value(10), "print the memory every p updates")
+            ("no-arena", "allocate the objects of the data on the heap");
+    // clang-format on
+
+    po::variables_map vm;
+    po::store(po::parse_command_line(argc, argv, desc), vm);
+    po::notify(vm);
+
+    if (vm.count("help")) {
+        std::cout << "This is used to benchmark the memory of the data reloads" << std::endl;
+        std::cout << desc << std::endl;
+        return 1;
+    }
+    type::Arena::set_enabled(!vm.count("no-arena"));
+
+    DataManager<type::Data> data_manager;
+    {
+        Timer t("Data loading: " + file);
+        data_manager.load(file, boost::none, {}, raptor_cache_size);
+    }
+    const size_t loaded_rss = rss_mb();
+    std::cout << "rss after loading: " << loaded_rss << "MB" << std::endl;
+
+    Timer total("realtime updates");
+    for (int u = 1; u <= nb_updates; ++u) {
+        auto data = data_manager.get_data_clone();
+        data->build_relations();
+        data->build_raptor(raptor_cache_size);
+        data->build_proximity_list();
+        {
+            Timer t("data swap");
+            data_manager.set_data(std::move(data));
+        }
+        if (u % print_every == 0 || u == nb_updates) {
+            const size_t rss = rss_mb();
+            std::cout << "update " << u << ": rss " << rss << "MB (+" << int64_t(rss) - int64_t(loaded_rss) << "MB)";
+            if (const auto* arena = data_manager.get_data()->arena()) {
+                std::cout << ", arena " << arena->reserved_bytes() / (1024 * 1024) << "MB in " << arena->nb_slabs()
+                          << " slabs";
+            }
+            std::cout << std::endl;
+        }
+    }
+}
@@ -36,6 +36,7 @@ www.navitia.io
 #include <boost/algorithm/string/replace.hpp>
 #include <boost/optional.hpp>
 
+#include <algorithm>
 #include <fstream>
 #include <iostream>
 
@@ -61,6 +62,8 @@ po::options_description get_options_description(const boost::optional<std::strin
          "name of the instance")
 
         ("GENERAL.nb_threads", po::value<int>()->default_value(1), "number of workers threads")
+        ("GENERAL.enable_numa", po::value<bool>()->default_value(false),
+                                  "on several numa nodes, pin the workers threads by node and give each node a copy of the data")
         ("GENERAL.is_realtime_enabled", po::value<bool>()->default_value(false),
                                         "enable loading of realtime data")
         ("GENERAL.is_realtime_add_enabled", po::value<bool>()->default_value(false),
@@ -78,10 +81,22 @@ po::options_description get_options_description(const boost::optional<std::strin
              po::value<bool>()->default_value(*display_contributors) : po::value<bool>()->default_value(false),
          "display all contributors in feed publishers")
         ("GENERAL.raptor_cache_size", po::value<int>()->default_value(10), "maximum number of stored raptor caches")
+        ("GENERAL.raptor_cache_prefetch_days", po::value<int>()->default_value(2),
+                                  "number of days from today whose raptor caches are built after each data update, 0 to disable")
+        ("GENERAL.raptor_cache_prefetch_threads", po::value<int>()->default_value(2),
+                                  "number of threads building the raptor caches in advance")
+        ("GENERAL.raptor_multi_target_second_pass", po::value<bool>()->default_value(false),
+                                  "compute the second pass of the journeys with one raptor seeded with all the arrivals")
         ("GENERAL.log_level", po::value<std::string>(), "log level of kraken")
         ("GENERAL.log_format", po::value<std::string>()->default_value("[%D{%y-%m-%d %H:%M:%S,%q}] [%p] [%x] - %m %b:%L  %n"), "log format")
 
         ("GENERAL.enable_request_deadline", po::value<bool>()->default_value(true), "enable deadline of request")
+        ("GENERAL.enable_request_coalescing", po::value<bool>()->default_value(false),
+                                  "share the response of a request with the identical requests received during its computation")
+        ("GENERAL.response_cache_ttl", po::value<int>()->default_value(0),
+                                  "seconds during which a response is reused for identical requests, 0 to disable")
+        ("GENERAL.response_cache_max_bytes", po::value<int>()->default_value(64 * 1024 * 1024),
+                                  "maximum size in bytes of the cached responses")
         ("GENERAL.metrics_binding", po::value<std::string>(), "IP:PORT to serving metrics in http")
         ("GENERAL.core_file_size_limit", po::value<int>()->default_value(0), "ulimit that define the maximum size of a core file")
 
@@ -253,6 +268,25 @@ bool Configuration::enable_request_deadline() const {
     return vm["GENERAL.enable_request_deadline"].as<bool>();
 }
 
+bool Configuration::enable_numa() const {
+    if (!vm.count("GENERAL.enable_numa")) {
+        return false;
+    }
+    return vm["GENERAL.enable_numa"].as<bool>();
+}
+
+bool Configuration::enable_request_coalescing() const {
+    return vm["GENERAL.enable_request_coalescing"].as<bool>();
+}
+
+int Configuration::response_cache_ttl() const {
+    return std::max(0, vm["GENERAL.response_cache_ttl"].as<int>());
+}
+
+size_t Configuration::response_cache_max_bytes() const {
+    return size_t(std::max(0, vm["GENERAL.response_cache_max_bytes"].as<int>()));
+}
+
 size_t Configuration::raptor_cache_size() const {
     if (!vm.count("GENERAL.raptor_cache_size")) {
         return 10;
@@ -264,6 +298,25 @@ size_t Configuration::raptor_cache_size() const {
     return size_t(raptor_cache_size);
 }
 
+size_t Configuration::raptor_cache_prefetch_days() const {
+    if (!vm.count("GENERAL.raptor_cache_prefetch_days")) {
+        return 2;
+    }
+    return size_t(std::max(0, vm["GENERAL.raptor_cache_prefetch_days"].as<int>()));
+}
+
+bool Configuration::raptor_multi_target_second_pass() const {
+    return vm.count("GENERAL.raptor_multi_target_second_pass")
+           && vm["GENERAL.raptor_multi_target_second_pass"].as<bool>();
+}
+
+size_t Configuration::raptor_cache_prefetch_threads() const {
+    if (!vm.count("GENERAL.raptor_cache_prefetch_threads")) {
+        return 2;
+    }
+    return size_t(std::max(1, vm["GENERAL.raptor_cache_prefetch_threads"].as<int>()));
+}
+
 boost::optional<std::string> Configuration::log_level() const {
     boost::optional<std::string> result;
     if (this->vm.count("GENERAL.log_level") > 0) {
@@ -67,12 +67,19 @@ public:
     int kirin_retry_timeout() const;
     bool display_contributors() const;
     size_t raptor_cache_size() const;
+    size_t raptor_cache_prefetch_days() const;
+    size_t raptor_cache_prefetch_threads() const;
+    bool raptor_multi_target_second_pass() const;
     int core_file_size_limit() const;
     int slow_request_duration() const;
     boost::optional<std::string> log_level() const;
     boost::optional<std::string> log_format() const;
     boost::optional<std::string> metrics_binding() const;
     bool enable_request_deadline() const;
+    bool enable_request_coalescing() const;
+    bool enable_numa() const;
+    int response_cache_ttl() const;
+    size_t response_cache_max_bytes() const;
 
     std::vector<std::string> rt_topics() const;
 };
@@ -30,6 +30,7 @@ www.navitia.io
 
 #pragma once
 
+#include "kraken/numa.h"
 #include "utils/logger.h"
 #include "utils/timer.h"
 #include "type/data_exceptions.h"
@@ -44,6 +45,9 @@ www.navitia.io
 #include <memory>
 #include <iostream>
 #include <atomic>
+#include <functional>
+#include <mutex>
+#include <vector>
 
 template <typename Data>
 void data_deleter(const Data* data) {
@@ -57,8 +61,20 @@ void data_deleter(const Data* data) {
 
 template <typename Data>
 class DataManager {
+    using Replicas = std::vector<boost::shared_ptr<const Data>>;
+    using ReplicaMaker = std::function<boost::shared_ptr<const Data>(const Data&, const Data*)>;
+
     boost::shared_ptr<const Data> current_data;
     std::atomic_size_t data_identifier;
+    // copies of the data read by the numa nodes 1 to n (at node - 1), null without replicas.
+    // After update_data, they are the copies of the previous version until replicate() replaces them
+    boost::shared_ptr<const Replicas> replicas;
+    // incremented by set_data, the replicas being built for a previous generation are dropped
+    size_t replicas_generation = 0;
+    navitia::numa::Topology topology;
+    ReplicaMaker make_replica;
+    // the replicas are built in background, and must not be published once their data is replaced
+    std::mutex publication_mutex;
 
 private:
     boost::shared_ptr<Data> create_data(size_t id) { return boost::shared_ptr<Data>(new Data(id), data_deleter<Data>); }
@@ -84,10 +100,132 @@ public:
         if (!data) {
             throw navitia::exception("Giving a null Data to DataManager::set_data");
         }
+        std::lock_guard<std::mutex> lock(publication_mutex);
         data->is_connected_to_rabbitmq = current_data->is_connected_to_rabbitmq.load();
-        current_data = std::move(data);
+        boost::atomic_store(&current_data, std::move(data));
+        // the replicas of the previous data must not be read anymore
+        boost::atomic_store(&replicas, boost::shared_ptr<const Replicas>());
+        ++replicas_generation;
     }
-    boost::shared_ptr<const Data> get_data() const { return current_data; }
+
+    /*
+     * Same as set_data for a data updated from the current one, as by the realtime: the other
+     * numa nodes keep reading their copy of the previous version until replicate() has built
+     * the one of the new version, instead of reading the first node.
+     */
+    void update_data(boost::shared_ptr<const Data>&& data) {
+        if (!data) {
+            throw navitia::exception("Giving a null Data to DataManager::update_data");
+        }
+        std::lock_guard<std::mutex> lock(publication_mutex);
+        data->is_connected_to_rabbitmq = current_data->is_connected_to_rabbitmq.load();
+        boost::atomic_store(&current_data, std::move(data));
+    }
+
+    /// The data of the numa node of the current thread
+    boost::shared_ptr<const Data> get_data() const {
+        const size_t node = navitia::numa::current_node();
+        if (node > 0) {
+            const auto local_replicas = boost::atomic_load(&replicas);
+            if (local_replicas && node <= local_replicas->size() && (*local_replicas)[node - 1]) {
+                return (*local_replicas)[node - 1];
+            }
+        }
+        return boost::atomic_load(&current_data);
+    }
+
+    /*
+     * With several numa nodes, each node can read its own copy of the data instead of
+     * reaching the memory of another node.  make_replica(data, previous) returns a copy of the
+     * data, built by replicate() on a thread of the node so that it is allocated there.
+     * previous is the copy of the node of a previous version of the data (see update_data),
+     * null if there is none.  The data loaded by a thread of the first node is the copy of that node.
+     */
+    void enable_replicas(const navitia::numa::Topology& topology, ReplicaMaker make_replica) {
+        this->topology = topology;
+        this->make_replica = std::move(make_replica);
+    }
+
+    /*
+     * Builds the replicas of the current data, each one being published as soon as it is built.
+     * Stops if the data is replaced by set_data or if is_cancelled returns true, but not on
+     * update_data: the replicas are not restarted from scratch for each realtime update.
+     * Until its replica is published, a node reads the previous one or current_data.
+     */
+    void replicate(const std::function<bool()>& is_cancelled = [] { return false; }) {
+        if (topology.nb_nodes() < 2 || !make_replica) {
+            return;
+        }
+        size_t generation;
+        {
+            std::lock_guard<std::mutex> lock(publication_mutex);
+            generation = replicas_generation;
+        }
+        for (size_t node = 1; node < topology.nb_nodes(); ++node) {
+            if (is_cancelled()) {
+                return;
+            }
+            // each node takes the last update of the data
+            boost::shared_ptr<const Data> data;
+            boost::shared_ptr<const Data> previous;
+            {
+                std::lock_guard<std::mutex> lock(publication_mutex);
+                if (generation != replicas_generation) {
+                    return;
+                }
+                data = current_data;
+                if (replicas) {
+                    previous = (*replicas)[node - 1];
+                }
+            }
+            boost::shared_ptr<const Data> replica;
+            navitia::numa::run_on_node(topology, node, [&] { replica = make_replica(*data, previous.get()); });
+
+            std::lock_guard<std::mutex> lock(publication_mutex);
+            if (generation != replicas_generation || is_cancelled()) {
+                return;
+            }
+            replica->is_connected_to_rabbitmq = current_data->is_connected_to_rabbitmq.load();
+            auto new_replicas = replicas ? boost::make_shared<Replicas>(*replicas)
+                                         : boost::make_shared<Replicas>(topology.nb_nodes() - 1);
+            (*new_replicas)[node - 1] = std::move(replica);
+            boost::atomic_store(&replicas, boost::shared_ptr<const Replicas>(std::move(new_replicas)));
+        }
+    }
+
+    /*
+     * Calls f with the data read by each numa node, on a thread of the node, one node after
+     * the other.  Without replicas, f is called with current_data on the current thread.
+     */
+    template <typename F>
+    void for_each_node(const F& f) const {
+        const auto local_replicas = boost::atomic_load(&replicas);
+        if (!local_replicas) {
+            f(*boost::atomic_load(&current_data));
+            return;
+        }
+        for (size_t node = 0; node < topology.nb_nodes(); ++node) {
+            const auto data = node == 0 || !(*local_replicas)[node - 1] ? boost::atomic_load(&current_data)
+                                                                        : (*local_replicas)[node - 1];
+            navitia::numa::run_on_node(topology, node, [&] { f(*data); });
+        }
+    }
+
+    /// Applies f to the current data and its replicas, as for the flags shared by all the nodes
+    template <typename F>
+    void for_each_data(const F& f) const {
+        f(*boost::atomic_load(&current_data));
+        const auto local_replicas = boost::atomic_load(&replicas);
+        if (!local_replicas) {
+            return;
+        }
+        for (const auto& data : *local_replicas) {
+            if (data) {
+                f(*data);
+            }
+        }
+    }
+
     boost::shared_ptr<Data> get_data_clone() {
         ++data_identifier;
         auto data = create_data(data_identifier.load());
@@ -30,6 +30,8 @@ www.navitia.io
 #include "kraken_zmq.h"
 
 #include "conf.h"
+#include "kraken/numa.h"
+#include "type/data.h"
 #include "type/type.pb.h"
 #include "utils/functions.h"  //navitia::absolute_path function
 #include "utils/init.h"
@@ -42,6 +44,7 @@ www.navitia.io
 #include <functional>
 #include <iostream>
 #include <string>
+#include <vector>
 #include <sys/resource.h>  // Posix dependencies for getrlimit
 
 namespace {
@@ -126,8 +129,47 @@ int main(int argn, char** argv) {
     LoadBalancer lb(context);
 
     const navitia::Metrics metrics(conf.metrics_binding(), conf.instance_name());
+    navitia::ResponseCache response_cache(conf.enable_request_coalescing(),
+                                          boost::posix_time::seconds(conf.response_cache_ttl()),
+                                          conf.response_cache_max_bytes());
+
+    // the replicas are enabled before the maintenance worker loads the data
+    const auto topology = conf.enable_numa() ? navitia::numa::Topology::detect() : navitia::numa::Topology();
+    if (topology.nb_nodes() > 1) {
+        LOG4CPLUS_INFO(logger, "numa mode: a copy of the data on each of the " << topology.nb_nodes() << " nodes");
+        const size_t raptor_cache_size = conf.raptor_cache_size();
+        data_manager.enable_replicas(topology, [raptor_cache_size](const navitia::type::Data& data,
+                                                                   const navitia::type::Data* previous) {
+            auto replica = boost::shared_ptr<navitia::type::Data>(new navitia::type::Data(data.data_identifier),
+                                                                  data_deleter<navitia::type::Data>);
+            replica->clone_from(data);
+            // as for the realtime, the relations of the data are taken instead of being rebuilt
+            replica->copy_relations_from(data);
+            replica->build_raptor(raptor_cache_size);
+            if (previous) {
+                // the proximity lists and the caches already on the node, unless the stop points have moved
+                replica->build_proximity_lists_of_changes(*previous);
+                replica->warmup(*previous);
+            } else {
+                replica->build_proximity_list();
+                // the caches already built for the first node are built for this one
+                replica->warmup(data);
+            }
+            return boost::shared_ptr<const navitia::type::Data>(std::move(replica));
+        });
+        // the data is loaded by the maintenance worker on the first node, whose copy it is, its
+        // thread inheriting the cpus of this one
+        navitia::numa::pin_current_thread(topology.cpus_by_node[0]);
+    }
 
     threads.create_thread(navitia::MaintenanceWorker(data_manager, conf, metrics));
+    if (topology.nb_nodes() > 1) {
+        std::vector<int> all_cpus;
+        for (const auto& cpus : topology.cpus_by_node) {
+            all_cpus.insert(all_cpus.end(), cpus.begin(), cpus.end());
+        }
+        navitia::numa::pin_current_thread(all_cpus);
+    }
     //
     // Data have been loaded, we can now accept connections
     try {
@@ -145,8 +187,15 @@ int main(int argn, char** argv) {
     // Launch pool of worker threads
     LOG4CPLUS_INFO(logger, "starting workers threads");
     for (int thread_nbr = 0; thread_nbr < nb_threads; ++thread_nbr) {
-        threads.create_thread([&context, &data_manager, conf, &metrics, &hostname, thread_nbr] {
-            return doWork(context, data_manager, conf, metrics, hostname, thread_nbr);
+        threads.create_thread([&context, &data_manager, conf, &metrics, &response_cache, &hostname, &topology,
+                               thread_nbr] {
+            if (topology.nb_nodes() > 1) {
+                // the workers are spread over the nodes, and read the data of their node
+                const size_t node = thread_nbr % topology.nb_nodes();
+                navitia::numa::pin_current_thread(topology.cpus_by_node[node]);
+                navitia::numa::current_node() = node;
+            }
+            return doWork(context, data_manager, conf, metrics, response_cache, hostname, thread_nbr);
         });
     }
 
@@ -37,6 +37,8 @@ www.navitia.io
 #include "kraken/configuration.h"
 #include "type/meta_data.h"
 #include "metrics.h"
+#include "response_cache.h"
+#include "routing/next_stop_time.h"
 #include "utils/deadline.h"
 #include "type/datetime.h"
 
@@ -44,10 +46,36 @@ www.navitia.io
 #include <boost/date_time/posix_time/posix_time.hpp>
 #include <boost/optional/optional_io.hpp>
 
+static void respond(zmq::socket_t& socket, const std::string& address, const navitia::ResponseCache::Bytes& bytes) {
+    // the message references the shared response, kept alive until zmq has sent it
+    auto* owner = new navitia::ResponseCache::Bytes(bytes);
+    zmq::message_t reply(const_cast<char*>(bytes->data()), bytes->size(),
+                         [](void*, void* hint) { delete static_cast<navitia::ResponseCache::Bytes*>(hint); }, owner);
+    z_send(socket, address, ZMQ_SNDMORE);
+    z_send(socket, "", ZMQ_SNDMORE);
+    socket.send(reply);
+}
+
+static std::string serialize(const pbnavitia::Response& response) {
+    std::string result;
+    try {
+        response.SerializeToString(&result);
+    } catch (const google::protobuf::FatalException& e) {
+        auto logger = log4cplus::Logger::getInstance("worker");
+        LOG4CPLUS_ERROR(logger, "failure during serialization: " << e.what());
+        pbnavitia::Response error_response;
+        error_response.mutable_error()->set_id(pbnavitia::Error::internal_error);
+        error_response.mutable_error()->set_message(e.what());
+        error_response.SerializeToString(&result);
+    }
+    return result;
+}
+
 static void respond(zmq::socket_t& socket, const std::string& address, const pbnavitia::Response& response) {
+    // the size is computed once, the response is then serialized in place in the zmq message
     zmq::message_t reply(response.ByteSize());
     try {
-        response.SerializeToArray(reply.data(), response.ByteSize());
+        response.SerializeWithCachedSizesToArray(static_cast<google::protobuf::uint8*>(reply.data()));
     } catch (const google::protobuf::FatalException& e) {
         auto logger = log4cplus::Logger::getInstance("worker");
         LOG4CPLUS_ERROR(logger, "failure during serialization: " << e.what());
@@ -67,6 +95,7 @@ inline void doWork(zmq::context_t& context,
                    DataManager<navitia::type::Data>& data_manager,
                    navitia::kraken::Configuration conf,
                    const navitia::Metrics& metrics,
+                   navitia::ResponseCache& response_cache,
                    const std::string& hostname,
                    int worker_id) {
     auto logger = log4cplus::Logger::getInstance("worker");
@@ -127,32 +156,53 @@ inline void doWork(zmq::context_t& context,
 
         LOG4CPLUS_DEBUG(logger, "deadline set to " << deadline.get());
         const auto data = data_manager.get_data();
-        try {
-            deadline.check();
-            w.dispatch(pb_req, *data);
-            if (api != pbnavitia::METADATAS) {
-                LOG4CPLUS_TRACE(logger, "response: " << w.pb_creator.get_response().DebugString());
+        const auto compute = [&](bool& cacheable) {
+            try {
+                deadline.check();
+                w.dispatch(pb_req, *data);
+                if (api != pbnavitia::METADATAS) {
+                    LOG4CPLUS_TRACE(logger, "response: " << w.pb_creator.get_response().DebugString());
+                }
+            } catch (const navitia::DeadlineExpired& e) {
+                LOG4CPLUS_ERROR(logger, "deadline expired, aborting request: " << e.what());
+                w.pb_creator.fill_pb_error(pbnavitia::Error::deadline_expired, e.what());
+                cacheable = false;
+                // we still respond so this thread become availlable again
+            } catch (const navitia::recoverable_exception& e) {
+                // on a recoverable an internal server error is returned
+                LOG4CPLUS_ERROR(logger, "internal server error: " << e.what());
+                LOG4CPLUS_ERROR(logger, "on query: " << pb_req.DebugString());
+                LOG4CPLUS_ERROR(logger, "backtrace: " << e.backtrace());
+                w.pb_creator.fill_pb_error(pbnavitia::Error::internal_error, e.what());
+                cacheable = false;
             }
-        } catch (const navitia::DeadlineExpired& e) {
-            LOG4CPLUS_ERROR(logger, "deadline expired, aborting request: " << e.what());
-            w.pb_creator.fill_pb_error(pbnavitia::Error::deadline_expired, e.what());
-            // we still respond so this thread become availlable again
-        } catch (const navitia::recoverable_exception& e) {
-            // on a recoverable an internal server error is returned
-            LOG4CPLUS_ERROR(logger, "internal server error: " << e.what());
-            LOG4CPLUS_ERROR(logger, "on query: " << pb_req.DebugString());
-            LOG4CPLUS_ERROR(logger, "backtrace: " << e.backtrace());
-            w.pb_creator.fill_pb_error(pbnavitia::Error::internal_error, e.what());
-        }
-        if (!data->loaded) {
-            w.pb_creator.set_publication_date(boost::gregorian::not_a_date_time);
+            if (!data->loaded) {
+                w.pb_creator.set_publication_date(boost::gregorian::not_a_date_time);
+                cacheable = false;
+            } else {
+                w.pb_creator.set_publication_date(data->meta->publication_date);
+            }
+        };
+        if (response_cache.is_enabled()) {
+            navitia::ResponseCache::Outcome outcome;
+            const auto response = response_cache.get(
+                navitia::ResponseCache::fingerprint(pb_req), data->data_identifier,
+                [&](bool& cacheable) {
+                    compute(cacheable);
+                    return std::make_shared<const std::string>(serialize(w.pb_creator.get_response()));
+                },
+                outcome, deadline.get());
+            metrics.observe_response_cache(outcome);
+            respond(socket, address, response);
         } else {
-            w.pb_creator.set_publication_date(data->meta->publication_date);
+            bool cacheable = true;
+            compute(cacheable);
+            respond(socket, address, w.pb_creator.get_response());
         }
-        respond(socket, address, w.pb_creator.get_response());
         auto end = pt::microsec_clock::universal_time();
         auto duration = end - start;
         metrics.observe_api(api, duration.total_milliseconds() / 1000.0);
+        metrics.observe_raptor_cache(navitia::routing::CachedNextStopTimeManager::counters());
         if (duration >= slow_request_duration) {
             LOG4CPLUS_WARN(logger, "slow request! duration: " << duration.total_milliseconds()
                                                               << "ms request: " << pb_req.DebugString());
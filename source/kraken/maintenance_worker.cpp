@@ -34,6 +34,9 @@ www.navitia.io
 #include "make_disruption_from_chaos.h"
 #include "metrics.h"
 #include "realtime.h"
+#include "routing/dataraptor.h"
+#include "type/meta_data.h"
+#include "type/nav_delta.h"
 #include "type/pt_data.h"
 #include "type/task.pb.h"
 #include "type/kirin.pb.h"
@@ -41,11 +44,18 @@ www.navitia.io
 
 #include <SimpleAmqpClient/Envelope.h>
 #include <boost/algorithm/string/join.hpp>
+#include <boost/filesystem/operations.hpp>
 #include <boost/optional.hpp>
 #include <boost/thread/thread.hpp>
+#include <boost/utility.hpp>
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <condition_variable>
 #include <csignal>
+#include <functional>
+#include <mutex>
 #include <sys/stat.h>
 #include <thread>
 #include <utility>
@@ -60,23 +70,177 @@ void MaintenanceWorker::load_data() {
     const std::string database = conf.databases_path();
     auto chaos_database = conf.chaos_database();
     auto contributors = conf.rt_topics();
-    LOG4CPLUS_INFO(logger, "Loading database from file: " + database);
     auto start = pt::microsec_clock::universal_time();
+    if (this->load_delta(database)) {
+        auto duration = pt::microsec_clock::universal_time() - start;
+        this->metrics.observe_data_loading(duration.total_seconds());
+        return;
+    }
+    LOG4CPLUS_INFO(logger, "Loading database from file: " + database);
     if (this->data_manager.load(database, chaos_database, contributors, conf.raptor_cache_size())) {
         auto data = data_manager.get_data();
         data->is_realtime_loaded = false;
         data->meta->instance_name = conf.instance_name();
+        this->replicate_and_prefetch();
     }
     auto duration = pt::microsec_clock::universal_time() - start;
     this->metrics.observe_data_loading(duration.total_seconds());
 }
 
+bool MaintenanceWorker::load_delta(const std::string& database) {
+    const std::string delta_file = database + ".delta";
+    const auto current = data_manager.get_data();
+    if (!current->loaded || current->nav_hash.empty() || !boost::filesystem::exists(delta_file)) {
+        return false;
+    }
+    if (conf.chaos_database() != boost::none) {
+        // the disruptions of the database would have to be applied again on the new vjs
+        LOG4CPLUS_INFO(logger, "the delta " << delta_file << " is not applied with a chaos database, full reload");
+        return false;
+    }
+    try {
+        nt::NavDelta delta;
+        delta.load(delta_file);
+        if (delta.base_hash != current->nav_hash) {
+            LOG4CPLUS_INFO(logger, "the delta " << delta_file << " is not made from the loaded data");
+            return false;
+        }
+        if (delta.target_hash != nt::hash_file(database)) {
+            LOG4CPLUS_INFO(logger, "the delta " << delta_file << " is not made to " << database);
+            return false;
+        }
+        LOG4CPLUS_INFO(logger, "Applying delta from file: " << delta_file);
+        auto data = data_manager.get_data_clone();
+        // as for the realtime, only the relations of the changes are rebuilt
+        data->copy_relations_from(*current);
+        data->pt_data->changes.start();
+        nt::apply_nav_delta(delta, *data);
+        const auto& changes = data->pt_data->changes;
+        LOG4CPLUS_INFO(logger, "rebuilding relations of " << changes.vehicle_journeys.size()
+                                                          << " vehicle journeys and " << changes.routes.size()
+                                                          << " routes");
+        data->build_relations_of_changes();
+        data->pt_data->clean_weak_impacts_of_changes();
+        LOG4CPLUS_INFO(logger, "rebuilding data raptor");
+        data->build_raptor(conf.raptor_cache_size());
+        // a delta doesn't change the streets
+        data->build_proximity_lists_of_changes(*current);
+        data->warmup(*current);
+        data->nav_hash = delta.target_hash;
+        data->last_load_at = pt::microsec_clock::universal_time();
+        data_manager.set_data(std::move(data));
+        this->replicate_and_prefetch();
+        return true;
+    } catch (const std::exception& e) {
+        LOG4CPLUS_WARN(logger, "the delta " << delta_file << " can't be applied, full reload: " << e.what());
+        return false;
+    }
+}
+
+/*
+ * A background thread running the last job requested.  A request doesn't interrupt the running
+ * job, it is run once this one is done, several requests meanwhile only running the last one.
+ * The job is cancelled and joined on destruction.
+ */
+class BackgroundTask : boost::noncopyable {
+    std::thread thread;
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::function<void()> job;
+    std::atomic<bool> requested{false};
+    std::atomic<bool> cancelled{false};
+
+    void run() {
+        while (true) {
+            std::function<void()> next_job;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                condition.wait(lock, [this] { return requested || cancelled; });
+                if (cancelled) {
+                    return;
+                }
+                next_job = std::move(job);
+                requested = false;
+            }
+            next_job();
+        }
+    }
+
+public:
+    ~BackgroundTask() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            cancelled = true;
+        }
+        condition.notify_one();
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+
+    bool is_cancelled() const { return cancelled; }
+    /// A job has been requested since the running one started, it will run next
+    bool is_outdated() const { return cancelled || requested; }
+
+    template <typename F>
+    void request(F&& f) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            job = std::forward<F>(f);
+            requested = true;
+            if (!thread.joinable()) {
+                thread = std::thread([this] { run(); });
+            }
+        }
+        condition.notify_one();
+    }
+};
+
+void MaintenanceWorker::replicate_and_prefetch() {
+    const size_t nb_days = conf.raptor_cache_prefetch_days();
+    const size_t nb_threads = conf.raptor_cache_prefetch_threads();
+    auto* task = background_task.get();
+    auto& manager = this->data_manager;
+    auto logger = this->logger;
+    // the replicas are built after the data is set, the other numa nodes reading their previous copy
+    // or the one of the first node meanwhile, so that neither the loading nor the realtime wait for them
+    task->request([nb_days, nb_threads, task, &manager, logger] {
+        try {
+            auto start = pt::microsec_clock::universal_time();
+            // a realtime update while replicating doesn't restart the replication, the next job
+            // replicates the new version from the copies built by this one
+            manager.replicate([task] { return task->is_cancelled(); });
+            LOG4CPLUS_DEBUG(logger, "data replicated in " << pt::microsec_clock::universal_time() - start);
+
+            // the caches of an outdated data are not prefetched, the next job prefetches the new one
+            const auto is_outdated = [task] { return task->is_outdated(); };
+            const auto data = manager.get_data();
+            const auto today = pt::second_clock::universal_time().date();
+            const auto& production_date = data->meta->production_date;
+            if (nb_days == 0 || !data->loaded || !data->dataRaptor || !production_date.contains(today)) {
+                return;
+            }
+            const size_t first_day = (today - production_date.begin()).days();
+            start = pt::microsec_clock::universal_time();
+            // the caches of each copy are built on its node
+            manager.for_each_node([&](const nt::Data& copy) {
+                if (copy.data_identifier == data->data_identifier && !is_outdated()) {
+                    copy.dataRaptor->prefetch(first_day, nb_days, 2, nb_threads, is_outdated);
+                }
+            });
+            LOG4CPLUS_INFO(logger, "raptor caches prefetched in " << pt::microsec_clock::universal_time() - start);
+        } catch (const std::exception& e) {
+            LOG4CPLUS_WARN(logger, "replication or prefetch of the raptor caches failed: " << e.what());
+        }
+    });
+}
+
 void MaintenanceWorker::load_realtime() {
     if (!conf.is_realtime_enabled()) {
         return;
     }
     if (!channel) {
-        data_manager.get_data()->is_realtime_loaded = false;
+        data_manager.for_each_data([](const nt::Data& d) { d.is_realtime_loaded = false; });
         throw std::runtime_error("not connected to rabbitmq");
     }
     if (data_manager.get_data()->is_realtime_loaded) {
@@ -84,7 +248,7 @@ void MaintenanceWorker::load_realtime() {
         LOG4CPLUS_TRACE(logger, "realtime data already loaded, skipping init");
         return;
     }
-    data_manager.get_data()->is_realtime_loaded = false;
+    data_manager.for_each_data([](const nt::Data& d) { d.is_realtime_loaded = false; });
     LOG4CPLUS_INFO(logger, "loading realtime data");
     //                                             name, passive, durable, exclusive, auto_delete
     std::string queue_name = channel->DeclareQueue("", false, false, true, true);
@@ -110,7 +274,7 @@ void MaintenanceWorker::load_realtime() {
     // waiting for a full gtfs-rt
     if (channel->BasicConsumeMessage(consumer_tag, envelope, conf.kirin_timeout())) {
         this->handle_rt_in_batch({envelope});
-        data_manager.get_data()->is_realtime_loaded = true;
+        data_manager.for_each_data([](const nt::Data& d) { d.is_realtime_loaded = true; });
     } else {
         LOG4CPLUS_WARN(logger, "no realtime data receive before timeout: going without it!");
     }
@@ -125,7 +289,7 @@ void MaintenanceWorker::operator()() {
         this->listen_rabbitmq();
     } catch (const std::runtime_error& ex) {
         LOG4CPLUS_ERROR(logger, "Connection to rabbitmq failed: " << ex.what());
-        data_manager.get_data()->is_connected_to_rabbitmq = false;
+        data_manager.for_each_data([](const nt::Data& d) { d.is_connected_to_rabbitmq = false; });
         sleep(10);
     }
     while (true) {
@@ -134,7 +298,7 @@ void MaintenanceWorker::operator()() {
             this->listen_rabbitmq();
         } catch (const std::runtime_error& ex) {
             LOG4CPLUS_ERROR(logger, "Connection to rabbitmq failed: " << ex.what());
-            data_manager.get_data()->is_connected_to_rabbitmq = false;
+            data_manager.for_each_data([](const nt::Data& d) { d.is_connected_to_rabbitmq = false; });
             sleep(10);
         }
     }
@@ -170,60 +334,117 @@ static bool autocomplete_rebuilding_needed(const transit_realtime::FeedEntity& e
                 == transit_realtime::Alert_Effect::Alert_Effect_MODIFIED_SERVICE));
 }
 
+/*
+ * Parses the feeds of the envelopes, on several threads for the big batches of the
+ * incidents.  Returns false if one of them is not valid.
+ */
+static bool parse_feeds(const std::vector<AmqpClient::Envelope::ptr_t>& envelopes,
+                        std::vector<transit_realtime::FeedMessage>& feeds) {
+    feeds.resize(envelopes.size());
+    std::atomic<bool> all_valid{true};
+    std::atomic<size_t> next{0};
+    const auto parse = [&]() {
+        for (size_t i = next++; i < envelopes.size(); i = next++) {
+            if (!feeds[i].ParseFromString(envelopes[i]->Message()->Body())) {
+                all_valid = false;
+            }
+        }
+    };
+    // a thread for each 64 feeds, the small batches being parsed in the current thread
+    const size_t nb_threads =
+        std::min<size_t>(std::max(1u, std::thread::hardware_concurrency()), envelopes.size() / 64 + 1);
+    std::vector<std::thread> threads;
+    for (size_t t = 1; t < nb_threads; ++t) {
+        threads.emplace_back(parse);
+    }
+    parse();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    return all_valid;
+}
+
 void MaintenanceWorker::handle_rt_in_batch(const std::vector<AmqpClient::Envelope::ptr_t>& envelopes) {
     boost::shared_ptr<nt::Data> data{};
     pt::ptime begin = pt::microsec_clock::universal_time();
     bool autocomplete_rebuilding_activated = false;
-    for (auto& envelope : envelopes) {
-        const auto routing_key = envelope->RoutingKey();
-        LOG4CPLUS_DEBUG(logger, "realtime info received from " << routing_key);
+    for (const auto& envelope : envelopes) {
+        LOG4CPLUS_DEBUG(logger, "realtime info received from " << envelope->RoutingKey());
         assert(envelope);
-        transit_realtime::FeedMessage feed_message;
-        if (!feed_message.ParseFromString(envelope->Message()->Body())) {
-            LOG4CPLUS_WARN(logger, "protobuf not valid!");
-            return;
-        }
+    }
+    std::vector<transit_realtime::FeedMessage> feeds;
+    if (!parse_feeds(envelopes, feeds)) {
+        LOG4CPLUS_WARN(logger, "protobuf not valid!");
+        return;
+    }
+    size_t nb_entities = 0;
+    for (const auto& feed_message : feeds) {
         LOG4CPLUS_TRACE(logger, "received entity: " << feed_message.DebugString());
-        for (const auto& entity : feed_message.entity()) {
-            if (!data) {
-                pt::ptime copy_begin = pt::microsec_clock::universal_time();
-                data = data_manager.get_data_clone();
-                auto duration = pt::microsec_clock::universal_time() - copy_begin;
-                this->metrics.observe_data_cloning(duration.total_seconds());
-                LOG4CPLUS_INFO(logger, "data copied in " << duration);
-            }
+        nb_entities += feed_message.entity_size();
+    }
+    // the successive updates of a disruption or a trip are applied once
+    const auto entities_by_id = coalesce_feed_entities(feeds);
+    if (!entities_by_id.empty()) {
+        LOG4CPLUS_INFO(logger, nb_entities << " realtime entities coalesced into " << entities_by_id.size());
+    }
+    for (const auto& entities : entities_by_id) {
+        if (!data) {
+            pt::ptime copy_begin = pt::microsec_clock::universal_time();
+            data = data_manager.get_data_clone();
+            // the clone starts with the relations of the current data, only the changes are rebuilt
+            data->copy_relations_from(*data_manager.get_data());
+            data->pt_data->changes.start();
+            auto duration = pt::microsec_clock::universal_time() - copy_begin;
+            this->metrics.observe_data_cloning(duration.total_seconds());
+            LOG4CPLUS_INFO(logger, "data copied in " << duration);
+        }
+        // the newest entity, or the newest trip update that is not ignored
+        for (auto it = entities.rbegin(); it != entities.rend(); ++it) {
+            const auto& entity = *it->entity;
             if (entity.is_deleted()) {
                 LOG4CPLUS_DEBUG(logger, "deletion of disruption " << entity.id());
                 delete_disruption(entity.id(), *data->pt_data, *data->meta);
-            } else if (entity.HasExtension(chaos::disruption)) {
+                break;
+            }
+            if (entity.HasExtension(chaos::disruption)) {
                 LOG4CPLUS_DEBUG(logger, "add/update of disruption " << entity.id());
                 make_and_apply_disruption(entity.GetExtension(chaos::disruption), *data->pt_data, *data->meta);
-            } else if (entity.has_trip_update()) {
+                break;
+            }
+            if (entity.has_trip_update()) {
                 LOG4CPLUS_DEBUG(logger, "RT trip update" << entity.id());
-                handle_realtime(entity.id(), navitia::from_posix_timestamp(feed_message.header().timestamp()),
-                                entity.trip_update(), *data, conf.is_realtime_add_enabled(),
-                                conf.is_realtime_add_trip_enabled());
-                autocomplete_rebuilding_activated = autocomplete_rebuilding_needed(entity);
+                if (handle_realtime(entity.id(), it->timestamp, entity.trip_update(), *data,
+                                    conf.is_realtime_add_enabled(), conf.is_realtime_add_trip_enabled())) {
+                    autocomplete_rebuilding_activated |= autocomplete_rebuilding_needed(entity);
+                    break;
+                }
             } else {
                 LOG4CPLUS_WARN(logger, "unsupported gtfs rt feed");
             }
         }
     }
     if (data) {
-        LOG4CPLUS_INFO(logger, "rebuilding relations");
-        data->build_relations();
-        if (autocomplete_rebuilding_activated) {
+        const auto& changes = data->pt_data->changes;
+        LOG4CPLUS_INFO(logger, "rebuilding relations of " << changes.vehicle_journeys.size()
+                                                          << " vehicle journeys and " << changes.routes.size()
+                                                          << " routes");
+        data->build_relations_of_changes();
+        // the autocomplete only indexes the names of the pt objects
+        if (autocomplete_rebuilding_activated && changes.pt_objects_created) {
             LOG4CPLUS_INFO(logger, "rebuilding autocomplete");
             data->build_autocomplete_partial();
         }
-        LOG4CPLUS_INFO(logger, "cleaning weak impacts");
-        data->pt_data->clean_weak_impacts();
+        LOG4CPLUS_INFO(logger,
+                       "cleaning weak impacts of " << changes.objects_with_deleted_impacts.size() << " objects");
+        data->pt_data->clean_weak_impacts_of_changes();
         LOG4CPLUS_INFO(logger, "rebuilding data raptor");
         data->build_raptor(conf.raptor_cache_size());
-        data->build_proximity_list();
+        // the realtime doesn't change the streets
+        data->build_proximity_lists_of_changes(*data_manager.get_data());
         data->warmup(*data_manager.get_data());
         data->set_last_rt_data_loaded(pt::microsec_clock::universal_time());
-        data_manager.set_data(std::move(data));
+        data_manager.update_data(std::move(data));
+        this->replicate_and_prefetch();
         auto duration = pt::microsec_clock::universal_time() - begin;
         this->metrics.observe_handle_rt(duration.total_seconds());
         LOG4CPLUS_INFO(logger, "data updated " << envelopes.size() << " disruption applied in " << duration);
@@ -231,8 +452,8 @@ void MaintenanceWorker::handle_rt_in_batch(const std::vector<AmqpClient::Envelop
         // we didn't had to update Data because there is no change but we want to track that realtime data
         // is being processed as it should because "nothing has changed" isn't the same thing
         // than "I don't known what's happening"
-        auto current_data = data_manager.get_data();
-        current_data->set_last_rt_data_loaded(pt::microsec_clock::universal_time());
+        const auto now = pt::microsec_clock::universal_time();
+        data_manager.for_each_data([&](const nt::Data& d) { d.set_last_rt_data_loaded(now); });
     }
 }
 
@@ -280,7 +501,7 @@ void MaintenanceWorker::listen_rabbitmq() {
     std::string rt_tag = this->channel->BasicConsume(this->queue_name_rt, "", no_local, no_ack, exclusive);
 
     LOG4CPLUS_INFO(logger, "start event loop");
-    data_manager.get_data()->is_connected_to_rabbitmq = true;
+    data_manager.for_each_data([](const nt::Data& d) { d.is_connected_to_rabbitmq = true; });
     while (true) {
         boost::this_thread::interruption_point();
         auto now = pt::microsec_clock::universal_time();
@@ -375,13 +596,14 @@ MaintenanceWorker::MaintenanceWorker(DataManager<type::Data>& data_manager,
       logger(log4cplus::Logger::getInstance(LOG4CPLUS_TEXT("background"))),
       conf(std::move(conf)),
       metrics(metrics),
-      next_try_realtime_loading(pt::microsec_clock::universal_time()) {
+      next_try_realtime_loading(pt::microsec_clock::universal_time()),
+      background_task(std::make_shared<BackgroundTask>()) {
     // Connect Rabbitmq
     try {
         this->init_rabbitmq();
     } catch (const std::runtime_error& ex) {
         LOG4CPLUS_ERROR(logger, "Connection to rabbitmq failed: " << ex.what());
-        data_manager.get_data()->is_connected_to_rabbitmq = false;
+        data_manager.for_each_data([](const nt::Data& d) { d.is_connected_to_rabbitmq = false; });
     }
 
     // Load Data (.nav, disruption Bdd, build raptor data)
@@ -392,7 +614,7 @@ MaintenanceWorker::MaintenanceWorker(DataManager<type::Data>& data_manager,
         this->load_realtime();
     } catch (const std::runtime_error& ex) {
         LOG4CPLUS_ERROR(logger, "Connection to rabbitmq failed: " << ex.what());
-        data_manager.get_data()->is_connected_to_rabbitmq = false;
+        data_manager.for_each_data([](const nt::Data& d) { d.is_connected_to_rabbitmq = false; });
     }
 }
 
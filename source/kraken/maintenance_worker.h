@@ -41,6 +41,7 @@ www.navitia.io
 namespace navitia {
 
 class Metrics;
+class BackgroundTask;
 
 class MaintenanceWorker {
 private:
@@ -65,6 +66,23 @@ private:
 
     void load_realtime();
 
+    /*
+     * Applies the delta written by ed2nav next to the nav file on a clone of the current data,
+     * instead of reloading the whole nav file.  Returns false if there is no delta made from
+     * the nav file of the current data to the one on disk, or if it can't be applied.
+     * The disruptions of a chaos database are only applied by a full reload.
+     */
+    bool load_delta(const std::string& database);
+
+    /*
+     * Builds in background the numa replicas of the current data, then the raptor caches of
+     * the next days of each copy, as the first requests would otherwise pay for them.  A
+     * building in progress is not restarted: it is followed by one for the latest data.
+     */
+    void replicate_and_prefetch();
+    // shared by the copies of the worker, the last one cancelling and joining the task
+    std::shared_ptr<BackgroundTask> background_task;
+
     /*!
      * This function will consume message in batch. It calls
      * AmqpClient::Channel::BasicConsumeMessage(const std::string&, Envelope::ptr_t&, int) to try
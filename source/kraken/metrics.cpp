@@ -30,6 +30,7 @@ www.navitia.io
 
 #include "metrics.h"
 
+#include "routing/next_stop_time.h"
 #include "utils/functions.h"
 #include "utils/logger.h"
 
@@ -128,6 +129,33 @@ Metrics::Metrics(const boost::optional<std::string>& endpoint, const std::string
                                      .Labels({{"coverage", coverage}})
                                      .Register(*registry)
                                      .Add({}, create_exponential_buckets(1, 2, 10));
+
+    auto& response_cache_family = prometheus::BuildCounter()
+                                      .Name("kraken_response_cache_total")
+                                      .Help("number of responses, by origin: computed, shared with an identical "
+                                            "request or cached")
+                                      .Labels({{"coverage", coverage}})
+                                      .Register(*registry);
+    this->response_cache_counters[ResponseCache::Outcome::computed] = &response_cache_family.Add({{"kind", "miss"}});
+    this->response_cache_counters[ResponseCache::Outcome::coalesced] =
+        &response_cache_family.Add({{"kind", "coalesced"}});
+    this->response_cache_counters[ResponseCache::Outcome::cached] = &response_cache_family.Add({{"kind", "hit"}});
+
+    auto& raptor_cache_family = prometheus::BuildCounter()
+                                    .Name("kraken_raptor_cache_total")
+                                    .Help("number of accesses to the raptor caches, by kind")
+                                    .Labels({{"coverage", coverage}})
+                                    .Register(*registry);
+    this->raptor_cache_hits = &raptor_cache_family.Add({{"kind", "hit"}});
+    this->raptor_cache_misses = &raptor_cache_family.Add({{"kind", "miss"}});
+    this->raptor_cache_prefetched = &raptor_cache_family.Add({{"kind", "prefetch"}});
+    this->raptor_cache_evictions = &raptor_cache_family.Add({{"kind", "eviction"}});
+    this->raptor_cache_build_duration = &prometheus::BuildCounter()
+                                             .Name("kraken_raptor_cache_build_duration_seconds_total")
+                                             .Help("duration of building the raptor caches")
+                                             .Labels({{"coverage", coverage}})
+                                             .Register(*registry)
+                                             .Add({});
 }
 
 InFlightGuard Metrics::start_in_flight() const {
@@ -171,4 +199,36 @@ void Metrics::observe_handle_rt(double duration) const {
     this->handle_rt_histogram->Observe(duration);
 }
 
+void Metrics::observe_response_cache(const ResponseCache::Outcome outcome) const {
+    if (!registry) {
+        return;
+    }
+    this->response_cache_counters.at(outcome)->Increment();
+}
+
+// adds to the counter what the value has more than the last one observed, the value becoming the
+// last one observed unless a greater one has been observed in the meantime
+template <typename T>
+static void catch_up(prometheus::Counter* counter, std::atomic<T>& last, const T value) {
+    T observed = last.load();
+    while (value > observed) {
+        if (last.compare_exchange_weak(observed, value)) {
+            counter->Increment(double(value - observed));
+            return;
+        }
+    }
+}
+
+void Metrics::observe_raptor_cache(const routing::NextStopTimeCacheCounters& counters) const {
+    if (!registry) {
+        return;
+    }
+    // the counters of the process are monotonic, but may be read in any order by the workers
+    catch_up(raptor_cache_hits, raptor_cache_observed_hits, counters.nb_hits);
+    catch_up(raptor_cache_misses, raptor_cache_observed_misses, counters.nb_misses);
+    catch_up(raptor_cache_prefetched, raptor_cache_observed_prefetched, counters.nb_prefetched);
+    catch_up(raptor_cache_evictions, raptor_cache_observed_evictions, counters.nb_evictions);
+    catch_up(raptor_cache_build_duration, raptor_cache_observed_build_duration, counters.build_duration);
+}
+
 }  // namespace navitia
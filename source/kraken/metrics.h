@@ -30,6 +30,7 @@ www.navitia.io
 
 #pragma once
 
+#include "response_cache.h"
 #include "type/type.pb.h"
 
 #include <boost/optional.hpp>
@@ -40,6 +41,7 @@ www.navitia.io
 
 #include <memory>
 #include <map>
+#include <atomic>
 
 // forward declare
 namespace prometheus {
@@ -49,6 +51,9 @@ class Histogram;
 }  // namespace prometheus
 
 namespace navitia {
+namespace routing {
+struct NextStopTimeCacheCounters;
+}
 
 class InFlightGuard {
     prometheus::Gauge* gauge;
@@ -71,6 +76,18 @@ protected:
     prometheus::Histogram* data_loading_histogram;
     prometheus::Histogram* data_cloning_histogram;
     prometheus::Histogram* handle_rt_histogram;
+    std::map<ResponseCache::Outcome, prometheus::Counter*> response_cache_counters;
+    prometheus::Counter* raptor_cache_hits;
+    prometheus::Counter* raptor_cache_misses;
+    prometheus::Counter* raptor_cache_prefetched;
+    prometheus::Counter* raptor_cache_evictions;
+    prometheus::Counter* raptor_cache_build_duration;
+    // the process counters already added to the prometheus ones
+    mutable std::atomic<uint64_t> raptor_cache_observed_hits{0};
+    mutable std::atomic<uint64_t> raptor_cache_observed_misses{0};
+    mutable std::atomic<uint64_t> raptor_cache_observed_prefetched{0};
+    mutable std::atomic<uint64_t> raptor_cache_observed_evictions{0};
+    mutable std::atomic<double> raptor_cache_observed_build_duration{0};
 
 public:
     Metrics(const boost::optional<std::string>& endpoint, const std::string& coverage);
@@ -80,6 +97,9 @@ public:
     void observe_data_loading(double duration) const;
     void observe_data_cloning(double duration) const;
     void observe_handle_rt(double duration) const;
+    void observe_response_cache(ResponseCache::Outcome outcome) const;
+    // catch up with the counters of the raptor caches of the process
+    void observe_raptor_cache(const routing::NextStopTimeCacheCounters& counters) const;
 };
 
 }  // namespace navitia
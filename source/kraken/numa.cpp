@@ -0,0 +1,138 @@
+/* Copyright © 2001-2018, Canal TP and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+channel `#navitia` on riot https://riot.im/app/#/room/#navitia:matrix.org
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#include "numa.h"
+
+#include <boost/algorithm/string/split.hpp>
+#include <boost/algorithm/string/classification.hpp>
+#include <boost/algorithm/string/trim.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/lexical_cast.hpp>
+
+#include <algorithm>
+#include <exception>
+#include <fstream>
+#include <map>
+#include <pthread.h>
+#include <sched.h>
+#include <thread>
+
+namespace navitia {
+namespace numa {
+
+std::vector<int> parse_cpu_list(const std::string& cpu_list) {
+    std::vector<int> cpus;
+    std::vector<std::string> ranges;
+    const auto trimmed = boost::algorithm::trim_copy(cpu_list);
+    if (trimmed.empty()) {
+        return cpus;
+    }
+    boost::algorithm::split(ranges, trimmed, boost::algorithm::is_any_of(","));
+    for (const auto& range : ranges) {
+        const auto dash = range.find('-');
+        const int first = boost::lexical_cast<int>(range.substr(0, dash));
+        const int last = dash == std::string::npos ? first : boost::lexical_cast<int>(range.substr(dash + 1));
+        for (int cpu = first; cpu <= last; ++cpu) {
+            cpus.push_back(cpu);
+        }
+    }
+    return cpus;
+}
+
+Topology Topology::detect(const std::string& sysfs_node_dir) {
+    namespace fs = boost::filesystem;
+    // by node number, the directory order being unspecified
+    std::map<int, std::vector<int>> cpus_by_node;
+    boost::system::error_code error;
+    if (fs::is_directory(sysfs_node_dir, error)) {
+        for (fs::directory_iterator it(sysfs_node_dir, error), end; it != end; it.increment(error)) {
+            const auto name = it->path().filename().string();
+            if (name.compare(0, 4, "node") != 0 || name.size() == 4
+                || name.find_first_not_of("0123456789", 4) != std::string::npos) {
+                continue;
+            }
+            std::ifstream cpulist((it->path() / "cpulist").string());
+            std::string line;
+            if (!std::getline(cpulist, line)) {
+                continue;
+            }
+            auto cpus = parse_cpu_list(line);
+            // a node without cpu, as a memory only node, can't run the workers
+            if (!cpus.empty()) {
+                cpus_by_node[boost::lexical_cast<int>(name.substr(4))] = std::move(cpus);
+            }
+        }
+    }
+
+    Topology topology;
+    for (auto& node_cpus : cpus_by_node) {
+        topology.cpus_by_node.push_back(std::move(node_cpus.second));
+    }
+    if (topology.cpus_by_node.empty()) {
+        std::vector<int> all_cpus;
+        for (int cpu = 0; cpu < int(std::max(1u, std::thread::hardware_concurrency())); ++cpu) {
+            all_cpus.push_back(cpu);
+        }
+        topology.cpus_by_node.push_back(all_cpus);
+    }
+    return topology;
+}
+
+bool pin_current_thread(const std::vector<int>& cpus) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (const int cpu : cpus) {
+        if (cpu >= 0 && cpu < CPU_SETSIZE) {
+            CPU_SET(cpu, &set);
+        }
+    }
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+}
+
+void run_on_node(const Topology& topology, const size_t node, const std::function<void()>& f) {
+    std::exception_ptr error;
+    std::thread thread([&] {
+        try {
+            // the memory is allocated on the node of the thread that first touches it
+            pin_current_thread(topology.cpus_by_node.at(node));
+            current_node() = node;
+            f();
+        } catch (...) {
+            error = std::current_exception();
+        }
+    });
+    thread.join();
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+}  // namespace numa
+}  // namespace navitia
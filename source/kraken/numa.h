@@ -0,0 +1,70 @@
+/* Copyright © 2001-2018, Canal TP and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+channel `#navitia` on riot https://riot.im/app/#/room/#navitia:matrix.org
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace navitia {
+namespace numa {
+
+/// The cpus of each numa node, as described by the kernel
+struct Topology {
+    std::vector<std::vector<int>> cpus_by_node;
+
+    size_t nb_nodes() const { return cpus_by_node.size(); }
+
+    /*
+     * Reads the nodes of sysfs_node_dir, a single node with all the cpus if there is
+     * none.  Another directory describes a simulated topology.
+     */
+    static Topology detect(const std::string& sysfs_node_dir = "/sys/devices/system/node");
+};
+
+/// "0-3,8,10-11" -> {0, 1, 2, 3, 8, 10, 11}
+std::vector<int> parse_cpu_list(const std::string& cpu_list);
+
+/// Restricts the current thread to the cpus, returns false if the kernel refuses
+bool pin_current_thread(const std::vector<int>& cpus);
+
+/// The node whose data the current thread reads, 0 by default
+inline size_t& current_node() {
+    static thread_local size_t node = 0;
+    return node;
+}
+
+/// Runs f on a new thread pinned to the cpus of the node, and waits for it
+void run_on_node(const Topology& topology, size_t node, const std::function<void()>& f);
+
+}  // namespace numa
+}  // namespace navitia
@@ -31,6 +31,7 @@ www.navitia.io
 
 #include "kraken/apply_disruption.h"
 #include "type/data.h"
+#include "type/chaos.pb.h"
 #include "type/datetime.h"
 #include "type/kirin.pb.h"
 #include "type/meta_data.h"
@@ -43,7 +44,9 @@ www.navitia.io
 #include <boost/make_shared.hpp>
 #include <boost/optional.hpp>
 
+#include <algorithm>
 #include <chrono>
+#include <unordered_map>
 
 namespace navitia {
 
@@ -607,7 +610,7 @@ static const type::disruption::Disruption* create_disruption(const std::string&
     return &disruption;
 }
 
-void handle_realtime(const std::string& id,
+bool handle_realtime(const std::string& id,
                      const boost::posix_time::ptime& timestamp,
                      const transit_realtime::TripUpdate& trip_update,
                      const type::Data& data,
@@ -619,7 +622,7 @@ void handle_realtime(const std::string& id,
     if (!is_handleable(trip_update, *data.pt_data, is_realtime_add_enabled, is_realtime_add_trip_enabled)
         || !check_trip_update(trip_update)) {
         LOG4CPLUS_DEBUG(log, "unhandled real time message");
-        return;
+        return false;
     }
 
     bool meta_vj_exists = data.pt_data->meta_vjs.exists(trip_update.trip().trip_id());
@@ -631,13 +634,13 @@ void handle_realtime(const std::string& id,
             LOG4CPLUS_WARN(log,
                            "Meta VJ 1st stop time departure: " << trip_update.stop_time_update(0).departure().time());
         }
-        return;
+        return false;
     }
     if (meta_vj_exists && is_added_trip(trip_update) && base_vj_exists_the_same_day(data, trip_update)) {
         LOG4CPLUS_WARN(log, "cannot add new trip, because trip id corresponds to a base VJ the same day"
                                 << ", trip id: " << trip_update.trip().trip_id() << ", effect: "
                                 << get_wordings(get_trip_effect(trip_update.GetExtension(kirin::effect))));
-        return;
+        return false;
     }
 
     const auto* disruption = create_disruption(id, timestamp, trip_update, data);
@@ -646,10 +649,46 @@ void handle_realtime(const std::string& id,
         LOG4CPLUS_INFO(
             log, "disruption " << id << " on " << trip_update.trip().trip_id() << " not valid, we do not handle it");
         delete_disruption(id, *data.pt_data, *data.meta);
-        return;
+        return true;
     }
 
     apply_disruption(*disruption, *data.pt_data, *data.meta);
+    return true;
+}
+
+std::vector<std::vector<FeedEntityRef>> coalesce_feed_entities(
+    const std::vector<transit_realtime::FeedMessage>& feeds) {
+    std::vector<std::vector<FeedEntityRef>> entities_by_id;
+    std::unordered_map<std::string, size_t> position_by_id;
+    for (const auto& feed : feeds) {
+        const auto timestamp = navitia::from_posix_timestamp(feed.header().timestamp());
+        for (const auto& entity : feed.entity()) {
+            if (entity.id().empty()) {
+                entities_by_id.push_back({{&entity, timestamp}});
+                continue;
+            }
+            const auto it = position_by_id.find(entity.id());
+            if (it == position_by_id.end()) {
+                position_by_id[entity.id()] = entities_by_id.size();
+                entities_by_id.push_back({{&entity, timestamp}});
+                continue;
+            }
+            auto entities = std::move(entities_by_id[it->second]);
+            entities_by_id[it->second].clear();
+            if (entity.is_deleted() || entity.HasExtension(chaos::disruption)) {
+                entities.clear();
+            }
+            entities.push_back({&entity, timestamp});
+            // the id moves at the end, as its last entity
+            it->second = entities_by_id.size();
+            entities_by_id.push_back(std::move(entities));
+        }
+    }
+    // the moved ids left empty entities behind them
+    entities_by_id.erase(std::remove_if(entities_by_id.begin(), entities_by_id.end(),
+                                        [](const std::vector<FeedEntityRef>& entities) { return entities.empty(); }),
+                         entities_by_id.end());
+    return entities_by_id;
 }
 
 }  // namespace navitia
@@ -40,11 +40,33 @@ namespace navitia {
  * After using it, make sure to rebuild:
  * - RAPTOR (probably through Data.build_raptor)
  * - AUTOCOMPLETE on PT-Ref (probably through PT_Data.build_autocomplete)
+ *
+ * Returns false if the trip update is ignored, the data being left as is.
  */
-void handle_realtime(const std::string& id,
+bool handle_realtime(const std::string& id,
                      const boost::posix_time::ptime& timestamp,
                      const transit_realtime::TripUpdate&,
                      const type::Data&,
                      const bool is_realtime_add_enabled = false,
                      const bool is_realtime_add_trip_enabled = false);
+
+/// An entity of a realtime feed, with the timestamp of the feed
+struct FeedEntityRef {
+    const transit_realtime::FeedEntity* entity;
+    boost::posix_time::ptime timestamp;
+};
+
+/**
+ * Reduces the entities of a batch of feeds to the ones that change the data.
+ *
+ * The entities of an id (a disruption or a trip update) replace each other, so only the
+ * last one of each id matters, and a deletion or a chaos disruption makes the previous ones
+ * useless.  As a trip update can be ignored, the previous updates of the id are kept
+ * after it, to apply the newest one that is not ignored.
+ *
+ * Returns the entities by id, oldest first, the ids in the order of their last entity.
+ */
+std::vector<std::vector<FeedEntityRef>> coalesce_feed_entities(
+    const std::vector<transit_realtime::FeedMessage>& feeds);
+
 }  // namespace navitia
@@ -0,0 +1,164 @@
+/* Copyright © 2001-2018, Canal TP and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+channel `#navitia` on riot https://riot.im/app/#/room/#navitia:matrix.org
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#include "response_cache.h"
+
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <boost/optional.hpp>
+
+#include <algorithm>
+#include <chrono>
+
+namespace pt = boost::posix_time;
+
+namespace navitia {
+
+ResponseCache::ResponseCache(const bool coalescing, const pt::time_duration& ttl, const size_t max_bytes)
+    : coalescing(coalescing), ttl(ttl), max_bytes(max_bytes) {}
+
+std::string ResponseCache::fingerprint(const pbnavitia::Request& request) {
+    pbnavitia::Request copy(request);
+    copy.clear_request_id();
+    copy.clear_deadline();
+    return copy.SerializeAsString();
+}
+
+ResponseCache::Bytes ResponseCache::get(const std::string& fingerprint,
+                                        const size_t data_identifier,
+                                        const std::function<Bytes(bool& cacheable)>& compute,
+                                        Outcome& outcome,
+                                        const pt::ptime& deadline) {
+    bool cacheable = true;
+    outcome = Outcome::computed;
+    if (!is_enabled()) {
+        return compute(cacheable);
+    }
+
+    const std::string key = std::to_string(data_identifier) + "/" + fingerprint;
+    boost::optional<std::shared_future<Bytes>> identical_request;
+    std::promise<Bytes> promise;
+    bool is_leader = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (auto bytes = find(key, pt::microsec_clock::universal_time())) {
+            outcome = Outcome::cached;
+            return bytes;
+        }
+        if (coalescing) {
+            const auto it = in_flight.find(key);
+            if (it != in_flight.end()) {
+                identical_request = it->second;
+            } else {
+                in_flight.emplace(key, promise.get_future().share());
+                is_leader = true;
+            }
+        }
+    }
+
+    if (identical_request) {
+        if (!deadline.is_not_a_date_time()) {
+            const auto remaining = deadline - pt::microsec_clock::universal_time();
+            const auto timeout = std::chrono::microseconds(std::max<int64_t>(0, remaining.total_microseconds()));
+            if (identical_request->wait_for(timeout) != std::future_status::ready) {
+                // the request is computed to answer its expired deadline
+                return compute(cacheable);
+            }
+        }
+        // a response that can't be shared is null, the request is then computed again
+        if (auto bytes = identical_request->get()) {
+            outcome = Outcome::coalesced;
+            return bytes;
+        }
+        return compute(cacheable);
+    }
+
+    Bytes bytes;
+    try {
+        bytes = compute(cacheable);
+    } catch (...) {
+        if (is_leader) {
+            std::lock_guard<std::mutex> lock(mutex);
+            in_flight.erase(key);
+            promise.set_value(nullptr);
+        }
+        throw;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (is_leader) {
+            in_flight.erase(key);
+        }
+        if (cacheable && ttl > pt::seconds(0)) {
+            insert(key, bytes, pt::microsec_clock::universal_time());
+        }
+    }
+    if (is_leader) {
+        promise.set_value(cacheable ? bytes : nullptr);
+    }
+    return bytes;
+}
+
+ResponseCache::Bytes ResponseCache::find(const std::string& key, const pt::ptime& now) {
+    const auto it = entries_by_key.find(key);
+    if (it == entries_by_key.end()) {
+        return nullptr;
+    }
+    if (it->second->expiration <= now) {
+        erase(it->second);
+        return nullptr;
+    }
+    entries.splice(entries.begin(), entries, it->second);
+    return it->second->bytes;
+}
+
+void ResponseCache::insert(const std::string& key, const Bytes& bytes, const pt::ptime& now) {
+    const size_t size = key.size() + bytes->size();
+    if (size > max_bytes) {
+        return;
+    }
+    const auto it = entries_by_key.find(key);
+    if (it != entries_by_key.end()) {
+        erase(it->second);
+    }
+    entries.push_front({key, bytes, now + ttl});
+    entries_by_key[key] = entries.begin();
+    nb_bytes += size;
+    while (nb_bytes > max_bytes) {
+        erase(std::prev(entries.end()));
+    }
+}
+
+void ResponseCache::erase(const std::list<Entry>::iterator it) {
+    nb_bytes -= it->key.size() + it->bytes->size();
+    entries_by_key.erase(it->key);
+    entries.erase(it);
+}
+
+}  // namespace navitia
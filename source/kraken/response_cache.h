@@ -0,0 +1,104 @@
+/* Copyright © 2001-2018, Canal TP and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+channel `#navitia` on riot https://riot.im/app/#/room/#navitia:matrix.org
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#pragma once
+
+#include "type/request.pb.h"
+
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <boost/utility.hpp>
+
+#include <functional>
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace navitia {
+
+/*
+ * Share the responses of identical requests between the workers.
+ *
+ * The retries and the pollings send the same requests within a few seconds: a request
+ * received while an identical one is being computed waits for its response instead of
+ * computing it again, and, if a ttl is set, the responses are kept in a cache bounded in
+ * bytes.  The requests are identified by their fingerprint and the identifier of the data
+ * they are computed on.
+ */
+class ResponseCache : boost::noncopyable {
+public:
+    using Bytes = std::shared_ptr<const std::string>;
+    enum class Outcome { computed, coalesced, cached };
+
+    ResponseCache(bool coalescing, const boost::posix_time::time_duration& ttl, size_t max_bytes);
+
+    bool is_enabled() const { return coalescing || ttl > boost::posix_time::seconds(0); }
+
+    /// The serialized request, without the fields identifying the call (id, deadline)
+    static std::string fingerprint(const pbnavitia::Request& request);
+
+    /*
+     * The serialized response of the request: from the cache, from an identical request
+     * being computed, or computed by compute.  compute sets its cacheable argument to false
+     * when its response must not be shared, as for an expired deadline.
+     * The response of an identical request is awaited until the deadline of the request (if
+     * it isn't not_a_date_time), the request being computed once it is expired.
+     */
+    Bytes get(const std::string& fingerprint,
+              size_t data_identifier,
+              const std::function<Bytes(bool& cacheable)>& compute,
+              Outcome& outcome,
+              const boost::posix_time::ptime& deadline = boost::posix_time::not_a_date_time);
+
+private:
+    struct Entry {
+        std::string key;
+        Bytes bytes;
+        boost::posix_time::ptime expiration;
+    };
+
+    const bool coalescing;
+    const boost::posix_time::time_duration ttl;
+    const size_t max_bytes;
+
+    std::mutex mutex;
+    std::unordered_map<std::string, std::shared_future<Bytes>> in_flight;
+    std::list<Entry> entries;  // the most recently used first
+    std::unordered_map<std::string, std::list<Entry>::iterator> entries_by_key;
+    size_t nb_bytes = 0;
+
+    Bytes find(const std::string& key, const boost::posix_time::ptime& now);
+    void insert(const std::string& key, const Bytes& bytes, const boost::posix_time::ptime& now);
+    void erase(std::list<Entry>::iterator it);
+};
+
+}  // namespace navitia
@@ -35,6 +35,7 @@ www.navitia.io
 
 #include <boost/test/unit_test.hpp>
 #include <atomic>
+#include <vector>
 
 namespace test {
 
@@ -62,6 +63,13 @@ bool Data::load_status = true;
 bool Data::last_load_succeeded = true;
 bool Data::destructor_called = false;
 
+// a topology of nodes sharing the first cpu
+navitia::numa::Topology make_topology(const size_t nb_nodes) {
+    navitia::numa::Topology topology;
+    topology.cpus_by_node.assign(nb_nodes, {0});
+    return topology;
+}
+
 }  // namespace test
 
 struct fixture {
@@ -123,4 +131,130 @@ BOOST_AUTO_TEST_CASE(destructor_not_called) {
     BOOST_CHECK(data_manager.get_data());
 }
 
+BOOST_AUTO_TEST_CASE(replicas) {
+    DataManager<test::Data> data_manager;
+    std::vector<size_t> replicated_nodes;
+    data_manager.enable_replicas(test::make_topology(2), [&](const test::Data& data, const test::Data* previous) {
+        // built on a thread of the node
+        replicated_nodes.push_back(navitia::numa::current_node());
+        BOOST_CHECK(!previous);
+        return boost::shared_ptr<const test::Data>(new test::Data(data.data_identifier));
+    });
+    const auto primary = data_manager.get_data();
+
+    // nothing is replicated until asked
+    navitia::numa::current_node() = 1;
+    BOOST_CHECK_EQUAL(data_manager.get_data(), primary);
+
+    data_manager.replicate();
+    BOOST_CHECK(replicated_nodes == std::vector<size_t>{1});
+    const auto replica = data_manager.get_data();
+    BOOST_CHECK_NE(replica, primary);
+    BOOST_CHECK_EQUAL(replica->data_identifier, primary->data_identifier);
+    navitia::numa::current_node() = 0;
+    BOOST_CHECK_EQUAL(data_manager.get_data(), primary);
+
+    // the flags are set on every copy
+    data_manager.for_each_data([](const test::Data& data) { data.is_connected_to_rabbitmq = true; });
+    BOOST_CHECK(primary->is_connected_to_rabbitmq);
+    BOOST_CHECK(replica->is_connected_to_rabbitmq);
+
+    // each node is visited on one of its threads with its data
+    std::vector<const test::Data*> visited;
+    data_manager.for_each_node([&](const test::Data& data) {
+        BOOST_CHECK_EQUAL(&data, (navitia::numa::current_node() == 0 ? primary : replica).get());
+        visited.push_back(&data);
+    });
+    BOOST_CHECK(visited == (std::vector<const test::Data*>{primary.get(), replica.get()}));
+
+    // a new data drops the replicas of the previous one
+    data_manager.set_data(new test::Data(42));
+    navitia::numa::current_node() = 1;
+    BOOST_CHECK_EQUAL(data_manager.get_data()->data_identifier, 42);
+    navitia::numa::current_node() = 0;
+}
+
+BOOST_AUTO_TEST_CASE(replicas_single_node) {
+    DataManager<test::Data> data_manager;
+    data_manager.enable_replicas(test::make_topology(1), [](const test::Data&,
+                                                            const test::Data*) -> boost::shared_ptr<const test::Data> {
+        BOOST_FAIL("no replica with a single node");
+        return {};
+    });
+    data_manager.replicate();
+    navitia::numa::current_node() = 1;
+    BOOST_CHECK_EQUAL(data_manager.get_data(), data_manager.get_data());
+    navitia::numa::current_node() = 0;
+}
+
+BOOST_AUTO_TEST_CASE(replicas_of_a_replaced_data_are_not_published) {
+    DataManager<test::Data> data_manager;
+    bool replace = true;
+    data_manager.enable_replicas(test::make_topology(2), [&](const test::Data& data, const test::Data*) {
+        if (replace) {
+            // a new data is loaded while replicating the previous one
+            data_manager.set_data(new test::Data(42));
+        }
+        return boost::shared_ptr<const test::Data>(new test::Data(data.data_identifier));
+    });
+    data_manager.replicate();
+    navitia::numa::current_node() = 1;
+    BOOST_CHECK_EQUAL(data_manager.get_data()->data_identifier, 42);
+
+    // nor the cancelled ones
+    replace = false;
+    data_manager.replicate([] { return true; });
+    const auto data_of_node_1 = data_manager.get_data();
+    navitia::numa::current_node() = 0;
+    BOOST_CHECK_EQUAL(data_of_node_1, data_manager.get_data());
+}
+
+BOOST_AUTO_TEST_CASE(replicas_of_an_updated_data) {
+    DataManager<test::Data> data_manager;
+    std::vector<const test::Data*> previous_replicas;
+    bool update = false;
+    data_manager.enable_replicas(test::make_topology(3), [&](const test::Data& data, const test::Data* previous) {
+        previous_replicas.push_back(previous);
+        if (update) {
+            // a realtime update while replicating doesn't stop the replication
+            update = false;
+            data_manager.update_data(boost::make_shared<const test::Data>(43));
+        }
+        return boost::shared_ptr<const test::Data>(new test::Data(data.data_identifier));
+    });
+    data_manager.set_data(new test::Data(41));
+    data_manager.replicate();
+    navitia::numa::current_node() = 1;
+    const auto replica_1 = data_manager.get_data();
+    navitia::numa::current_node() = 2;
+    const auto replica_2 = data_manager.get_data();
+    BOOST_CHECK_EQUAL(replica_1->data_identifier, 41);
+    BOOST_CHECK_EQUAL(replica_2->data_identifier, 41);
+    BOOST_CHECK(previous_replicas == (std::vector<const test::Data*>{nullptr, nullptr}));
+
+    // the other nodes read their copy of the previous version until the new one is replicated
+    data_manager.update_data(boost::make_shared<const test::Data>(42));
+    BOOST_CHECK_EQUAL(data_manager.get_data(), replica_2);
+    navitia::numa::current_node() = 0;
+    BOOST_CHECK_EQUAL(data_manager.get_data()->data_identifier, 42);
+
+    // the new copies are made from the previous ones, and published even if the data is updated meanwhile
+    previous_replicas.clear();
+    update = true;
+    data_manager.replicate();
+    BOOST_CHECK(previous_replicas == (std::vector<const test::Data*>{replica_1.get(), replica_2.get()}));
+    navitia::numa::current_node() = 1;
+    BOOST_CHECK_EQUAL(data_manager.get_data()->data_identifier, 42);
+    navitia::numa::current_node() = 2;
+    BOOST_CHECK_EQUAL(data_manager.get_data()->data_identifier, 43);
+
+    // the flags are set on the current data and on every copy
+    data_manager.for_each_data([](const test::Data& data) { data.is_connected_to_rabbitmq = true; });
+    BOOST_CHECK(data_manager.get_data()->is_connected_to_rabbitmq);
+    navitia::numa::current_node() = 1;
+    BOOST_CHECK(data_manager.get_data()->is_connected_to_rabbitmq);
+    navitia::numa::current_node() = 0;
+    BOOST_CHECK(data_manager.get_data()->is_connected_to_rabbitmq);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,99 @@
+/* Copyright © 2001-2014, Canal TP and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+channel `#navitia` on riot https://riot.im/app/#/room/#navitia:matrix.org
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE numa_test
+
+#include "kraken/numa.h"
+
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <fstream>
+#include <map>
+
+namespace fs = boost::filesystem;
+using navitia::numa::Topology;
+
+namespace {
+
+// a sysfs node directory, with a cpulist by node
+struct SimulatedTopology {
+    fs::path dir = fs::temp_directory_path() / fs::unique_path();
+
+    explicit SimulatedTopology(const std::map<std::string, std::string>& cpulist_by_node) {
+        for (const auto& node_cpulist : cpulist_by_node) {
+            fs::create_directories(dir / node_cpulist.first);
+            std::ofstream(((dir / node_cpulist.first) / "cpulist").string()) << node_cpulist.second << "\n";
+        }
+        // not a node
+        std::ofstream((dir / "possible").string()) << "0-3\n";
+    }
+    ~SimulatedTopology() { fs::remove_all(dir); }
+};
+
+void check_cpus(const std::vector<int>& cpus, const std::vector<int>& expected) {
+    BOOST_CHECK_EQUAL_COLLECTIONS(cpus.begin(), cpus.end(), expected.begin(), expected.end());
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(parse_cpu_list_test) {
+    check_cpus(navitia::numa::parse_cpu_list("0-3,8,10-11\n"), {0, 1, 2, 3, 8, 10, 11});
+    BOOST_CHECK(navitia::numa::parse_cpu_list("").empty());
+}
+
+BOOST_AUTO_TEST_CASE(detect_two_nodes) {
+    // the nodes are ordered by number, and the nodes without cpu are ignored
+    SimulatedTopology simulated({{"node10", "6-7"}, {"node1", "2-3"}, {"node0", "0-1"}, {"node2", ""}});
+    const auto topology = Topology::detect(simulated.dir.string());
+    BOOST_REQUIRE_EQUAL(topology.nb_nodes(), 3);
+    check_cpus(topology.cpus_by_node[0], {0, 1});
+    check_cpus(topology.cpus_by_node[1], {2, 3});
+    check_cpus(topology.cpus_by_node[2], {6, 7});
+}
+
+BOOST_AUTO_TEST_CASE(detect_without_nodes) {
+    // as on a kernel without numa support
+    const auto topology = Topology::detect((fs::temp_directory_path() / fs::unique_path()).string());
+    BOOST_REQUIRE_EQUAL(topology.nb_nodes(), 1);
+    BOOST_CHECK(!topology.cpus_by_node[0].empty());
+}
+
+BOOST_AUTO_TEST_CASE(run_on_node_sets_the_node) {
+    Topology topology;
+    topology.cpus_by_node = {{0}, {0}};
+    size_t node = 0;
+    navitia::numa::run_on_node(topology, 1, [&] { node = navitia::numa::current_node(); });
+    BOOST_CHECK_EQUAL(node, 1);
+    BOOST_CHECK_EQUAL(navitia::numa::current_node(), 0);
+    BOOST_CHECK_THROW(navitia::numa::run_on_node(topology, 0, [] { throw std::runtime_error("error"); }),
+                      std::runtime_error);
+}
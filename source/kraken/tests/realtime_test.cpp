@@ -31,6 +31,7 @@ www.navitia.io
 #define BOOST_TEST_DYN_LINK
 #define BOOST_TEST_MODULE test_realtime
 #include <boost/test/unit_test.hpp>
+#include "type/chaos.pb.h"
 #include "type/gtfs-realtime.pb.h"
 #include "type/pt_data.h"
 #include "type/kirin.pb.h"
@@ -41,6 +42,7 @@ www.navitia.io
 #include "routing/raptor_api.h"
 #include "kraken/apply_disruption.h"
 #include "disruption/traffic_reports_api.h"
+#include "type/nav_delta.h"
 #include "type/pb_converter.h"
 
 struct logger_initialized {
@@ -3508,3 +3510,245 @@ BOOST_FIXTURE_TEST_CASE(cannot_add_new_trip_if_id_corresponds_to_a_base_VJ_the_s
     BOOST_CHECK_EQUAL(res.response_type(), pbnavitia::NO_SOLUTION);
     BOOST_CHECK_EQUAL(res.impacts_size(), 0);
 }
+
+static void add_trip_update(tr::FeedMessage& feed, const std::string& id, const std::string& trip_id) {
+    auto* entity = feed.add_entity();
+    entity->set_id(id);
+    *entity->mutable_trip_update() = make_cancellation_message(trip_id, "20150928");
+}
+
+BOOST_AUTO_TEST_CASE(coalesce_feed_entities_by_id) {
+    std::vector<tr::FeedMessage> feeds(3);
+    for (size_t f = 0; f < feeds.size(); ++f) {
+        feeds[f].mutable_header()->set_timestamp(navitia::to_posix_timestamp(timestamp) + f);
+    }
+    add_trip_update(feeds[0], "A", "vj:a");
+    add_trip_update(feeds[0], "B", "vj:b");
+    auto* chaos_entity = feeds[0].add_entity();
+    chaos_entity->set_id("C");
+    chaos_entity->MutableExtension(chaos::disruption)->set_id("C");
+
+    add_trip_update(feeds[1], "A", "vj:a");
+    auto* deletion = feeds[1].add_entity();
+    deletion->set_id("C");
+    deletion->set_is_deleted(true);
+
+    add_trip_update(feeds[2], "A", "vj:a");
+    deletion = feeds[2].add_entity();
+    deletion->set_id("B");
+    deletion->set_is_deleted(true);
+    add_trip_update(feeds[2], "B", "vj:b");
+
+    const auto entities_by_id = navitia::coalesce_feed_entities(feeds);
+    // in the order of the last entity of each id
+    BOOST_REQUIRE_EQUAL(entities_by_id.size(), 3);
+
+    // the deletion replaces the chaos disruption
+    BOOST_REQUIRE_EQUAL(entities_by_id[0].size(), 1);
+    BOOST_CHECK(entities_by_id[0][0].entity == &feeds[1].entity(1));
+
+    // the trip updates are kept, the newest one being the last
+    BOOST_REQUIRE_EQUAL(entities_by_id[1].size(), 3);
+    for (size_t f = 0; f < feeds.size(); ++f) {
+        BOOST_CHECK(entities_by_id[1][f].entity == &feeds[f].entity(0));
+        BOOST_CHECK_EQUAL(entities_by_id[1][f].timestamp, timestamp + pt::seconds(f));
+    }
+
+    // the trip update before the deletion is useless
+    BOOST_REQUIRE_EQUAL(entities_by_id[2].size(), 2);
+    BOOST_CHECK(entities_by_id[2][0].entity->is_deleted());
+    BOOST_CHECK(entities_by_id[2][1].entity == &feeds[2].entity(2));
+}
+
+BOOST_AUTO_TEST_CASE(ignored_trip_update) {
+    ed::builder b("20150928");
+    b.vj("A", "000001", "", true, "vj:1")("stop1", "08:00"_t)("stop2", "09:00"_t);
+    b.data->build_uri();
+
+    // an unknown trip can't be cancelled, the caller falls back on a previous update
+    BOOST_CHECK(!navitia::handle_realtime(feed_id, timestamp, make_cancellation_message("vj:unknown", "20150928"),
+                                          *b.data, true, true));
+    BOOST_CHECK(navitia::handle_realtime(feed_id, timestamp, make_cancellation_message("vj:1", "20150928"), *b.data,
+                                         true, true));
+}
+
+template <typename Set>
+static std::set<std::string> uris(const Set& objects) {
+    std::set<std::string> res;
+    for (const auto* obj : objects) {
+        res.insert(obj ? obj->uri : "");
+    }
+    return res;
+}
+
+static void check_same_relations(const nt::Data& data, const nt::Data& expected) {
+    for (const auto* route : expected.pt_data->routes) {
+        const auto* other = data.pt_data->routes_map.at(route->uri);
+        BOOST_CHECK(uris(other->stop_point_list) == uris(route->stop_point_list));
+        BOOST_CHECK(uris(other->stop_area_list) == uris(route->stop_area_list));
+    }
+    for (const auto* sp : expected.pt_data->stop_points) {
+        BOOST_CHECK(uris(data.pt_data->stop_points_map.at(sp->uri)->route_list) == uris(sp->route_list));
+    }
+    for (const auto* sa : expected.pt_data->stop_areas) {
+        BOOST_CHECK(uris(data.pt_data->stop_areas_map.at(sa->uri)->route_list) == uris(sa->route_list));
+    }
+    for (const auto* dataset : expected.pt_data->datasets) {
+        BOOST_CHECK(uris(data.pt_data->datasets_map.at(dataset->uri)->vehiclejourney_list)
+                    == uris(dataset->vehiclejourney_list));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(rebuild_relations_of_changes) {
+    ed::builder b("20150928");
+    b.vj("A", "000001", "", true, "vj:1")("stop1", "08:01"_t)("stop2", "09:01"_t)("stop3", "10:01"_t);
+    b.vj("B", "000001", "", true, "vj:2")("stop3", "08:01"_t)("stop4", "09:01"_t);
+    b.make();
+
+    const auto trip_update_1 = ntest::make_trip_update_message(
+        "vj:1", "20150928",
+        {RTStopTime("stop1", "20150928T0810"_pts).delay(9_min), RTStopTime("stop2", "20150928T0910"_pts).delay(9_min),
+         RTStopTime("stop3", "20150928T1010"_pts).delay(9_min)});
+    const auto trip_update_2 = ntest::make_trip_update_message(
+        "vj:1", "20150928",
+        {RTStopTime("stop1", "20150928T0830"_pts).delay(29_min),
+         RTStopTime("stop2", "20150928T0930"_pts).delay(29_min),
+         RTStopTime("stop3", "20150928T1030"_pts).delay(29_min)});
+
+    // the reference: all the relations are built again after the updates
+    nt::Data expected;
+    expected.clone_from(*b.data);
+    navitia::handle_realtime(feed_id, timestamp, trip_update_1, expected, true, true);
+    navitia::handle_realtime(feed_id, timestamp, trip_update_2, expected, true, true);
+    expected.build_relations();
+
+    nt::Data data;
+    data.clone_from(*b.data);
+    data.copy_relations_from(*b.data);
+    data.pt_data->changes.start();
+    navitia::handle_realtime(feed_id, timestamp, trip_update_1, data, true, true);
+    navitia::handle_realtime(feed_id, timestamp, trip_update_2, data, true, true);
+
+    const auto& changes = data.pt_data->changes;
+    // the vj of the first update has been replaced by the one of the second
+    BOOST_REQUIRE_EQUAL(changes.vehicle_journeys.size(), 1);
+    BOOST_CHECK((*changes.vehicle_journeys.begin())->realtime_level == nt::RTLevel::RealTime);
+    BOOST_CHECK_EQUAL(changes.routes.size(), 1);
+    BOOST_CHECK(!changes.pt_objects_created);
+    // the disruption of the first update has been deleted
+    BOOST_CHECK_EQUAL(changes.objects_with_deleted_impacts.size(), 1);
+    BOOST_CHECK(changes.objects_with_deleted_impacts.count(data.pt_data->meta_vjs.get_mut("vj:1")));
+    BOOST_CHECK(!changes.unknown_objects_with_deleted_impacts);
+
+    data.build_relations_of_changes();
+    data.pt_data->clean_weak_impacts_of_changes();
+    check_same_relations(data, expected);
+
+    // nothing is tracked on the base data
+    BOOST_CHECK(!b.data->pt_data->changes.is_tracking);
+    BOOST_CHECK(b.data->pt_data->changes.vehicle_journeys.empty());
+}
+
+BOOST_AUTO_TEST_CASE(rebuild_proximity_lists_of_changes) {
+    ed::builder b("20150928");
+    b.vj("A", "000001", "", true, "vj:1")("stop1", "08:01"_t)("stop2", "09:01"_t);
+    const nt::GeographicalCoord coord1 = {2.35, 48.85};
+    const nt::GeographicalCoord coord2 = {2.40, 48.85};
+    b.sps["stop1"]->coord = coord1;
+    b.sps["stop2"]->coord = coord2;
+    b.make();
+    b.data->build_proximity_list();
+
+    const auto trip_update = ntest::make_trip_update_message(
+        "vj:1", "20150928",
+        {RTStopTime("stop1", "20150928T0810"_pts).delay(9_min), RTStopTime("stop2", "20150928T0910"_pts).delay(9_min)});
+    const auto nb_stop_points_within = [](const nt::Data& data, const nt::GeographicalCoord& coord) {
+        return data.pt_data->stop_point_proximity_list.find_within(coord, 100).size();
+    };
+
+    // the stop points are not changed by the realtime, their lists are taken from the base data
+    nt::Data data;
+    data.clone_from(*b.data);
+    data.copy_relations_from(*b.data);
+    data.pt_data->changes.start();
+    navitia::handle_realtime(feed_id, timestamp, trip_update, data, true, true);
+    BOOST_CHECK(!data.pt_data->changes.stop_points_changed);
+    data.build_proximity_lists_of_changes(*b.data);
+    BOOST_CHECK_EQUAL(nb_stop_points_within(data, coord1), 1);
+    BOOST_CHECK_EQUAL(nb_stop_points_within(data, coord2), 1);
+
+    // a moved stop point is found at its new place
+    nt::Data moved;
+    moved.clone_from(*b.data);
+    moved.copy_relations_from(*b.data);
+    moved.pt_data->changes.start();
+    moved.pt_data->stop_points_map.at("stop2")->coord = coord1;
+    moved.pt_data->changes.add_stop_point();
+    moved.build_proximity_lists_of_changes(*b.data);
+    BOOST_CHECK_EQUAL(nb_stop_points_within(moved, coord1), 2);
+    BOOST_CHECK_EQUAL(nb_stop_points_within(moved, coord2), 0);
+}
+
+BOOST_AUTO_TEST_CASE(applied_delta_gives_the_journeys_of_the_target) {
+    ed::builder base("20150928");
+    base.vj("A", "111111", "", true, "vj:1")("stop1", "08:00"_t)("stop2", "09:00"_t);
+    base.vj("B", "111111", "", true, "vj:2")("stop2", "09:30"_t)("stop3", "10:00"_t);
+    base.vj("B", "111111", "", true, "vj:3")("stop2", "11:00"_t)("stop3", "11:30"_t);
+    base.make();
+
+    ed::builder target("20150928");
+    target.vj("A", "111111", "", true, "vj:1")("stop1", "08:00"_t)("stop2", "08:45"_t);
+    target.vj("B", "111111", "", true, "vj:2")("stop2", "09:30"_t)("stop3", "10:00"_t);
+    target.vj("B", "011111", "", true, "vj:4")("stop2", "08:50"_t)("stop3", "09:10"_t);
+    target.make();
+
+    const auto delta = nt::make_nav_delta(*base.data, *target.data);
+    BOOST_REQUIRE(delta);
+
+    // as the maintenance worker does
+    nt::Data data;
+    data.clone_from(*base.data);
+    data.copy_relations_from(*base.data);
+    data.pt_data->changes.start();
+    nt::apply_nav_delta(*delta, data);
+    data.build_relations_of_changes();
+    data.pt_data->clean_weak_impacts_of_changes();
+    data.build_raptor();
+
+    navitia::routing::RAPTOR raptor(data);
+    navitia::routing::RAPTOR target_raptor(*target.data);
+    const auto compute = [](navitia::routing::RAPTOR& raptor, const std::string& from, const std::string& to,
+                            uint32_t hour, int day) {
+        const auto& stop_areas = raptor.data.pt_data->stop_areas_map;
+        return raptor.compute(stop_areas.at(from), stop_areas.at(to), hour, day, navitia::DateTimeUtils::inf,
+                              nt::RTLevel::Base, 2_min, true);
+    };
+    const std::vector<std::pair<std::string, std::string>> ods = {
+        {"stop1", "stop2"}, {"stop1", "stop3"}, {"stop2", "stop3"}};
+    for (const auto& od : ods) {
+        for (const int day : {0, 1}) {
+            for (const auto hour : {"07:00"_t, "08:55"_t, "10:30"_t}) {
+                const auto paths = compute(raptor, od.first, od.second, hour, day);
+                const auto target_paths = compute(target_raptor, od.first, od.second, hour, day);
+                BOOST_REQUIRE_EQUAL(paths.size(), target_paths.size());
+                for (size_t i = 0; i < paths.size(); ++i) {
+                    BOOST_CHECK_EQUAL(paths[i].nb_changes, target_paths[i].nb_changes);
+                    BOOST_REQUIRE_EQUAL(paths[i].items.size(), target_paths[i].items.size());
+                    for (size_t j = 0; j < paths[i].items.size(); ++j) {
+                        const auto& item = paths[i].items[j];
+                        const auto& target_item = target_paths[i].items[j];
+                        BOOST_CHECK_EQUAL(item.departure, target_item.departure);
+                        BOOST_CHECK_EQUAL(item.arrival, target_item.arrival);
+                        const auto* vj = item.get_vj();
+                        const auto* target_vj = target_item.get_vj();
+                        BOOST_CHECK_EQUAL(vj ? vj->uri : "", target_vj ? target_vj->uri : "");
+                    }
+                }
+            }
+        }
+    }
+
+    const auto no_delta = nt::make_nav_delta(data, *target.data);
+    BOOST_REQUIRE(no_delta);
+    BOOST_CHECK(no_delta->empty());
+}
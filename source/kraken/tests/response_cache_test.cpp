@@ -0,0 +1,197 @@
+/* Copyright © 2001-2014, Canal TP and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+channel `#navitia` on riot https://riot.im/app/#/room/#navitia:matrix.org
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE response_cache_test
+
+#include "kraken/response_cache.h"
+
+#include <boost/test/unit_test.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+using navitia::ResponseCache;
+namespace pt = boost::posix_time;
+
+namespace {
+
+pbnavitia::Request make_request(const std::string& id, const std::string& uri) {
+    pbnavitia::Request request;
+    request.set_requested_api(pbnavitia::place_uri);
+    request.set_request_id(id);
+    request.set_deadline("20200101T000000");
+    request.mutable_place_uri()->set_uri(uri);
+    return request;
+}
+
+ResponseCache::Bytes make_bytes(const std::string& s) {
+    return std::make_shared<const std::string>(s);
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(fingerprint_ignores_the_call_fields) {
+    BOOST_CHECK_EQUAL(ResponseCache::fingerprint(make_request("id1", "stop_area:A")),
+                      ResponseCache::fingerprint(make_request("id2", "stop_area:A")));
+    BOOST_CHECK_NE(ResponseCache::fingerprint(make_request("id1", "stop_area:A")),
+                   ResponseCache::fingerprint(make_request("id1", "stop_area:B")));
+}
+
+BOOST_AUTO_TEST_CASE(disabled_cache_always_computes) {
+    ResponseCache cache(false, pt::seconds(0), 1000);
+    BOOST_CHECK(!cache.is_enabled());
+    int nb_computed = 0;
+    ResponseCache::Outcome outcome;
+    for (int i = 0; i < 2; ++i) {
+        cache.get("key", 0,
+                  [&](bool&) {
+                      ++nb_computed;
+                      return make_bytes("response");
+                  },
+                  outcome);
+        BOOST_CHECK(outcome == ResponseCache::Outcome::computed);
+    }
+    BOOST_CHECK_EQUAL(nb_computed, 2);
+}
+
+BOOST_AUTO_TEST_CASE(ttl_cache) {
+    ResponseCache cache(false, pt::seconds(60), 30);
+    int nb_computed = 0;
+    ResponseCache::Outcome outcome;
+    const auto get = [&](const std::string& key, const size_t data_identifier, const bool cacheable) {
+        return cache.get(key, data_identifier,
+                         [&](bool& c) {
+                             ++nb_computed;
+                             c = cacheable;
+                             return make_bytes("response " + key);
+                         },
+                         outcome);
+    };
+
+    BOOST_CHECK_EQUAL(*get("a", 0, true), "response a");
+    BOOST_CHECK(outcome == ResponseCache::Outcome::computed);
+    BOOST_CHECK_EQUAL(*get("a", 0, true), "response a");
+    BOOST_CHECK(outcome == ResponseCache::Outcome::cached);
+    BOOST_CHECK_EQUAL(nb_computed, 1);
+
+    // another data
+    get("a", 1, true);
+    BOOST_CHECK(outcome == ResponseCache::Outcome::computed);
+
+    // the responses that can't be shared are not kept
+    get("b", 0, false);
+    get("b", 0, false);
+    BOOST_CHECK(outcome == ResponseCache::Outcome::computed);
+    BOOST_CHECK_EQUAL(nb_computed, 4);
+
+    // at most 30 bytes, "a" is evicted by "c" as the least recently used
+    get("c", 0, true);
+    get("a", 0, true);
+    BOOST_CHECK(outcome == ResponseCache::Outcome::computed);
+}
+
+BOOST_AUTO_TEST_CASE(identical_requests_are_coalesced) {
+    ResponseCache cache(true, pt::seconds(0), 1000);
+    std::atomic<int> nb_computed{0};
+    std::atomic<bool> release{false};
+    std::atomic<int> nb_coalesced{0};
+
+    const auto request = [&]() {
+        ResponseCache::Outcome outcome;
+        const auto bytes = cache.get("key", 0,
+                                     [&](bool&) {
+                                         ++nb_computed;
+                                         while (!release) {
+                                             std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                                         }
+                                         return make_bytes("response");
+                                     },
+                                     outcome);
+        BOOST_CHECK_EQUAL(*bytes, "response");
+        if (outcome == ResponseCache::Outcome::coalesced) {
+            ++nb_coalesced;
+        }
+    };
+    std::thread leader(request);
+    while (nb_computed == 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    std::vector<std::thread> followers;
+    for (int i = 0; i < 3; ++i) {
+        followers.emplace_back(request);
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    release = true;
+    leader.join();
+    for (auto& follower : followers) {
+        follower.join();
+    }
+    BOOST_CHECK_EQUAL(nb_computed, 1);
+    BOOST_CHECK_EQUAL(nb_coalesced, 3);
+}
+
+BOOST_AUTO_TEST_CASE(identical_requests_wait_until_their_deadline) {
+    ResponseCache cache(true, pt::seconds(0), 1000);
+    std::atomic<int> nb_computed{0};
+    std::atomic<bool> release{false};
+
+    std::thread leader([&]() {
+        ResponseCache::Outcome outcome;
+        cache.get("key", 0,
+                  [&](bool&) {
+                      ++nb_computed;
+                      while (!release) {
+                          std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                      }
+                      return make_bytes("response");
+                  },
+                  outcome);
+    });
+    while (nb_computed == 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    // the leader is still computing at the deadline of the follower, which answers by itself
+    ResponseCache::Outcome outcome;
+    const auto bytes = cache.get("key", 0,
+                                 [&](bool& cacheable) {
+                                     ++nb_computed;
+                                     cacheable = false;
+                                     return make_bytes("deadline expired");
+                                 },
+                                 outcome, pt::microsec_clock::universal_time() + pt::milliseconds(20));
+    BOOST_CHECK_EQUAL(*bytes, "deadline expired");
+    BOOST_CHECK(outcome == ResponseCache::Outcome::computed);
+    release = true;
+    leader.join();
+    BOOST_CHECK_EQUAL(nb_computed, 2);
+}
@@ -379,6 +379,9 @@ void Worker::init_worker_data(const navitia::type::Data* data,
     //@TODO should be done in data_manager
     if (data->data_identifier != this->last_data_identifier || !planner) {
         planner = std::make_unique<routing::RAPTOR>(*data);
+        if (conf.raptor_multi_target_second_pass()) {
+            planner->snd_phase_mode = routing::RAPTOR::SndPhaseMode::MultiTarget;
+        }
         street_network_worker = std::make_unique<georef::StreetNetwork>(*data->geo_ref);
         this->last_data_identifier = data->data_identifier;
         LOG4CPLUS_INFO(logger, "Instanciate planner");
@@ -872,6 +875,16 @@ void Worker::graphical_isochrone(const pbnavitia::GraphicalIsochroneRequest& req
     const auto end_mode_iso = request_journey.clockwise() ? sn.destination_mode() : sn.origin_mode();
     const auto end_mode = type::static_data::get()->modeByCaption(end_mode_iso);
     const double end_speed = get_speed(sn, end_mode);
+    if (request_journey.datetimes_size() > 1) {
+        // one isochrone by datetime, computed together
+        const std::vector<uint64_t> datetimes(request_journey.datetimes().begin(), request_journey.datetimes().end());
+        navitia::routing::make_graphical_isochrones(
+            this->pb_creator, *planner, center_and_stop_points.first, datetimes, boundary_duration,
+            request_journey.max_transfers(), arg.accessibilite_params, arg.forbidden, arg.allowed,
+            request_journey.clockwise(), arg.rt_level, *street_network_worker, end_speed,
+            center_and_stop_points.second);
+        return;
+    }
     navitia::routing::make_graphical_isochrone(
         this->pb_creator, *planner, center_and_stop_points.first, request_journey.datetimes(0), boundary_duration,
         request_journey.max_transfers(), arg.accessibilite_params, arg.forbidden, arg.allowed,
@@ -890,6 +903,16 @@ void Worker::heat_map(const pbnavitia::HeatMapRequest& request) {
     auto end_mode_iso = request_journey.clockwise() ? streetnetwork.destination_mode() : streetnetwork.origin_mode();
     auto end_mode = type::static_data::get()->modeByCaption(end_mode_iso);
     auto end_speed = get_speed(streetnetwork, end_mode);
+    if (request_journey.datetimes_size() > 1) {
+        // one heat map by datetime, computed together
+        const std::vector<uint64_t> datetimes(request_journey.datetimes().begin(), request_journey.datetimes().end());
+        navitia::routing::make_heat_maps(
+            this->pb_creator, *planner, center_and_stop_points.first, datetimes, request_journey.max_duration(),
+            request_journey.max_transfers(), arg.accessibilite_params, arg.forbidden, arg.allowed,
+            request_journey.clockwise(), arg.rt_level, *street_network_worker, end_speed, end_mode,
+            request.resolution(), center_and_stop_points.second);
+        return;
+    }
     navitia::routing::make_heat_map(this->pb_creator, *planner, center_and_stop_points.first,
                                     request_journey.datetimes(0), request_journey.max_duration(),
                                     request_journey.max_transfers(), arg.accessibilite_params, arg.forbidden,
@@ -92,6 +92,16 @@ void ProximityList<T>::build() {
     NN_index->buildIndex();
 }
 
+/*
+ * The IndexOnly queries (used for the projections) return at most the INDEX_ONLY_MAX_SIZE nearest elements,
+ * whether they are batched or not, so that all the projections agree.
+ * */
+constexpr static int INDEX_ONLY_MAX_SIZE = 100;
+
+static int index_only_size(const int size) {
+    return size < 0 || size > INDEX_ONLY_MAX_SIZE ? INDEX_ONLY_MAX_SIZE : size;
+}
+
 template <typename T, typename Items, typename Indices, typename Distances, typename Out, typename F>
 static void make_result(const type::GeographicalCoord& coord,
                         const Items& items,
@@ -146,23 +156,36 @@ static int radius_search(const std::shared_ptr<index_t>& NN_index,
     return nb_found;
 }
 
+template <class T>
+template <typename F>
+void ProximityList<T>::visit_within(const GeographicalCoord& coord,
+                                    const double radius,
+                                    const int size,
+                                    SearchBuffer& buffer,
+                                    F&& op) const {
+    // Containers are auto-sized by NN_index, Flann will return all objects inside of the given radius
+    int nb_found = radius_search(NN_index, coord, radius, size, buffer.indices, buffer.distances);
+    assert(buffer.indices.size() == 1);
+    assert(buffer.distances.size() == 1);
+    for (int i = 0; i < nb_found; ++i) {
+        int res_ind = buffer.indices[0][i];
+        if (res_ind < 0 || res_ind >= static_cast<int>(items.size())) {
+            continue;
+        }
+        op(items[res_ind], buffer.distances[0][i]);
+    }
+}
+
 template <class T>
 auto ProximityList<T>::find_within_impl(const GeographicalCoord& coord,
                                         const double radius,
                                         const int size,
                                         IndexCoord /*unused*/) const
     -> std::vector<typename ReturnTypeTrait<T, IndexCoord>::ValueType> {
-    // Containers are auto-sized by NN_index, Flann will return all objects inside of the given radius
-    std::vector<std::vector<int>> indices;
-    std::vector<std::vector<index_t::DistanceType>> distances;
-    int nb_found = radius_search(NN_index, coord, radius, size, indices, distances);
-    assert(indices.size() == 1);
-    assert(distances.size() == 1);
-
     std::vector<typename ReturnTypeTrait<T, IndexCoord>::ValueType> res;
-    auto op = [](const Item& item, float /*unused*/) { return std::make_pair(item.element, item.coord); };
-    make_result<T>(coord, items, indices[0], distances[0], nb_found, res, op);
-
+    SearchBuffer buffer;
+    visit_within(coord, radius, size, buffer,
+                 [&](const Item& item, float /*unused*/) { res.emplace_back(item.element, item.coord); });
     return res;
 }
 
@@ -172,17 +195,10 @@ auto ProximityList<T>::find_within_impl(const GeographicalCoord& coord,
                                         const int size,
                                         IndexCoordDistance /*unused*/) const
     -> std::vector<typename ReturnTypeTrait<T, IndexCoordDistance>::ValueType> {
-    // Containers are auto-sized by NN_index, Flann will return all objects inside of the given radius
-    std::vector<std::vector<int>> indices;
-    std::vector<std::vector<index_t::DistanceType>> distances;
-    int nb_found = radius_search(NN_index, coord, radius, size, indices, distances);
-    assert(indices.size() == 1);
-    assert(distances.size() == 1);
-
     std::vector<typename ReturnTypeTrait<T, IndexCoordDistance>::ValueType> res;
-    auto op = [](const Item& item, float distance) { return std::make_tuple(item.element, item.coord, distance); };
-    make_result<T>(coord, items, indices[0], distances[0], nb_found, res, op);
-
+    SearchBuffer buffer;
+    visit_within(coord, radius, size, buffer,
+                 [&](const Item& item, float distance) { res.emplace_back(item.element, item.coord, distance); });
     return res;
 }
 
@@ -192,13 +208,13 @@ auto ProximityList<T>::find_within_impl(const GeographicalCoord& coord,
                                         const int size,
                                         IndexOnly /*unused*/) const
     -> std::vector<typename ReturnTypeTrait<T, IndexOnly>::ValueType> {
+    const int max_size = index_only_size(size);
     // Using small sized std::array will avoid heap allocation and limit the research
-    const static std::size_t max_size = 100;
-    std::array<int, max_size> indices_data{};
-    flann::Matrix<int> indices(&indices_data[0], 1, size == -1 ? max_size : size);
-    std::array<index_t::DistanceType, max_size> distances_data{};
-    flann::Matrix<index_t::DistanceType> distances(&distances_data[0], 1, size == -1 ? max_size : size);
-    int nb_found = radius_search(NN_index, coord, radius, size, indices, distances);
+    std::array<int, INDEX_ONLY_MAX_SIZE> indices_data{};
+    flann::Matrix<int> indices(&indices_data[0], 1, max_size);
+    std::array<index_t::DistanceType, INDEX_ONLY_MAX_SIZE> distances_data{};
+    flann::Matrix<index_t::DistanceType> distances(&distances_data[0], 1, max_size);
+    int nb_found = radius_search(NN_index, coord, radius, max_size, indices, distances);
 
     std::vector<typename ReturnTypeTrait<T, IndexOnly>::ValueType> res;
     auto op = [](const Item& item, float /*unused*/) { return item.element; };
@@ -207,6 +223,51 @@ auto ProximityList<T>::find_within_impl(const GeographicalCoord& coord,
     return res;
 }
 
+template <class T>
+void ProximityList<T>::find_within_batch_impl(const std::vector<GeographicalCoord>& coords,
+                                              const double radius,
+                                              const int size,
+                                              BatchResult<typename ReturnTypeTrait<T, IndexOnly>::ValueType>& result,
+                                              IndexOnly /*unused*/) const {
+    const int max_size = index_only_size(size);
+    SearchBuffer buffer;
+    for (const auto& coord : coords) {
+        visit_within(coord, radius, max_size, buffer,
+                     [&](const Item& item, float /*unused*/) { result.values.push_back(item.element); });
+        result.offsets.push_back(result.values.size());
+    }
+}
+
+template <class T>
+void ProximityList<T>::find_within_batch_impl(const std::vector<GeographicalCoord>& coords,
+                                              const double radius,
+                                              const int size,
+                                              BatchResult<typename ReturnTypeTrait<T, IndexCoord>::ValueType>& result,
+                                              IndexCoord /*unused*/) const {
+    SearchBuffer buffer;
+    for (const auto& coord : coords) {
+        visit_within(coord, radius, size, buffer,
+                     [&](const Item& item, float /*unused*/) { result.values.emplace_back(item.element, item.coord); });
+        result.offsets.push_back(result.values.size());
+    }
+}
+
+template <class T>
+void ProximityList<T>::find_within_batch_impl(
+    const std::vector<GeographicalCoord>& coords,
+    const double radius,
+    const int size,
+    BatchResult<typename ReturnTypeTrait<T, IndexCoordDistance>::ValueType>& result,
+    IndexCoordDistance /*unused*/) const {
+    SearchBuffer buffer;
+    for (const auto& coord : coords) {
+        visit_within(coord, radius, size, buffer, [&](const Item& item, float distance) {
+            result.values.emplace_back(item.element, item.coord, distance);
+        });
+        result.offsets.push_back(result.values.size());
+    }
+}
+
 NotFound::~NotFound() noexcept = default;
 
 template struct ProximityList<unsigned int>;
@@ -34,6 +34,8 @@ www.navitia.io
 #include "utils/exception.h"
 #include "utils/logger.h"
 
+#include <boost/range/iterator_range.hpp>
+
 #include <memory>
 #include <vector>
 
@@ -81,6 +83,35 @@ template <typename T>
 struct ReturnTypeTrait<T, IndexCoordDistance> {
     typedef std::tuple<T, GeographicalCoord, float> ValueType;
 };
+
+/*
+ * Results of a batch of queries, stored contiguously (CSR like).
+ *
+ * The results of the i-th query are values[offsets[i]] to values[offsets[i + 1]] (excluded).
+ * The containers keep their capacity between batches, so a BatchResult should be reused.
+ * */
+template <typename ValueType>
+struct BatchResult {
+    using const_iterator = typename std::vector<ValueType>::const_iterator;
+
+    std::vector<size_t> offsets;
+    std::vector<ValueType> values;
+
+    size_t size() const { return offsets.empty() ? 0 : offsets.size() - 1; }
+    boost::iterator_range<const_iterator> operator[](const size_t i) const {
+        return boost::make_iterator_range(values.begin() + offsets[i], values.begin() + offsets[i + 1]);
+    }
+    void clear() {
+        offsets.clear();
+        values.clear();
+    }
+};
+
+// Buffers used by the queries, reused from one query of a batch to another
+struct SearchBuffer {
+    std::vector<std::vector<int>> indices;
+    std::vector<std::vector<float>> distances;
+};
 /* A structure allows to find K Nearest Neighbours with a given radius.
  *
  * The Item contains T(in practice, the Idx of the wanted object) and the coord of the object.
@@ -128,6 +159,7 @@ struct ProximityList {
      * When Tag is IndexCorrdDistance, the method returns a vector of Index, Coord and the Distance.
      *
      * If Tag is IndexOnly, the method returns a vector of Index, which is useful for coord projections.
+     * Only the 100 nearest elements are returned in that case (the same for find_within_batch).
      *
      * */
     template <typename Tag = IndexCoord>
@@ -138,6 +170,26 @@ struct ProximityList {
         return find_within_impl(coord, radius, size, Tag{});
     }
 
+    /*
+     * Same as find_within, but for many coordinates at once.
+     *
+     * result is cleared, then result[i] contains the elements found for coords[i]
+     * */
+    template <typename Tag = IndexCoord>
+    void find_within_batch(const std::vector<GeographicalCoord>& coords,
+                           BatchResult<typename ReturnTypeTrait<T, Tag>::ValueType>& result,
+                           double radius = 500,
+                           int size = -1) const {
+        result.clear();
+        result.offsets.reserve(coords.size() + 1);
+        result.offsets.push_back(0);
+        if (!NN_index || !size || !radius) {
+            result.offsets.resize(coords.size() + 1, 0);
+            return;
+        }
+        find_within_batch_impl(coords, radius, size, result, Tag{});
+    }
+
     /// Fonction de confort pour retrouver l'élément le plus proche dans l'indexe
     T find_nearest(double lon, double lat) const { return find_nearest(GeographicalCoord(lon, lat)); }
 
@@ -160,6 +212,30 @@ struct ProximityList {
     }
 
 private:
+    // Calls op(item, squared distance) for all the items within the radius, the nearest first
+    template <typename F>
+    void visit_within(const GeographicalCoord& coord,
+                      const double radius,
+                      const int size,
+                      SearchBuffer& buffer,
+                      F&& op) const;
+
+    void find_within_batch_impl(const std::vector<GeographicalCoord>& coords,
+                                const double radius,
+                                const int size,
+                                BatchResult<typename ReturnTypeTrait<T, IndexOnly>::ValueType>& result,
+                                IndexOnly) const;
+    void find_within_batch_impl(const std::vector<GeographicalCoord>& coords,
+                                const double radius,
+                                const int size,
+                                BatchResult<typename ReturnTypeTrait<T, IndexCoord>::ValueType>& result,
+                                IndexCoord) const;
+    void find_within_batch_impl(const std::vector<GeographicalCoord>& coords,
+                                const double radius,
+                                const int size,
+                                BatchResult<typename ReturnTypeTrait<T, IndexCoordDistance>::ValueType>& result,
+                                IndexCoordDistance) const;
+
     /*
      * This implementation is used for /places_nearby
      *
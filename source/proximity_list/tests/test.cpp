@@ -199,6 +199,63 @@ BOOST_AUTO_TEST_CASE(find_nearest) {
     BOOST_CHECK_EQUAL_COLLECTIONS(tmp.begin(), tmp.end(), expected.begin(), expected.end());
 }
 
+/*
+ * The batch queries must give the same results as the queries one by one
+ */
+BOOST_AUTO_TEST_CASE(batch_find_within) {
+    constexpr double M_TO_DEG = 1.0 / 111320.0;
+    ProximityList<unsigned int> pl;
+
+    // a 40x40 square of points, 20 meters from each others, around Paris and around the antimeridian
+    unsigned int element = 0;
+    for (const auto& origin : {GeographicalCoord(2.35, 48.85), GeographicalCoord(179.9995, 0.)}) {
+        for (int i = 0; i < 40; ++i) {
+            for (int j = 0; j < 40; ++j) {
+                GeographicalCoord c(origin.lon() + M_TO_DEG * 20 * i, origin.lat() + M_TO_DEG * 20 * j);
+                if (c.lon() > 180) {
+                    c.set_lon(c.lon() - 360);
+                }
+                pl.add(c, element);
+                ++element;
+            }
+        }
+    }
+    pl.build();
+
+    std::vector<GeographicalCoord> queries = {
+        GeographicalCoord(2.35 + M_TO_DEG * 400, 48.85 + M_TO_DEG * 400),
+        GeographicalCoord(2.35 - M_TO_DEG * 100, 48.85 + M_TO_DEG * 10),
+        GeographicalCoord(180. - M_TO_DEG * 10, M_TO_DEG * 300),
+        GeographicalCoord(-180. + M_TO_DEG * 100, M_TO_DEG * 100),
+        GeographicalCoord(-100., 10.),
+    };
+    BatchResult<unsigned int> batch;
+    for (const double radius : {10., 55., 150., 490.}) {
+        for (const int size : {-1, 1, 5}) {
+            pl.find_within_batch<IndexOnly>(queries, batch, radius, size);
+            BOOST_REQUIRE_EQUAL(batch.size(), queries.size());
+            for (size_t q = 0; q < queries.size(); ++q) {
+                const auto expected = pl.find_within<IndexOnly>(queries[q], radius, size);
+                const std::vector<unsigned int> from_batch(batch[q].begin(), batch[q].end());
+                // IndexOnly queries never return more than the 100 nearest elements
+                BOOST_CHECK_LE(expected.size(), 100);
+                BOOST_CHECK(from_batch == expected);
+            }
+        }
+    }
+
+    BatchResult<std::tuple<unsigned int, GeographicalCoord, float>> batch_with_distance;
+    pl.find_within_batch<IndexCoordDistance>(queries, batch_with_distance, 100);
+    BOOST_REQUIRE_EQUAL(batch_with_distance.size(), queries.size());
+    for (size_t q = 0; q < queries.size(); ++q) {
+        const auto expected = pl.find_within<IndexCoordDistance>(queries[q], 100);
+        BOOST_REQUIRE_EQUAL(batch_with_distance[q].size(), expected.size());
+        for (size_t i = 0; i < expected.size(); ++i) {
+            BOOST_CHECK_EQUAL(std::get<0>(batch_with_distance[q][i]), std::get<0>(expected[i]));
+        }
+    }
+}
+
 BOOST_AUTO_TEST_CASE(test_api) {
     navitia::type::Data data;
     // Everything in the range
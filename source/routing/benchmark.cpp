@@ -92,6 +92,7 @@ int main(int argc, char** argv) {
             ("hour,h", po::value<int>(&hour)->default_value(-1),
                     "Begginning hour of a particular journey")
             ("verbose,v", "Verbose debugging output")
+            ("parents", "Unwind the journeys with the parents of the labels")
             ("stop_files", po::value<std::string>(&stop_input_file), "File with list of start and target")
             ("output,o", po::value<std::string>(&output)->default_value("benchmark.csv"),
                      "Output file");
@@ -190,6 +191,7 @@ int main(int argc, char** argv) {
     std::vector<Result> results;
     data.build_raptor();
     RAPTOR router(data);
+    router.record_parents = vm.count("parents");
 
     std::cout << "On lance le benchmark de l'algo " << std::endl;
     boost::progress_display show_progress(demands.size());
@@ -252,4 +254,8 @@ int main(int argc, char** argv) {
 
     std::cout << "Number of requests: " << demands.size() << std::endl;
     std::cout << "Number of results with solution: " << nb_reponses << std::endl;
+    if (router.record_parents) {
+        std::cout << "Memory used by the parents of the labels: " << router.parents_memory() / 1024 << " KiB"
+                  << std::endl;
+    }
 }
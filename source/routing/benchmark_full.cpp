@@ -138,6 +138,7 @@ int main(int argc, char** argv) {
     po::options_description desc("Benchmark tool options");
     std::string data_file, benchmark_output_file, requests_input_file, requests_output_file;
     int iterations, nb_second_pass;
+    double min_distance;
 
     // clang-format off
     desc.add_options()
@@ -149,6 +150,10 @@ int main(int argc, char** argv) {
                      "Path to data.nav.lz4")
             ("verbose,v", "Verbose debugging output.")
             ("nb_second_pass", po::value<int>(&nb_second_pass)->default_value(0), "nb second pass")
+            ("target_pruning", "Prune the first pass with the lower bounds of the travel times.")
+            ("min_distance", po::value<double>(&min_distance)->default_value(0),
+                     "Minimal distance (in meters) between the start and the target of the generated requests, "
+                     "to benchmark long-distance queries.")
             ("requests", po::value<std::string>(&requests_input_file),
                         "List of requests to benchmark on.\n"
                         "Must be a comma-separated csv file where the first 3 columns are :  start point uri, target point uri, departure posix time.\n"
@@ -222,7 +227,8 @@ int main(int argc, char** argv) {
                 request.start = sa_start->uri;
                 request.target = sa_dest->uri;
             } while (sa_start == sa_dest || ba::starts_with(sa_dest->uri, "stop_area:SNC:")
-                     || ba::starts_with(sa_start->uri, "stop_area:SNC:"));
+                     || ba::starts_with(sa_start->uri, "stop_area:SNC:")
+                     || sa_start->coord.distance_to(sa_dest->coord) < min_distance);
 
             for (auto day : days) {
                 for (auto hour : hours) {
@@ -253,6 +259,12 @@ int main(int argc, char** argv) {
     std::vector<Result> results;
     data.build_raptor();
     RAPTOR raptor(data);
+    raptor.target_pruning = vm.count("target_pruning");
+    if (raptor.target_pruning) {
+        Timer t("Computing the lower bounds of the travel times");
+        data.dataRaptor->get_lower_bound_oracle(*data.pt_data);
+    }
+    size_t nb_pruned_labels = 0;
     auto georef_worker = georef::StreetNetwork(*data.geo_ref);
 
     // disabling logging, to not pollute std::cout
@@ -308,6 +320,7 @@ int main(int argc, char** argv) {
                           10,                              // max_transfers
                           nb_second_pass);
             auto resp = pb_creator.get_response();
+            nb_pruned_labels += raptor.nb_pruned_labels;
 
             Result result(resp.journeys().size(), t2.ms());
             results.push_back(result);
@@ -339,4 +352,7 @@ int main(int argc, char** argv) {
     std::cout << "Number of requests: " << requests.size() << std::endl;
     std::cout << "Number of results with solution: " << nb_reponses << std::endl;
     std::cout << "Number of journey found: " << nb_journeys << std::endl;
+    if (raptor.target_pruning) {
+        std::cout << "Number of pruned labels: " << nb_pruned_labels << std::endl;
+    }
 }
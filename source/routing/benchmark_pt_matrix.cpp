@@ -0,0 +1,122 @@
+/* Copyright © 2001-2014, Canal TP and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+channel `#navitia` on riot https://riot.im/app/#/room/#navitia:matrix.org
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#include "pt_matrix.h"
+#include "type/accessibility_params.h"
+#include "type/data.h"
+#include "type/meta_data.h"
+#include "type/stop_area.h"
+#include "type/stop_point.h"
+#include "utils/init.h"
+#include "utils/timer.h"
+
+#include <boost/program_options.hpp>
+
+#include <algorithm>
+#include <random>
+
+using namespace navitia;
+using namespace routing;
+namespace po = boost::program_options;
+
+// the stop points of random stop areas, reached without walking
+static std::vector<map_stop_point_duration> random_stop_areas(const type::Data& data, int nb, std::mt19937& rng) {
+    std::uniform_int_distribution<size_t> gen(0, data.pt_data->stop_areas.size() - 1);
+    std::vector<map_stop_point_duration> result;
+    for (int i = 0; i < nb; ++i) {
+        map_stop_point_duration sps;
+        for (const auto* sp : data.pt_data->stop_areas[gen(rng)]->stop_point_list) {
+            sps[SpIdx(*sp)] = {};
+        }
+        result.push_back(sps);
+    }
+    return result;
+}
+
+int main(int argc, char** argv) {
+    navitia::init_app();
+    po::options_description desc("Options of the public transport matrix benchmark");
+    std::string file;
+    int nb_origins, nb_destinations, nb_threads, window, step, max_duration, hour;
+
+    // clang-format off
+    desc.add_options()
+            ("help", "Show this message")
+            ("file,f", po::value<std::string>(&file)->default_value("data.nav.lz4"), "Path to data.nav.lz4")
+            ("origins,o", po::value<int>(&nb_origins)->default_value(1000), "number of random origin stop areas")
+            ("destinations,d", po::value<int>(&nb_destinations)->default_value(1000),
+                     "number of random destination stop areas")
+            ("threads,t", po::value<int>(&nb_threads)->default_value(0),
+                     "number of threads, 0 for the hardware concurrency")
+            ("hour", po::value<int>(&hour)->default_value(8), "hour of the beginning of the departure window")
+            ("window,w", po::value<int>(&window)->default_value(3600), "duration of the departure window in seconds")
+            ("step,s", po::value<int>(&step)->default_value(600), "seconds between two departures of the window")
+            ("max_duration,m", po::value<int>(&max_duration)->default_value(3 * 3600),
+                     "maximum duration of the journeys in seconds");
+    // clang-format on
+
+    po::variables_map vm;
+    po::store(po::parse_command_line(argc, argv, desc), vm);
+    po::notify(vm);
+
+    if (vm.count("help")) {
+        std::cout << "This is used to benchmark the public transport travel time matrices" << std::endl;
+        std::cout << desc << std::endl;
+        return 1;
+    }
+
+    type::Data data;
+    {
+        Timer t("Data loading: " + file);
+        data.load_nav(file);
+        data.build_raptor();
+    }
+
+    std::mt19937 rng(31442);
+    const auto origins = random_stop_areas(data, nb_origins, rng);
+    const auto destinations = random_stop_areas(data, nb_destinations, rng);
+    std::vector<DateTime> departure_datetimes;
+    for (int offset = 0; offset <= window; offset += std::max(step, 1)) {
+        departure_datetimes.push_back(DateTimeUtils::set(1, hour * 3600 + offset));
+    }
+
+    PtMatrix matrix;
+    {
+        Timer t("Computing a " + std::to_string(nb_origins) + "x" + std::to_string(nb_destinations) + " matrix with "
+                + std::to_string(departure_datetimes.size()) + " departures by origin");
+        matrix = compute_pt_matrix(data, origins, destinations, departure_datetimes, max_duration, 10,
+                                   type::AccessibiliteParams(), {}, {}, type::RTLevel::Base, nb_threads);
+    }
+    const auto nb_reached = std::count_if(matrix.cells.begin(), matrix.cells.end(), [](const PtMatrix::Cell& cell) {
+        return cell.duration != DateTimeUtils::inf;
+    });
+    std::cout << "Number of reached cells: " << nb_reached << " / " << matrix.cells.size() << std::endl;
+    return 0;
+}
@@ -72,11 +72,36 @@ static void compute(std::vector<Demand> demands, boost::progress_display& show_p
     std::cout << "Number of results: " << results.size() << std::endl;
 }
 
+// requests mostly for today and tomorrow, in realtime and without accessibility constraint
+static std::vector<Demand> realistic_demands(int nb_requests, int nb_days) {
+    std::mt19937 rng(42);
+    std::discrete_distribution<int> day_kind({70, 20, 10});
+    std::uniform_int_distribution<int> any_day(1, std::max(1, nb_days - 1));
+    std::uniform_int_distribution<int> any_hour(0, 86399);
+    const std::vector<nt::RTLevel> levels{nt::RTLevel::Base, nt::RTLevel::Adapted, nt::RTLevel::RealTime};
+    std::discrete_distribution<int> level({25, 5, 70});
+    std::bernoulli_distribution wheelchair(0.1);
+
+    std::vector<Demand> demands;
+    for (int i = 0; i < nb_requests; ++i) {
+        Demand demand;
+        const int kind = day_kind(rng);
+        demand.date = kind == 2 ? any_day(rng) : kind + 1;
+        demand.hour = any_hour(rng);
+        demand.level = levels[level(rng)];
+        if (wheelchair(rng)) {
+            demand.accessibilite_params.properties.set(type::hasProperties::WHEELCHAIR_BOARDING, true);
+        }
+        demands.push_back(demand);
+    }
+    return demands;
+}
+
 int main(int argc, char** argv) {
     navitia::init_app();
     po::options_description desc("Options de l'outil de benchmark");
     std::string file, profile;
-    int nb_days, size, nb_threads;
+    int nb_days, size, nb_threads, nb_requests, nb_prefetch_days;
 
     // clang-format off
     desc.add_options()
@@ -85,6 +110,10 @@ int main(int argc, char** argv) {
             ("days,d", po::value<int>(&nb_days)->default_value(30), "number of day to build")
             ("size,s", po::value<int>(&size)->default_value(10), "raptor cache size")
             ("threads,t", po::value<int>(&nb_threads)->default_value(1), "number of threads to run")
+            ("requests,r", po::value<int>(&nb_requests)->default_value(0),
+                     "number of requests of a realistic mix, instead of building each day")
+            ("prefetch", po::value<int>(&nb_prefetch_days)->default_value(0),
+                     "number of days whose caches are prefetched before the requests")
             ("profile,p", po::value<std::string>(&profile)->default_value(""), "profile file");
     // clang-format on
 
@@ -105,16 +134,24 @@ int main(int argc, char** argv) {
         data.build_raptor(size);
     }
     std::vector<Demand> demands;
-    std::vector<nt::RTLevel> levels{nt::RTLevel::Base, nt::RTLevel::Adapted, nt::RTLevel::RealTime};
-    for (int day = 1; day < nb_days; ++day) {
-        Demand demand;
-        demand.date = day;
-        demand.hour = 0;
-        for (auto l : levels) {
-            demand.level = l;
-            demands.push_back(demand);
+    if (nb_requests > 0) {
+        demands = realistic_demands(nb_requests, nb_days);
+    } else {
+        std::vector<nt::RTLevel> levels{nt::RTLevel::Base, nt::RTLevel::Adapted, nt::RTLevel::RealTime};
+        for (int day = 1; day < nb_days; ++day) {
+            Demand demand;
+            demand.date = day;
+            demand.hour = 0;
+            for (auto l : levels) {
+                demand.level = l;
+                demands.push_back(demand);
+            }
         }
     }
+    if (nb_prefetch_days > 0) {
+        Timer t("Prefetch raptor cache ");
+        data.dataRaptor->prefetch(1, nb_prefetch_days, 2, nb_threads);
+    }
 
     RAPTOR router(data);
 
@@ -145,4 +182,10 @@ int main(int argc, char** argv) {
     }
 
     std::cout << "Number of requests: " << demands.size() << std::endl;
+    const auto counters = CachedNextStopTimeManager::counters();
+    const auto nb_loads = counters.nb_hits + counters.nb_misses;
+    std::cout << "Hits: " << counters.nb_hits << ", misses: " << counters.nb_misses
+              << ", hit rate: " << (nb_loads ? 100. * counters.nb_hits / nb_loads : 0.) << "%" << std::endl;
+    std::cout << "Prefetched: " << counters.nb_prefetched << ", evictions: " << counters.nb_evictions
+              << ", build time: " << counters.build_duration << "s" << std::endl;
 }
@@ -31,7 +31,9 @@ www.navitia.io
 #include "dataraptor.h"
 
 #include "routing.h"
+#include "routing/lower_bound_oracle.h"
 #include "routing/raptor_utils.h"
+#include "routing/valid_journey_patterns.h"
 
 #include <boost/range/algorithm_ext.hpp>
 
@@ -90,6 +92,9 @@ void dataRAPTOR::JppsFromJp::load(const JourneyPatternContainer& jp_container) {
     }
 }
 
+dataRAPTOR::dataRAPTOR() = default;
+dataRAPTOR::~dataRAPTOR() = default;
+
 void dataRAPTOR::load(const type::PT_Data& data, size_t cache_size) {
     jp_container.load(data);
     labels_const.init_inf(data.stop_points);
@@ -125,10 +130,44 @@ void dataRAPTOR::load(const type::PT_Data& data, size_t cache_size) {
     }
 
     cached_next_st_manager = std::make_unique<CachedNextStopTimeManager>(*this, cache_size);
+    valid_jps_manager = std::make_unique<ValidJourneyPatternsManager>(data, *this, cache_size);
+
+    std::lock_guard<std::mutex> lock(lower_bound_oracle_mutex);
+    lower_bound_oracle.reset();
+}
+
+const LowerBoundOracle& dataRAPTOR::get_lower_bound_oracle(const type::PT_Data& data) const {
+    std::lock_guard<std::mutex> lock(lower_bound_oracle_mutex);
+    if (!lower_bound_oracle) {
+        lower_bound_oracle = std::make_unique<const LowerBoundOracle>(data);
+    }
+    return *lower_bound_oracle;
 }
 
 void dataRAPTOR::warmup(const dataRAPTOR& other) {
     this->cached_next_st_manager->warmup(*other.cached_next_st_manager);
+    this->valid_jps_manager->warmup(*other.valid_jps_manager);
+}
+
+void dataRAPTOR::prefetch(const size_t first_day,
+                          const size_t nb_days,
+                          const size_t nb_accessibilities,
+                          const size_t nb_threads,
+                          const std::function<bool()>& is_cancelled) {
+    auto accessibilities = cached_next_st_manager->popular_accessibilities(nb_accessibilities);
+    if (accessibilities.empty() && nb_accessibilities > 0) {
+        accessibilities.emplace_back();
+    }
+    // the most likely first: today before tomorrow, then the less requested accessibilities
+    std::vector<CachedNextStopTimeKey> keys;
+    for (const auto& accessibility : accessibilities) {
+        for (size_t day = first_day; day < first_day + nb_days; ++day) {
+            for (const auto rt_level : {type::RTLevel::RealTime, type::RTLevel::Base}) {
+                keys.emplace_back(day, rt_level, accessibility);
+            }
+        }
+    }
+    cached_next_st_manager->prefetch(keys, nb_threads, is_cancelled);
 }
 
 }  // namespace routing
@@ -40,9 +40,15 @@ www.navitia.io
 #include <boost/foreach.hpp>
 #include <boost/dynamic_bitset.hpp>
 
+#include <functional>
+#include <mutex>
+
 namespace navitia {
 namespace routing {
 
+struct ValidJourneyPatternsManager;
+struct LowerBoundOracle;
+
 /** Données statiques qui ne sont pas modifiées pendant le calcul */
 struct dataRAPTOR {
     // cache friendly access to the connections
@@ -100,6 +106,8 @@ struct dataRAPTOR {
 
     NextStopTimeData next_stop_time_data;
     std::unique_ptr<CachedNextStopTimeManager> cached_next_st_manager;
+    // journey patterns valid for a request, shared between the workers
+    std::unique_ptr<ValidJourneyPatternsManager> valid_jps_manager;
 
     JourneyPatternContainer jp_container;
 
@@ -110,10 +118,27 @@ struct dataRAPTOR {
     // jp_validity_patterns[date][jp_idx] == any(vj.validity_pattern->check2(date) for vj in jp)
     flat_enum_map<type::RTLevel, std::vector<boost::dynamic_bitset<>>> jp_validity_patterns;
 
-    dataRAPTOR() {}
+    dataRAPTOR();
+    ~dataRAPTOR();
     void load(const navitia::type::PT_Data&, size_t cache_size = 10);
 
+    /// Lower bounds of the travel times, only computed by the first request using them,
+    /// so that the realtime rebuilds don't pay for it
+    const LowerBoundOracle& get_lower_bound_oracle(const navitia::type::PT_Data&) const;
+
     void warmup(const dataRAPTOR& other);
+
+    /// Builds the next stop time caches of nb_days days from first_day, for the base and the
+    /// realtime levels and the nb_accessibilities most requested accessibilities
+    void prefetch(size_t first_day,
+                  size_t nb_days,
+                  size_t nb_accessibilities,
+                  size_t nb_threads,
+                  const std::function<bool()>& is_cancelled = [] { return false; });
+
+private:
+    mutable std::mutex lower_bound_oracle_mutex;
+    mutable std::unique_ptr<const LowerBoundOracle> lower_bound_oracle;
 };
 
 }  // namespace routing
@@ -32,9 +32,12 @@ www.navitia.io
 
 #include "routing/dataraptor.h"
 #include "routing/next_stop_time.h"
+#include "type/meta_data.h"
 #include "type/pb_converter.h"
+#include "type/vehicle_journey.h"
 
 #include <functional>
+#include <limits>
 
 namespace navitia {
 namespace routing {
@@ -95,6 +98,168 @@ std::vector<datetime_stop_time> get_stop_times(const routing::StopEvent stop_eve
     return result;
 }
 
+namespace {
+
+/*
+ * Walks the precomputed timeline (NextStopTimeData) of a discrete journey pattern point day after day.
+ *
+ * Contrary to NextStopTime::earliest_stop_time, the position in the timeline is kept between
+ * two calls, so we do not have to lookup the timeline again for every departure.
+ */
+struct TimelineCursor {
+    TimelineCursor(const NextStopTimeData& next_stop_time_data,
+                   const StopEvent stop_event,
+                   const JppIdx jpp_idx,
+                   const DateTime dt)
+        : next_stop_time_data(next_stop_time_data),
+          stop_event(stop_event),
+          jpp_idx(jpp_idx),
+          range(next_stop_time_data.stop_time_range_after(jpp_idx, dt, stop_event)),
+          date(DateTimeUtils::date(dt)),
+          min_dt(dt) {}
+
+    // Returns the next valid stop time in [min_dt, bound]
+    std::pair<const type::StopTime*, DateTime> next(const DateTime bound,
+                                                    const type::RTLevel rt_level,
+                                                    const type::VehicleProperties& vehicle_props) {
+        while (date <= DateTimeUtils::date(bound)) {
+            for (; !range.empty(); range.advance_begin(1)) {
+                const auto* st = range.front();
+                const uint32_t hour = (stop_event == StopEvent::pick_up) ? st->boarding_time : st->alighting_time;
+                const DateTime cur_dt = DateTimeUtils::set(date, DateTimeUtils::hour(hour));
+                if (bound < cur_dt) {
+                    return {nullptr, DateTimeUtils::inf};
+                }
+                // like get_stop_times, the next departure must be at least one second after the previous one
+                if (cur_dt < min_dt) {
+                    continue;
+                }
+                if (st->is_valid_day(date, false, rt_level) && st->vehicle_journey->accessible(vehicle_props)) {
+                    range.advance_begin(1);
+                    min_dt = cur_dt + 1;
+                    return {st, cur_dt};
+                }
+            }
+            ++date;
+            range = next_stop_time_data.stop_time_range_forward(jpp_idx, stop_event);
+        }
+        return {nullptr, DateTimeUtils::inf};
+    }
+
+    const NextStopTimeData& next_stop_time_data;
+    const StopEvent stop_event;
+    const JppIdx jpp_idx;
+    NextStopTimeData::StopTimeIter range;
+    DateTime date;
+    DateTime min_dt;
+};
+
+struct GroupJppSt {
+    size_t group;
+    size_t source;  // index in the cursor list, or invalid_source if the jpp is handled by NextStopTime
+    routing::JppIdx jpp;
+    const type::StopTime* st;
+    DateTime dt;
+};
+
+const size_t invalid_source = std::numeric_limits<size_t>::max();
+
+struct GroupBestDTComp {
+    bool operator()(const GroupJppSt& j1, const GroupJppSt& j2) const {
+        if (clockwise) {
+            return j1.dt > j2.dt;
+        }
+        return j1.dt < j2.dt;
+    }
+    const bool clockwise;
+};
+
+}  // namespace
+
+std::vector<std::vector<datetime_stop_time>> get_stop_times_by_group(
+    const routing::StopEvent stop_event,
+    const std::vector<std::vector<routing::JppIdx>>& jpp_groups,
+    const DateTime& dt,
+    const DateTime& max_dt,
+    const size_t max_departures_by_group,
+    const type::Data& data,
+    const type::RTLevel rt_level,
+    const type::AccessibiliteParams& accessibilite_params) {
+    const bool clockwise(max_dt >= dt);
+    std::vector<std::vector<datetime_stop_time>> result(jpp_groups.size());
+    if (max_departures_by_group == 0) {
+        return result;
+    }
+    const auto& jp_container = data.dataRaptor->jp_container;
+    const routing::NextStopTime next_st(data);
+    // same bound as NextStopTime::earliest_stop_time
+    const DateTime bound = std::min(max_dt, DateTimeUtils::set(data.meta->production_date.length().days(), 0));
+
+    // the cursors are only used for clockwise requests on journey patterns without frequencies,
+    // the other cases are delegated to NextStopTime
+    std::vector<TimelineCursor> cursors;
+    std::priority_queue<GroupJppSt, std::vector<GroupJppSt>, GroupBestDTComp> queue({clockwise});
+
+    auto next = [&](const size_t source, const routing::JppIdx jpp_idx, const DateTime from) {
+        if (source != invalid_source) {
+            return cursors[source].next(bound, rt_level, accessibilite_params.vehicle_properties);
+        }
+        return next_st.next_stop_time(stop_event, jpp_idx, from, clockwise, rt_level,
+                                      accessibilite_params.vehicle_properties, true, max_dt);
+    };
+
+    for (size_t group = 0; group < jpp_groups.size(); ++group) {
+        for (const auto& jpp_idx : jpp_groups[group]) {
+            const routing::JourneyPatternPoint& jpp = jp_container.get(jpp_idx);
+            if (!data.pt_data->stop_points[jpp.sp_idx.val]->accessible(accessibilite_params.properties)) {
+                continue;
+            }
+            size_t source = invalid_source;
+            if (clockwise && jp_container.get(jpp.jp_idx).freq_vjs.empty()) {
+                source = cursors.size();
+                cursors.emplace_back(data.dataRaptor->next_stop_time_data, stop_event, jpp_idx, dt);
+            }
+            const auto st = next(source, jpp_idx, dt);
+            if (st.first) {
+                queue.push({group, source, jpp_idx, st.first, st.second});
+            }
+        }
+    }
+
+    while (!queue.empty()) {
+        const auto best = queue.top();  // copy
+        queue.pop();
+        if ((clockwise && best.dt > max_dt) || (!clockwise && best.dt < max_dt)) {
+            // the best elt of the queue is after the limit, we can stop
+            break;
+        }
+        auto& group_result = result[best.group];
+        if (group_result.size() >= max_departures_by_group) {
+            // this group is full, we do not need to feed it anymore
+            continue;
+        }
+
+        auto result_dt = best.dt;
+        if (stop_event == StopEvent::pick_up) {
+            result_dt += best.st->get_boarding_duration();
+        } else {
+            result_dt -= best.st->get_alighting_duration();
+        }
+        group_result.emplace_back(result_dt, best.st);
+        if (group_result.size() >= max_departures_by_group) {
+            continue;
+        }
+
+        // we insert the next stop time in the queue (it must be at least one second after/before)
+        const auto st = next(best.source, best.jpp, best.dt + (clockwise ? 1 : -1));
+        if (st.first) {
+            queue.push({best.group, best.source, best.jpp, st.first, st.second});
+        }
+    }
+
+    return result;
+}
+
 std::vector<datetime_stop_time> get_calendar_stop_times(const std::vector<routing::JppIdx>& journey_pattern_points,
                                                         const uint32_t begining_time,
                                                         const uint32_t max_time,
@@ -60,6 +60,28 @@ std::vector<datetime_stop_time> get_stop_times(
     const type::RTLevel rt_level,
     const type::AccessibiliteParams& accessibilite_params = type::AccessibiliteParams());
 
+/**
+ * @brief get_stop_times_by_group: Return the departures of several groups of journey pattern points at once
+ *
+ * All the groups are merged in a single pass (k-way merge over the timelines of NextStopTimeData)
+ * and each group stops being fed as soon as it reached max_departures_by_group.
+ * For each group, the result is the same as get_stop_times(stop_event, group, dt, max_dt, max_departures_by_group)
+ *
+ * @param jpp_groups: list of groups of journey_pattern_point (for example one group by route point)
+ * @param max_departures_by_group: max number of departures for each group
+ * @return: one list of pair <datetime, departure st.idx> by group, in the order of jpp_groups.
+ *          Each list is sorted on the datetimes.
+ */
+std::vector<std::vector<datetime_stop_time>> get_stop_times_by_group(
+    const routing::StopEvent stop_event,
+    const std::vector<std::vector<routing::JppIdx>>& jpp_groups,
+    const DateTime& dt,
+    const DateTime& max_dt,
+    const size_t max_departures_by_group,
+    const type::Data& data,
+    const type::RTLevel rt_level,
+    const type::AccessibiliteParams& accessibilite_params = type::AccessibiliteParams());
+
 std::vector<datetime_stop_time> get_calendar_stop_times(
     const std::vector<routing::JppIdx>& journey_pattern_points,
     const uint32_t begining_time,
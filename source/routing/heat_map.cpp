@@ -132,6 +132,9 @@ static Boundary find_boundary(const std::pair<int, int>& rank_source,
     return {end_lon_box, end_lat_box, begin_lon_box, begin_lat_box};
 }
 
+// Min number of longitudes computed by a thread of the heat map
+constexpr static size_t MIN_HEAT_MAP_BAND = 16;
+
 static std::vector<std::vector<Projection>> find_projection(BoundBox box,
                                                             const double height_step,
                                                             const double width_step,
@@ -154,51 +157,59 @@ static std::vector<std::vector<Projection>> find_projection(BoundBox box,
     }
 
     const auto coslat = cos(objects_inside.front().second.lat() * type::GeographicalCoord::N_DEG_TO_RAD);
-    for (const auto& o : objects_inside) {
-        const auto element = o.first;
-        const auto& source = o.second;
-
-        if (!box.contains(source)) {
-            continue;
-        }
-        const auto rank_source = find_rank(box, source, height_step, width_step);
-        BOOST_FOREACH (const georef::edge_t& e, boost::out_edges(element, worker.graph)) {
-            const auto v = target(e, worker.graph);
-            const auto& target = worker.graph[v].coord;
-            const auto rank_target = find_rank(box, target, height_step, width_step);
-            const auto boundary = find_boundary(rank_source, rank_target, offset_lon, offset_lat, step);
-            for (uint lon_rank = boundary.min_lon; lon_rank <= boundary.max_lon; lon_rank++) {
-                for (uint lat_rank = boundary.min_lat; lat_rank <= boundary.max_lat; lat_rank++) {
-                    auto center = type::GeographicalCoord(heat_map.body[lon_rank].first.min_coord + width_step / 2,
-                                                          heat_map.header[lat_rank].min_coord + height_step / 2);
-                    auto proj = center.approx_project(source, target, coslat);
-                    auto length = double(proj.second);
-                    if (length < min_dist
-                        && (!dist_pixel[lon_rank][lat_rank].distance
-                            || length < *dist_pixel[lon_rank][lat_rank].distance)) {
-                        dist_pixel[lon_rank][lat_rank].distance = length;
-                        dist_pixel[lon_rank][lat_rank].source = element;
-                        dist_pixel[lon_rank][lat_rank].target = v;
+    // Each band of longitudes is handled by a thread that only writes its own cells.
+    // The edges are visited in the same order by all the bands, so the result does not depend on the threads
+    const auto project_band = [&](const size_t band_begin, const size_t band_end) {
+        for (const auto& o : objects_inside) {
+            const auto element = o.first;
+            const auto& source = o.second;
+
+            if (!box.contains(source)) {
+                continue;
+            }
+            const auto rank_source = find_rank(box, source, height_step, width_step);
+            BOOST_FOREACH (const georef::edge_t& e, boost::out_edges(element, worker.graph)) {
+                const auto v = target(e, worker.graph);
+                const auto& target = worker.graph[v].coord;
+                const auto rank_target = find_rank(box, target, height_step, width_step);
+                const auto boundary = find_boundary(rank_source, rank_target, offset_lon, offset_lat, step);
+                const auto min_lon = std::max(boundary.min_lon, band_begin);
+                const auto max_lon = std::min(boundary.max_lon, band_end - 1);
+                for (size_t lon_rank = min_lon; lon_rank <= max_lon && lon_rank < band_end; lon_rank++) {
+                    for (uint lat_rank = boundary.min_lat; lat_rank <= boundary.max_lat; lat_rank++) {
+                        auto center = type::GeographicalCoord(heat_map.body[lon_rank].first.min_coord + width_step / 2,
+                                                              heat_map.header[lat_rank].min_coord + height_step / 2);
+                        auto proj = center.approx_project(source, target, coslat);
+                        auto length = double(proj.second);
+                        if (length < min_dist
+                            && (!dist_pixel[lon_rank][lat_rank].distance
+                                || length < *dist_pixel[lon_rank][lat_rank].distance)) {
+                            dist_pixel[lon_rank][lat_rank].distance = length;
+                            dist_pixel[lon_rank][lat_rank].source = element;
+                            dist_pixel[lon_rank][lat_rank].target = v;
+                        }
                     }
                 }
             }
         }
-    }
+    };
+    parallel_for_bands(step, MIN_HEAT_MAP_BAND, project_band);
     return dist_pixel;
 }
 
-HeatMap fill_heat_map(const BoundBox& box,
-                      const double height_step,
-                      const double width_step,
+// Computes the durations of the longitudes [begin, end) of the heat map
+static void fill_band(HeatMap& heat_map,
+                      const std::vector<std::vector<Projection>>& projection,
                       const georef::GeoRef& worker,
-                      const double min_dist,
+                      const double width_step,
+                      const double height_step,
                       const double max_duration,
                       const double speed,
                       const std::vector<navitia::time_duration>& distances,
-                      const size_t step) {
-    auto heat_map = HeatMap(step, box, height_step, width_step);
-    auto projection = find_projection(box, height_step, width_step, worker, min_dist, heat_map, step);
-    for (size_t i = 0; i < step; i++) {
+                      const size_t begin,
+                      const size_t end) {
+    const size_t step = heat_map.header.size();
+    for (size_t i = begin; i < end; i++) {
         for (size_t j = 0; j < step; j++) {
             auto& duration = heat_map.body[i].second[j];
             if (projection[i][j].distance) {
@@ -224,6 +235,25 @@ HeatMap fill_heat_map(const BoundBox& box,
             }
         }
     }
+}
+
+HeatMap fill_heat_map(const BoundBox& box,
+                      const double height_step,
+                      const double width_step,
+                      const georef::GeoRef& worker,
+                      const double min_dist,
+                      const double max_duration,
+                      const double speed,
+                      const std::vector<navitia::time_duration>& distances,
+                      const size_t step) {
+    auto heat_map = HeatMap(step, box, height_step, width_step);
+    auto projection = find_projection(box, height_step, width_step, worker, min_dist, heat_map, step);
+    if (projection.empty()) {
+        return heat_map;
+    }
+    parallel_for_bands(step, MIN_HEAT_MAP_BAND, [&](const size_t begin, const size_t end) {
+        fill_band(heat_map, projection, worker, width_step, height_step, max_duration, speed, distances, begin, end);
+    });
     return heat_map;
 }
 
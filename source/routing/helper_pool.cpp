@@ -0,0 +1,163 @@
+/* Copyright © 2001-2014, Canal TP and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+channel `#navitia` on riot https://riot.im/app/#/room/#navitia:matrix.org
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#include "routing/helper_pool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <memory>
+
+namespace navitia {
+namespace routing {
+
+namespace {
+
+// A parallel_for shared by the calling thread and the helpers, kept alive by the helpers that
+// have not started yet when the parallel_for returns
+struct Batch {
+    const std::function<void(size_t)>* f;
+    size_t nb_tasks;
+    std::atomic<size_t> next{0};
+
+    std::mutex mutex;
+    std::condition_variable done;
+    bool closed = false;
+    size_t nb_running_helpers = 0;
+    std::exception_ptr error;
+
+    Batch(const std::function<void(size_t)>& f, const size_t nb_tasks) : f(&f), nb_tasks(nb_tasks) {}
+
+    void work() {
+        for (size_t i = next++; i < nb_tasks; i = next++) {
+            try {
+                (*f)(i);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!error) {
+                    error = std::current_exception();
+                }
+                next = nb_tasks;
+            }
+        }
+    }
+
+    void help() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (closed) {
+                return;
+            }
+            ++nb_running_helpers;
+        }
+        work();
+        std::lock_guard<std::mutex> lock(mutex);
+        if (--nb_running_helpers == 0) {
+            done.notify_all();
+        }
+    }
+};
+
+}  // namespace
+
+HelperPool& HelperPool::get() {
+    static HelperPool pool(std::max(1u, std::thread::hardware_concurrency()));
+    return pool;
+}
+
+HelperPool::HelperPool(const size_t nb_threads) {
+    threads.reserve(nb_threads);
+    for (size_t i = 0; i < nb_threads; ++i) {
+        threads.emplace_back([this] { run(); });
+    }
+}
+
+HelperPool::~HelperPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopped = true;
+    }
+    cv.notify_all();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+void HelperPool::run() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        ++nb_idle;
+        cv.wait(lock, [this] { return stopped || !jobs.empty(); });
+        --nb_idle;
+        if (stopped) {
+            return;
+        }
+        auto job = std::move(jobs.front());
+        jobs.pop_front();
+        lock.unlock();
+        job();
+        lock.lock();
+    }
+}
+
+void HelperPool::parallel_for(const size_t nb_tasks, const size_t max_helpers, const std::function<void(size_t)>& f) {
+    if (nb_tasks == 0) {
+        return;
+    }
+    auto batch = std::make_shared<Batch>(f, nb_tasks);
+    size_t nb_helpers = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        // only the idle threads are asked, a busy pool leaves the work to the calling thread
+        const size_t nb_free = nb_idle > jobs.size() ? nb_idle - jobs.size() : 0;
+        nb_helpers = std::min({max_helpers, nb_free, nb_tasks - 1});
+        for (size_t i = 0; i < nb_helpers; ++i) {
+            jobs.emplace_back([batch] { batch->help(); });
+        }
+    }
+    if (nb_helpers == 1) {
+        cv.notify_one();
+    } else if (nb_helpers > 1) {
+        cv.notify_all();
+    }
+
+    batch->work();
+
+    std::unique_lock<std::mutex> lock(batch->mutex);
+    // the helpers not started yet will do nothing
+    batch->closed = true;
+    batch->done.wait(lock, [&] { return batch->nb_running_helpers == 0; });
+    if (batch->error) {
+        std::rethrow_exception(batch->error);
+    }
+}
+
+}  // namespace routing
+}  // namespace navitia
@@ -0,0 +1,83 @@
+/* Copyright © 2001-2014, Canal TP and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+channel `#navitia` on riot https://riot.im/app/#/room/#navitia:matrix.org
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace navitia {
+namespace routing {
+
+/*
+ * Threads shared by all the workers of a kraken to parallelise a single request.
+ *
+ * The number of threads is fixed, whatever the number of requests computed at the same time.
+ * A parallel_for is computed by the calling thread, helped by the threads of the pool that are
+ * idle: when the pool is busy, the work is done by the calling thread alone, so the cores are
+ * never oversubscribed by the requests.
+ */
+class HelperPool {
+public:
+    /// The pool of the process, with one thread by core
+    static HelperPool& get();
+
+    explicit HelperPool(size_t nb_threads);
+    ~HelperPool();
+    HelperPool(const HelperPool&) = delete;
+    HelperPool& operator=(const HelperPool&) = delete;
+
+    size_t nb_threads() const { return threads.size(); }
+
+    /*
+     * Calls f(i) for each i of [0, nb_tasks), the tasks being taken one at a time by the calling
+     * thread and by at most max_helpers idle threads of the pool.
+     * The first exception raised by a task stops the remaining ones and is rethrown.
+     */
+    void parallel_for(size_t nb_tasks, size_t max_helpers, const std::function<void(size_t)>& f);
+
+private:
+    std::vector<std::thread> threads;
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<std::function<void()>> jobs;
+    size_t nb_idle = 0;
+    bool stopped = false;
+
+    void run();
+};
+
+}  // namespace routing
+}  // namespace navitia
@@ -41,10 +41,13 @@ www.navitia.io
 #include <boost/range/algorithm.hpp>
 
 #include <algorithm>
+#include <array>
 #include <cassert>
 #include <cmath>
+#include <limits>
 #include <set>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace navitia {
@@ -186,6 +189,214 @@ DateTime build_bound(const bool clockwise, const DateTime duration, const DateTi
     return clockwise ? init_dt + duration : init_dt - duration;
 }
 
+// Max number of nodes on each side of the raster of an isochrone
+constexpr static size_t MAX_RASTER_SIZE = 1024;
+
+// Min size of a cell of the raster of an isochrone, in meter
+constexpr static double MIN_RASTER_CELL = 10;
+
+namespace {
+
+/*
+ * Regular grid of nodes on an equirectangular projection (in meter) around the circles.
+ * Each node holds the signed distance to the union of the circles (positive inside),
+ * the border nodes being always outside.
+ */
+struct CirclesRaster {
+    double coslat;
+    double cell;
+    double min_x;
+    double min_y;
+    size_t nb_x;
+    size_t nb_y;
+    std::vector<float> field;
+
+    explicit CirclesRaster(const std::vector<std::pair<type::GeographicalCoord, double>>& circles)
+        : coslat(cos(circles.front().first.lat() * type::GeographicalCoord::N_DEG_TO_RAD)) {
+        double max_x = std::numeric_limits<double>::lowest();
+        double max_y = std::numeric_limits<double>::lowest();
+        min_x = std::numeric_limits<double>::max();
+        min_y = std::numeric_limits<double>::max();
+        for (const auto& c : circles) {
+            min_x = std::min(min_x, x(c.first) - c.second);
+            min_y = std::min(min_y, y(c.first) - c.second);
+            max_x = std::max(max_x, x(c.first) + c.second);
+            max_y = std::max(max_y, y(c.first) + c.second);
+        }
+        cell = std::max(MIN_RASTER_CELL, std::max(max_x - min_x, max_y - min_y) / (MAX_RASTER_SIZE - 3));
+        // one cell of margin on each side, the border nodes are outside of all circles
+        min_x -= cell;
+        min_y -= cell;
+        nb_x = size_t(ceil((max_x - min_x) / cell)) + 2;
+        nb_y = size_t(ceil((max_y - min_y) / cell)) + 2;
+        field.assign(nb_x * nb_y, std::numeric_limits<float>::lowest());
+
+        parallel_for_bands(nb_y, 64, [&](const size_t begin, const size_t end) { fill(circles, begin, end); });
+    }
+
+    double x(const type::GeographicalCoord& coord) const {
+        return coord.lon() * type::GeographicalCoord::N_DEG_TO_RAD * type::GeographicalCoord::EARTH_RADIUS_IN_METERS
+               * coslat;
+    }
+    double y(const type::GeographicalCoord& coord) const {
+        return coord.lat() * type::GeographicalCoord::N_DEG_TO_RAD * type::GeographicalCoord::EARTH_RADIUS_IN_METERS;
+    }
+    type::GeographicalCoord coord(const double x, const double y) const {
+        const double lat = y / type::GeographicalCoord::EARTH_RADIUS_IN_METERS * N_RAD_TO_DEG;
+        const double lon = x / (type::GeographicalCoord::EARTH_RADIUS_IN_METERS * coslat) * N_RAD_TO_DEG;
+        return type::GeographicalCoord(lon, lat);
+    }
+
+    float at(const size_t i, const size_t j) const { return field[j * nb_x + i]; }
+
+    // Computes the nodes of the rows [begin, end).
+    // Each circle updates the nodes inside it and their neighbours, so that every crossing of the contour
+    // is interpolated between two computed values
+    void fill(const std::vector<std::pair<type::GeographicalCoord, double>>& circles,
+              const size_t begin,
+              const size_t end) {
+        for (const auto& c : circles) {
+            const double cx = x(c.first) - min_x;
+            const double cy = y(c.first) - min_y;
+            const double radius = c.second;
+            const auto first_row = size_t(std::max(0., floor((cy - radius) / cell) - 1));
+            const auto last_row = std::min(size_t(ceil((cy + radius) / cell) + 1), nb_y - 1);
+            for (size_t j = std::max(begin, first_row); j < end && j <= last_row; ++j) {
+                const double dy = j * cell - cy;
+                const double inner_dy = std::max(fabs(dy) - cell, 0.);
+                const double half_width = sqrt(std::max(radius * radius - inner_dy * inner_dy, 0.)) + cell;
+                const auto first_col = size_t(std::max(0., floor((cx - half_width) / cell)));
+                const auto last_col = std::min(size_t(ceil((cx + half_width) / cell)), nb_x - 1);
+                float* row = &field[j * nb_x];
+                // kept branch free to be vectorised
+                for (size_t i = first_col; i <= last_col; ++i) {
+                    const double dx = i * cell - cx;
+                    row[i] = std::max(row[i], float(radius - sqrt(dx * dx + dy * dy)));
+                }
+            }
+        }
+    }
+
+    // horizontal edge between (i, j) and (i + 1, j), vertical edge between (i, j) and (i, j + 1)
+    size_t h_edge(const size_t i, const size_t j) const { return 2 * (j * nb_x + i); }
+    size_t v_edge(const size_t i, const size_t j) const { return 2 * (j * nb_x + i) + 1; }
+
+    // point where the contour crosses an edge, linearly interpolated on the distance field
+    type::GeographicalCoord crossing(const size_t edge) const {
+        const size_t node = edge / 2;
+        const size_t i = node % nb_x;
+        const size_t j = node / nb_x;
+        const bool horizontal = edge % 2 == 0;
+        const double a = at(i, j);
+        const double b = horizontal ? at(i + 1, j) : at(i, j + 1);
+        const double t = a / (a - b);
+        return coord(min_x + (i + (horizontal ? t : 0)) * cell, min_y + (j + (horizontal ? 0 : t)) * cell);
+    }
+
+    /*
+     * Marching squares: returns the contour edges, from each crossed edge to the next one,
+     * oriented with the inside on the left.
+     *
+     * Going counter clockwise around a cell, the crossings alternate between leaving and entering the inside.
+     * Each segment goes from a leaving crossing to an entering one: the next crossing if the center of the cell
+     * is inside, the previous one otherwise (this only matters for the saddle cells).
+     */
+    std::unordered_map<size_t, size_t> contour_segments() const {
+        std::unordered_map<size_t, size_t> next;
+        for (size_t j = 0; j + 1 < nb_y; ++j) {
+            for (size_t i = 0; i + 1 < nb_x; ++i) {
+                const std::array<float, 4> values = {{at(i, j), at(i + 1, j), at(i + 1, j + 1), at(i, j + 1)}};
+                const std::array<size_t, 4> edges = {{h_edge(i, j), v_edge(i + 1, j), h_edge(i, j + 1), v_edge(i, j)}};
+                std::array<size_t, 4> crossings;
+                std::array<bool, 4> leaving;
+                size_t nb_crossings = 0;
+                for (size_t k = 0; k < 4; ++k) {
+                    const bool inside = values[k] > 0;
+                    if (inside != (values[(k + 1) % 4] > 0)) {
+                        crossings[nb_crossings] = edges[k];
+                        leaving[nb_crossings] = inside;
+                        ++nb_crossings;
+                    }
+                }
+                if (nb_crossings == 0) {
+                    continue;
+                }
+                const bool center_inside = values[0] + values[1] + values[2] + values[3] > 0;
+                for (size_t k = 0; k < nb_crossings; ++k) {
+                    if (leaving[k]) {
+                        const size_t other = center_inside ? (k + 1) % nb_crossings
+                                                           : (k + nb_crossings - 1) % nb_crossings;
+                        next[crossings[k]] = crossings[other];
+                    }
+                }
+            }
+        }
+        return next;
+    }
+};
+
+}  // namespace
+
+type::MultiPolygon raster_circles_union(const std::vector<std::pair<type::GeographicalCoord, double>>& circles) {
+    type::MultiPolygon result;
+    if (circles.empty()) {
+        return result;
+    }
+    const CirclesRaster raster(circles);
+    auto next = raster.contour_segments();
+
+    // outer rings are counter clockwise, holes clockwise
+    std::vector<type::Polygon> outers;
+    std::vector<type::Polygon> holes;
+    while (!next.empty()) {
+        type::Polygon ring;
+        auto it = next.begin();
+        const size_t first = it->first;
+        size_t edge = first;
+        do {
+            ring.outer().push_back(raster.crossing(edge));
+            it = next.find(edge);
+            if (it == next.end()) {
+                // cannot happen on a closed field, but we'd rather drop the ring than loop forever
+                break;
+            }
+            edge = it->second;
+            next.erase(it);
+        } while (edge != first);
+        if (ring.outer().size() < 3) {
+            continue;
+        }
+        ring.outer().push_back(ring.outer().front());
+        const bool counter_clockwise = boost::geometry::area(ring) < 0;
+        (counter_clockwise ? outers : holes).push_back(std::move(ring));
+    }
+
+    for (auto& outer : outers) {
+        boost::geometry::correct(outer);
+    }
+    for (auto& hole : holes) {
+        boost::geometry::correct(hole);
+        // the hole goes in the smallest outer ring containing it, islands may be in the hole of another ring
+        type::Polygon* owner = nullptr;
+        double owner_area = std::numeric_limits<double>::max();
+        for (auto& outer : outers) {
+            if (boost::geometry::within(hole.outer().front(), outer)) {
+                const double area = boost::geometry::area(outer);
+                if (area < owner_area) {
+                    owner = &outer;
+                    owner_area = area;
+                }
+            }
+        }
+        if (owner) {
+            owner->inners().push_back(std::move(hole.outer()));
+        }
+    }
+    result.assign(outers.begin(), outers.end());
+    boost::geometry::correct(result);
+    return result;
+}
+
 type::MultiPolygon build_single_isochrone(RAPTOR& raptor,
                                           const std::vector<type::StopPoint*>& stop_points,
                                           const bool clockwise,
@@ -222,6 +433,14 @@ type::MultiPolygon build_single_isochrone(RAPTOR& raptor,
     }
     std::vector<InfoCircle> circles_check = delete_useless_circle(std::move(circles_classed), speed);
 
+    if (circles_check.size() >= MIN_CIRCLES_FOR_RASTER) {
+        std::vector<std::pair<type::GeographicalCoord, double>> raster_circles;
+        raster_circles.reserve(circles_check.size());
+        for (const auto& c : circles_check) {
+            raster_circles.emplace_back(c.center, c.duration_left * speed);
+        }
+        return raster_circles_union(raster_circles);
+    }
     for (const auto& c : circles_check) {
         type::Polygon circle_to_add = circle(c.center, c.duration_left * speed);
         circles = merge_poly(circles, circle_to_add);
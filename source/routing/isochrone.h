@@ -33,7 +33,9 @@ www.navitia.io
 #include "type/geographical_coord.h"
 #include "utils/exception.h"
 #include "raptor.h"
+#include "routing/helper_pool.h"
 
+#include <algorithm>
 #include <set>
 
 namespace navitia {
@@ -59,6 +61,33 @@ type::GeographicalCoord project_in_direction(const type::GeographicalCoord& cent
 // Create a circle
 type::Polygon circle(const type::GeographicalCoord& center, const double& radius);
 
+// Above this number of circles, the isochrone is rasterised instead of merging the circles one by one
+constexpr static size_t MIN_CIRCLES_FOR_RASTER = 64;
+
+// Max number of threads used by a single raster computation
+constexpr static size_t MAX_RASTER_THREADS = 8;
+
+/*
+ * Calls f(begin, end) on contiguous bands of [0, nb_items) in parallel, on the HelperPool.
+ * A band holds at least min_items_by_thread items, so small rasters stay on the calling thread.
+ * The first exception raised by a band is rethrown once all the bands are done.
+ */
+template <typename F>
+void parallel_for_bands(const size_t nb_items, const size_t min_items_by_thread, const F& f) {
+    const size_t nb_bands = std::max<size_t>(1, std::min(MAX_RASTER_THREADS, nb_items / min_items_by_thread));
+    if (nb_bands == 1) {
+        f(size_t(0), nb_items);
+        return;
+    }
+    const size_t band_size = (nb_items + nb_bands - 1) / nb_bands;
+    HelperPool::get().parallel_for(nb_bands, nb_bands - 1, [&](const size_t band) {
+        const size_t begin = band * band_size;
+        if (begin < nb_items) {
+            f(begin, std::min(nb_items, begin + band_size));
+        }
+    });
+}
+
 template <typename T>
 bool in_bound(const T& begin, const T& end, bool clockwise) {
     return (clockwise && begin < end) || (!clockwise && begin > end);
@@ -66,6 +95,10 @@ bool in_bound(const T& begin, const T& end, bool clockwise) {
 
 DateTime build_bound(const bool clockwise, const DateTime duration, const DateTime init_dt);
 
+// Union of circles (center, radius in meter) computed on a raster of their signed distance field,
+// the contours being traced back with marching squares
+type::MultiPolygon raster_circles_union(const std::vector<std::pair<type::GeographicalCoord, double>>& circles);
+
 // Create a multi polygon with circles around all the stop points in the isochrone
 type::MultiPolygon build_single_isochrone(RAPTOR& raptor,
                                           const std::vector<type::StopPoint*>& stop_points,
@@ -0,0 +1,150 @@
+/* Copyright © 2001-2014, Canal TP and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+channel `#navitia` on riot https://riot.im/app/#/room/#navitia:matrix.org
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#include "routing/lower_bound_oracle.h"
+
+#include "type/pt_data.h"
+#include "type/stop_area.h"
+#include "type/stop_point.h"
+#include "type/connection.h"
+#include "type/stop_time.h"
+#include "type/vehicle_journey.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <map>
+#include <queue>
+
+namespace navitia {
+namespace routing {
+
+namespace {
+// a stop area, or a stop point without stop area, never split between two clusters
+struct Unit {
+    type::GeographicalCoord coord;
+    std::vector<SpIdx> stop_points;
+};
+
+std::vector<Unit> make_units(const type::PT_Data& pt_data) {
+    std::vector<Unit> res;
+    for (const auto* sa : pt_data.stop_areas) {
+        Unit unit{sa->coord, {}};
+        for (const auto* sp : sa->stop_point_list) {
+            unit.stop_points.push_back(SpIdx(*sp));
+        }
+        res.push_back(std::move(unit));
+    }
+    for (const auto* sp : pt_data.stop_points) {
+        if (!sp->stop_area) {
+            res.push_back({sp->coord, {SpIdx(*sp)}});
+        }
+    }
+    return res;
+}
+}  // namespace
+
+LowerBoundOracle::LowerBoundOracle(const type::PT_Data& pt_data, const size_t max_nb_clusters)
+    : clusters(pt_data.stop_points.size(), 0) {
+    // stripes of longitude, then cells of latitude in each stripe, with the same number of units
+    auto units = make_units(pt_data);
+    const size_t nb_stripes = std::max<size_t>(1, std::floor(std::sqrt(max_nb_clusters)));
+    const size_t nb_cells = std::max<size_t>(1, max_nb_clusters / nb_stripes);
+    nb = nb_stripes * nb_cells;
+    std::sort(units.begin(), units.end(),
+              [](const Unit& a, const Unit& b) { return a.coord.lon() < b.coord.lon(); });
+    const size_t stripe_size = (units.size() + nb_stripes - 1) / nb_stripes;
+    for (size_t stripe = 0; stripe * stripe_size < units.size(); ++stripe) {
+        const auto begin = units.begin() + stripe * stripe_size;
+        const auto end = units.begin() + std::min(units.size(), (stripe + 1) * stripe_size);
+        std::sort(begin, end, [](const Unit& a, const Unit& b) { return a.coord.lat() < b.coord.lat(); });
+        const size_t cell_size = (end - begin + nb_cells - 1) / nb_cells;
+        for (auto it = begin; it != end; ++it) {
+            const auto cell = size_t(it - begin) / cell_size;
+            for (const auto& sp : it->stop_points) {
+                clusters[sp.val] = ClusterIdx(stripe * nb_cells + cell);
+            }
+        }
+    }
+
+    // the edges of the cluster graph, with their shortest duration
+    std::map<std::pair<ClusterIdx, ClusterIdx>, DateTime> edges;
+    const auto add_edge = [&](const SpIdx from, const SpIdx to, const DateTime duration) {
+        if (cluster(from) == cluster(to)) {
+            return;
+        }
+        const auto it = edges.emplace(std::make_pair(cluster(from), cluster(to)), duration).first;
+        it->second = std::min(it->second, duration);
+    };
+    for (const auto* vj : pt_data.vehicle_journeys) {
+        const auto& sts = vj->stop_time_list;
+        for (size_t i = 1; i < sts.size(); ++i) {
+            const auto ride = int64_t(sts[i].arrival_time) - int64_t(sts[i - 1].departure_time);
+            add_edge(SpIdx(*sts[i - 1].stop_point), SpIdx(*sts[i].stop_point), DateTime(std::max<int64_t>(0, ride)));
+        }
+        if (vj->next_vj && !sts.empty() && !vj->next_vj->stop_time_list.empty()) {
+            add_edge(SpIdx(*sts.back().stop_point), SpIdx(*vj->next_vj->stop_time_list.front().stop_point), 0);
+        }
+    }
+    for (const auto* conn : pt_data.stop_point_connections) {
+        add_edge(SpIdx(*conn->departure), SpIdx(*conn->destination), DateTime(conn->duration));
+    }
+    std::vector<std::vector<std::pair<ClusterIdx, DateTime>>> out_edges(nb);
+    for (const auto& edge : edges) {
+        out_edges[edge.first.first].emplace_back(edge.first.second, edge.second);
+    }
+
+    // a dijkstra from each cluster
+    durations.assign(nb * nb, DateTimeUtils::inf);
+    using Elt = std::pair<DateTime, ClusterIdx>;
+    for (size_t from = 0; from < nb; ++from) {
+        auto* dist = &durations[from * nb];
+        std::priority_queue<Elt, std::vector<Elt>, std::greater<Elt>> queue;
+        dist[from] = 0;
+        queue.emplace(0, ClusterIdx(from));
+        while (!queue.empty()) {
+            const auto elt = queue.top();
+            queue.pop();
+            if (elt.first != dist[elt.second]) {
+                continue;
+            }
+            for (const auto& edge : out_edges[elt.second]) {
+                const DateTime d = elt.first + edge.second;
+                if (d < dist[edge.first]) {
+                    dist[edge.first] = d;
+                    queue.emplace(d, edge.first);
+                }
+            }
+        }
+    }
+}
+
+}  // namespace routing
+}  // namespace navitia
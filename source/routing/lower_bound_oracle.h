@@ -0,0 +1,71 @@
+/* Copyright © 2001-2014, Canal TP and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+channel `#navitia` on riot https://riot.im/app/#/room/#navitia:matrix.org
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#pragma once
+
+#include "type/datetime.h"
+#include "routing/raptor_utils.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace navitia {
+namespace type {
+struct PT_Data;
+}
+namespace routing {
+
+/** Lower bounds of the public transport travel time between areas of the network
+ *
+ * The stop areas are split geographically in clusters of about the same number of stop
+ * areas.  A graph of the clusters is built with, as edges, the shortest ride between two
+ * consecutive stop times of any vehicle journey, the stay-ins and the connections.  The
+ * shortest path between two clusters in this graph is thus never longer than a journey
+ * between any of their stop points, whatever the date, the number of transfers or the
+ * waiting times.
+ */
+struct LowerBoundOracle {
+    using ClusterIdx = uint16_t;
+
+    explicit LowerBoundOracle(const type::PT_Data& pt_data, size_t max_nb_clusters = 256);
+
+    ClusterIdx cluster(const SpIdx sp) const { return clusters[sp.val]; }
+    size_t nb_clusters() const { return nb; }
+    /// DateTimeUtils::inf if `to` cannot be reached from `from`
+    DateTime duration(const ClusterIdx from, const ClusterIdx to) const { return durations[from * nb + to]; }
+
+private:
+    std::vector<ClusterIdx> clusters;  // by stop point
+    size_t nb = 0;
+    std::vector<DateTime> durations;  // nb * nb, by departure cluster then arrival cluster
+};
+
+}  // namespace routing
+}  // namespace navitia
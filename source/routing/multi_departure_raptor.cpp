@@ -0,0 +1,332 @@
+/* Copyright © 2001-2014, Canal TP and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+channel `#navitia` on riot https://riot.im/app/#/room/#navitia:matrix.org
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#include "routing/multi_departure_raptor.h"
+
+#include "routing/isochrone.h"
+#include "routing/raptor_visitors.h"
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+
+namespace navitia {
+namespace routing {
+
+constexpr size_t MultiDepartureRaptor::max_lanes;
+
+namespace {
+// calls f(lane) for each lane of the mask
+template <typename F>
+void for_each_lane(MultiDepartureRaptor::LaneMask mask, const F& f) {
+    while (mask) {
+        f(size_t(__builtin_ctzll(mask)));
+        mask &= mask - 1;
+    }
+}
+}  // namespace
+
+MultiDepartureRaptor::MultiDepartureRaptor(const type::Data& data)
+    : data(data), Q(data.dataRaptor->jp_container.get_jps_values()) {}
+
+void MultiDepartureRaptor::isochrones(const map_stop_point_duration& departures,
+                                      const std::vector<DateTime>& departure_datetimes,
+                                      const DateTime max_duration,
+                                      const uint32_t max_transfers,
+                                      const type::AccessibiliteParams& accessibilite_params,
+                                      const std::vector<std::string>& forbidden,
+                                      const std::vector<std::string>& allowed,
+                                      const bool clockwise,
+                                      const nt::RTLevel rt_level,
+                                      const std::function<void(size_t)>& on_result) {
+    nb_passes = 0;
+    bounds.clear();
+    for (const auto dt : departure_datetimes) {
+        bounds.push_back(limit_bound(clockwise, dt, build_bound(clockwise, max_duration, dt)));
+    }
+    lanes.assign(departure_datetimes.size(), 0);
+
+    // a batch shares the valid journey patterns and the next stop time cache, that depend on the date
+    const auto batch_key = [&](const size_t i) {
+        return std::make_pair(DateTimeUtils::date(departure_datetimes[i]),
+                              DateTimeUtils::date(clockwise ? departure_datetimes[i] : bounds[i]));
+    };
+    std::vector<size_t> order(departure_datetimes.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(),
+              [&](const size_t a, const size_t b) { return departure_datetimes[a] < departure_datetimes[b]; });
+
+    std::vector<size_t> batch;
+    const auto flush = [&]() {
+        run_batch(departures, batch, departure_datetimes, max_transfers, accessibilite_params, forbidden, allowed,
+                  clockwise, rt_level);
+        for (const auto i : batch) {
+            on_result(i);
+        }
+        batch.clear();
+    };
+    for (const auto i : order) {
+        if (!batch.empty() && (batch.size() == max_lanes || batch_key(batch.front()) != batch_key(i))) {
+            flush();
+        }
+        batch.push_back(i);
+    }
+    if (!batch.empty()) {
+        flush();
+    }
+}
+
+void MultiDepartureRaptor::fill_best_labels(const size_t i, Labels& best_labels) const {
+    const auto lane = lane_of(i);
+    for (size_t sp = 0; sp < data.pt_data->stop_points.size(); ++sp) {
+        best_labels.mut_dt_pt(SpIdx(sp)) = best_pt[sp * nb_lanes + lane];
+        best_labels.mut_dt_transfer(SpIdx(sp)) = best_transfer[sp * nb_lanes + lane];
+    }
+}
+
+void MultiDepartureRaptor::run_batch(const map_stop_point_duration& departures,
+                                     const std::vector<size_t>& batch,
+                                     const std::vector<DateTime>& departure_datetimes,
+                                     const uint32_t max_transfers,
+                                     const type::AccessibiliteParams& accessibilite_params,
+                                     const std::vector<std::string>& forbidden,
+                                     const std::vector<std::string>& allowed,
+                                     const bool clockwise,
+                                     const nt::RTLevel rt_level) {
+    nb_lanes = batch.size();
+    for (size_t lane = 0; lane < nb_lanes; ++lane) {
+        lanes[batch[lane]] = lane;
+    }
+    const auto first = batch.front();
+    valid_jps = data.dataRaptor->valid_jps_manager->load(DateTimeUtils::date(departure_datetimes[first]), rt_level,
+                                                         accessibilite_params, forbidden, allowed);
+    next_st = data.dataRaptor->cached_next_st_manager->load(clockwise ? departure_datetimes[first] : bounds[first],
+                                                            rt_level, accessibilite_params);
+
+    const size_t nb_sps = data.pt_data->stop_points.size();
+    best_pt.resize(nb_sps * nb_lanes);
+    for (size_t sp = 0; sp < nb_sps; ++sp) {
+        for (size_t lane = 0; lane < nb_lanes; ++lane) {
+            best_pt[sp * nb_lanes + lane] = bounds[batch[lane]];
+        }
+    }
+    best_transfer = best_pt;
+    best_pt_round.assign(nb_sps * nb_lanes, 0);
+    pt_marked.assign(nb_sps, 0);
+    transfer_marked.assign(nb_sps, 0);
+    prev_transfer_marked.assign(nb_sps, 0);
+    Q.assign(data.dataRaptor->jp_container.get_jps_values(), clockwise ? std::numeric_limits<int>::max() : -1);
+
+    const LaneMask all_lanes = nb_lanes == max_lanes ? ~LaneMask(0) : (LaneMask(1) << nb_lanes) - 1;
+    for (const auto& sp_dt : departures) {
+        if (!data.pt_data->stop_points[sp_dt.first.val]->accessible(accessibilite_params.properties)) {
+            continue;
+        }
+        const DateTime sn_dur = sp_dt.second.total_seconds();
+        for (size_t lane = 0; lane < nb_lanes; ++lane) {
+            const auto dt = departure_datetimes[batch[lane]];
+            best_transfer[sp_dt.first.val * nb_lanes + lane] = clockwise ? dt + sn_dur : dt - sn_dur;
+        }
+        prev_transfer_marked[sp_dt.first.val] = all_lanes;
+        for (const auto& jpp : valid_jps->jpps_from_sp[sp_dt.first]) {
+            if (clockwise ? Q[jpp.jp_idx] > jpp.order : Q[jpp.jp_idx] < jpp.order) {
+                Q[jpp.jp_idx] = jpp.order;
+            }
+        }
+    }
+
+    if (clockwise) {
+        raptor_loop(raptor_visitor(), rt_level, max_transfers);
+    } else {
+        raptor_loop(raptor_reverse_visitor(), rt_level, max_transfers);
+    }
+    ++nb_passes;
+}
+
+template <typename Visitor>
+bool MultiDepartureRaptor::apply_vj_extension(const Visitor& v,
+                                              const nt::RTLevel rt_level,
+                                              const type::VehicleJourney* vj,
+                                              const size_t lane,
+                                              const uint16_t l_zone,
+                                              DateTime base_dt) {
+    bool result = false;
+    while (vj) {
+        base_dt = v.get_base_dt_extension(base_dt, vj);
+        const auto& stop_time_list = v.stop_time_list(vj);
+        const auto& st_begin = stop_time_list.front();
+        const auto first_dt = st_begin.section_end(base_dt, v.clockwise());
+
+        // If the vj is not valid for the first stop it won't be valid at all
+        if (!st_begin.is_valid_day(DateTimeUtils::date(first_dt), !v.clockwise(), rt_level)) {
+            return result;
+        }
+        for (const type::StopTime& st : stop_time_list) {
+            if (!st.valid_end(v.clockwise())) {
+                continue;
+            }
+            if (l_zone != std::numeric_limits<uint16_t>::max() && l_zone == st.local_traffic_zone) {
+                continue;
+            }
+            const auto sp_idx = SpIdx(*st.stop_point);
+            if (!valid_jps->stop_points[sp_idx.val]) {
+                continue;
+            }
+            result = improve_pt(v, sp_idx, lane, st.section_end(base_dt, v.clockwise())) || result;
+        }
+        vj = v.get_extension_vj(vj);
+    }
+    return result;
+}
+
+template <typename Visitor>
+bool MultiDepartureRaptor::foot_path(const Visitor& v) {
+    bool result = false;
+    std::fill(transfer_marked.begin(), transfer_marked.end(), 0);
+    const auto& cnx_list = v.clockwise() ? data.dataRaptor->connections.forward_connections
+                                         : data.dataRaptor->connections.backward_connections;
+
+    for (const auto sp_cnx : cnx_list) {
+        const auto mask = pt_marked[sp_cnx.first.val];
+        if (!mask) {
+            continue;
+        }
+        for (const auto& conn : sp_cnx.second) {
+            for_each_lane(mask, [&](const size_t lane) {
+                const DateTime dt = v.combine(best_pt[sp_cnx.first.val * nb_lanes + lane], conn.duration);
+                auto& best = best_transfer[conn.sp_idx.val * nb_lanes + lane];
+                if (v.comp(dt, best)) {
+                    best = dt;
+                    transfer_marked[conn.sp_idx.val] |= LaneMask(1) << lane;
+                    result = true;
+                }
+            });
+        }
+    }
+
+    for (const auto sp_jpps : valid_jps->jpps_from_sp) {
+        if (!transfer_marked[sp_jpps.first.val]) {
+            continue;
+        }
+        for (const auto& jpp : sp_jpps.second) {
+            if (v.comp(jpp.order, Q[jpp.jp_idx])) {
+                Q[jpp.jp_idx] = jpp.order;
+            }
+        }
+    }
+    std::swap(prev_transfer_marked, transfer_marked);
+    return result;
+}
+
+template <typename Visitor>
+void MultiDepartureRaptor::raptor_loop(const Visitor& v, const nt::RTLevel rt_level, const uint32_t max_transfers) {
+    // the vehicle boarded by each lane while scanning a journey pattern
+    struct Onboard {
+        typename Visitor::stop_time_iterator it_st;
+        DateTime base_dt;
+        DateTime working_dt;
+        uint16_t l_zone;
+    };
+    std::vector<Onboard> onboard_lanes(nb_lanes);
+    const auto no_zone = std::numeric_limits<uint16_t>::max();
+
+    bool continue_algorithm = true;
+    for (uint32_t round = 1; continue_algorithm && round - 1 <= max_transfers; ++round) {
+        count = uint8_t(std::min<uint32_t>(round, std::numeric_limits<uint8_t>::max()));
+        continue_algorithm = false;
+        std::fill(pt_marked.begin(), pt_marked.end(), 0);
+
+        for (auto q_elt : Q) {
+            if (q_elt.second == v.init_queue_item()) {
+                continue;
+            }
+            LaneMask onboard = 0;
+            for (const auto& jpp : v.jpps_from_order(data.dataRaptor->jpps_from_jp, q_elt.first, q_elt.second)) {
+                const bool valid_sp = valid_jps->stop_points[jpp.sp_idx.val];
+                for_each_lane(onboard, [&](const size_t lane) {
+                    auto& lane_onboard = onboard_lanes[lane];
+                    ++lane_onboard.it_st;
+                    const type::StopTime& st = *lane_onboard.it_st;
+                    lane_onboard.working_dt = st.section_end(lane_onboard.base_dt, v.clockwise());
+                    if (valid_sp && st.valid_end(v.clockwise())
+                        && (lane_onboard.l_zone == no_zone || lane_onboard.l_zone != st.local_traffic_zone)) {
+                        continue_algorithm =
+                            improve_pt(v, jpp.sp_idx, lane, lane_onboard.working_dt) || continue_algorithm;
+                    }
+                });
+                if (!valid_sp) {
+                    continue;
+                }
+
+                // the lanes that have reached this stop point at the previous round try to board
+                for_each_lane(prev_transfer_marked[jpp.sp_idx.val], [&](const size_t lane) {
+                    const auto previous_dt = best_transfer[jpp.sp_idx.val * nb_lanes + lane];
+                    const auto tmp_st_dt = next_st->next_stop_time(v.stop_event(), jpp.idx, previous_dt, v.clockwise());
+                    if (tmp_st_dt.first == nullptr) {
+                        return;
+                    }
+                    const auto candidate_base_dt = tmp_st_dt.first->base_dt(tmp_st_dt.second, v.clockwise());
+                    const auto candidate_debark_time = v.clockwise() ? tmp_st_dt.first->arrival(candidate_base_dt)
+                                                                     : tmp_st_dt.first->departure(candidate_base_dt);
+                    const LaneMask bit = LaneMask(1) << lane;
+                    auto& lane_onboard = onboard_lanes[lane];
+                    if ((onboard & bit) && !v.be(candidate_debark_time, lane_onboard.working_dt)) {
+                        return;
+                    }
+                    if (!(onboard & bit) || &*lane_onboard.it_st != tmp_st_dt.first) {
+                        lane_onboard.it_st = v.st_range(*tmp_st_dt.first).begin();
+                        lane_onboard.l_zone = lane_onboard.it_st->local_traffic_zone;
+                        onboard |= bit;
+                    } else if (lane_onboard.l_zone != lane_onboard.it_st->local_traffic_zone) {
+                        lane_onboard.l_zone = no_zone;
+                    }
+                    lane_onboard.working_dt = candidate_debark_time;
+                    lane_onboard.base_dt = candidate_base_dt;
+                });
+            }
+            for_each_lane(onboard, [&](const size_t lane) {
+                const auto& lane_onboard = onboard_lanes[lane];
+                const auto* vj_stay_in = v.get_extension_vj(lane_onboard.it_st->vehicle_journey);
+                if (vj_stay_in) {
+                    continue_algorithm = apply_vj_extension(v, rt_level, vj_stay_in, lane, lane_onboard.l_zone,
+                                                            lane_onboard.base_dt)
+                                         || continue_algorithm;
+                }
+            });
+            q_elt.second = v.init_queue_item();
+        }
+        if (continue_algorithm) {
+            continue_algorithm = foot_path(v);
+        }
+    }
+}
+
+}  // namespace routing
+}  // namespace navitia
@@ -0,0 +1,143 @@
+/* Copyright © 2001-2014, Canal TP and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+channel `#navitia` on riot https://riot.im/app/#/room/#navitia:matrix.org
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#pragma once
+
+#include "routing/raptor.h"
+
+#include <functional>
+#include <vector>
+
+namespace navitia {
+namespace routing {
+
+/** Raptor for the same stop points at many datetimes
+ *
+ * The accessibility analyses ask for isochrones and heat maps every few minutes of a day
+ * from the same origin.  Up to max_lanes datetimes sharing their next stop time cache are
+ * computed in the same pass: each datetime is a lane of the labels, and the journey
+ * patterns, the stop points and the connections are scanned once for all the lanes that
+ * have been improved, as marked by a bit of a LaneMask.
+ *
+ * Only the best datetime of the labels is kept, as needed by the isochrones and the heat
+ * maps, thus the walking duration does not break the ties.
+ */
+struct MultiDepartureRaptor {
+    using LaneMask = uint64_t;
+    static constexpr size_t max_lanes = 64;
+
+    explicit MultiDepartureRaptor(const type::Data& data);
+
+    /*
+     * The same as a RAPTOR::isochrone for each datetime, bounded by max_duration.  The
+     * datetimes are computed by batches, and on_result(i) is called once the i-th datetime is
+     * computed, while its labels can be read with dt_pt and fill_best_labels.
+     */
+    void isochrones(const map_stop_point_duration& departures,
+                    const std::vector<DateTime>& departure_datetimes,
+                    const DateTime max_duration,
+                    const uint32_t max_transfers,
+                    const type::AccessibiliteParams& accessibilite_params,
+                    const std::vector<std::string>& forbidden,
+                    const std::vector<std::string>& allowed,
+                    const bool clockwise,
+                    const nt::RTLevel rt_level,
+                    const std::function<void(size_t)>& on_result);
+
+    /// Best arrival (resp. departure) at the stop point for the i-th datetime of the current batch
+    DateTime dt_pt(const size_t i, const SpIdx sp) const { return best_pt[sp.val * nb_lanes + lane_of(i)]; }
+    /// Number of vehicles used by the best label of the stop point for the i-th datetime of the current batch
+    unsigned round_pt(const size_t i, const SpIdx sp) const { return best_pt_round[sp.val * nb_lanes + lane_of(i)]; }
+    /// Copy the labels of the i-th datetime, as RAPTOR::isochrone would have left them
+    void fill_best_labels(const size_t i, Labels& best_labels) const;
+    /// The bound used for the i-th datetime
+    DateTime bound(const size_t i) const { return bounds[i]; }
+
+    /// Number of passes done by the last call to isochrones
+    size_t nb_passes = 0;
+
+private:
+    const type::Data& data;
+    std::shared_ptr<const CachedNextStopTime> next_st;
+    std::shared_ptr<const ValidJourneyPatterns> valid_jps;
+    IdxMap<JourneyPattern, int> Q;
+
+    std::vector<DateTime> bounds;         // by datetime
+    std::vector<size_t> lanes;            // by datetime, the lane in its batch
+    size_t nb_lanes = 0;                  // of the current batch
+    std::vector<DateTime> best_pt;        // by stop point then by lane
+    std::vector<DateTime> best_transfer;
+    std::vector<uint8_t> best_pt_round;   // by stop point then by lane, the vehicles used by best_pt
+    uint8_t count = 0;                    // the current round, saturated
+    std::vector<LaneMask> pt_marked;      // by stop point, lanes improved by the current round
+    std::vector<LaneMask> transfer_marked;
+    std::vector<LaneMask> prev_transfer_marked;
+
+    size_t lane_of(const size_t i) const { return lanes[i]; }
+
+    void run_batch(const map_stop_point_duration& departures,
+                   const std::vector<size_t>& batch,
+                   const std::vector<DateTime>& departure_datetimes,
+                   const uint32_t max_transfers,
+                   const type::AccessibiliteParams& accessibilite_params,
+                   const std::vector<std::string>& forbidden,
+                   const std::vector<std::string>& allowed,
+                   const bool clockwise,
+                   const nt::RTLevel rt_level);
+
+    template <typename Visitor>
+    void raptor_loop(const Visitor& v, const nt::RTLevel rt_level, const uint32_t max_transfers);
+
+    template <typename Visitor>
+    bool foot_path(const Visitor& v);
+
+    template <typename Visitor>
+    bool apply_vj_extension(const Visitor& v,
+                            const nt::RTLevel rt_level,
+                            const type::VehicleJourney* vj,
+                            const size_t lane,
+                            const uint16_t l_zone,
+                            DateTime base_dt);
+
+    template <typename Visitor>
+    bool improve_pt(const Visitor& v, const SpIdx sp, const size_t lane, const DateTime dt) {
+        auto& best = best_pt[sp.val * nb_lanes + lane];
+        if (!v.comp(dt, best)) {
+            return false;
+        }
+        best = dt;
+        best_pt_round[sp.val * nb_lanes + lane] = count;
+        pt_marked[sp.val] |= LaneMask(1) << lane;
+        return true;
+    }
+};
+
+}  // namespace routing
+}  // namespace navitia
@@ -41,6 +41,10 @@ www.navitia.io
 #include <boost/range/algorithm/sort.hpp>
 #include <boost/range/algorithm_ext/push_back.hpp>
 
+#include <chrono>
+#include <exception>
+#include <thread>
+
 namespace nt = navitia::type;
 
 namespace navitia {
@@ -419,7 +423,35 @@ bool CachedNextStopTimeKey::operator<(const CachedNextStopTimeKey& other) const
     return accessibilite_params < other.accessibilite_params;
 }
 
+namespace {
+// the counters of all the managers, that are monotonic as the managers are replaced at each reload
+std::atomic<uint64_t> nb_loads{0};
+std::atomic<uint64_t> nb_misses{0};
+std::atomic<uint64_t> nb_prefetched{0};
+std::atomic<uint64_t> nb_evictions{0};
+std::atomic<uint64_t> build_duration_us{0};
+
+// set by the threads building caches that are not requested yet
+thread_local bool is_prefetching = false;
+
+struct PrefetchingGuard {
+    PrefetchingGuard() { is_prefetching = true; }
+    ~PrefetchingGuard() { is_prefetching = false; }
+};
+}  // namespace
+
 CachedNextStopTime CachedNextStopTimeManager::CacheCreator::operator()(const CachedNextStopTimeKey& key) const {
+    const auto start = std::chrono::steady_clock::now();
+    if (is_prefetching) {
+        ++nb_prefetched;
+    } else {
+        ++nb_misses;
+    }
+    // the lru keeps at most max_cache caches, each new one evicts another
+    if (++nb_built > max_cache) {
+        ++nb_evictions;
+    }
+
     CachedNextStopTime::vDtStByJpp departure, arrival;
     const auto& jp_container = dataRaptor.jp_container;
 
@@ -441,7 +473,10 @@ CachedNextStopTime CachedNextStopTimeManager::CacheCreator::operator()(const Cac
     for (const auto jpp_dtst : departure) {
         boost::sort(jpp_dtst.second, compare);
     }
-    return {departure, arrival};
+    CachedNextStopTime result{departure, arrival};
+    build_duration_us += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start)
+                             .count();
+    return result;
 }
 
 CachedNextStopTime::DtStFromJpp::DtStFromJpp(const vDtStByJpp& map) {
@@ -501,9 +536,91 @@ std::shared_ptr<const CachedNextStopTime> CachedNextStopTimeManager::load(
     const type::RTLevel rt_level,
     const type::AccessibiliteParams& accessibilite_params) {
     CachedNextStopTimeKey key(DateTimeUtils::date(from), rt_level, accessibilite_params);
+    {
+        std::lock_guard<std::mutex> lock(accessibilities_mutex);
+        ++nb_requests_by_accessibility[accessibilite_params];
+    }
+    ++nb_loads;
     return lru(key);
 }
 
+void CachedNextStopTimeManager::warmup(const CachedNextStopTimeManager& other) {
+    {
+        std::lock_guard<std::mutex> lock(other.accessibilities_mutex);
+        nb_requests_by_accessibility = other.nb_requests_by_accessibility;
+    }
+    PrefetchingGuard guard;
+    this->lru.warmup(other.lru);
+}
+
+void CachedNextStopTimeManager::prefetch(const std::vector<CachedNextStopTimeKey>& keys,
+                                         size_t nb_threads,
+                                         const std::function<bool()>& is_cancelled) {
+    const size_t nb_keys = std::min(keys.size(), max_cache);
+    nb_threads = std::max<size_t>(1, std::min(nb_threads, nb_keys));
+    std::atomic<size_t> next_key{0};
+    const auto work = [&]() {
+        PrefetchingGuard guard;
+        for (size_t k = next_key++; k < nb_keys && !is_cancelled(); k = next_key++) {
+            lru(keys[k]);
+        }
+    };
+
+    std::vector<std::exception_ptr> errors(nb_threads);
+    std::vector<std::thread> threads;
+    for (size_t t = 1; t < nb_threads; ++t) {
+        threads.emplace_back([&work, &errors, t] {
+            try {
+                work();
+            } catch (...) {
+                errors[t] = std::current_exception();
+            }
+        });
+    }
+    try {
+        work();
+    } catch (...) {
+        errors[0] = std::current_exception();
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    for (const auto& error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+}
+
+std::vector<type::AccessibiliteParams> CachedNextStopTimeManager::popular_accessibilities(size_t nb) const {
+    std::vector<std::pair<uint64_t, type::AccessibiliteParams>> by_popularity;
+    {
+        std::lock_guard<std::mutex> lock(accessibilities_mutex);
+        for (const auto& accessibility_nb : nb_requests_by_accessibility) {
+            by_popularity.emplace_back(accessibility_nb.second, accessibility_nb.first);
+        }
+    }
+    std::stable_sort(by_popularity.begin(), by_popularity.end(),
+                     [](const std::pair<uint64_t, type::AccessibiliteParams>& a,
+                        const std::pair<uint64_t, type::AccessibiliteParams>& b) { return a.first > b.first; });
+    std::vector<type::AccessibiliteParams> result;
+    for (size_t i = 0; i < std::min(nb, by_popularity.size()); ++i) {
+        result.push_back(by_popularity[i].second);
+    }
+    return result;
+}
+
+NextStopTimeCacheCounters CachedNextStopTimeManager::counters() {
+    NextStopTimeCacheCounters result;
+    // the misses are read first, as each miss follows its load
+    result.nb_misses = nb_misses;
+    result.nb_hits = nb_loads - result.nb_misses;
+    result.nb_prefetched = nb_prefetched;
+    result.nb_evictions = nb_evictions;
+    result.build_duration = build_duration_us / 1e6;
+    return result;
+}
+
 inline static bool within(u_int32_t val, std::pair<u_int32_t, u_int32_t> bound) {
     return val >= bound.first && val <= bound.second;
 }
@@ -45,6 +45,11 @@ www.navitia.io
 #include <boost/optional.hpp>
 #include <boost/dynamic_bitset.hpp>
 
+#include <atomic>
+#include <functional>
+#include <map>
+#include <mutex>
+
 namespace navitia {
 
 namespace type {
@@ -266,27 +271,58 @@ private:
     DtStFromJpp arrival;
 };
 
+/// Counters of all the next stop time caches of the process, for the monitoring
+struct NextStopTimeCacheCounters {
+    uint64_t nb_hits = 0;
+    uint64_t nb_misses = 0;      // caches built for a request
+    uint64_t nb_prefetched = 0;  // caches built by prefetch or warmup
+    uint64_t nb_evictions = 0;
+    double build_duration = 0;  // in seconds, of all the built caches
+};
+
 struct CachedNextStopTimeManager {
-    explicit CachedNextStopTimeManager(const dataRAPTOR& dataRaptor, size_t max_cache) : lru({dataRaptor}, max_cache) {}
-    CachedNextStopTimeManager& operator=(CachedNextStopTimeManager&&) = default;
+    explicit CachedNextStopTimeManager(const dataRAPTOR& dataRaptor, size_t max_cache)
+        : lru({dataRaptor, max_cache, nb_built}, max_cache), max_cache(max_cache) {}
     ~CachedNextStopTimeManager();
 
     std::shared_ptr<const CachedNextStopTime> load(const DateTime from,
                                                    const type::RTLevel rt_level,
                                                    const type::AccessibiliteParams& accessibilite_params);
 
-    void warmup(const CachedNextStopTimeManager& other) { this->lru.warmup(other.lru); }
+    void warmup(const CachedNextStopTimeManager& other);
+
+    /*
+     * Builds the caches of the keys in advance, with nb_threads threads, the first keys
+     * first.  Only the first max_cache keys are built, as the others would evict them, and
+     * the building stops as soon as is_cancelled returns true.
+     */
+    void prefetch(const std::vector<CachedNextStopTimeKey>& keys,
+                  size_t nb_threads,
+                  const std::function<bool()>& is_cancelled = [] { return false; });
+
+    /// The accessibilities of the requests, the most requested first
+    std::vector<type::AccessibiliteParams> popular_accessibilities(size_t nb) const;
+
+    static NextStopTimeCacheCounters counters();
 
 private:
     struct CacheCreator {
         typedef CachedNextStopTimeKey const& argument_type;
         typedef CachedNextStopTime result_type;
         const dataRAPTOR& dataRaptor;
-        CacheCreator(const dataRAPTOR& d) : dataRaptor(d) {}
+        size_t max_cache;
+        std::atomic<size_t>& nb_built;  // by the manager, to count the evictions
+        CacheCreator(const dataRAPTOR& d, size_t max_cache, std::atomic<size_t>& nb_built)
+            : dataRaptor(d), max_cache(max_cache), nb_built(nb_built) {}
         CachedNextStopTime operator()(const CachedNextStopTimeKey& key) const;
     };
 
+    std::atomic<size_t> nb_built{0};
     ConcurrentLru<CacheCreator> lru;
+    size_t max_cache;
+
+    mutable std::mutex accessibilities_mutex;
+    std::map<type::AccessibiliteParams, uint64_t> nb_requests_by_accessibility;
 };
 
 DateTime get_next_stop_time(const StopEvent stop_event,
@@ -0,0 +1,174 @@
+/* Copyright © 2001-2014, Canal TP and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+channel `#navitia` on riot https://riot.im/app/#/room/#navitia:matrix.org
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#include "routing/pt_matrix.h"
+
+#include "routing/helper_pool.h"
+#include "routing/multi_departure_raptor.h"
+#include "type/accessibility_params.h"
+#include "type/data.h"
+
+#include <algorithm>
+#include <atomic>
+
+namespace navitia {
+namespace routing {
+
+namespace {
+
+/*
+ * The travel times of one origin towards every destination, by departure datetime, then
+ * reduced to their median
+ */
+struct OriginComputer {
+    const std::vector<map_stop_point_duration>& destinations;
+    const std::vector<DateTime>& departure_datetimes;
+    const DateTime max_duration;
+    MultiDepartureRaptor raptor;
+    std::vector<PtMatrix::Cell> samples;  // by destination then by departure datetime
+
+    OriginComputer(const type::Data& data,
+                   const std::vector<map_stop_point_duration>& destinations,
+                   const std::vector<DateTime>& departure_datetimes,
+                   const DateTime max_duration)
+        : destinations(destinations),
+          departure_datetimes(departure_datetimes),
+          max_duration(max_duration),
+          raptor(data) {}
+
+    void compute(const map_stop_point_duration& origin,
+                 const uint32_t max_transfers,
+                 const type::AccessibiliteParams& accessibilite_params,
+                 const std::vector<std::string>& forbidden,
+                 const std::vector<std::string>& allowed,
+                 const type::RTLevel rt_level,
+                 PtMatrix::Cell* row) {
+        const size_t nb_samples = departure_datetimes.size();
+        samples.assign(destinations.size() * nb_samples, PtMatrix::Cell());
+
+        // walking from a stop point of the origin to a stop point of the destination
+        for (size_t d = 0; d < destinations.size(); ++d) {
+            for (const auto& sp_dur : destinations[d]) {
+                const auto it = origin.find(sp_dur.first);
+                if (it == origin.end()) {
+                    continue;
+                }
+                const DateTime duration = (it->second + sp_dur.second).total_seconds();
+                for (size_t s = 0; s < nb_samples; ++s) {
+                    auto& sample = samples[d * nb_samples + s];
+                    sample.duration = std::min(sample.duration, duration);
+                }
+            }
+        }
+
+        raptor.isochrones(origin, departure_datetimes, max_duration, max_transfers, accessibilite_params, forbidden,
+                          allowed, true, rt_level, [&](const size_t s) {
+                              const DateTime departure = departure_datetimes[s];
+                              const DateTime bound = raptor.bound(s);
+                              for (size_t d = 0; d < destinations.size(); ++d) {
+                                  auto& sample = samples[d * nb_samples + s];
+                                  for (const auto& sp_dur : destinations[d]) {
+                                      const DateTime dt = raptor.dt_pt(s, sp_dur.first);
+                                      if (dt >= bound) {
+                                          continue;
+                                      }
+                                      const DateTime duration = dt - departure + sp_dur.second.total_seconds();
+                                      if (duration < sample.duration) {
+                                          sample.duration = duration;
+                                          sample.nb_transfers = uint16_t(raptor.round_pt(s, sp_dur.first) - 1);
+                                      }
+                                  }
+                              }
+                          });
+
+        for (size_t d = 0; d < destinations.size(); ++d) {
+            const auto begin = samples.begin() + d * nb_samples;
+            const auto median = begin + nb_samples / 2;
+            std::nth_element(begin, median, begin + nb_samples,
+                             [](const PtMatrix::Cell& a, const PtMatrix::Cell& b) { return a.duration < b.duration; });
+            if (median->duration <= max_duration) {
+                row[d] = *median;
+            }
+        }
+    }
+};
+
+}  // namespace
+
+PtMatrix compute_pt_matrix(const type::Data& data,
+                           const std::vector<map_stop_point_duration>& origins,
+                           const std::vector<map_stop_point_duration>& destinations,
+                           const std::vector<DateTime>& departure_datetimes,
+                           const DateTime max_duration,
+                           const uint32_t max_transfers,
+                           const type::AccessibiliteParams& accessibilite_params,
+                           const std::vector<std::string>& forbidden,
+                           const std::vector<std::string>& allowed,
+                           const type::RTLevel rt_level,
+                           size_t nb_threads) {
+    PtMatrix matrix;
+    matrix.nb_origins = origins.size();
+    matrix.nb_destinations = destinations.size();
+    matrix.cells.resize(origins.size() * destinations.size());
+    if (origins.empty() || destinations.empty() || departure_datetimes.empty()) {
+        return matrix;
+    }
+
+    auto& pool = HelperPool::get();
+    if (nb_threads == 0) {
+        nb_threads = pool.nb_threads() + 1;
+    }
+    nb_threads = std::max<size_t>(1, std::min(nb_threads, origins.size()));
+
+    // each task computes origins, taken one at a time as their searches do not last the same,
+    // until there is none left: a task started once all the origins are taken does nothing
+    std::atomic<size_t> next_origin{0};
+    pool.parallel_for(nb_threads, nb_threads - 1, [&](size_t) {
+        size_t o = next_origin++;
+        if (o >= origins.size()) {
+            return;
+        }
+        OriginComputer computer(data, destinations, departure_datetimes, max_duration);
+        try {
+            for (; o < origins.size(); o = next_origin++) {
+                computer.compute(origins[o], max_transfers, accessibilite_params, forbidden, allowed, rt_level,
+                                 &matrix.at(o, 0));
+            }
+        } catch (...) {
+            // the other tasks stop after their current origin
+            next_origin = origins.size();
+            throw;
+        }
+    });
+    return matrix;
+}
+
+}  // namespace routing
+}  // namespace navitia
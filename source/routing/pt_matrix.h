@@ -0,0 +1,87 @@
+/* Copyright © 2001-2014, Canal TP and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+channel `#navitia` on riot https://riot.im/app/#/room/#navitia:matrix.org
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#pragma once
+
+#include "routing/raptor_utils.h"
+#include "type/rt_level.h"
+
+#include <string>
+#include <vector>
+
+namespace navitia {
+namespace type {
+class Data;
+struct AccessibiliteParams;
+}  // namespace type
+namespace routing {
+
+/// Public transport travel times between many origins and destinations
+struct PtMatrix {
+    struct Cell {
+        DateTime duration = DateTimeUtils::inf;  // inf when the destination is not reached
+        uint16_t nb_transfers = 0;
+    };
+
+    size_t nb_origins = 0;
+    size_t nb_destinations = 0;
+    std::vector<Cell> cells;  // by origin then by destination
+
+    const Cell& at(const size_t origin, const size_t destination) const {
+        return cells[origin * nb_destinations + destination];
+    }
+    Cell& at(const size_t origin, const size_t destination) { return cells[origin * nb_destinations + destination]; }
+};
+
+/*
+ * The door to door travel time from each origin to each destination, the origins and the
+ * destinations being given by their stop points and the street network durations to reach
+ * them.
+ *
+ * Each origin is a one to all search at all the departure datetimes, computed by a
+ * MultiDepartureRaptor.  The departure datetimes are the samples of a time window, and a
+ * cell holds the median of the travel times of the samples, with the transfers of that
+ * sample.  The origins are shared by the calling thread and at most nb_threads - 1 idle
+ * threads of the HelperPool (0 for all of them), each with its own raptor.
+ */
+PtMatrix compute_pt_matrix(const type::Data& data,
+                           const std::vector<map_stop_point_duration>& origins,
+                           const std::vector<map_stop_point_duration>& destinations,
+                           const std::vector<DateTime>& departure_datetimes,
+                           const DateTime max_duration,
+                           const uint32_t max_transfers,
+                           const type::AccessibiliteParams& accessibilite_params,
+                           const std::vector<std::string>& forbidden,
+                           const std::vector<std::string>& allowed,
+                           const type::RTLevel rt_level,
+                           size_t nb_threads = 0);
+
+}  // namespace routing
+}  // namespace navitia
@@ -36,6 +36,7 @@ www.navitia.io
 #include <boost/functional/hash.hpp>
 #include <boost/range/adaptor/filtered.hpp>
 #include <boost/range/algorithm/find_if.hpp>
+#include <boost/range/algorithm_ext/erase.hpp>
 #include <boost/range/algorithm_ext/push_back.hpp>
 
 #include <chrono>
@@ -64,7 +65,9 @@ bool RAPTOR::apply_vj_extension(const Visitor& v,
                                 const uint16_t l_zone,
                                 DateTime base_dt,
                                 DateTime working_walking_duration,
-                                SpIdx boarding_stop_point) {
+                                SpIdx boarding_stop_point,
+                                const type::StopTime* boarding_st,
+                                DateTime boarding_dt) {
     auto& working_labels = labels[count];
     bool result = false;
     while (vj) {
@@ -88,12 +91,24 @@ bool RAPTOR::apply_vj_extension(const Visitor& v,
             auto sp = st.stop_point;
             const auto sp_idx = SpIdx(*sp);
 
-            if (!valid_stop_points[sp_idx.val]) {
+            if (!valid_jps->stop_points[sp_idx.val]) {
                 continue;
             }
-            if (v.comp(workingDt, best_labels.dt_pt(sp_idx))
-                || (workingDt == best_labels.dt_pt(sp_idx)
-                    && working_walking_duration < best_labels.walking_duration_pt(sp_idx))) {
+            const bool has_better_label = v.comp(workingDt, best_labels.dt_pt(sp_idx))
+                                          || (workingDt == best_labels.dt_pt(sp_idx)
+                                              && working_walking_duration < best_labels.walking_duration_pt(sp_idx));
+            if (snd_phase_tags.enabled) {
+                snd_phase_tags.reach_pt(count, boarding_stop_point, sp_idx, has_better_label,
+                                        has_better_label ? v.comp(workingDt, working_labels.dt_pt(sp_idx))
+                                                         : v.comp(best_labels.dt_pt(sp_idx), workingDt));
+            }
+            const bool pruned = has_better_label && target_bounds.prunes(sp_idx, workingDt, working_walking_duration);
+            if (pruned) {
+                // still a bound for the other labels
+                best_labels.mut_dt_pt(sp_idx) = workingDt;
+                best_labels.mut_walking_duration_pt(sp_idx) = working_walking_duration;
+                ++nb_pruned_labels;
+            } else if (has_better_label) {
                 LOG4CPLUS_TRACE(raptor_logger, "Updating label dt count : "
                                                    << count << " sp " << data.pt_data->stop_points[sp_idx.val]->uri
                                                    << " from " << iso_string(working_labels.dt_pt(sp_idx), data)
@@ -106,6 +121,9 @@ bool RAPTOR::apply_vj_extension(const Visitor& v,
                 BOOST_ASSERT(working_walking_duration != DateTimeUtils::not_valid);
                 best_labels.mut_dt_pt(sp_idx) = workingDt;
                 best_labels.mut_walking_duration_pt(sp_idx) = working_walking_duration;
+                if (record_parents) {
+                    parents[count].pt[sp_idx.val] = {boarding_st, boarding_dt, &st};
+                }
                 result = true;
             }
         }
@@ -136,9 +154,24 @@ bool RAPTOR::foot_path(const Visitor& v) {
             const DateTime end_connection_date = v.combine(start_connection_date, conn.duration);
             const DateTime candidate_walking_duration =
                 working_labels.walking_duration_pt(sp_idx) + conn.walking_duration;
-            if (v.comp(end_connection_date, best_labels.dt_transfer(destination_sp_idx))
+            const bool has_better_label =
+                v.comp(end_connection_date, best_labels.dt_transfer(destination_sp_idx))
                 || (end_connection_date == best_labels.dt_transfer(destination_sp_idx)
-                    && candidate_walking_duration < best_labels.walking_duration_transfer(destination_sp_idx))) {
+                    && candidate_walking_duration < best_labels.walking_duration_transfer(destination_sp_idx));
+            if (snd_phase_tags.enabled) {
+                snd_phase_tags.reach_transfer(
+                    count, sp_idx, destination_sp_idx, has_better_label,
+                    has_better_label ? v.comp(end_connection_date, working_labels.dt_transfer(destination_sp_idx))
+                                     : v.comp(best_labels.dt_transfer(destination_sp_idx), end_connection_date));
+            }
+            const bool pruned = has_better_label
+                                && target_bounds.prunes(destination_sp_idx, end_connection_date,
+                                                        candidate_walking_duration);
+            if (pruned) {
+                best_labels.mut_dt_transfer(destination_sp_idx) = end_connection_date;
+                best_labels.mut_walking_duration_transfer(destination_sp_idx) = candidate_walking_duration;
+                ++nb_pruned_labels;
+            } else if (has_better_label) {
                 LOG4CPLUS_TRACE(raptor_logger,
                                 "Updating label transfer count : "
                                     << count << " sp " << data.pt_data->stop_points[destination_sp_idx.val]->uri
@@ -153,12 +186,15 @@ bool RAPTOR::foot_path(const Visitor& v) {
                 working_labels.mut_walking_duration_transfer(destination_sp_idx) = candidate_walking_duration;
                 best_labels.mut_dt_transfer(destination_sp_idx) = end_connection_date;
                 best_labels.mut_walking_duration_transfer(destination_sp_idx) = candidate_walking_duration;
+                if (record_parents) {
+                    parents[count].transfer[destination_sp_idx.val] = sp_idx;
+                }
                 result = true;
             }
         }
     }
 
-    for (const auto sp_jpps : jpps_from_sp) {
+    for (const auto sp_jpps : valid_jps->jpps_from_sp) {
         if (!working_labels.transfer_is_initialized(sp_jpps.first)) {
             continue;
         }
@@ -184,6 +220,10 @@ void RAPTOR::clear(const bool clockwise, const DateTime bound) {
     for (auto& lbl_list : labels) {
         lbl_list = clean_labels;
     }
+    // the parents are always written with their labels, no need to clean them
+    if (record_parents && parents.size() < labels.size()) {
+        parents.resize(labels.size(), LabelParents(data.pt_data->stop_points.size()));
+    }
 
     best_labels.fill_values(bound, bound, DateTimeUtils::not_valid, DateTimeUtils::not_valid);
 }
@@ -202,7 +242,7 @@ void RAPTOR::init(const map_stop_point_duration& dep,
         labels[0].mut_walking_duration_transfer(sp_dt.first) = sn_dur;
         best_labels.mut_dt_transfer(sp_dt.first) = begin_dt;
         best_labels.mut_walking_duration_transfer(sp_dt.first) = begin_dt;
-        for (const auto& jpp : jpps_from_sp[sp_dt.first]) {
+        for (const auto& jpp : valid_jps->jpps_from_sp[sp_dt.first]) {
             if (clockwise && Q[jpp.jp_idx] > jpp.order) {
                 Q[jpp.jp_idx] = jpp.order;
             } else if (!clockwise && Q[jpp.jp_idx] < jpp.order) {
@@ -212,6 +252,95 @@ void RAPTOR::init(const map_stop_point_duration& dep,
     }
 }
 
+void TargetBounds::init(const LowerBoundOracle& o, const map_stop_point_duration& dests, const bool c) {
+    enabled = true;
+    clockwise = c;
+    oracle = &o;
+    targets.clear();
+    destinations.clear();
+    by_cluster.assign(oracle->nb_clusters(), DateTimeUtils::inf);
+    min_fallback = DateTimeUtils::inf;
+    for (const auto& dest : dests) {
+        const DateTime fallback = dest.second.total_seconds();
+        const auto dest_cluster = oracle->cluster(dest.first);
+        destinations.emplace_back(dest.first, fallback);
+        min_fallback = std::min(min_fallback, fallback);
+        for (size_t cluster = 0; cluster < by_cluster.size(); ++cluster) {
+            // going backward in time, the clusters are reached from the destination
+            const DateTime duration = clockwise ? oracle->duration(cluster, dest_cluster)
+                                                : oracle->duration(dest_cluster, cluster);
+            if (duration != DateTimeUtils::inf) {
+                by_cluster[cluster] = std::min(by_cluster[cluster], duration + fallback);
+            }
+        }
+    }
+}
+
+void TargetBounds::add_targets(const Labels& working_labels) {
+    for (const auto& dest : destinations) {
+        if (!working_labels.pt_is_initialized(dest.first)) {
+            continue;
+        }
+        const DateTime dt = working_labels.dt_pt(dest.first);
+        const Target target = {clockwise ? dt + dest.second : dt - dest.second,
+                               working_labels.walking_duration_pt(dest.first) + dest.second};
+        const auto dominates = [&](const Target& lhs, const Target& rhs) {
+            return (clockwise ? lhs.end_dt <= rhs.end_dt : lhs.end_dt >= rhs.end_dt)
+                   && lhs.walking_dur <= rhs.walking_dur;
+        };
+        if (std::any_of(targets.begin(), targets.end(), [&](const Target& t) { return dominates(t, target); })) {
+            continue;
+        }
+        boost::remove_erase_if(targets, [&](const Target& t) { return dominates(target, t); });
+        targets.push_back(target);
+    }
+}
+
+constexpr uint32_t SndPhaseTags::none;
+
+void RAPTOR::init_multi_target(const std::vector<StartingPointSndPhase>& starting_points,
+                               const map_stop_point_duration& arrivals,
+                               const bool clockwise,
+                               const type::Properties& properties) {
+    snd_phase_tags.reset(clockwise, labels.size(), data.pt_data->stop_points.size());
+    snd_phase_tags.conflicted.resize(starting_points.size());
+    for (const auto& start : starting_points) {
+        snd_phase_tags.seeds.push_back({start.end_dt, DateTime(arrivals.at(start.sp_idx).total_seconds())});
+    }
+
+    // a stop point can only be seeded once: the starting point with the best
+    // departure for the backward pass is kept, the others may be conflicted
+    auto& seeds_by_sp = snd_phase_tags.transfer[0];
+    const auto snd_pass_dt = [&](const uint32_t i) {
+        return first_pass_labels[starting_points[i].count].dt_pt(starting_points[i].sp_idx);
+    };
+    for (uint32_t i = 0; i < starting_points.size(); ++i) {
+        auto& seed = seeds_by_sp[starting_points[i].sp_idx.val];
+        if (seed != SndPhaseTags::none) {
+            if (snd_pass_dt(i) == snd_pass_dt(seed)) {
+                continue;
+            }
+            if (clockwise ? snd_pass_dt(i) < snd_pass_dt(seed) : snd_pass_dt(i) > snd_pass_dt(seed)) {
+                snd_phase_tags.lose(seed, i);
+                continue;
+            }
+            snd_phase_tags.lose(i, seed);
+        }
+        seed = i;
+    }
+
+    for (uint32_t i = 0; i < starting_points.size(); ++i) {
+        const auto sp_idx = starting_points[i].sp_idx;
+        if (seeds_by_sp[sp_idx.val] != i) {
+            continue;
+        }
+        map_stop_point_duration init_map;
+        init_map[sp_idx] = 0_s;
+        init(init_map, snd_pass_dt(i), !clockwise, properties);
+        snd_phase_tags.best_transfer[sp_idx.val] = i;
+    }
+}
+
 void RAPTOR::first_raptor_loop(const map_stop_point_duration& departures,
                                const DateTime& departure_datetime,
                                const nt::RTLevel rt_level,
@@ -417,7 +546,13 @@ RAPTOR::Journeys RAPTOR::compute_all_journeys(const map_stop_point_duration& dep
     const auto& calc_dep = clockwise ? departures : destinations;
     const auto& calc_dest = clockwise ? destinations : departures;
 
+    snd_phase_tags.enabled = false;
+    nb_pruned_labels = 0;
+    if (target_pruning) {
+        target_bounds.init(data.dataRaptor->get_lower_bound_oracle(*data.pt_data), calc_dest, clockwise);
+    }
     first_raptor_loop(calc_dep, departure_datetime, rt_level, bound, max_transfers, accessibilite_params, clockwise);
+    target_bounds.enabled = false;
 
     LOG4CPLUS_TRACE(raptor_logger, "labels after first pass : " << std::endl << print_all_labels());
 
@@ -456,7 +591,62 @@ RAPTOR::Journeys RAPTOR::compute_all_journeys(const map_stop_point_duration& dep
                                                                 << print_starting_points_snd_phase(starting_points));
 
     size_t nb_snd_pass = 0, nb_useless = 0, last_usefull_2nd_pass = 0, supplementary_2nd_pass = 0;
-    for (const auto& start : starting_points) {
+
+    // the bound of the starting point is beaten by the solutions already found
+    const auto is_useless = [&](const StartingPointSndPhase& start) {
+        if (start.has_priority || !solutions.contains_better_than(convert_to_bound(start, clockwise))) {
+            return false;
+        }
+        LOG4CPLUS_TRACE(raptor_logger, "already found a better solution than the fake journey from "
+                                           << data.pt_data->stop_points[start.sp_idx.val]->uri);
+        return true;
+    };
+
+    // In multi-target mode, the starting points with priority, that the loop
+    // below always uses, are seeded in one backward raptor.  The solutions of
+    // the ones that have not been conflicted by another one are read from it,
+    // and only the conflicted ones get their own pass.  Whether the other
+    // starting points are used depends on the solutions found before them, so
+    // they are left to the loop below.
+    boost::dynamic_bitset<> done(starting_points.size());
+    if (snd_phase_mode == SndPhaseMode::MultiTarget) {
+        std::vector<StartingPointSndPhase> seeds;
+        std::vector<size_t> seed_idx;
+        for (size_t i = 0; i < starting_points.size() && starting_points[i].has_priority; ++i) {
+            seeds.push_back(starting_points[i]);
+            seed_idx.push_back(i);
+        }
+        if (seeds.size() > 1) {
+            clear(!clockwise, departure_datetime + (clockwise ? -1 : 1));
+            best_labels = best_labels_for_snd_pass;
+            init_multi_target(seeds, calc_dest, clockwise, accessibilite_params.properties);
+            snd_phase_tags.enabled = true;
+            boucleRAPTOR(!clockwise, rt_level, max_transfers);
+            snd_phase_tags.enabled = false;
+            ++nb_snd_pass;
+
+            // the labels are shared by the seeds, so they are read once for all of them
+            std::vector<StartingPointSndPhase> end_points;
+            for (size_t i = 0; i < seeds.size(); ++i) {
+                if (snd_phase_tags.conflicted[i]) {
+                    continue;
+                }
+                done.set(seed_idx[i]);
+                end_points.push_back(seeds[i]);
+            }
+            read_solutions(*this, solutions, !clockwise, departure_datetime, departures, destinations, rt_level,
+                           accessibilite_params, transfer_penalty, end_points);
+            LOG4CPLUS_DEBUG(raptor_logger, "[2nd pass] multi-target pass with " << seeds.size() << " starting points, "
+                                                                                << seeds.size() - done.count()
+                                                                                << " conflicted");
+        }
+    }
+
+    for (size_t i = 0; i < starting_points.size(); ++i) {
+        const auto& start = starting_points[i];
+        if (done[i]) {
+            continue;
+        }
         navitia::type::StopPoint* start_stop_point = data.pt_data->stop_points[start.sp_idx.val];
 
         LOG4CPLUS_TRACE(raptor_logger, std::endl
@@ -464,11 +654,7 @@ RAPTOR::Journeys RAPTOR::compute_all_journeys(const map_stop_point_duration& dep
                                            << "   count : " << start.count);
 
         if (!start.has_priority) {
-            Journey fake_journey = convert_to_bound(start, clockwise);
-
-            if (solutions.contains_better_than(fake_journey)) {
-                LOG4CPLUS_TRACE(raptor_logger,
-                                "already found a better solution than the fake journey from " << start_stop_point->uri);
+            if (is_useless(start)) {
                 continue;
             }
 
@@ -524,145 +710,13 @@ void RAPTOR::isochrone(const map_stop_point_duration& departures,
     first_raptor_loop(departures, departure_datetime, rt_level, b, max_transfers, accessibilite_params, clockwise);
 }
 
-namespace {
-struct ObjsFromIds {
-    boost::dynamic_bitset<> jps;
-    boost::dynamic_bitset<> jpps;
-    boost::dynamic_bitset<> sps;
-    ObjsFromIds(const std::vector<std::string>& ids, const JourneyPatternContainer& jp_container, const nt::Data& data)
-        : jps(jp_container.nb_jps()), jpps(jp_container.nb_jpps()), sps(data.pt_data->stop_points.size()) {
-        for (const auto& id : ids) {
-            const auto it_line = data.pt_data->lines_map.find(id);
-            if (it_line != data.pt_data->lines_map.end()) {
-                for (const auto route : it_line->second->route_list) {
-                    for (const auto& jp_idx : jp_container.get_jps_from_route()[RouteIdx(*route)]) {
-                        jps.set(jp_idx.val, true);
-                    }
-                }
-                continue;
-            }
-            const auto it_route = data.pt_data->routes_map.find(id);
-            if (it_route != data.pt_data->routes_map.end()) {
-                for (const auto& jp_idx : jp_container.get_jps_from_route()[RouteIdx(*it_route->second)]) {
-                    jps.set(jp_idx.val, true);
-                }
-                continue;
-            }
-            const auto it_commercial_mode = data.pt_data->commercial_modes_map.find(id);
-            if (it_commercial_mode != data.pt_data->commercial_modes_map.end()) {
-                for (const auto line : it_commercial_mode->second->line_list) {
-                    for (auto route : line->route_list) {
-                        for (const auto& jp_idx : jp_container.get_jps_from_route()[RouteIdx(*route)]) {
-                            jps.set(jp_idx.val, true);
-                        }
-                    }
-                }
-                continue;
-            }
-            const auto it_physical_mode = data.pt_data->physical_modes_map.find(id);
-            if (it_physical_mode != data.pt_data->physical_modes_map.end()) {
-                const auto phy_mode_idx = PhyModeIdx(*it_physical_mode->second);
-                for (const auto& jp_idx : jp_container.get_jps_from_phy_mode()[phy_mode_idx]) {
-                    jps.set(jp_idx.val, true);
-                }
-                continue;
-            }
-            const auto it_network = data.pt_data->networks_map.find(id);
-            if (it_network != data.pt_data->networks_map.end()) {
-                for (const auto line : it_network->second->line_list) {
-                    for (const auto route : line->route_list) {
-                        for (const auto& jp_idx : jp_container.get_jps_from_route()[RouteIdx(*route)]) {
-                            jps.set(jp_idx.val, true);
-                        }
-                    }
-                }
-                continue;
-            }
-            const auto it_sp = data.pt_data->stop_points_map.find(id);
-            if (it_sp != data.pt_data->stop_points_map.end()) {
-                sps.set(it_sp->second->idx, true);
-                for (const auto& jpp : data.dataRaptor->jpps_from_sp[SpIdx(*it_sp->second)]) {
-                    jpps.set(jpp.idx.val, true);
-                }
-                continue;
-            }
-            const auto it_sa = data.pt_data->stop_areas_map.find(id);
-            if (it_sa != data.pt_data->stop_areas_map.end()) {
-                for (const auto sp : it_sa->second->stop_point_list) {
-                    sps.set(sp->idx, true);
-                    for (const auto& jpp : data.dataRaptor->jpps_from_sp[SpIdx(*sp)]) {
-                        jpps.set(jpp.idx.val, true);
-                    }
-                }
-                continue;
-            }
-        }
-    }
-};
-}  // namespace
 
-// Returns valid_jpps
 void RAPTOR::set_valid_jp_and_jpp(uint32_t date,
                                   const type::AccessibiliteParams& accessibilite_params,
                                   const std::vector<std::string>& forbidden,
                                   const std::vector<std::string>& allowed,
                                   const nt::RTLevel rt_level) {
-    const auto& jp_container = data.dataRaptor->jp_container;
-    valid_journey_patterns = data.dataRaptor->jp_validity_patterns[rt_level][date];
-    boost::dynamic_bitset<> valid_journey_pattern_points(jp_container.nb_jpps());
-    valid_journey_pattern_points.set();
-    valid_stop_points.set();
-
-    auto forbidden_objs = ObjsFromIds(forbidden, jp_container, data);
-    valid_journey_patterns &= forbidden_objs.jps.flip();
-    valid_journey_pattern_points &= forbidden_objs.jpps.flip();
-    valid_stop_points &= forbidden_objs.sps.flip();
-
-    const auto allowed_objs = ObjsFromIds(allowed, jp_container, data);
-    if (allowed_objs.jps.any()) {
-        // If a journey pattern is present in allowed_obj, the
-        // constraint is setted. Else, there is no constraint at the
-        // journey pattern level.
-        valid_journey_patterns &= allowed_objs.jps;
-    }
-    if (allowed_objs.jpps.any()) {
-        // If a journey point pattern is present in allowed_obj, the
-        // constraint is setted. Else, there is no constraint at the
-        // journey pattern point level.
-        valid_journey_pattern_points &= allowed_objs.jpps;
-        valid_stop_points &= allowed_objs.sps;
-    }
-
-    // filter accessibility
-    if (accessibilite_params.properties.any()) {
-        for (const auto* sp : data.pt_data->stop_points) {
-            if (sp->accessible(accessibilite_params.properties)) {
-                continue;
-            }
-            valid_stop_points.set(sp->idx, false);
-            for (const auto& jpp : data.dataRaptor->jpps_from_sp[SpIdx(*sp)]) {
-                valid_journey_pattern_points.set(jpp.idx.val, false);
-            }
-        }
-    }
-
-    // propagate the invalid jp in their jpp
-    for (JpIdx jp_idx = JpIdx(0); jp_idx.val < valid_journey_patterns.size(); ++jp_idx.val) {
-        if (valid_journey_patterns[jp_idx.val]) {
-            continue;
-        }
-        const auto& jp = jp_container.get(jp_idx);
-        for (const auto& jpp_idx : jp.jpps) {
-            valid_journey_pattern_points.set(jpp_idx.val, false);
-        }
-    }
-
-    // We get our own copy of jpps_from_sp to filter every invalid
-    // jpps.  Thanks to that, we don't need to check
-    // valid_journey_pattern[_point]s as we iterate only on the
-    // feasible ones.
-    jpps_from_sp = data.dataRaptor->jpps_from_sp;
-    jpps_from_sp.filter_jpps(valid_journey_pattern_points);
+    valid_jps = data.dataRaptor->valid_jps_manager->load(date, rt_level, accessibilite_params, forbidden, allowed);
 }
 
 template <typename Visitor>
@@ -679,6 +733,12 @@ void RAPTOR::raptor_loop(Visitor visitor, const nt::RTLevel rt_level, uint32_t m
             } else {
                 this->labels.push_back(this->data.dataRaptor->labels_const_reverse);
             }
+            if (snd_phase_tags.enabled) {
+                snd_phase_tags.add_round();
+            }
+            if (record_parents && parents.size() < labels.size()) {
+                parents.emplace_back(data.pt_data->stop_points.size());
+            }
         }
         const auto& prec_labels = labels[count - 1];
         auto& working_labels = labels[this->count];
@@ -702,6 +762,8 @@ void RAPTOR::raptor_loop(Visitor visitor, const nt::RTLevel rt_level, uint32_t m
                 DateTime base_dt = workingDt;
                 DateTime working_walking_duration = DateTimeUtils::not_valid;
                 SpIdx boarding_stop_point = SpIdx();
+                const type::StopTime* boarding_st = nullptr;
+                DateTime boarding_dt = workingDt;
 
                 /// will be used to iterate through the StopTimeS of
                 /// the vehicle journey of the current journey_pattern (jp_idx)
@@ -727,11 +789,25 @@ void RAPTOR::raptor_loop(Visitor visitor, const nt::RTLevel rt_level, uint32_t m
                             visitor.comp(workingDt, best_labels.dt_pt(jpp.sp_idx))
                             || (workingDt == best_labels.dt_pt(jpp.sp_idx)
                                 && working_walking_duration < best_labels.walking_duration_pt(jpp.sp_idx));
-                        if (st.valid_end(visitor.clockwise())
+                        const bool can_debark =
+                            st.valid_end(visitor.clockwise())
                             && (l_zone == std::numeric_limits<uint16_t>::max() || l_zone != st.local_traffic_zone)
-                            && has_better_label
-                            && valid_stop_points[jpp.sp_idx.val])  // we need to check the accessibility
-                        {
+                            && valid_jps->stop_points[jpp.sp_idx.val];  // we need to check the accessibility
+                        if (can_debark && snd_phase_tags.enabled) {
+                            snd_phase_tags.reach_pt(
+                                count, boarding_stop_point, jpp.sp_idx, has_better_label,
+                                has_better_label ? visitor.comp(workingDt, working_labels.dt_pt(jpp.sp_idx))
+                                                 : visitor.comp(best_labels.dt_pt(jpp.sp_idx), workingDt));
+                        }
+                        const bool pruned =
+                            can_debark && has_better_label
+                            && target_bounds.prunes(jpp.sp_idx, workingDt, working_walking_duration);
+                        if (pruned) {
+                            // still a bound for the other labels
+                            best_labels.mut_dt_pt(jpp.sp_idx) = workingDt;
+                            best_labels.mut_walking_duration_pt(jpp.sp_idx) = working_walking_duration;
+                            ++nb_pruned_labels;
+                        } else if (can_debark && has_better_label) {
                             LOG4CPLUS_TRACE(raptor_logger,
                                             "Updating label dt "
                                                 << "count : " << count << " sp "
@@ -748,6 +824,9 @@ void RAPTOR::raptor_loop(Visitor visitor, const nt::RTLevel rt_level, uint32_t m
                             BOOST_ASSERT(working_walking_duration != DateTimeUtils::not_valid);
                             best_labels.mut_dt_pt(jpp.sp_idx) = workingDt;
                             best_labels.mut_walking_duration_pt(jpp.sp_idx) = working_walking_duration;
+                            if (record_parents) {
+                                parents[count].pt[jpp.sp_idx.val] = {boarding_st, boarding_dt, &st};
+                            }
                             continue_algorithm = true;
                         }
                     }
@@ -757,7 +836,7 @@ void RAPTOR::raptor_loop(Visitor visitor, const nt::RTLevel rt_level, uint32_t m
                     // journey pattern point before
 
                     // if we cannot board at this stop point, nothing to do
-                    if (!prec_labels.transfer_is_initialized(jpp.sp_idx) || !valid_stop_points[jpp.sp_idx.val]) {
+                    if (!prec_labels.transfer_is_initialized(jpp.sp_idx) || !valid_jps->stop_points[jpp.sp_idx.val]) {
                         continue;
                     }
 
@@ -800,6 +879,21 @@ void RAPTOR::raptor_loop(Visitor visitor, const nt::RTLevel rt_level, uint32_t m
                     //                                    << " working dt : " << iso_string(workingDt, data)
                     //                                    << " walking : " << navitia::str(working_walking_duration));
 
+                    if (is_onboard && snd_phase_tags.enabled) {
+                        // only one of the two boardings is kept for the rest of the journey
+                        // pattern, it hides the other one unless it is the same vehicle at the same time
+                        const auto& prec_tags = snd_phase_tags.transfer[count - 1];
+                        const auto onboard_tag = prec_tags[boarding_stop_point.val];
+                        const auto candidate_tag = prec_tags[jpp.sp_idx.val];
+                        if (candidate_debark_time != workingDt || &*it_st != tmp_st_dt.first) {
+                            if (update_boarding_stop_point) {
+                                snd_phase_tags.lose(candidate_tag, onboard_tag);
+                            } else {
+                                snd_phase_tags.lose(onboard_tag, candidate_tag);
+                            }
+                        }
+                    }
+
                     if (update_boarding_stop_point) {
                         /// we are at stop point jpp.idx at time previous_dt
                         /// waiting for the next vehicle journey of the journey_pattern jpp.jp_idx to embark on
@@ -853,6 +947,8 @@ void RAPTOR::raptor_loop(Visitor visitor, const nt::RTLevel rt_level, uint32_t m
                             workingDt = candidate_debark_time;
                             working_walking_duration = previous_walking_duration;
                             boarding_stop_point = jpp.sp_idx;
+                            boarding_st = tmp_st_dt.first;
+                            boarding_dt = candidate_board_time;
 
                             base_dt = candidate_base_dt;
                         }
@@ -861,8 +957,9 @@ void RAPTOR::raptor_loop(Visitor visitor, const nt::RTLevel rt_level, uint32_t m
                 if (is_onboard) {
                     const type::VehicleJourney* vj_stay_in = visitor.get_extension_vj(it_st->vehicle_journey);
                     if (vj_stay_in) {
-                        bool applied = apply_vj_extension(visitor, rt_level, vj_stay_in, l_zone, base_dt,
-                                                          working_walking_duration, boarding_stop_point);
+                        bool applied =
+                            apply_vj_extension(visitor, rt_level, vj_stay_in, l_zone, base_dt,
+                                               working_walking_duration, boarding_stop_point, boarding_st, boarding_dt);
                         continue_algorithm = continue_algorithm || applied;
                     }
                 }
@@ -870,12 +967,23 @@ void RAPTOR::raptor_loop(Visitor visitor, const nt::RTLevel rt_level, uint32_t m
             /// mark the journey_pattern as visited, no need to explore it in the next round
             q_elt.second = visitor.init_queue_item();
         }
+        if (target_bounds.enabled) {
+            target_bounds.add_targets(working_labels);
+        }
         if (continue_algorithm) {
             continue_algorithm = this->foot_path(visitor);
         }
     }
 }
 
+size_t RAPTOR::parents_memory() const {
+    size_t res = 0;
+    for (const auto& round : parents) {
+        res += round.pt.capacity() * sizeof(LabelParents::Pt) + round.transfer.capacity() * sizeof(SpIdx);
+    }
+    return res;
+}
+
 void RAPTOR::boucleRAPTOR(const bool clockwise, const nt::RTLevel rt_level, uint32_t max_transfers) {
     if (clockwise) {
         raptor_loop(raptor_visitor(), rt_level, max_transfers);
@@ -49,6 +49,8 @@ www.navitia.io
 #include "utils/timer.h"
 #include "dataraptor.h"
 #include "raptor_utils.h"
+#include "valid_journey_patterns.h"
+#include "lower_bound_oracle.h"
 
 #include "dataraptor.h"
 #include <unordered_map>
@@ -68,6 +70,170 @@ struct StartingPointSndPhase {
     bool has_priority;
 };
 
+/** How the labels of a round have been reached
+ *
+ * Only filled when RAPTOR::record_parents is set, it allows read_solutions to unwind the
+ * journey found by the labels leg by leg, without trying every boarding again.  The journeys
+ * with alternative boardings, transfers or stay-ins are still read from all the candidates.
+ */
+struct LabelParents {
+    struct Pt {
+        const type::StopTime* board_st;  // boarding, in the direction of the pass
+        DateTime board_dt;
+        const type::StopTime* debark_st;  // its datetime is the label
+    };
+    std::vector<Pt> pt;             // by stop point
+    std::vector<SpIdx> transfer;  // by stop point, the pt label the connection comes from
+
+    explicit LabelParents(const size_t nb_sps) : pt(nb_sps), transfer(nb_sps) {}
+};
+
+/** Target pruning of the first pass
+ *
+ * A label that cannot reach any destination, or that cannot lead to a starting point of the
+ * second pass not dominated by one already found, is not explored further.  The starting
+ * points found in the previous rounds are the targets: they have less sections, and if one
+ * of them ends strictly earlier (resp. later) than any journey from the label can, with less
+ * or the same walking, the label can only give dominated starting points.  The end of the
+ * journeys from a label is bounded with the LowerBoundOracle.
+ *
+ * The pruned labels still update the best labels, as they would have done, but as their
+ * successors are not explored, the pruned first pass can find a few more starting points
+ * that are not on the pareto front.
+ */
+struct TargetBounds {
+    struct Target {
+        DateTime end_dt;
+        DateTime walking_dur;
+    };
+
+    bool enabled = false;
+    bool clockwise = true;
+    const LowerBoundOracle* oracle = nullptr;
+    std::vector<DateTime> by_cluster;  // shortest duration to reach a destination and its fallback
+    DateTime min_fallback = 0;
+    std::vector<std::pair<SpIdx, DateTime>> destinations;  // with their fallback
+    std::vector<Target> targets;  // pareto front of the starting points found
+
+    void init(const LowerBoundOracle& o, const map_stop_point_duration& dests, const bool c);
+    /// Add the starting points reached by the pt labels of a round
+    void add_targets(const Labels& working_labels);
+
+    bool prunes(const SpIdx sp, const DateTime dt, const DateTime walking_dur) const {
+        if (!enabled) {
+            return false;
+        }
+        const DateTime lower_bound = by_cluster[oracle->cluster(sp)];
+        if (lower_bound == DateTimeUtils::inf) {
+            return true;
+        }
+        const int64_t best_end = clockwise ? int64_t(dt) + lower_bound : int64_t(dt) - lower_bound;
+        for (const auto& target : targets) {
+            if ((clockwise ? target.end_dt < best_end : target.end_dt > best_end)
+                && target.walking_dur <= walking_dur + min_fallback) {
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+/** Origin of the labels of a multi-target second pass
+ *
+ * All the starting points of the second pass are seeded in the same backward raptor, and
+ * each label remembers the starting point it comes from.  When a label of a starting point
+ * is beaten by a label of another starting point that does not dominate it (arriving later
+ * or with a longer fallback), the journeys of the beaten starting point may be lost: it is
+ * marked as conflicted and gets its own second pass afterwards.
+ */
+struct SndPhaseTags {
+    static constexpr uint32_t none = std::numeric_limits<uint32_t>::max();
+
+    struct Seed {
+        DateTime end_dt;
+        DateTime fallback_dur;
+    };
+
+    bool enabled = false;
+    bool clockwise = true;  // of the request, i.e. of the first pass
+    std::vector<Seed> seeds;
+    std::vector<std::vector<uint32_t>> pt;        // by round then by stop point
+    std::vector<std::vector<uint32_t>> transfer;  // by round then by stop point
+    std::vector<uint32_t> best_pt;
+    std::vector<uint32_t> best_transfer;
+    boost::dynamic_bitset<> conflicted;
+
+    void reset(const bool c, const size_t nb_rounds, const size_t nb_sps) {
+        clockwise = c;
+        seeds.clear();
+        pt.assign(nb_rounds, std::vector<uint32_t>(nb_sps, none));
+        transfer.assign(nb_rounds, std::vector<uint32_t>(nb_sps, none));
+        best_pt.assign(nb_sps, none);
+        best_transfer.assign(nb_sps, none);
+        conflicted.clear();
+    }
+    void add_round() {
+        pt.emplace_back(best_pt.size(), none);
+        transfer.emplace_back(best_transfer.size(), none);
+    }
+
+    // the bounds of the first pass (tagged none) are used by every second pass
+    bool dominates(const uint32_t winner, const uint32_t loser) const {
+        if (winner == loser || winner == none) {
+            return true;
+        }
+        const auto& w = seeds[winner];
+        const auto& l = seeds[loser];
+        return (clockwise ? w.end_dt <= l.end_dt : w.end_dt >= l.end_dt) && w.fallback_dur <= l.fallback_dur;
+    }
+    void lose(const uint32_t winner, const uint32_t loser) {
+        if (loser != none && !dominates(winner, loser)) {
+            conflicted.set(loser);
+        }
+    }
+    /*
+     * A vehicle boarded at `boarding` reaches `sp` at round `count`.  If `improved`, its label
+     * replaces the one of the round, otherwise it is discarded for the best label.  Only a
+     * strictly better datetime hides a journey from the solution reader, thus `strictly`
+     * tells if the discarded label is strictly worse than the kept one.
+     */
+    void reach_pt(const unsigned count,
+                  const SpIdx boarding,
+                  const SpIdx sp,
+                  const bool improved,
+                  const bool strictly) {
+        reach(transfer[count - 1][boarding.val], pt[count], best_pt, sp, improved, strictly);
+    }
+    /// Same as reach_pt for a connection from `from` reaching `to`
+    void reach_transfer(const unsigned count,
+                        const SpIdx from,
+                        const SpIdx to,
+                        const bool improved,
+                        const bool strictly) {
+        reach(pt[count][from.val], transfer[count], best_transfer, to, improved, strictly);
+    }
+
+private:
+    void reach(const uint32_t tag,
+               std::vector<uint32_t>& working,
+               std::vector<uint32_t>& best,
+               const SpIdx sp,
+               const bool improved,
+               const bool strictly) {
+        if (!improved) {
+            if (strictly) {
+                lose(best[sp.val], tag);
+            }
+            return;
+        }
+        if (strictly) {
+            lose(tag, working[sp.val]);
+        }
+        working[sp.val] = tag;
+        best[sp.val] = tag;
+    }
+};
+
 /** Worker Raptor : une instance par thread, les données sont modifiées par le calcul */
 struct RAPTOR {
     typedef std::list<Journey> Journeys;
@@ -86,24 +252,41 @@ struct RAPTOR {
 
     /// Number of transfers done for the moment
     unsigned int count;
-    /// Are the journey pattern valid
-    boost::dynamic_bitset<> valid_journey_patterns;
-    dataRAPTOR::JppsFromSp jpps_from_sp;
+    /// Valid journey patterns, journey pattern points and stop points of the request,
+    /// shared with the other workers (see set_valid_jp_and_jpp)
+    std::shared_ptr<const ValidJourneyPatterns> valid_jps;
     /// Order of the first journey_pattern point of each journey_pattern
     IdxMap<JourneyPattern, int> Q;
 
-    // set to store if the stop_point is valid
-    boost::dynamic_bitset<> valid_stop_points;
-
     log4cplus::Logger raptor_logger;
 
+    /// How the second pass of compute_all_journeys is done
+    enum class SndPhaseMode {
+        ByStartingPoint,  // one backward raptor by starting point
+        MultiTarget       // one backward raptor seeded with every starting point
+    };
+    SndPhaseMode snd_phase_mode = SndPhaseMode::ByStartingPoint;
+    /// Tags of the labels, only enabled during a multi-target second pass
+    SndPhaseTags snd_phase_tags;
+
+    /// Record the parents of the labels (about 28 bytes by stop point and round)
+    bool record_parents = false;
+    /// Parents of the labels by round, only when record_parents is set
+    std::vector<LabelParents> parents;
+    /// Memory used by the parents, in bytes
+    size_t parents_memory() const;
+
+    /// Prune the labels of the first pass of compute_all_journeys that cannot lead to the destinations
+    bool target_pruning = false;
+    TargetBounds target_bounds;
+    /// Number of labels pruned by the last first pass
+    size_t nb_pruned_labels = 0;
+
     explicit RAPTOR(const navitia::type::Data& data)
         : data(data),
           best_labels(data.pt_data->stop_points),
           count(0),
-          valid_journey_patterns(data.dataRaptor->jp_container.nb_jps()),
           Q(data.dataRaptor->jp_container.get_jps_values()),
-          valid_stop_points(data.pt_data->stop_points.size()),
           raptor_logger(log4cplus::Logger::getInstance(LOG4CPLUS_TEXT("raptor"))) {
         labels.assign(10, data.dataRaptor->labels_const);
         first_pass_labels.assign(10, data.dataRaptor->labels_const);
@@ -117,6 +300,12 @@ struct RAPTOR {
               const bool clockwise,
               const type::Properties& properties);
 
+    /// Initialize a multi-target second pass with the given starting points
+    void init_multi_target(const std::vector<StartingPointSndPhase>& starting_points,
+                           const map_stop_point_duration& arrivals,
+                           const bool clockwise,
+                           const type::Properties& properties);
+
     // pt_data object getters by typed idx
     const type::StopPoint* get_sp(SpIdx idx) const { return data.pt_data->stop_points[idx.val]; }
 
@@ -214,7 +403,9 @@ struct RAPTOR {
                             const uint16_t l_zone,
                             DateTime workingDate,
                             DateTime working_walking_duration,
-                            SpIdx boarding_stop_point);
+                            SpIdx boarding_stop_point,
+                            const type::StopTime* boarding_st,
+                            DateTime boarding_dt);
 
     /// Main loop
     template <typename Visitor>
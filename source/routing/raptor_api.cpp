@@ -34,6 +34,8 @@ www.navitia.io
 #include "georef/street_network.h"
 #include "heat_map.h"
 #include "isochrone.h"
+#include "multi_departure_raptor.h"
+#include "pt_matrix.h"
 #include "type/datetime.h"
 #include "type/meta_data.h"
 #include "type/pb_converter.h"
@@ -705,8 +707,8 @@ static bt::ptime handle_pt_sections(pbnavitia::Journey* pb_journey,
     }
 
     if (vp) {
-        const auto& vect_p = vptranslator::translate(*vp);
-        pb_creator.fill(vect_p, pb_journey->mutable_calendars(), 0);
+        const auto vect_p = vptranslator::translate_cached(*vp);
+        pb_creator.fill(*vect_p, pb_journey->mutable_calendars(), 0);
     }
 
     compute_most_serious_disruption(pb_journey, pb_creator);
@@ -1678,5 +1680,169 @@ void make_heat_map(navitia::PbCreator& pb_creator,
     add_heat_map(heat_map, pb_creator, center, clockwise, isochrone_common->datetime);
 }
 
+/*
+ * Computes the isochrone of each datetime with a MultiDepartureRaptor, and calls
+ * on_isochrone(common) with the labels of the datetime copied into raptor.best_labels,
+ * where the builders of the isochrones and of the heat maps read them.
+ */
+template <typename F>
+static void make_multi_departure_isochrones(PbCreator& pb_creator,
+                                            RAPTOR& raptor,
+                                            const type::EntryPoint& center,
+                                            const std::vector<uint64_t>& departure_datetimes,
+                                            const DateTime max_duration,
+                                            const uint32_t max_transfers,
+                                            const type::AccessibiliteParams& accessibilite_params,
+                                            const std::vector<std::string>& forbidden,
+                                            const std::vector<std::string>& allowed,
+                                            const bool clockwise,
+                                            const nt::RTLevel rt_level,
+                                            georef::StreetNetwork& worker,
+                                            const boost::optional<const type::EntryPoints&>& stop_points,
+                                            const F& on_isochrone) {
+    const auto datetimes = parse_datetimes(raptor, departure_datetimes, pb_creator, clockwise);
+    if (pb_creator.has_error() || datetimes.empty() || pb_creator.has_response_type(pbnavitia::DATE_OUT_OF_BOUNDS)) {
+        return;
+    }
+
+    const auto departures = get_stop_points_if_not_already_done(center, raptor.data, worker, stop_points);
+    if (!departures) {
+        pb_creator.fill_pb_error(pbnavitia::Error::unknown_object, "The entry point: " + center.uri + " is not valid");
+        return;
+    }
+
+    std::vector<DateTime> init_dts;
+    for (const auto& datetime : datetimes) {
+        init_dts.push_back(to_datetime(datetime, raptor.data));
+    }
+    MultiDepartureRaptor multi_raptor(raptor.data);
+    multi_raptor.isochrones(*departures, init_dts, max_duration, max_transfers, accessibilite_params, forbidden,
+                            allowed, clockwise, rt_level, [&](const size_t i) {
+                                multi_raptor.fill_best_labels(i, raptor.best_labels);
+                                on_isochrone(IsochroneCommon(clockwise, center.coordinates, *departures, init_dts[i],
+                                                             center, build_bound(clockwise, max_duration, init_dts[i]),
+                                                             datetimes[i]));
+                            });
+}
+
+void make_graphical_isochrones(navitia::PbCreator& pb_creator,
+                               RAPTOR& raptor,
+                               const type::EntryPoint& center,
+                               const std::vector<uint64_t>& departure_datetimes,
+                               const std::vector<DateTime>& boundary_duration,
+                               const uint32_t max_transfers,
+                               const type::AccessibiliteParams& accessibilite_params,
+                               const std::vector<std::string>& forbidden,
+                               const std::vector<std::string>& allowed,
+                               const bool clockwise,
+                               const nt::RTLevel rt_level,
+                               georef::StreetNetwork& worker,
+                               const double& speed,
+                               const boost::optional<const type::EntryPoints&>& stop_points) {
+    make_multi_departure_isochrones(
+        pb_creator, raptor, center, departure_datetimes, boundary_duration[0], max_transfers, accessibilite_params,
+        forbidden, allowed, clockwise, rt_level, worker, stop_points, [&](const IsochroneCommon& common) {
+            const auto isochrones = build_isochrones(raptor, clockwise, common.coord_origin, common.departures, speed,
+                                                     boundary_duration, common.init_dt);
+            for (const auto& iso : isochrones) {
+                auto min_date_time = make_isochrone_date(common.init_dt, iso.min_duration, clockwise);
+                auto max_date_time = make_isochrone_date(common.init_dt, iso.max_duration, clockwise);
+                add_graphical_isochrone(iso.shape, iso.min_duration, iso.max_duration, pb_creator, center, clockwise,
+                                        common.datetime, raptor.data, min_date_time, max_date_time);
+            }
+        });
+}
+
+void make_heat_maps(navitia::PbCreator& pb_creator,
+                    RAPTOR& raptor,
+                    const type::EntryPoint& center,
+                    const std::vector<uint64_t>& departure_datetimes,
+                    const DateTime max_duration,
+                    const uint32_t max_transfers,
+                    const type::AccessibiliteParams& accessibilite_params,
+                    const std::vector<std::string>& forbidden,
+                    const std::vector<std::string>& allowed,
+                    const bool clockwise,
+                    const nt::RTLevel rt_level,
+                    georef::StreetNetwork& worker,
+                    const double& end_speed,
+                    const navitia::type::Mode_e end_mode,
+                    const uint32_t resolution,
+                    const boost::optional<const type::EntryPoints&>& stop_points) {
+    if (worker.geo_ref.nb_vertex_by_mode == 0) {
+        // if we have no street network we cannot compute a heatmap
+        pb_creator.fill_pb_error(pbnavitia::Error::no_solution, pbnavitia::NO_SOLUTION,
+                                 "no street network data, impossible to compute a heat_map");
+        return;
+    }
+
+    make_multi_departure_isochrones(
+        pb_creator, raptor, center, departure_datetimes, max_duration, max_transfers, accessibilite_params, forbidden,
+        allowed, clockwise, rt_level, worker, stop_points, [&](const IsochroneCommon& common) {
+            auto heat_map = build_raster_isochrone(worker.geo_ref, end_speed, end_mode, common.init_dt, raptor,
+                                                   common.coord_origin, max_duration, clockwise, common.bound,
+                                                   resolution);
+            add_heat_map(heat_map, pb_creator, center, clockwise, common.datetime);
+        });
+}
+
+void make_pt_routing_matrix(navitia::PbCreator& pb_creator,
+                            const type::Data& data,
+                            const type::EntryPoints& origins,
+                            const type::EntryPoints& destinations,
+                            const std::vector<uint64_t>& departure_datetimes,
+                            const DateTime max_duration,
+                            const uint32_t max_transfers,
+                            const type::AccessibiliteParams& accessibilite_params,
+                            const std::vector<std::string>& forbidden,
+                            const std::vector<std::string>& allowed,
+                            const nt::RTLevel rt_level,
+                            georef::StreetNetwork& worker,
+                            const size_t nb_threads) {
+    std::vector<DateTime> datetimes;
+    for (const auto datetime : departure_datetimes) {
+        const bt::ptime departure = bt::from_time_t(datetime);
+        if (!data.meta->production_date.contains(departure.date())) {
+            pb_creator.fill_pb_error(pbnavitia::Error::date_out_of_bounds, pbnavitia::DATE_OUT_OF_BOUNDS,
+                                     "date is not in data production period");
+            return;
+        }
+        datetimes.push_back(to_datetime(departure, data));
+    }
+
+    // the street network durations of each entry point, as for a journey
+    const auto fallbacks = [&](const type::EntryPoints& entry_points, const bool use_second) {
+        std::vector<map_stop_point_duration> result;
+        for (const auto& ep : entry_points) {
+            if (use_second) {
+                worker.init(ep, ep);
+            } else {
+                worker.init(ep);
+            }
+            auto stop_points = get_stop_points(ep, data, worker, 0, use_second);
+            result.push_back(stop_points ? std::move(*stop_points) : map_stop_point_duration());
+        }
+        return result;
+    };
+    const auto matrix =
+        compute_pt_matrix(data, fallbacks(origins, false), fallbacks(destinations, true), datetimes, max_duration,
+                          max_transfers, accessibilite_params, forbidden, allowed, rt_level, nb_threads);
+
+    for (size_t o = 0; o < matrix.nb_origins; ++o) {
+        auto* row = pb_creator.mutable_sn_routing_matrix()->add_rows();
+        for (size_t d = 0; d < matrix.nb_destinations; ++d) {
+            const auto& cell = matrix.at(o, d);
+            auto* k = row->add_routing_response();
+            if (cell.duration == DateTimeUtils::inf) {
+                k->set_duration(0);
+                k->set_routing_status(pbnavitia::RoutingStatus::unreached);
+            } else {
+                k->set_duration(cell.duration);
+                k->set_routing_status(pbnavitia::RoutingStatus::reached);
+            }
+        }
+    }
+}
+
 }  // namespace routing
 }  // namespace navitia
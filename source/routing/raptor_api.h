@@ -224,6 +224,65 @@ void make_heat_map(navitia::PbCreator& pb_creator,
                    const uint32_t resolution,
                    const boost::optional<const type::EntryPoints&>& stop_points = boost::none);
 
+/**
+ * @brief The graphical isochrones (resp. heat maps) of each datetime, computed by batches
+ * of datetimes with a MultiDepartureRaptor instead of one raptor by datetime
+ */
+void make_graphical_isochrones(navitia::PbCreator& pb_creator,
+                               RAPTOR& raptor,
+                               const type::EntryPoint& center,
+                               const std::vector<uint64_t>& departure_datetimes,
+                               const std::vector<DateTime>& boundary_duration,
+                               const uint32_t max_transfers,
+                               const type::AccessibiliteParams& accessibilite_params,
+                               const std::vector<std::string>& forbidden,
+                               const std::vector<std::string>& allowed,
+                               const bool clockwise,
+                               const nt::RTLevel rt_level,
+                               georef::StreetNetwork& worker,
+                               const double& speed,
+                               const boost::optional<const type::EntryPoints&>& stop_points = boost::none);
+
+void make_heat_maps(navitia::PbCreator& pb_creator,
+                    RAPTOR& raptor,
+                    const type::EntryPoint& center,
+                    const std::vector<uint64_t>& departure_datetimes,
+                    const DateTime max_duration,
+                    const uint32_t max_transfers,
+                    const type::AccessibiliteParams& accessibilite_params,
+                    const std::vector<std::string>& forbidden,
+                    const std::vector<std::string>& allowed,
+                    const bool clockwise,
+                    const nt::RTLevel rt_level,
+                    georef::StreetNetwork& worker,
+                    const double& end_speed,
+                    const navitia::type::Mode_e end_mode,
+                    const uint32_t resolution,
+                    const boost::optional<const type::EntryPoints&>& stop_points = boost::none);
+
+/**
+ * @brief The public transport travel times from each origin to each destination, as the
+ * rows of a routing matrix
+ *
+ * The departure datetimes are the samples of a time window, and each duration is the median
+ * of the samples.  The origins are computed in parallel by at most nb_threads threads of the
+ * HelperPool (0 for all of them).  The routing responses have no field for the transfers,
+ * they are only in the PtMatrix.
+ */
+void make_pt_routing_matrix(navitia::PbCreator& pb_creator,
+                            const type::Data& data,
+                            const type::EntryPoints& origins,
+                            const type::EntryPoints& destinations,
+                            const std::vector<uint64_t>& departure_datetimes,
+                            const DateTime max_duration,
+                            const uint32_t max_transfers,
+                            const type::AccessibiliteParams& accessibilite_params,
+                            const std::vector<std::string>& forbidden,
+                            const std::vector<std::string>& allowed,
+                            const nt::RTLevel rt_level,
+                            georef::StreetNetwork& worker,
+                            const size_t nb_threads = 0);
+
 void make_pathes(PbCreator& pb_creator,
                  const std::vector<navitia::routing::Path>& paths,
                  georef::StreetNetwork& worker,
@@ -38,6 +38,8 @@ www.navitia.io
 #include <boost/container/flat_map.hpp>
 #include <boost/range/algorithm/find_if.hpp>
 #include <boost/range/algorithm/reverse.hpp>
+
+#include <deque>
 #include <utility>
 
 namespace navitia {
@@ -480,7 +482,7 @@ struct RaptorSolutionReader {
             if (v.comp(end_limit, cur_dt)) {
                 continue;
             }
-            if (!raptor.valid_stop_points[end_sp_idx.val]) {
+            if (!raptor.valid_jps->stop_points[end_sp_idx.val]) {
                 continue;
             }
 
@@ -537,7 +539,7 @@ struct RaptorSolutionReader {
                       Transfers& transfers) {
         const unsigned transfer_t = v.clockwise() ? begin_dt - end_st_dt.second : end_st_dt.second - begin_dt;
         const DateTime begin_limit = raptor.labels[count].dt_pt(begin_sp_idx);
-        for (const auto& jpp : raptor.jpps_from_sp[begin_sp_idx]) {
+        for (const auto& jpp : raptor.valid_jps->jpps_from_sp[begin_sp_idx]) {
             // trying to begin
             const auto begin_st_dt = raptor.next_st->next_stop_time(v.stop_event(), jpp.idx, begin_dt, v.clockwise());
             if (begin_st_dt.first == nullptr) {
@@ -546,7 +548,7 @@ struct RaptorSolutionReader {
             if (v.comp(begin_limit, begin_st_dt.second)) {
                 continue;
             }
-            if (!raptor.valid_stop_points[begin_sp_idx.val]) {
+            if (!raptor.valid_jps->stop_points[begin_sp_idx.val]) {
                 continue;
             }
 
@@ -569,9 +571,90 @@ struct RaptorSolutionReader {
         }
     }
 
+    /*
+     * The journey found by the labels, unwound with their parents instead of trying every boarding.
+     *
+     * The labels keep one parent, whereas begin_pt explores every journey pattern, transfer and stay-in
+     * reaching them, and takes the vehicle journey nearest to each transfer.  Returns false without any
+     * solution if the journey has such alternatives, or if a parent has not been set with the label it is
+     * read for: begin_pt must be used instead.
+     */
+    bool unwind(const unsigned count, const SpIdx begin_sp_idx) {
+        static const auto no_zone = std::numeric_limits<uint16_t>::max();
+        const auto& cnx_list = v.clockwise() ? raptor.data.dataRaptor->connections.forward_connections
+                                             : raptor.data.dataRaptor->connections.backward_connections;
+        std::deque<PathElt> path_elts;
+        const PathElt* path = nullptr;
+        SpIdx sp_idx = begin_sp_idx;
+        DateTime begin_dt = raptor.labels[count].dt_pt(begin_sp_idx);
+        for (unsigned round = count; round > 0; --round) {
+            const auto& jpps = raptor.valid_jps->jpps_from_sp[sp_idx];
+            if (!raptor.labels[round].pt_is_initialized(sp_idx) || jpps.size() != 1) {
+                return false;
+            }
+            // the pass has boarded where the reader gets out
+            const auto& parent = raptor.parents[round].pt[sp_idx.val];
+            if (parent.board_st == nullptr || parent.debark_st == nullptr
+                || parent.board_st->vehicle_journey != parent.debark_st->vehicle_journey
+                || parent.debark_st->local_traffic_zone != no_zone) {
+                return false;
+            }
+            // the reader begins with the vehicle journey found from begin_dt, it must be the one of the label
+            const auto begin_st_dt =
+                raptor.next_st->next_stop_time(v.stop_event(), jpps.front().idx, begin_dt, v.clockwise());
+            if (begin_st_dt.first != parent.debark_st || begin_st_dt.second != raptor.labels[round].dt_pt(sp_idx)) {
+                return false;
+            }
+            // create_transfers continues in the stay-ins, and tries every stop point of the vehicle journey
+            // where the previous round allows to get out
+            if (v.get_extension_vj(parent.debark_st->vehicle_journey) != nullptr) {
+                return false;
+            }
+            const SpIdx board_sp_idx = SpIdx(*parent.board_st->stop_point);
+            const auto base_dt = begin_st_dt.first->base_dt(begin_st_dt.second, v.clockwise());
+            const DateTime end_dt = parent.board_st->section_end(base_dt, v.clockwise());
+            if (!raptor.labels[round - 1].transfer_is_initialized(board_sp_idx)
+                || v.comp(raptor.labels[round - 1].dt_transfer(board_sp_idx), end_dt)) {
+                return false;
+            }
+            auto st_range = v.st_range(*parent.debark_st);
+            for (const auto& end_st : st_range.advance_begin(1)) {
+                if (&end_st != parent.board_st && end_st.valid_end(v.clockwise())
+                    && raptor.labels[round - 1].transfer_is_initialized(SpIdx(*end_st.stop_point))) {
+                    return false;
+                }
+            }
+            path_elts.emplace_back(*parent.debark_st, begin_st_dt.second, *parent.board_st, end_dt, path);
+            path = &path_elts.back();
+            if (round == 1) {
+                break;
+            }
+            // try_transfer tries every connection of the stop point, the one of the label must be the only one
+            const SpIdx from_sp_idx = raptor.parents[round - 1].transfer[board_sp_idx.val];
+            const dataRAPTOR::Connections::Connection* transfer = nullptr;
+            for (const auto& conn : cnx_list[board_sp_idx]) {
+                if (conn.sp_idx == from_sp_idx) {
+                    transfer = &conn;
+                } else if (raptor.labels[round - 1].pt_is_initialized(conn.sp_idx)) {
+                    return false;
+                }
+            }
+            if (transfer == nullptr) {
+                return false;
+            }
+            begin_dt = v.combine(end_dt, transfer->duration);
+            if (v.comp(raptor.labels[round - 1].dt_pt(from_sp_idx), begin_dt)) {
+                return false;
+            }
+            sp_idx = from_sp_idx;
+        }
+        handle_solution(*path);
+        return true;
+    }
+
     void begin_pt(const unsigned count, const SpIdx begin_sp_idx, const DateTime begin_dt) {
         const DateTime begin_limit = raptor.labels[count].dt_pt(begin_sp_idx);
-        for (const auto& jpp : raptor.jpps_from_sp[begin_sp_idx]) {
+        for (const auto& jpp : raptor.valid_jps->jpps_from_sp[begin_sp_idx]) {
             // trying to begin
             const auto begin_st_dt = raptor.next_st->next_stop_time(v.stop_event(), jpp.idx, begin_dt, v.clockwise());
             if (begin_st_dt.first == nullptr) {
@@ -597,10 +680,14 @@ void read_solutions(const RAPTOR& raptor,
                     const type::RTLevel rt_level,
                     const type::AccessibiliteParams& accessibilite_params,
                     const navitia::time_duration& transfer_penalty,
-                    const StartingPointSndPhase& end_point) {
+                    const std::vector<StartingPointSndPhase>& end_points) {
     auto reader = RaptorSolutionReader<Visitor>(raptor, solutions, v, departure_datetime, deps, arrs, rt_level,
-                                                accessibilite_params, transfer_penalty, end_point);
-    const auto end_point_street_network_duration = (v.clockwise() ? arrs : deps).at(end_point.sp_idx);
+                                                accessibilite_params, transfer_penalty, end_points.front());
+    std::vector<navitia::time_duration> end_points_street_network_duration;
+    end_points_street_network_duration.reserve(end_points.size());
+    for (const auto& end_point : end_points) {
+        end_points_street_network_duration.push_back((v.clockwise() ? arrs : deps).at(end_point.sp_idx));
+    }
     for (unsigned count = 1; count <= raptor.count; ++count) {
         auto& working_labels = raptor.labels[count];
         for (const auto& a : v.clockwise() ? deps : arrs) {
@@ -614,23 +701,30 @@ void read_solutions(const RAPTOR& raptor,
                 continue;
             }
             reader.nb_sol_added = 0;
-            // we check that it's worth to explore this possible journey
-            auto transfer_duration = working_labels.walking_duration_pt(a.first) - end_point_street_network_duration;
-            auto j = make_bound_journey(
-                working_labels.dt_pt(a.first), a.second, raptor.labels[0].dt_transfer(end_point.sp_idx),
-                end_point_street_network_duration, count, navitia::seconds(transfer_duration), v.clockwise());
-            LOG4CPLUS_DEBUG(raptor.raptor_logger, "Journey from " << stop_point->uri << " count : " << count
-                                                                  << std::endl
-                                                                  << j);
-
-            if (reader.solutions.contains_better_than(j)) {
+            // we check that it's worth to explore this possible journey, to one of the end points at least
+            // (the journeys built from the label do not depend on the end point, only this bound does)
+            bool is_worth = false;
+            for (size_t e = 0; e < end_points.size() && !is_worth; ++e) {
+                const auto& sn_duration = end_points_street_network_duration[e];
+                auto transfer_duration = working_labels.walking_duration_pt(a.first) - sn_duration;
+                auto j = make_bound_journey(working_labels.dt_pt(a.first), a.second,
+                                            raptor.labels[0].dt_transfer(end_points[e].sp_idx), sn_duration, count,
+                                            navitia::seconds(transfer_duration), v.clockwise());
+                LOG4CPLUS_DEBUG(raptor.raptor_logger, "Journey from " << stop_point->uri << " count : " << count
+                                                                      << std::endl
+                                                                      << j);
+                is_worth = !reader.solutions.contains_better_than(j);
+            }
+            if (!is_worth) {
                 LOG4CPLUS_DEBUG(raptor.raptor_logger, "Journey discarded");
 
                 continue;
             }
             try {
                 LOG4CPLUS_DEBUG(raptor.raptor_logger, "try to build journey ");
-                reader.begin_pt(count, a.first, working_labels.dt_pt(a.first));
+                if (!raptor.record_parents || !reader.unwind(count, a.first)) {
+                    reader.begin_pt(count, a.first, working_labels.dt_pt(a.first));
+                }
             } catch (stop_search&) {
             }
         }
@@ -675,13 +769,30 @@ void read_solutions(const RAPTOR& raptor,
                     const type::RTLevel rt_level,
                     const type::AccessibiliteParams& accessibilite_params,
                     const navitia::time_duration& transfer_penalty,
-                    const StartingPointSndPhase& end_point) {
+                    const std::vector<StartingPointSndPhase>& end_points) {
+    if (end_points.empty()) {
+        return;
+    }
     if (clockwise) {
         return read_solutions(raptor, solutions, raptor_reverse_visitor(), departure_datetime, deps, arrs, rt_level,
-                              accessibilite_params, transfer_penalty, end_point);
+                              accessibilite_params, transfer_penalty, end_points);
     }
     return read_solutions(raptor, solutions, raptor_visitor(), departure_datetime, deps, arrs, rt_level,
-                          accessibilite_params, transfer_penalty, end_point);
+                          accessibilite_params, transfer_penalty, end_points);
+}
+
+void read_solutions(const RAPTOR& raptor,
+                    Solutions& solutions,
+                    const bool clockwise,
+                    const DateTime& departure_datetime,
+                    const routing::map_stop_point_duration& deps,
+                    const routing::map_stop_point_duration& arrs,
+                    const type::RTLevel rt_level,
+                    const type::AccessibiliteParams& accessibilite_params,
+                    const navitia::time_duration& transfer_penalty,
+                    const StartingPointSndPhase& end_point) {
+    read_solutions(raptor, solutions, clockwise, departure_datetime, deps, arrs, rt_level, accessibilite_params,
+                   transfer_penalty, std::vector<StartingPointSndPhase>{end_point});
 }
 
 Path make_path(const Journey& journey, const type::Data& data) {
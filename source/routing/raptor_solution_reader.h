@@ -98,6 +98,19 @@ void read_solutions(const RAPTOR& raptor,
                     const navitia::time_duration& transfer_penalty,
                     const StartingPointSndPhase& end_point);
 
+// Same, for the labels of a multi-target second pass seeded with all the end_points:
+// each label is read once, if it can lead to a solution to one of the end points
+void read_solutions(const RAPTOR& raptor,
+                    Solutions& solutions,
+                    const bool clockwise,
+                    const DateTime& departure_datetime,
+                    const routing::map_stop_point_duration& deps,
+                    const routing::map_stop_point_duration& arrs,
+                    const type::RTLevel rt_level,
+                    const type::AccessibiliteParams& accessibilite_params,
+                    const navitia::time_duration& transfer_penalty,
+                    const std::vector<StartingPointSndPhase>& end_points);
+
 Path make_path(const Journey& journey, const type::Data& data);
 
 }  // namespace routing
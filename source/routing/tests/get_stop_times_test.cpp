@@ -524,3 +524,44 @@ BOOST_FIXTURE_TEST_CASE(dep_arr_filtering, departure_helper) {
     BOOST_CHECK_EQUAL(prev_departures.at(3).first, "19:01"_t);
     BOOST_CHECK_EQUAL(prev_departures.at(4).first, "11:01"_t);
 }
+
+/*
+ * get_stop_times_by_group must give, for each group, the same departures as get_stop_times
+ *
+ * 3 lines (one of them a frequency line) pass through the 'center' station,
+ * each line is a group limited to 2 departures
+ */
+BOOST_FIXTURE_TEST_CASE(get_stop_times_by_group_test, departure_helper) {
+    b.vj("A", "1111", "", true, "A1")("x", "08:00"_t, "08:01"_t)("center", "09:00"_t, "09:01"_t)("y", "10:00"_t,
+                                                                                                 "10:01"_t);
+    b.vj("A", "1111", "", true, "A2")("x", "10:00"_t, "10:01"_t)("center", "10:30"_t, "10:31"_t)("y", "11:00"_t,
+                                                                                                 "11:01"_t);
+    b.vj("A", "1111", "", true, "A3")("x", "10:30"_t, "10:31"_t)("center", "11:00"_t, "11:01"_t)("y", "11:30"_t,
+                                                                                                 "11:31"_t);
+    b.vj("B", "1111", "", true, "B1")("x", "18:00"_t, "18:01"_t)("center", "23:50"_t, "23:51"_t)("y", "23:55"_t,
+                                                                                                 "23:56"_t);
+    b.frequency_vj("C", "09:00"_t, "10:00"_t, "00:20"_t)("x", "09:00"_t, "09:00"_t)("center", "09:10"_t, "09:10"_t);
+    b.make();
+
+    std::vector<std::vector<JppIdx>> groups;
+    for (const auto& jpp_idx : get_jpp_idx("center")) {
+        groups.push_back({jpp_idx});
+    }
+    BOOST_REQUIRE_EQUAL(groups.size(), 3);
+
+    for (const auto& bounds : {std::make_pair(today, tomorrow), std::make_pair(today + "10:00"_t, tomorrow),
+                               std::make_pair(yesterday + "23:00"_t, tomorrow), std::make_pair(tomorrow, today)}) {
+        const auto res_by_group = get_stop_times_by_group(StopEvent::pick_up, groups, bounds.first, bounds.second, 2,
+                                                          *b.data, nt::RTLevel::Base);
+        BOOST_REQUIRE_EQUAL(res_by_group.size(), groups.size());
+        for (size_t i = 0; i < groups.size(); ++i) {
+            const auto expected = get_stop_times(StopEvent::pick_up, groups[i], bounds.first, bounds.second, 2,
+                                                 *b.data, nt::RTLevel::Base);
+            BOOST_REQUIRE_EQUAL(res_by_group[i].size(), expected.size());
+            for (size_t j = 0; j < expected.size(); ++j) {
+                BOOST_CHECK_EQUAL(res_by_group[i][j].first, expected[j].first);
+                BOOST_CHECK_EQUAL(res_by_group[i][j].second, expected[j].second);
+            }
+        }
+    }
+}
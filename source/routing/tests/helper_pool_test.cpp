@@ -0,0 +1,132 @@
+/* Copyright © 2001-2014, Canal TP and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+channel `#navitia` on riot https://riot.im/app/#/room/#navitia:matrix.org
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE helper_pool_test
+
+#include "routing/helper_pool.h"
+#include "routing/isochrone.h"
+
+#include <boost/test/unit_test.hpp>
+
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace navitia::routing;
+
+BOOST_AUTO_TEST_CASE(every_task_is_done_once) {
+    HelperPool pool(3);
+    std::vector<std::atomic<int>> done(1000);
+    for (auto& d : done) {
+        d = 0;
+    }
+    pool.parallel_for(done.size(), 3, [&](const size_t i) { ++done[i]; });
+    for (const auto& d : done) {
+        BOOST_CHECK_EQUAL(d, 1);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(the_helpers_are_bounded) {
+    HelperPool pool(4);
+    std::atomic<int> running{0};
+    std::atomic<int> max_running{0};
+    pool.parallel_for(64, 1, [&](const size_t) {
+        const int nb = ++running;
+        int max = max_running;
+        while (nb > max && !max_running.compare_exchange_weak(max, nb)) {
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        --running;
+    });
+    // the calling thread and at most one helper
+    BOOST_CHECK_LE(max_running, 2);
+}
+
+BOOST_AUTO_TEST_CASE(a_busy_pool_leaves_the_work_to_the_caller) {
+    HelperPool pool(1);
+    std::atomic<bool> blocked{true};
+    std::atomic<bool> started{false};
+    std::thread other([&] {
+        pool.parallel_for(2, 1, [&](const size_t) {
+            started = true;
+            while (blocked) {
+                std::this_thread::yield();
+            }
+        });
+    });
+    while (!started) {
+        std::this_thread::yield();
+    }
+    // the only thread of the pool may be blocked by the other parallel_for, this one must not wait for it
+    const auto caller = std::this_thread::get_id();
+    size_t nb_on_caller = 0;
+    pool.parallel_for(10, 1, [&](const size_t) {
+        if (std::this_thread::get_id() == caller) {
+            ++nb_on_caller;
+        }
+    });
+    BOOST_CHECK_GE(nb_on_caller, 1);
+    blocked = false;
+    other.join();
+}
+
+BOOST_AUTO_TEST_CASE(exceptions_are_rethrown) {
+    HelperPool pool(2);
+    BOOST_CHECK_THROW(pool.parallel_for(100, 2,
+                                        [&](const size_t i) {
+                                            if (i == 42) {
+                                                throw std::runtime_error("42");
+                                            }
+                                        }),
+                      std::runtime_error);
+    // the pool is still usable
+    std::atomic<size_t> nb{0};
+    pool.parallel_for(10, 2, [&](const size_t) { ++nb; });
+    BOOST_CHECK_EQUAL(nb, 10);
+}
+
+BOOST_AUTO_TEST_CASE(bands_cover_all_the_items) {
+    for (const size_t nb_items : {0, 1, 5, 63, 64, 65, 1000, 1001}) {
+        std::vector<std::atomic<int>> done(nb_items);
+        for (auto& d : done) {
+            d = 0;
+        }
+        parallel_for_bands(nb_items, 1, [&](const size_t begin, const size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                ++done[i];
+            }
+        });
+        for (const auto& d : done) {
+            BOOST_CHECK_EQUAL(d, 1);
+        }
+    }
+}
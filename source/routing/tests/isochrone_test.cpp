@@ -35,6 +35,7 @@ www.navitia.io
 #include "routing/isochrone.h"
 #include "ed/build_helper.h"
 #include "routing/raptor.h"
+#include "routing/multi_departure_raptor.h"
 #include "routing/routing.h"
 #include "tests/utils_test.h"
 #include "utils/logger.h"
@@ -219,3 +220,79 @@ BOOST_AUTO_TEST_CASE(build_ischrons_test) {
     BOOST_CHECK(boost::geometry::equals(isochrone_8h30[0].shape, isochrone_8h_8h30_9h[0].shape));
     BOOST_CHECK(boost::geometry::equals(isochrone_8h30_9h[0].shape, isochrone_8h_8h30_9h[1].shape));
 }
+
+BOOST_AUTO_TEST_CASE(raster_circles_union_test) {
+    using coord = navitia::type::GeographicalCoord;
+    const coord coord_Paris{2.3522219000000177, 48.856614};
+    const coord coord_far = project_in_direction(coord_Paris, 90, 8000);
+
+    // a ring of circles around Paris, leaving a hole in the middle, and an island far away
+    std::vector<std::pair<coord, double>> circles;
+    for (int direction = 0; direction < 360; direction += 5) {
+        circles.emplace_back(project_in_direction(coord_Paris, direction, 2000), 300);
+    }
+    circles.emplace_back(coord_far, 500);
+
+    const auto raster = raster_circles_union(circles);
+    BOOST_REQUIRE_EQUAL(raster.size(), 2);
+    const auto& ring = boost::geometry::within(coord_far, raster[0]) ? raster[1] : raster[0];
+    BOOST_CHECK_EQUAL(ring.inners().size(), 1);
+
+    BOOST_CHECK(!boost::geometry::within(coord_Paris, raster));
+    BOOST_CHECK(boost::geometry::within(coord_far, raster));
+    BOOST_CHECK(boost::geometry::within(project_in_direction(coord_Paris, 42, 2000), raster));
+    BOOST_CHECK(!boost::geometry::within(project_in_direction(coord_Paris, 42, 2400), raster));
+
+    // same shape as the union of the polygons, up to the raster resolution
+    navitia::type::MultiPolygon exact;
+    for (const auto& c : circles) {
+        navitia::type::MultiPolygon merged;
+        boost::geometry::union_(circle(c.first, c.second), exact, merged);
+        exact = std::move(merged);
+    }
+    BOOST_CHECK_CLOSE(boost::geometry::area(raster), boost::geometry::area(exact), 2);
+}
+
+// a MultiDepartureRaptor must find the same labels as one RAPTOR::isochrone by datetime
+BOOST_AUTO_TEST_CASE(multi_departure_isochrones_test) {
+    ed::builder b("20120614");
+    for (int i = 0; i < 12; ++i) {
+        const int dep = "07:00"_t + i * 10 * 60;
+        b.vj("A")("stop1", dep)("stop2", dep + 10 * 60)("stop3", dep + 20 * 60);
+        b.vj("B")("stop2", dep + 13 * 60)("stop4", dep + 30 * 60)("stop5", dep + 45 * 60);
+    }
+    b.vj("C", "11111111", "block1")("stop3", "08:30"_t)("stop6", "08:40"_t);
+    b.vj("D", "11111111", "block1")("stop6", "08:45"_t)("stop7", "09:00"_t);
+    b.connection("stop2", "stop2", 120);
+    b.connection("stop3", "stop4", 300);
+    b.make();
+
+    navitia::routing::map_stop_point_duration d;
+    for (const bool clockwise : {true, false}) {
+        d.clear();
+        d.emplace(navitia::routing::SpIdx(*b.sps[clockwise ? "stop1" : "stop5"]), navitia::seconds(60));
+        std::vector<navitia::DateTime> datetimes;
+        for (int i = 0; i < 70; ++i) {
+            datetimes.push_back(navitia::DateTimeUtils::set(0, (clockwise ? "06:50"_t : "08:00"_t) + i * 2 * 60));
+        }
+        const navitia::DateTime max_duration = 2 * 3600;
+
+        MultiDepartureRaptor multi_raptor(*b.data);
+        RAPTOR raptor(*b.data);
+        size_t nb_results = 0;
+        multi_raptor.isochrones(d, datetimes, max_duration, 10, {}, {}, {}, clockwise, navitia::type::RTLevel::Base,
+                                [&](const size_t i) {
+                                    ++nb_results;
+                                    raptor.isochrone(d, datetimes[i],
+                                                     build_bound(clockwise, max_duration, datetimes[i]), 10, {}, {},
+                                                     {}, clockwise);
+                                    for (const auto* sp : b.data->pt_data->stop_points) {
+                                        const SpIdx sp_idx(*sp);
+                                        BOOST_CHECK_EQUAL(multi_raptor.dt_pt(i, sp_idx),
+                                                          raptor.best_labels.dt_pt(sp_idx));
+                                    }
+                                });
+        BOOST_CHECK_EQUAL(nb_results, datetimes.size());
+        BOOST_CHECK_EQUAL(multi_raptor.nb_passes, 2);
+    }
+}
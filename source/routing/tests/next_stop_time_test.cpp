@@ -2571,3 +2571,39 @@ BOOST_AUTO_TEST_CASE(freq_next_stop_time_with_distant_bounds) {
         BOOST_CHECK_EQUAL(st->stop_point->stop_area->name, spa2);
     }
 }
+
+BOOST_AUTO_TEST_CASE(cache_prefetch_and_counters) {
+    ed::builder b("20120614");
+    b.vj("A")("stop1", "08:00"_t)("stop2", "09:00"_t);
+    b.make();
+    b.data->build_raptor(4);
+    auto& manager = *b.data->dataRaptor->cached_next_st_manager;
+
+    type::AccessibiliteParams wheelchair;
+    wheelchair.properties.set(type::hasProperties::WHEELCHAIR_BOARDING, true);
+    const auto before = CachedNextStopTimeManager::counters();
+    manager.load(DateTimeUtils::set(0, "08:00"_t), nt::RTLevel::Base, wheelchair);
+    manager.load(DateTimeUtils::set(0, "10:00"_t), nt::RTLevel::Base, wheelchair);
+    manager.load(DateTimeUtils::set(0, "08:00"_t), nt::RTLevel::Base, {});
+
+    auto counters = CachedNextStopTimeManager::counters();
+    BOOST_CHECK_EQUAL(counters.nb_misses - before.nb_misses, 2);
+    BOOST_CHECK_EQUAL(counters.nb_hits - before.nb_hits, 1);
+    const auto popular = manager.popular_accessibilities(1);
+    BOOST_REQUIRE_EQUAL(popular.size(), 1);
+    BOOST_CHECK(popular.front().properties == wheelchair.properties);
+
+    // nothing is built once cancelled
+    b.data->dataRaptor->prefetch(0, 2, 1, 2, [] { return true; });
+    BOOST_CHECK_EQUAL(CachedNextStopTimeManager::counters().nb_prefetched, counters.nb_prefetched);
+
+    // the wheelchair caches of both days and both levels, the base one of the first day being already built
+    b.data->dataRaptor->prefetch(0, 2, 1, 2);
+    counters = CachedNextStopTimeManager::counters();
+    BOOST_CHECK_EQUAL(counters.nb_prefetched - before.nb_prefetched, 3);
+    BOOST_CHECK_EQUAL(counters.nb_evictions - before.nb_evictions, 1);
+
+    manager.load(DateTimeUtils::set(1, "08:00"_t), nt::RTLevel::RealTime, wheelchair);
+    BOOST_CHECK_EQUAL(CachedNextStopTimeManager::counters().nb_misses, counters.nb_misses);
+    BOOST_CHECK_EQUAL(CachedNextStopTimeManager::counters().nb_hits - before.nb_hits, 2);
+}
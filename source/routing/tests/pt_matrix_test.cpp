@@ -0,0 +1,93 @@
+/* Copyright © 2001-2016, Canal TP and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+channel `#navitia` on riot https://riot.im/app/#/room/#navitia:matrix.org
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE pt_matrix_test
+
+#include "routing/pt_matrix.h"
+#include "ed/build_helper.h"
+#include "tests/utils_test.h"
+#include "utils/logger.h"
+
+#include <boost/test/unit_test.hpp>
+#include <vector>
+
+struct logger_initialized {
+    logger_initialized() { navitia::init_logger(); }
+};
+BOOST_GLOBAL_FIXTURE(logger_initialized);
+
+using namespace navitia::routing;
+
+BOOST_AUTO_TEST_CASE(pt_matrix_test) {
+    ed::builder b("20120614");
+    for (int i = 0; i < 12; ++i) {
+        const int dep = "07:00"_t + i * 10 * 60;
+        b.vj("A")("stop1", dep)("stop2", dep + 10 * 60)("stop3", dep + 20 * 60);
+        b.vj("B")("stop2", dep + 13 * 60)("stop4", dep + 30 * 60)("stop5", dep + 45 * 60);
+    }
+    b.connection("stop2", "stop2", 120);
+    b.make();
+
+    const auto make_sps = [&](const std::string& sp, const int duration) {
+        map_stop_point_duration sps;
+        sps.emplace(SpIdx(*b.sps[sp]), navitia::seconds(duration));
+        return sps;
+    };
+    const std::vector<map_stop_point_duration> origins = {make_sps("stop1", 60), make_sps("stop2", 0)};
+    const std::vector<map_stop_point_duration> destinations = {make_sps("stop3", 60), make_sps("stop5", 0),
+                                                               make_sps("stop1", 0)};
+    std::vector<navitia::DateTime> datetimes;
+    for (const auto time : {"07:00"_t, "07:05"_t, "07:10"_t}) {
+        datetimes.push_back(navitia::DateTimeUtils::set(0, time));
+    }
+
+    // 0 for all the threads of the pool
+    for (const size_t nb_threads : {0, 1, 2}) {
+        const auto matrix = compute_pt_matrix(*b.data, origins, destinations, datetimes, 2 * 3600, 10, {}, {}, {},
+                                              navitia::type::RTLevel::Base, nb_threads);
+        BOOST_REQUIRE_EQUAL(matrix.nb_origins, 2);
+        BOOST_REQUIRE_EQUAL(matrix.nb_destinations, 3);
+
+        // the medians of the departures at 07:00, 07:05 and 07:10
+        BOOST_CHECK_EQUAL(matrix.at(0, 0).duration, 31 * 60);
+        BOOST_CHECK_EQUAL(matrix.at(0, 0).nb_transfers, 0);
+        BOOST_CHECK_EQUAL(matrix.at(0, 1).duration, 55 * 60);
+        BOOST_CHECK_EQUAL(matrix.at(0, 1).nb_transfers, 1);
+        // the origin and the destination share their stop point
+        BOOST_CHECK_EQUAL(matrix.at(0, 2).duration, 60);
+        BOOST_CHECK_EQUAL(matrix.at(0, 2).nb_transfers, 0);
+
+        BOOST_CHECK_EQUAL(matrix.at(1, 0).duration, 16 * 60);
+        BOOST_CHECK_EQUAL(matrix.at(1, 1).duration, 40 * 60);
+        BOOST_CHECK_EQUAL(matrix.at(1, 1).nb_transfers, 0);
+        BOOST_CHECK_EQUAL(matrix.at(1, 2).duration, navitia::DateTimeUtils::inf);
+    }
+}
@@ -50,6 +50,7 @@ BOOST_GLOBAL_FIXTURE(logger_initialized);
 
 using namespace navitia;
 using namespace routing;
+using navitia::test::summarize;
 namespace bt = boost::posix_time;
 
 BOOST_AUTO_TEST_CASE(direct) {
@@ -3572,3 +3573,303 @@ BOOST_AUTO_TEST_CASE(test_jira1686_should_take_journey_with_minimum_walking_on_t
     BOOST_CHECK_EQUAL(res[0].items[0].stop_points[0]->uri, "A");
     BOOST_CHECK_EQUAL(res[1].items[0].stop_points[0]->uri, "B");
 }
+
+// The journeys found by a multi-target second pass must be the ones found by one second pass by starting point
+static void check_same_journeys_with_multi_target(const type::Data& data,
+                                                  const routing::map_stop_point_duration& departures,
+                                                  const routing::map_stop_point_duration& arrivals,
+                                                  const DateTime departure_datetime,
+                                                  const bool clockwise,
+                                                  const size_t max_extra_second_pass = 0) {
+    const auto compute = [&](const RAPTOR::SndPhaseMode mode) {
+        RAPTOR raptor(data);
+        raptor.snd_phase_mode = mode;
+        return summarize(raptor.compute_all(departures, arrivals, departure_datetime, type::RTLevel::Base, 2_min,
+                                            clockwise ? DateTimeUtils::inf : DateTimeUtils::min, 10, {}, {}, {},
+                                            clockwise, boost::none, max_extra_second_pass));
+    };
+
+    const auto expected = compute(RAPTOR::SndPhaseMode::ByStartingPoint);
+    const auto res = compute(RAPTOR::SndPhaseMode::MultiTarget);
+    BOOST_CHECK(!expected.empty());
+    BOOST_REQUIRE_EQUAL(res.size(), expected.size());
+    BOOST_CHECK(res == expected);
+}
+
+/*
+ * Schedules:
+ *      Line A:
+ *      S1      S2      S3      S4
+ *      8h00    8h10    8h20    8h30
+ *
+ *      Line B:
+ *      S2      S5
+ *      8h15    8h22
+ *
+ *      Line C:
+ *      S6      S3      S5
+ *      8h05    8h21    8h26
+ *
+ * The arrival stop points S2, S3, S4 and S5 are all reached during the first pass with
+ * different datetimes, numbers of sections and fallbacks.  Some of them share labels
+ * during the multi-target second pass without dominating each other.
+ */
+BOOST_AUTO_TEST_CASE(multi_target_second_pass) {
+    ed::builder b("20150101");
+    b.vj("A")("S1", "8:00"_t)("S2", "8:10"_t)("S3", "8:20"_t)("S4", "8:30"_t);
+    b.vj("B")("S2", "8:15"_t)("S5", "8:22"_t);
+    b.vj("C")("S6", "8:05"_t)("S3", "8:21"_t)("S5", "8:26"_t);
+    b.connection("S2", "S2", "00:02"_t);
+    b.connection("S3", "S3", "00:00"_t);
+    b.connection("S1", "S6", "00:03"_t);
+    b.connection("S6", "S1", "00:03"_t);
+    b.make();
+
+    auto& sa_map = b.get_data().pt_data->stop_areas_map;
+    const auto sp = [&](const std::string& name) { return SpIdx(*sa_map.at(name)->stop_point_list.front()); };
+
+    routing::map_stop_point_duration departures, arrivals;
+    departures[sp("S1")] = 0_s;
+    departures[sp("S6")] = 4_min;
+    arrivals[sp("S2")] = 25_min;
+    arrivals[sp("S3")] = 12_min;
+    arrivals[sp("S4")] = 0_s;
+    arrivals[sp("S5")] = 5_min;
+
+    for (const size_t max_extra : {0, 2, 10}) {
+        check_same_journeys_with_multi_target(b.get_data(), departures, arrivals, DateTimeUtils::set(0, "7:55"_t),
+                                              true, max_extra);
+        check_same_journeys_with_multi_target(b.get_data(), departures, arrivals, DateTimeUtils::set(0, "8:40"_t),
+                                              false, max_extra);
+    }
+}
+
+/*
+ * Schedules:
+ *      Line A:
+ *      S1      S2      S3      S4
+ *      8h00    8h10    8h20    8h30
+ *
+ *      Line B:
+ *      S1      S5
+ *      8h15    8h25
+ *
+ * S2 and S4 are the starting points with priority of the second pass.  S3 and S5 are
+ * dominated by S2 during the first pass, they are only used according to the solutions
+ * found from S2 and S4 and to max_extra_second_pass.
+ */
+BOOST_AUTO_TEST_CASE(multi_target_second_pass_without_priority) {
+    ed::builder b("20150101");
+    b.vj("A")("S1", "8:00"_t)("S2", "8:10"_t)("S3", "8:20"_t)("S4", "8:30"_t);
+    b.vj("B")("S1", "8:15"_t)("S5", "8:25"_t);
+    b.make();
+
+    auto& sa_map = b.get_data().pt_data->stop_areas_map;
+    const auto sp = [&](const std::string& name) { return SpIdx(*sa_map.at(name)->stop_point_list.front()); };
+
+    routing::map_stop_point_duration departures, arrivals;
+    departures[sp("S1")] = 0_s;
+    arrivals[sp("S2")] = 10_min;
+    arrivals[sp("S3")] = 15_min;
+    arrivals[sp("S4")] = 5_min;
+    arrivals[sp("S5")] = 20_min;
+
+    for (const size_t max_extra : {0, 1, 2, 10}) {
+        check_same_journeys_with_multi_target(b.get_data(), departures, arrivals, DateTimeUtils::set(0, "7:55"_t),
+                                              true, max_extra);
+        check_same_journeys_with_multi_target(b.get_data(), departures, arrivals, DateTimeUtils::set(0, "9:00"_t),
+                                              false, max_extra);
+    }
+}
+
+// same as pareto_front: the two arrival stop points do not dominate each other
+BOOST_AUTO_TEST_CASE(multi_target_second_pass_pareto_front) {
+    ed::builder b("20120614");
+    b.vj("line1")("stop1", 9 * 3600)("stop2", 9 * 3600 + 50 * 60);
+    b.vj("line2")("stop2", 9 * 3600 + 55 * 60)("stop3", 10 * 3600);
+    b.connection("stop2", "stop2", 120);
+    b.make();
+
+    type::PT_Data& d = *b.data->pt_data;
+    routing::map_stop_point_duration departs, destinations;
+    departs[SpIdx(*d.stop_areas_map["stop1"]->stop_point_list.front())] = 0_s;
+    destinations[SpIdx(*d.stop_areas_map["stop2"]->stop_point_list.front())] = 15_min;
+    destinations[SpIdx(*d.stop_areas_map["stop3"]->stop_point_list.front())] = 0_s;
+
+    check_same_journeys_with_multi_target(*b.data, departs, destinations, DateTimeUtils::set(0, 8 * 3600), true);
+
+    RAPTOR raptor(*b.data);
+    raptor.snd_phase_mode = RAPTOR::SndPhaseMode::MultiTarget;
+    auto res = raptor.compute_all(departs, destinations, DateTimeUtils::set(0, 8 * 3600), type::RTLevel::Base, 2_min);
+    BOOST_REQUIRE_EQUAL(res.size(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(valid_journey_patterns_are_shared) {
+    ed::builder b("20150101");
+    b.vj("A")("S1", "8:00"_t)("S2", "8:10"_t);
+    b.vj("B")("S2", "8:15"_t)("S3", "8:30"_t);
+    b.make();
+
+    auto& manager = *b.data->dataRaptor->valid_jps_manager;
+    const auto s1 = SpIdx(*b.data->pt_data->stop_areas_map.at("S1")->stop_point_list.front());
+    const auto s2 = SpIdx(*b.data->pt_data->stop_areas_map.at("S2")->stop_point_list.front());
+
+    const auto all = manager.load(0, type::RTLevel::Base, {}, {}, {});
+    BOOST_CHECK_EQUAL(all->journey_patterns.count(), 2);
+    BOOST_CHECK_EQUAL(all->stop_points.count(), 3);
+    BOOST_CHECK_EQUAL(all->jpps_from_sp[s2].size(), 2);
+
+    const auto without_a = manager.load(0, type::RTLevel::Base, {}, {"A", "unknown"}, {});
+    BOOST_CHECK_EQUAL(without_a->journey_patterns.count(), 1);
+    BOOST_CHECK(without_a->jpps_from_sp[s1].empty());
+    BOOST_CHECK_EQUAL(without_a->jpps_from_sp[s2].size(), 1);
+    BOOST_CHECK_NE(all, without_a);
+
+    // the order and the duplicates of the uris don't matter
+    BOOST_CHECK_EQUAL(without_a, manager.load(0, type::RTLevel::Base, {}, {"unknown", "A", "A"}, {}));
+
+    const auto only_s2 = manager.load(0, type::RTLevel::Base, {}, {}, {"S2"});
+    BOOST_CHECK_EQUAL(only_s2->stop_points.count(), 1);
+    BOOST_CHECK(only_s2->stop_points[s2.val]);
+
+    // the workers use the shared view without copying it
+    RAPTOR raptor(*b.data);
+    raptor.set_valid_jp_and_jpp(0, {}, {"A"}, {}, type::RTLevel::Base);
+    BOOST_CHECK_EQUAL(raptor.valid_jps, manager.load(0, type::RTLevel::Base, {}, {"A"}, {}));
+    BOOST_CHECK_NE(raptor.valid_jps, without_a);
+}
+
+// The journeys unwound with the parents of the labels must be the ones found by the solution reader
+static void check_same_journeys_with_parents(const type::Data& data,
+                                             const routing::map_stop_point_duration& departures,
+                                             const routing::map_stop_point_duration& arrivals) {
+    const auto summarize_items = [](const std::vector<Path>& paths) {
+        std::vector<std::vector<std::tuple<bt::ptime, bt::ptime, ItemType>>> res;
+        for (const auto& path : paths) {
+            res.emplace_back();
+            for (const auto& item : path.items) {
+                res.back().emplace_back(item.departure, item.arrival, item.type);
+            }
+        }
+        std::sort(res.begin(), res.end());
+        return res;
+    };
+    for (const bool clockwise : {true, false}) {
+        const auto dt = DateTimeUtils::set(0, clockwise ? "7:55"_t : "9:00"_t);
+        const auto bound = clockwise ? DateTimeUtils::inf : DateTimeUtils::min;
+        RAPTOR reader(data);
+        const auto expected = summarize_items(
+            reader.compute_all(departures, arrivals, dt, type::RTLevel::Base, 2_min, bound, 10, {}, {}, {}, clockwise));
+        BOOST_CHECK_EQUAL(reader.parents_memory(), 0);
+
+        RAPTOR unwinder(data);
+        unwinder.record_parents = true;
+        const auto res = summarize_items(unwinder.compute_all(departures, arrivals, dt, type::RTLevel::Base, 2_min,
+                                                              bound, 10, {}, {}, {}, clockwise));
+        BOOST_CHECK_GT(unwinder.parents_memory(), 0);
+
+        BOOST_CHECK(!expected.empty());
+        BOOST_REQUIRE_EQUAL(res.size(), expected.size());
+        BOOST_CHECK(res == expected);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(read_solutions_with_parents) {
+    ed::builder b("20150101");
+    b.vj("A")("S1", "8:00"_t)("S2", "8:10"_t)("S3", "8:20"_t)("S4", "8:30"_t);
+    b.vj("B")("S2", "8:15"_t)("S5", "8:22"_t);
+    b.vj("C")("S6", "8:05"_t)("S3", "8:21"_t)("S5", "8:26"_t);
+    b.vj("D", "1111111", "block1", true)("S5", "8:30"_t)("S7", "8:40"_t);
+    b.vj("E", "1111111", "block1", true)("S7", "8:45"_t)("S8", "8:50"_t);
+    b.connection("S2", "S2", "00:02"_t);
+    b.connection("S5", "S5", "00:02"_t);
+    b.connection("S1", "S6", "00:03"_t);
+    b.make();
+
+    auto& sa_map = b.get_data().pt_data->stop_areas_map;
+    const auto sp = [&](const std::string& name) { return SpIdx(*sa_map.at(name)->stop_point_list.front()); };
+
+    routing::map_stop_point_duration departures, arrivals;
+    departures[sp("S1")] = 0_s;
+    arrivals[sp("S4")] = 10_min;
+    arrivals[sp("S8")] = 0_s;
+    check_same_journeys_with_parents(b.get_data(), departures, arrivals);
+}
+
+/*
+ * The labels keep one parent, while the solution reader finds several journeys:
+ *  - the vehicle journeys A1 and A2 of the same journey pattern reach S2, the label keeps A1
+ *    but the reader takes A2, the nearest to the transfer,
+ *  - S2 is reached by a transfer from S2 or from S4, with the same arrival,
+ *  - S6 is reached by the stay-in E -> F, or by a transfer at S3 to G.
+ * The journeys unwound with the parents must still be all the ones of the reader.
+ */
+BOOST_AUTO_TEST_CASE(read_solutions_with_parents_and_alternatives) {
+    ed::builder b("20150101");
+    b.vj("A")("S1", "8:00"_t)("S2", "8:10"_t);
+    b.vj("A")("S1", "8:04"_t)("S2", "8:14"_t);
+    b.vj("D")("S1", "8:01"_t)("S4", "8:13"_t);
+    b.vj("C")("S2", "8:20"_t)("S3", "8:30"_t);
+    b.vj("E", "1111111", "block2", true)("S3", "8:31"_t)("S5", "8:40"_t);
+    b.vj("F", "1111111", "block2", true)("S5", "8:45"_t)("S6", "8:55"_t);
+    b.vj("G")("S3", "8:35"_t)("S6", "8:55"_t);
+    b.connection("S2", "S2", "00:02"_t);
+    b.connection("S4", "S2", "00:03"_t);
+    b.connection("S3", "S3", "00:00"_t);
+    b.make();
+
+    auto& sa_map = b.get_data().pt_data->stop_areas_map;
+    const auto sp = [&](const std::string& name) { return SpIdx(*sa_map.at(name)->stop_point_list.front()); };
+
+    routing::map_stop_point_duration departures, arrivals;
+    departures[sp("S1")] = 0_s;
+    arrivals[sp("S6")] = 0_s;
+    arrivals[sp("S3")] = 30_min;
+    check_same_journeys_with_parents(b.get_data(), departures, arrivals);
+}
+
+/*
+ * The line B goes away from the destination S3 and C is slower than A: with the target pruning,
+ * their labels are not explored, and the journeys are the same.
+ */
+BOOST_AUTO_TEST_CASE(target_pruning) {
+    ed::builder b("20150101");
+    b.vj("A")("S1", "8:00"_t)("S2", "8:10"_t)("S3", "8:20"_t);
+    b.vj("B")("S1", "8:05"_t)("S4", "8:15"_t)("S5", "8:30"_t);
+    b.vj("C")("S2", "8:12"_t)("S6", "8:40"_t)("S3", "9:00"_t);
+    b.connection("S2", "S2", "00:02"_t);
+    b.make();
+
+    auto& sa_map = b.get_data().pt_data->stop_areas_map;
+    const auto sp = [&](const std::string& name) { return SpIdx(*sa_map.at(name)->stop_point_list.front()); };
+
+    const auto& oracle = b.get_data().dataRaptor->get_lower_bound_oracle(*b.get_data().pt_data);
+    BOOST_CHECK_EQUAL(oracle.duration(oracle.cluster(sp("S1")), oracle.cluster(sp("S3"))), "00:20"_t);
+    BOOST_CHECK_EQUAL(oracle.duration(oracle.cluster(sp("S2")), oracle.cluster(sp("S3"))), "00:10"_t);
+    BOOST_CHECK_EQUAL(oracle.duration(oracle.cluster(sp("S4")), oracle.cluster(sp("S3"))), DateTimeUtils::inf);
+
+    routing::map_stop_point_duration departures, arrivals;
+    departures[sp("S1")] = 0_s;
+    arrivals[sp("S3")] = 0_s;
+
+    for (const bool clockwise : {true, false}) {
+        const auto dt = DateTimeUtils::set(0, clockwise ? "7:55"_t : "9:30"_t);
+        const auto bound = clockwise ? DateTimeUtils::inf : DateTimeUtils::min;
+        RAPTOR raptor(b.get_data());
+        const auto expected = summarize(
+            raptor.compute_all(departures, arrivals, dt, type::RTLevel::Base, 2_min, bound, 10, {}, {}, {}, clockwise));
+        BOOST_CHECK_EQUAL(raptor.nb_pruned_labels, 0);
+
+        raptor.target_pruning = true;
+        const auto res = summarize(
+            raptor.compute_all(departures, arrivals, dt, type::RTLevel::Base, 2_min, bound, 10, {}, {}, {}, clockwise));
+        if (clockwise) {
+            // S4 and S5 cannot reach S3, and the transfer at S2 cannot arrive before 8:20
+            BOOST_CHECK_EQUAL(raptor.nb_pruned_labels, 3);
+        }
+
+        BOOST_CHECK(!expected.empty());
+        BOOST_REQUIRE_EQUAL(res.size(), expected.size());
+        BOOST_CHECK(res == expected);
+    }
+}
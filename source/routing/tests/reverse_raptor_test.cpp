@@ -44,6 +44,7 @@ BOOST_GLOBAL_FIXTURE(logger_initialized);
 
 using namespace navitia;
 using namespace routing;
+using navitia::test::summarize;
 namespace bt = boost::posix_time;
 
 BOOST_AUTO_TEST_CASE(direct) {
@@ -901,3 +902,40 @@ BOOST_AUTO_TEST_CASE(stay_in_pass_midnight) {
     // as we arrive the 20170103, we must begin the day before
     BOOST_CHECK_EQUAL(result.front().items.front().departure, "20170102T234500"_dt);
 }
+
+// an arrival after midnight with several departure stop points must give the same
+// journeys with a multi-target second pass than with one second pass by starting point
+BOOST_AUTO_TEST_CASE(multi_target_second_pass_anticlockwise) {
+    ed::builder b("20170101");
+    b.vj("A")("S1", "23:30"_t)("S2", "23:40"_t)("S3", "23:50"_t)("S4", "24:20"_t);
+    b.vj("B")("S2", "23:35"_t)("S5", "24:00"_t)("S4", "24:15"_t);
+    b.vj("C")("S3", "23:55"_t)("S5", "24:05"_t);
+    b.connection("S5", "S5", "00:02"_t);
+    b.connection("S3", "S3", "00:02"_t);
+    b.make();
+
+    auto& sa_map = b.data->pt_data->stop_areas_map;
+    const auto sp = [&](const std::string& name) { return SpIdx(*sa_map.at(name)->stop_point_list.front()); };
+
+    routing::map_stop_point_duration departures, arrivals;
+    departures[sp("S1")] = 0_s;
+    departures[sp("S2")] = 8_min;
+    departures[sp("S3")] = 20_min;
+    arrivals[sp("S4")] = 0_s;
+
+    for (const size_t max_extra : {0, 5}) {
+        RAPTOR by_starting_point(*b.data);
+        RAPTOR multi_target(*b.data);
+        multi_target.snd_phase_mode = RAPTOR::SndPhaseMode::MultiTarget;
+
+        const auto expected = summarize(
+            by_starting_point.compute_all(departures, arrivals, DateTimeUtils::set(1, "00:30"_t), type::RTLevel::Base,
+                                          2_min, DateTimeUtils::min, 10, {}, {}, {}, false, boost::none, max_extra));
+        const auto res = summarize(multi_target.compute_all(departures, arrivals, DateTimeUtils::set(1, "00:30"_t),
+                                                            type::RTLevel::Base, 2_min, DateTimeUtils::min, 10, {}, {},
+                                                            {}, false, boost::none, max_extra));
+        BOOST_CHECK(!expected.empty());
+        BOOST_REQUIRE_EQUAL(res.size(), expected.size());
+        BOOST_CHECK(res == expected);
+    }
+}
@@ -0,0 +1,239 @@
+/* Copyright © 2001-2014, Canal TP and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+channel `#navitia` on riot https://riot.im/app/#/room/#navitia:matrix.org
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#include "routing/valid_journey_patterns.h"
+
+#include "type/commercial_mode.h"
+#include "type/line.h"
+#include "type/network.h"
+#include "type/physical_mode.h"
+#include "type/pt_data.h"
+#include "type/route.h"
+#include "type/stop_area.h"
+#include "type/stop_point.h"
+#include "utils/logger.h"
+
+#include <algorithm>
+
+namespace navitia {
+namespace routing {
+
+namespace {
+struct ObjsFromIds {
+    boost::dynamic_bitset<> jps;
+    boost::dynamic_bitset<> jpps;
+    boost::dynamic_bitset<> sps;
+    ObjsFromIds(const std::vector<std::string>& ids,
+                const JourneyPatternContainer& jp_container,
+                const type::PT_Data& pt_data,
+                const dataRAPTOR& dataRaptor)
+        : jps(jp_container.nb_jps()), jpps(jp_container.nb_jpps()), sps(pt_data.stop_points.size()) {
+        for (const auto& id : ids) {
+            const auto it_line = pt_data.lines_map.find(id);
+            if (it_line != pt_data.lines_map.end()) {
+                for (const auto route : it_line->second->route_list) {
+                    for (const auto& jp_idx : jp_container.get_jps_from_route()[RouteIdx(*route)]) {
+                        jps.set(jp_idx.val, true);
+                    }
+                }
+                continue;
+            }
+            const auto it_route = pt_data.routes_map.find(id);
+            if (it_route != pt_data.routes_map.end()) {
+                for (const auto& jp_idx : jp_container.get_jps_from_route()[RouteIdx(*it_route->second)]) {
+                    jps.set(jp_idx.val, true);
+                }
+                continue;
+            }
+            const auto it_commercial_mode = pt_data.commercial_modes_map.find(id);
+            if (it_commercial_mode != pt_data.commercial_modes_map.end()) {
+                for (const auto line : it_commercial_mode->second->line_list) {
+                    for (auto route : line->route_list) {
+                        for (const auto& jp_idx : jp_container.get_jps_from_route()[RouteIdx(*route)]) {
+                            jps.set(jp_idx.val, true);
+                        }
+                    }
+                }
+                continue;
+            }
+            const auto it_physical_mode = pt_data.physical_modes_map.find(id);
+            if (it_physical_mode != pt_data.physical_modes_map.end()) {
+                const auto phy_mode_idx = PhyModeIdx(*it_physical_mode->second);
+                for (const auto& jp_idx : jp_container.get_jps_from_phy_mode()[phy_mode_idx]) {
+                    jps.set(jp_idx.val, true);
+                }
+                continue;
+            }
+            const auto it_network = pt_data.networks_map.find(id);
+            if (it_network != pt_data.networks_map.end()) {
+                for (const auto line : it_network->second->line_list) {
+                    for (const auto route : line->route_list) {
+                        for (const auto& jp_idx : jp_container.get_jps_from_route()[RouteIdx(*route)]) {
+                            jps.set(jp_idx.val, true);
+                        }
+                    }
+                }
+                continue;
+            }
+            const auto it_sp = pt_data.stop_points_map.find(id);
+            if (it_sp != pt_data.stop_points_map.end()) {
+                sps.set(it_sp->second->idx, true);
+                for (const auto& jpp : dataRaptor.jpps_from_sp[SpIdx(*it_sp->second)]) {
+                    jpps.set(jpp.idx.val, true);
+                }
+                continue;
+            }
+            const auto it_sa = pt_data.stop_areas_map.find(id);
+            if (it_sa != pt_data.stop_areas_map.end()) {
+                for (const auto sp : it_sa->second->stop_point_list) {
+                    sps.set(sp->idx, true);
+                    for (const auto& jpp : dataRaptor.jpps_from_sp[SpIdx(*sp)]) {
+                        jpps.set(jpp.idx.val, true);
+                    }
+                }
+                continue;
+            }
+        }
+    }
+};
+}  // namespace
+
+ValidJourneyPatternsKey::ValidJourneyPatternsKey(uint32_t date,
+                                                 type::RTLevel rt_level,
+                                                 const type::Properties& properties,
+                                                 std::vector<std::string> forbidden,
+                                                 std::vector<std::string> allowed)
+    : date(date),
+      rt_level(rt_level),
+      properties(properties),
+      forbidden(std::move(forbidden)),
+      allowed(std::move(allowed)) {
+    // the order and the duplicates of the uris don't change the result
+    for (auto* ids : {&this->forbidden, &this->allowed}) {
+        std::sort(ids->begin(), ids->end());
+        ids->erase(std::unique(ids->begin(), ids->end()), ids->end());
+    }
+}
+
+bool ValidJourneyPatternsKey::operator<(const ValidJourneyPatternsKey& other) const {
+    if (date != other.date) {
+        return date < other.date;
+    }
+    if (rt_level != other.rt_level) {
+        return rt_level < other.rt_level;
+    }
+    if (properties != other.properties) {
+        return properties.to_ulong() < other.properties.to_ulong();
+    }
+    if (forbidden != other.forbidden) {
+        return forbidden < other.forbidden;
+    }
+    return allowed < other.allowed;
+}
+
+ValidJourneyPatterns ValidJourneyPatternsManager::CacheCreator::operator()(const ValidJourneyPatternsKey& key) const {
+    const auto& jp_container = dataRaptor.jp_container;
+    ValidJourneyPatterns res;
+    res.journey_patterns = dataRaptor.jp_validity_patterns[key.rt_level][key.date];
+    boost::dynamic_bitset<> valid_journey_pattern_points(jp_container.nb_jpps());
+    valid_journey_pattern_points.set();
+    res.stop_points.resize(pt_data.stop_points.size());
+    res.stop_points.set();
+
+    auto forbidden_objs = ObjsFromIds(key.forbidden, jp_container, pt_data, dataRaptor);
+    res.journey_patterns &= forbidden_objs.jps.flip();
+    valid_journey_pattern_points &= forbidden_objs.jpps.flip();
+    res.stop_points &= forbidden_objs.sps.flip();
+
+    const auto allowed_objs = ObjsFromIds(key.allowed, jp_container, pt_data, dataRaptor);
+    if (allowed_objs.jps.any()) {
+        // If a journey pattern is present in allowed_obj, the
+        // constraint is setted. Else, there is no constraint at the
+        // journey pattern level.
+        res.journey_patterns &= allowed_objs.jps;
+    }
+    if (allowed_objs.jpps.any()) {
+        // If a journey point pattern is present in allowed_obj, the
+        // constraint is setted. Else, there is no constraint at the
+        // journey pattern point level.
+        valid_journey_pattern_points &= allowed_objs.jpps;
+        res.stop_points &= allowed_objs.sps;
+    }
+
+    // filter accessibility
+    if (key.properties.any()) {
+        for (const auto* sp : pt_data.stop_points) {
+            if (sp->accessible(key.properties)) {
+                continue;
+            }
+            res.stop_points.set(sp->idx, false);
+            for (const auto& jpp : dataRaptor.jpps_from_sp[SpIdx(*sp)]) {
+                valid_journey_pattern_points.set(jpp.idx.val, false);
+            }
+        }
+    }
+
+    // propagate the invalid jp in their jpp
+    for (JpIdx jp_idx = JpIdx(0); jp_idx.val < res.journey_patterns.size(); ++jp_idx.val) {
+        if (res.journey_patterns[jp_idx.val]) {
+            continue;
+        }
+        const auto& jp = jp_container.get(jp_idx);
+        for (const auto& jpp_idx : jp.jpps) {
+            valid_journey_pattern_points.set(jpp_idx.val, false);
+        }
+    }
+
+    // We get our own copy of jpps_from_sp to filter every invalid
+    // jpps.  Thanks to that, raptor doesn't need to check
+    // valid_journey_pattern[_point]s as it iterates only on the
+    // feasible ones.
+    res.jpps_from_sp = dataRaptor.jpps_from_sp;
+    res.jpps_from_sp.filter_jpps(valid_journey_pattern_points);
+    return res;
+}
+
+ValidJourneyPatternsManager::~ValidJourneyPatternsManager() {
+    auto logger = log4cplus::Logger::getInstance("logger");
+    LOG4CPLUS_INFO(logger, "Valid journey patterns cache miss : " << lru.get_nb_cache_miss() << " / "
+                                                                  << lru.get_nb_calls());
+}
+
+std::shared_ptr<const ValidJourneyPatterns> ValidJourneyPatternsManager::load(
+    const uint32_t date,
+    const type::RTLevel rt_level,
+    const type::AccessibiliteParams& accessibilite_params,
+    const std::vector<std::string>& forbidden,
+    const std::vector<std::string>& allowed) {
+    return lru(ValidJourneyPatternsKey(date, rt_level, accessibilite_params.properties, forbidden, allowed));
+}
+
+}  // namespace routing
+}  // namespace navitia
@@ -0,0 +1,102 @@
+/* Copyright © 2001-2014, Canal TP and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+channel `#navitia` on riot https://riot.im/app/#/room/#navitia:matrix.org
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#pragma once
+
+#include "routing/dataraptor.h"
+#include "type/rt_level.h"
+#include "type/accessibility_params.h"
+#include "utils/lru.h"
+
+#include <boost/dynamic_bitset.hpp>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace navitia {
+namespace routing {
+
+/** Journey patterns, journey pattern points and stop points usable by a request
+ *
+ * Computing them needs to resolve the forbidden and allowed uris and to walk every
+ * journey pattern and stop point, and the same few combinations are asked again and
+ * again. They are thus shared read only between the workers through an LRU cache.
+ */
+struct ValidJourneyPatterns {
+    boost::dynamic_bitset<> journey_patterns;
+    boost::dynamic_bitset<> stop_points;
+    // only the valid journey pattern points, thus raptor doesn't need to check them
+    dataRAPTOR::JppsFromSp jpps_from_sp;
+};
+
+struct ValidJourneyPatternsKey {
+    uint32_t date;
+    type::RTLevel rt_level;
+    type::Properties properties;  // only the stop point accessibility is used
+    std::vector<std::string> forbidden;
+    std::vector<std::string> allowed;
+    ValidJourneyPatternsKey(uint32_t date,
+                            type::RTLevel rt_level,
+                            const type::Properties& properties,
+                            std::vector<std::string> forbidden,
+                            std::vector<std::string> allowed);
+
+    bool operator<(const ValidJourneyPatternsKey& other) const;
+};
+
+struct ValidJourneyPatternsManager {
+    ValidJourneyPatternsManager(const type::PT_Data& pt_data, const dataRAPTOR& dataRaptor, size_t max_cache)
+        : lru({pt_data, dataRaptor}, max_cache) {}
+    ~ValidJourneyPatternsManager();
+
+    std::shared_ptr<const ValidJourneyPatterns> load(const uint32_t date,
+                                                     const type::RTLevel rt_level,
+                                                     const type::AccessibiliteParams& accessibilite_params,
+                                                     const std::vector<std::string>& forbidden,
+                                                     const std::vector<std::string>& allowed);
+
+    void warmup(const ValidJourneyPatternsManager& other) { this->lru.warmup(other.lru); }
+
+private:
+    struct CacheCreator {
+        typedef ValidJourneyPatternsKey const& argument_type;
+        typedef ValidJourneyPatterns result_type;
+        const type::PT_Data& pt_data;
+        const dataRAPTOR& dataRaptor;
+        CacheCreator(const type::PT_Data& p, const dataRAPTOR& d) : pt_data(p), dataRaptor(d) {}
+        ValidJourneyPatterns operator()(const ValidJourneyPatternsKey& key) const;
+    };
+
+    ConcurrentLru<CacheCreator> lru;
+};
+
+}  // namespace routing
+}  // namespace navitia
@@ -67,6 +67,9 @@ struct mock_kraken {
         LoadBalancer lb(context);
         lb.bind(conf.zmq_socket_path(), "inproc://workers");
         navitia::Metrics metric(boost::none, "mock");
+        navitia::ResponseCache response_cache(conf.enable_request_coalescing(),
+                                              boost::posix_time::seconds(conf.response_cache_ttl()),
+                                              conf.response_cache_max_bytes());
 
         // this option is not parsed by get_options_description because it is used only here
         if (std::find(other_options.begin(), other_options.end(), "spawn_maintenance_worker") != other_options.end()) {
@@ -75,7 +78,8 @@ struct mock_kraken {
 
         // Launch only one thread for the tests
         threads.create_thread(
-            std::bind(&doWork, std::ref(context), std::ref(data_manager), conf, std::ref(metric), "myhostname", 0));
+            std::bind(&doWork, std::ref(context), std::ref(data_manager), conf, std::ref(metric),
+                      std::ref(response_cache), "myhostname", 0));
 
         // Connect work threads to client threads via a queue
         do {
@@ -7,7 +7,9 @@
 #include "kraken/realtime.h"
 #include <boost/date_time/gregorian/gregorian.hpp>
 #include <boost/date_time/posix_time/posix_time.hpp>
+#include <algorithm>
 #include <set>
+#include <tuple>
 #include <vector>
 #include <map>
 
@@ -27,6 +29,20 @@ inline void handle_realtime_test(const std::string& id,
     raptor = std::make_unique<navitia::routing::RAPTOR>(data);
 }
 
+/*
+ * The departure, the arrival and the number of items of each path, sorted,
+ * to compare the journeys found by two ways of computing them
+ */
+inline std::vector<std::tuple<boost::posix_time::ptime, boost::posix_time::ptime, size_t>> summarize(
+    const std::vector<routing::Path>& paths) {
+    std::vector<std::tuple<boost::posix_time::ptime, boost::posix_time::ptime, size_t>> res;
+    for (const auto& path : paths) {
+        res.emplace_back(path.items.front().departure, path.items.back().arrival, path.items.size());
+    }
+    std::sort(res.begin(), res.end());
+    return res;
+}
+
 inline uint64_t to_posix_timestamp(const std::string& str) {
     return navitia::to_posix_timestamp(boost::posix_time::from_iso_string(str));
 }
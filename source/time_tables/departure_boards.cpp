@@ -349,21 +349,33 @@ void departure_board(PbCreator& pb_creator,
     auto sort_predicate = [](routing::datetime_stop_time dt1, routing::datetime_stop_time dt2) {
         return dt1.first < dt2.first;
     };
+    std::vector<std::vector<routing::JppIdx>> jpps_by_route_point;
+    jpps_by_route_point.reserve(route_points.size());
+    for (const auto& route_point : route_points) {
+        jpps_by_route_point.push_back(get_jpp_from_route_point(route_point, *pb_creator.data->dataRaptor));
+    }
+    // all the route points are merged in one pass, each one being limited to items_per_route_point
+    std::vector<std::vector<routing::datetime_stop_time>> stop_times_by_route_point;
+    if (!calendar_id) {
+        stop_times_by_route_point = routing::get_stop_times_by_group(
+            routing::StopEvent::pick_up, jpps_by_route_point, handler.date_time, handler.max_datetime,
+            items_per_route_point, *pb_creator.data, rt_level);
+    }
+
     // we group the stoptime belonging to the same pair (stop_point, route)
     // since we want to display the departures grouped by route
     // the route being a loose commercial direction
-    for (const auto& route_point : route_points) {
+    for (size_t route_point_idx = 0; route_point_idx < route_points.size(); ++route_point_idx) {
+        const auto& route_point = *(route_points.begin() + route_point_idx);
         const type::StopPoint* stop_point = pb_creator.data->pt_data->stop_points[route_point.second.val];
         const type::Route* route = pb_creator.data->pt_data->routes[route_point.first.val];
 
-        const auto routepoint_jpps = get_jpp_from_route_point(route_point, *pb_creator.data->dataRaptor);
+        const auto& routepoint_jpps = jpps_by_route_point[route_point_idx];
 
         std::vector<routing::datetime_stop_time> stop_times;
         int32_t utc_offset = 0;
         if (!calendar_id) {
-            stop_times =
-                routing::get_stop_times(routing::StopEvent::pick_up, routepoint_jpps, handler.date_time,
-                                        handler.max_datetime, items_per_route_point, *pb_creator.data, rt_level);
+            stop_times = std::move(stop_times_by_route_point[route_point_idx]);
             std::sort(stop_times.begin(), stop_times.end(), sort_predicate);
 
             if (route->line->opening_time && !stop_times.empty()) {
@@ -0,0 +1,213 @@
+/* Copyright © 2001-2019, Canal TP and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+channel `#navitia` on riot https://riot.im/app/#/room/#navitia:matrix.org
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#include "type/arena.h"
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+namespace navitia {
+namespace type {
+
+namespace {
+
+/*
+ * The slabs of all the arenas, to tell the objects of an arena from the ones of the heap.
+ *
+ * Every object deleted asks for its slab, so the registry is read without lock: it is a bit by
+ * slab of the address space, in blocks allocated at the first slab of their range and kept
+ * until the end of the process.
+ */
+class SlabRegistry {
+    static const int slab_bits = 20;             // log2(Arena::slab_size)
+    static const int address_bits = 48;          // the user space of the 64 bits linux
+    static const int block_bits = 15;            // 32768 slabs (32GB) by block
+    static const size_t nb_blocks = size_t(1) << (address_bits - slab_bits - block_bits);
+    static const size_t nb_words = (size_t(1) << block_bits) / 64;
+
+    struct Block {
+        std::atomic<uint64_t> words[nb_words];
+        Block() {
+            for (auto& word : words) {
+                word = 0;
+            }
+        }
+    };
+    std::atomic<Block*> blocks[nb_blocks];
+
+    Block* block_of(const uintptr_t slab_index, const bool create) {
+        const size_t b = slab_index >> block_bits;
+        Block* block = blocks[b].load(std::memory_order_acquire);
+        if (block || !create) {
+            return block;
+        }
+        auto* new_block = new Block();
+        if (blocks[b].compare_exchange_strong(block, new_block, std::memory_order_acq_rel)) {
+            return new_block;
+        }
+        // created by another thread meanwhile
+        delete new_block;
+        return block;
+    }
+
+    static uintptr_t index_of(const void* p) { return reinterpret_cast<uintptr_t>(p) >> slab_bits; }
+    static bool in_address_space(const uintptr_t slab_index) { return (slab_index >> block_bits) < nb_blocks; }
+
+public:
+    SlabRegistry() {
+        static_assert((size_t(1) << slab_bits) == Arena::slab_size, "a bit by slab");
+        for (auto& block : blocks) {
+            block = nullptr;
+        }
+    }
+
+    void insert(const void* slab) {
+        const auto i = index_of(slab);
+        if (!in_address_space(i)) {
+            throw std::bad_alloc();
+        }
+        block_of(i, true)->words[(i & ((1 << block_bits) - 1)) / 64].fetch_or(uint64_t(1) << (i % 64));
+    }
+
+    void erase(const void* slab) {
+        const auto i = index_of(slab);
+        block_of(i, false)->words[(i & ((1 << block_bits) - 1)) / 64].fetch_and(~(uint64_t(1) << (i % 64)));
+    }
+
+    bool contains(const void* p) {
+        const auto i = index_of(p);
+        if (!in_address_space(i)) {
+            return false;
+        }
+        const Block* block = block_of(i, false);
+        if (!block) {
+            return false;
+        }
+        const auto word = block->words[(i & ((1 << block_bits) - 1)) / 64].load(std::memory_order_relaxed);
+        return (word >> (i % 64)) & 1;
+    }
+};
+
+SlabRegistry& registry() {
+    static SlabRegistry registry;
+    return registry;
+}
+
+thread_local Arena* current_arena = nullptr;
+std::atomic<bool> arena_enabled{true};
+
+const size_t alignment = alignof(std::max_align_t);
+
+}  // namespace
+
+Arena::~Arena() {
+    auto& reg = registry();
+    for (char* slab : slabs) {
+        reg.erase(slab);
+        std::free(slab);
+    }
+}
+
+void* Arena::allocate(const size_t size) {
+    const size_t aligned_size = (size + alignment - 1) & ~(alignment - 1);
+    if (aligned_size > slab_size / 4) {
+        // a big object would waste the end of a slab
+        return nullptr;
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    if (used_in_last_slab + aligned_size > slab_size) {
+        void* slab = nullptr;
+        if (posix_memalign(&slab, slab_size, slab_size) != 0) {
+            throw std::bad_alloc();
+        }
+        registry().insert(slab);
+        slabs.push_back(static_cast<char*>(slab));
+        used_in_last_slab = 0;
+    }
+    void* p = slabs.back() + used_in_last_slab;
+    used_in_last_slab += aligned_size;
+    nb_allocated_bytes += aligned_size;
+    return p;
+}
+
+size_t Arena::nb_slabs() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return slabs.size();
+}
+
+size_t Arena::allocated_bytes() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return nb_allocated_bytes;
+}
+
+Arena* Arena::current() {
+    return current_arena;
+}
+
+bool Arena::owns(const void* p) {
+    return registry().contains(p);
+}
+
+bool Arena::enabled() {
+    return arena_enabled;
+}
+
+void Arena::set_enabled(const bool enabled) {
+    arena_enabled = enabled;
+}
+
+Arena::Scope::Scope(Arena* arena) : previous(current_arena) {
+    current_arena = arena;
+}
+
+Arena::Scope::~Scope() {
+    current_arena = previous;
+}
+
+void* Arena::allocate_object(const size_t size) {
+    if (current_arena) {
+        if (void* p = current_arena->allocate(size)) {
+            return p;
+        }
+    }
+    return ::operator new(size);
+}
+
+void Arena::deallocate_object(void* p) noexcept {
+    // the memory of the objects of an arena is freed with the arena
+    if (p && !owns(p)) {
+        ::operator delete(p);
+    }
+}
+
+}  // namespace type
+}  // namespace navitia
@@ -0,0 +1,96 @@
+/* Copyright © 2001-2019, Canal TP and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+channel `#navitia` on riot https://riot.im/app/#/room/#navitia:matrix.org
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#pragma once
+
+#include <boost/noncopyable.hpp>
+
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+namespace navitia {
+namespace type {
+
+/*
+ * Monotonic memory of the objects of one Data.
+ *
+ * The millions of pt and street network objects of a Data are allocated in slabs instead of
+ * one by one, so that they are contiguous and that destroying the Data frees a few slabs
+ * instead of millions of blocks scattered over the heap.  Deleting an object of the arena
+ * only runs its destructor, its memory being reused when the whole arena is freed.
+ *
+ * The objects deriving from Header are allocated in the arena of their thread, set by an
+ * Arena::Scope, and on the heap outside of a scope.
+ */
+class Arena : boost::noncopyable {
+public:
+    // the slabs are aligned on their size, to find the slab of an object from its address
+    static const size_t slab_size = 1 << 20;
+
+    Arena() = default;
+    ~Arena();
+
+    void* allocate(size_t size);
+
+    size_t nb_slabs() const;
+    size_t allocated_bytes() const;  // the memory given to the objects
+    size_t reserved_bytes() const { return nb_slabs() * slab_size; }
+
+    /// The arena of the current thread, nullptr outside of a scope
+    static Arena* current();
+
+    /// Is p in a slab of an arena?
+    static bool owns(const void* p);
+
+    /// Arenas can be disabled to compare with the heap allocation
+    static bool enabled();
+    static void set_enabled(bool enabled);
+
+    /// Allocates the objects of the current thread in the arena until its destruction
+    struct Scope : boost::noncopyable {
+        Arena* previous;
+        explicit Scope(Arena* arena);
+        ~Scope();
+    };
+
+    /// The allocation functions of the objects allowed in an arena
+    static void* allocate_object(size_t size);
+    static void deallocate_object(void* p) noexcept;
+
+private:
+    mutable std::mutex mutex;
+    std::vector<char*> slabs;
+    size_t used_in_last_slab = slab_size;
+    size_t nb_allocated_bytes = 0;
+};
+
+}  // namespace type
+}  // namespace navitia
@@ -37,6 +37,7 @@ www.navitia.io
 #include <boost/fusion/container.hpp>
 #include <boost/fusion/algorithm.hpp>
 
+#include <algorithm>
 #include <type_traits>
 #include <map>
 #include <vector>
@@ -94,6 +95,31 @@ struct CodeContainer {
         code_m[{key, val}].push_back(obj);
     }
 
+    /// removes the codes of an object before its deletion
+    template <typename T>
+    void forget(const T* obj) {
+        auto& obj_m = at_key<T>(obj_map);
+        const auto it = obj_m.find(obj);
+        if (it == obj_m.end()) {
+            return;
+        }
+        auto& code_m = at_key<T>(code_map);
+        for (const auto& key_values : it->second) {
+            for (const auto& value : key_values.second) {
+                const auto code_it = code_m.find({key_values.first, value});
+                if (code_it == code_m.end()) {
+                    continue;
+                }
+                auto& objs = code_it->second;
+                objs.erase(std::remove(objs.begin(), objs.end(), obj), objs.end());
+                if (objs.empty()) {
+                    code_m.erase(code_it);
+                }
+            }
+        }
+        obj_m.erase(it);
+    }
+
     template <class Archive>
     void serialize(Archive& ar, const unsigned int) {
         ar& obj_map& code_map;
@@ -38,5 +38,14 @@ const Comments::stop_time_key Comments::get_as_key(const navitia::type::StopTime
     return std::make_pair(st.vehicle_journey, st.order());
 }
 
+void Comments::forget_vj(const VehicleJourney* vj) {
+    boost::fusion::at_key<VehicleJourney>(map).erase(vj);
+    auto& stop_time_comments = boost::fusion::at_key<StopTime>(map);
+    auto it = stop_time_comments.lower_bound(stop_time_key(vj, RankStopTime(0)));
+    while (it != stop_time_comments.end() && it->first.first == vj) {
+        it = stop_time_comments.erase(it);
+    }
+}
+
 }  // namespace type
 }  // namespace navitia
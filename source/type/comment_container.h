@@ -63,6 +63,9 @@ struct Comments {
         c[get_as_key(obj)].push_back(comment);
     }
 
+    /// removes the comments of a vehicle journey and of its stop times before its deletion
+    void forget_vj(const VehicleJourney* vj);
+
     template <class Archive>
     void serialize(Archive& ar, const unsigned int) {
         ar& map;
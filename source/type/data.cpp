@@ -45,6 +45,7 @@ www.navitia.io
 #include "type/calendar.h"
 #include "type/contributor.h"
 #include "type/meta_vehicle_journey.h"
+#include "type/nav_delta.h"
 #include "type/physical_mode.h"
 #include "type/commercial_mode.h"
 #include "utils/functions.h"
@@ -57,15 +58,19 @@ www.navitia.io
 #include <boost/container/container_fwd.hpp>
 #include <boost/filesystem/operations.hpp>
 #include <boost/filesystem/path.hpp>
+#include <boost/iostreams/concepts.hpp>
 #include <boost/iostreams/filtering_streambuf.hpp>
+#include <boost/iostreams/read.hpp>
 #include <boost/range/algorithm/find.hpp>
 #include <boost/range/algorithm_ext/push_back.hpp>
 #include <boost/serialization/variant.hpp>
 #include <eos_portable_archive/portable_iarchive.hpp>
 #include <eos_portable_archive/portable_oarchive.hpp>
 
+#include <algorithm>
 #include <fstream>
 #include <thread>
+#include <vector>
 
 namespace pt = boost::posix_time;
 
@@ -76,6 +81,7 @@ const unsigned int Data::data_version = 10;  //< *INCREMENT* every time serializ
 
 Data::Data(size_t data_identifier)
     : _last_rt_data_loaded(boost::posix_time::not_a_date_time),
+      _arena(Arena::enabled() ? std::make_unique<Arena>() : nullptr),
       disruption_error(false),
       data_identifier(data_identifier),
       meta(std::make_unique<MetaData>()),
@@ -135,13 +141,20 @@ void Data::load_nav(const std::string& filename) {
     try {
         std::ifstream ifs(filename.c_str(), std::ios::in | std::ios::binary);
         ifs.exceptions(std::ifstream::failbit | std::ifstream::badbit);
-        this->load(ifs);
+        // the file is hashed while it is read, it might be replaced in the meantime
+        ContentHash hash;
+        this->load(ifs, &hash);
+        nav_hash = hash.hex();
         loaded = true;
         last_load_at = pt::microsec_clock::universal_time();
         last_load_succeeded = true;
         LOG4CPLUS_INFO(logger, boost::format("stopTimes : %d nb foot path : %d Nombre de stop points : %d")
                                    % pt_data->nb_stop_times() % pt_data->stop_point_connections.size()
                                    % pt_data->stop_points.size());
+        if (_arena) {
+            LOG4CPLUS_INFO(logger, "objects allocated in " << _arena->nb_slabs() << " slabs of the arena ("
+                                                            << _arena->allocated_bytes() / (1024 * 1024) << "MB)");
+        }
     } catch (const std::exception& ex) {
         LOG4CPLUS_ERROR(logger, "Data loading failed: " + std::string(ex.what()));
         throw navitia::data::data_loading_error("Data loading failed: " + std::string(ex.what()));
@@ -152,12 +165,45 @@ void Data::load_nav(const std::string& filename) {
     LOG4CPLUS_DEBUG(logger, "Finished to load nav");
 }
 
-void Data::load(std::istream& ifs) {
-    boost::iostreams::filtering_streambuf<boost::iostreams::input> in;
-    in.push(LZ4Decompressor(2048 * 500), 8192 * 500, 8192 * 500);
-    in.push(ifs);
-    eos::portable_iarchive ia(in);
-    ia >> *this;
+namespace {
+// hashes the bytes read from the file before they are decompressed
+class HashFilter : public boost::iostreams::multichar_input_filter {
+    ContentHash* hash;
+
+public:
+    explicit HashFilter(ContentHash* hash) : hash(hash) {}
+
+    template <typename Source>
+    std::streamsize read(Source& src, char* s, std::streamsize n) {
+        const auto nb = boost::iostreams::read(src, s, n);
+        if (nb > 0) {
+            hash->add(s, nb);
+        }
+        return nb;
+    }
+};
+}  // anonymous namespace
+
+void Data::load(std::istream& ifs, ContentHash* hash) {
+    {
+        boost::iostreams::filtering_streambuf<boost::iostreams::input> in;
+        in.push(LZ4Decompressor(2048 * 500), 8192 * 500, 8192 * 500);
+        if (hash) {
+            in.push(HashFilter(hash));
+        }
+        in.push(ifs);
+        eos::portable_iarchive ia(in);
+        Arena::Scope arena_scope(_arena.get());
+        ia >> *this;
+    }
+    if (hash) {
+        // what has not been read by the archive, to get the hash of the whole content
+        std::vector<char> buffer(1024 * 1024);
+        std::streamsize nb;
+        while ((nb = ifs.rdbuf()->sgetn(buffer.data(), buffer.size())) > 0) {
+            hash->add(buffer.data(), nb);
+        }
+    }
 }
 
 /**
@@ -276,6 +322,37 @@ void Data::build_proximity_list() {
     this->geo_ref->project_stop_points(this->pt_data->stop_points);
 }
 
+void Data::copy_proximity_lists_from(const Data& from) {
+    // the indexes are not modified once built, they can be shared
+    pt_data->stop_area_proximity_list = from.pt_data->stop_area_proximity_list;
+    pt_data->stop_point_proximity_list = from.pt_data->stop_point_proximity_list;
+    geo_ref->pl_walking = from.geo_ref->pl_walking;
+    geo_ref->pl_bike = from.geo_ref->pl_bike;
+    geo_ref->pl_car = from.geo_ref->pl_car;
+    geo_ref->poi_proximity_list = from.geo_ref->poi_proximity_list;
+    geo_ref->projected_stop_points = from.geo_ref->projected_stop_points;
+    geo_ref->projected_coords = from.geo_ref->projected_coords;
+}
+
+template <typename T>
+static bool same_places(const std::vector<T*>& objects, const std::vector<T*>& others) {
+    return objects.size() == others.size()
+           && std::equal(objects.begin(), objects.end(), others.begin(), [](const T* object, const T* other) {
+                  return object->uri == other->uri && object->coord == other->coord;
+              });
+}
+
+void Data::build_proximity_lists_of_changes(const Data& from) {
+    if (!pt_data->changes.stop_points_changed && same_places(pt_data->stop_points, from.pt_data->stop_points)
+        && same_places(pt_data->stop_areas, from.pt_data->stop_areas)) {
+        copy_proximity_lists_from(from);
+        return;
+    }
+    log4cplus::Logger logger = log4cplus::Logger::getInstance(LOG4CPLUS_TEXT("logger"));
+    LOG4CPLUS_INFO(logger, "the stop points have changed, rebuilding the proximity lists");
+    build_proximity_list();
+}
+
 void Data::build_administrative_regions() {
     auto log = log4cplus::Logger::getInstance("ed::Data");
     georef::AdminRtree admin_tree = georef::build_admins_tree(geo_ref->admins);
@@ -413,8 +490,8 @@ static void build_datasets(navitia::type::VehicleJourney* vj) {
  *
  * @param vj The vehicle journey to browse
  */
-static void build_route_and_stop_point_relations(navitia::type::VehicleJourney* vj) {
-    for (navitia::type::StopTime& st : vj->stop_time_list) {
+static void build_route_and_stop_point_relations(const navitia::type::VehicleJourney* vj) {
+    for (const navitia::type::StopTime& st : vj->stop_time_list) {
         if (st.stop_point) {
             vj->route->stop_point_list.insert(st.stop_point);
             vj->route->stop_area_list.insert(st.stop_point->stop_area);
@@ -437,21 +514,97 @@ static void build_companies(navitia::type::VehicleJourney* vj) {
     }
 }
 
+static void build_line_relations(navitia::type::VehicleJourney* vj) {
+    if (!vj->physical_mode || !vj->route || !vj->route->line) {
+        return;
+    }
+    build_companies(vj);
+    if (!navitia::contains(vj->route->line->physical_mode_list, vj->physical_mode)) {
+        vj->route->line->physical_mode_list.push_back(vj->physical_mode);
+    }
+}
+
 void Data::build_relations() {
     // physical_mode_list of line
     for (auto* vj : pt_data->vehicle_journeys) {
         build_datasets(vj);
         build_route_and_stop_point_relations(vj);
-        if (!vj->physical_mode || !vj->route || !vj->route->line) {
-            continue;
+        build_line_relations(vj);
+    }
+}
+
+/*
+ * The relations of the clone point to its own objects, found by their index as the clone
+ * has the same objects at the same indexes.
+ */
+template <typename Set, typename T>
+static void copy_same_objects(const Set& from, Set& to, const std::vector<T*>& collection) {
+    std::vector<T*> objects;
+    objects.reserve(from.size());
+    for (const auto* obj : from) {
+        objects.push_back(obj ? collection.at(obj->idx) : nullptr);
+    }
+    to.insert(objects.begin(), objects.end());
+}
+
+void Data::copy_relations_from(const Data& from) {
+    for (const auto* from_route : from.pt_data->routes) {
+        auto* route = pt_data->routes.at(from_route->idx);
+        copy_same_objects(from_route->stop_point_list, route->stop_point_list, pt_data->stop_points);
+        copy_same_objects(from_route->stop_area_list, route->stop_area_list, pt_data->stop_areas);
+    }
+    for (const auto* from_sp : from.pt_data->stop_points) {
+        copy_same_objects(from_sp->route_list, pt_data->stop_points.at(from_sp->idx)->route_list, pt_data->routes);
+    }
+    for (const auto* from_sa : from.pt_data->stop_areas) {
+        copy_same_objects(from_sa->route_list, pt_data->stop_areas.at(from_sa->idx)->route_list, pt_data->routes);
+    }
+    for (const auto* from_dataset : from.pt_data->datasets) {
+        copy_same_objects(from_dataset->vehiclejourney_list,
+                          pt_data->datasets.at(from_dataset->idx)->vehiclejourney_list, pt_data->vehicle_journeys);
+    }
+}
+
+/*
+ * The stop points of a route are the ones of its vehicle journeys, those that are not
+ * served anymore lose the route.
+ */
+static void rebuild_route_and_stop_point_relations(navitia::type::Route* route) {
+    const auto old_stop_points = std::move(route->stop_point_list);
+    const auto old_stop_areas = std::move(route->stop_area_list);
+    route->stop_point_list.clear();
+    route->stop_area_list.clear();
+    route->for_each_vehicle_journey([&](const VehicleJourney& vj) {
+        build_route_and_stop_point_relations(&vj);
+        return true;
+    });
+    for (auto* sp : old_stop_points) {
+        if (!route->stop_point_list.count(sp)) {
+            sp->route_list.erase(route);
         }
-        build_companies(vj);
-        if (!navitia::contains(vj->route->line->physical_mode_list, vj->physical_mode)) {
-            vj->route->line->physical_mode_list.push_back(vj->physical_mode);
+    }
+    for (auto* sa : old_stop_areas) {
+        if (sa && !route->stop_area_list.count(sa)) {
+            sa->route_list.erase(route);
         }
     }
 }
 
+void Data::build_relations_of_changes() {
+    const auto& changes = pt_data->changes;
+    if (!changes.is_tracking) {
+        build_relations();
+        return;
+    }
+    for (auto* vj : changes.vehicle_journeys) {
+        build_datasets(vj);
+        build_line_relations(vj);
+    }
+    for (auto* route : changes.routes) {
+        rebuild_route_and_stop_point_relations(route);
+    }
+}
+
 void Data::aggregate_odt() {
     // TODO ODT NTFSv0.3: remove that when we stop to support NTFSv0.1
     //
@@ -838,9 +991,11 @@ void Data::clone_from(const Data& from) {
     });
     {
         boost::archive::binary_iarchive ia(p.in);
+        Arena::Scope arena_scope(_arena.get());
         ia >> *this;
     }
     write.join();
+    nav_hash = from.nav_hash;
 }
 
 void Data::set_last_rt_data_loaded(const boost::posix_time::ptime& p) const {
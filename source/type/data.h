@@ -29,6 +29,7 @@ www.navitia.io
 */
 
 #pragma once
+#include "type/arena.h"
 #include "type/validity_pattern.h"
 #include "data_exceptions.h"
 #include "utils/obj_factory.h"
@@ -54,6 +55,8 @@ www.navitia.io
 namespace navitia {
 namespace type {
 
+class ContentHash;
+
 template <typename T>
 struct ContainerTrait {
     typedef std::vector<T*> vect_type;
@@ -114,6 +117,9 @@ class Data : boost::noncopyable {
     static_assert(IS_TRIVIALLY_COPYABLE(navitia::ptime),
                   "ptime isn't is_trivially_copyable and can't be used with std::atomic");
     mutable std::atomic<navitia::ptime> _last_rt_data_loaded;  // datetime of the last Real Time loaded data
+    // memory of the objects loaded in this data, declared first to be freed after them
+    std::unique_ptr<Arena> _arena;
+
 public:
     static const unsigned int data_version;  //< Data version number. *INCREMENT* in cpp file
     unsigned int version = 0;                //< Version of loaded data
@@ -181,6 +187,9 @@ public:
     // UTC
     boost::posix_time::ptime last_load_at;
 
+    // content hash of the nav file the data has been loaded from, a delta must be made from it to be applied
+    std::string nav_hash;
+
     // This object is the only field mutated in this object. As it is
     // thread safe to mutate it, we mark it as mutable.  Maybe we can
     // find in the future a cleaner way, but now, this is cleaner than
@@ -224,6 +233,18 @@ public:
     void aggregate_odt();
     void build_relations();
 
+    /** Takes the relations that are not serialized from the data this one has been cloned from */
+    void copy_relations_from(const Data& from);
+    /** Updates the relations of the objects changed since the journal of pt_data started */
+    void build_relations_of_changes();
+    /** Takes the proximity lists and the projections of a data with the same stop points and streets */
+    void copy_proximity_lists_from(const Data& from);
+    /**
+     * Takes the proximity lists of the data this one has been cloned from if the journal of pt_data
+     * records no change of stop points and they are still at the same place, rebuilds them otherwise
+     */
+    void build_proximity_lists_of_changes(const Data& from);
+
     void build_grid_validity_pattern();
 
     void complete();
@@ -238,8 +259,9 @@ public:
      *
      * LZ4 compression is super fast but its efficiency is average
      * The goal is to achieve the same read performance with and without compression
+     * The whole content of the stream is added to the hash if one is given
      */
-    void load(std::istream& ifs);
+    void load(std::istream& ifs, ContentHash* hash = nullptr);
 
     /** Save data in a compressed binary file using LZ4*/
     void save(std::ostream& ofs) const;
@@ -248,6 +270,8 @@ public:
     void clone_from(const Data&);
 
     void set_last_rt_data_loaded(const boost::posix_time::ptime&) const;
+    /// nullptr when the arenas are disabled
+    const Arena* arena() const { return _arena.get(); }
     const boost::posix_time::ptime last_rt_data_loaded() const;
 
 private:
@@ -8,6 +8,7 @@ data_loading_error::~data_loading_error() noexcept = default;
 disruptions_broken_connection::~disruptions_broken_connection() noexcept = default;
 disruptions_loading_error::~disruptions_loading_error() noexcept = default;
 raptor_building_error::~raptor_building_error() noexcept = default;
+delta_error::~delta_error() noexcept = default;
 
 }  // namespace data
 }  // namespace navitia
@@ -75,5 +75,13 @@ struct raptor_building_error : public navitia::recoverable_exception {
     virtual ~raptor_building_error() noexcept;
 };
 
+// Delta of the data that can't be applied
+struct delta_error : public navitia::recoverable_exception {
+    delta_error(const std::string& msg) : navitia::recoverable_exception(msg) {}
+    delta_error(const delta_error&) = default;
+    delta_error& operator=(const delta_error&) = default;
+    virtual ~delta_error() noexcept;
+};
+
 }  // namespace data
 }  // namespace navitia
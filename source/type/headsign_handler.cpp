@@ -196,11 +196,14 @@ void HeadsignHandler::affect_headsign_to_stop_time(const StopTime& stop_time, co
     update_headsign_mvj_after_remove(*vj, prev_headsign_for_stop_time);
 }
 
-void HeadsignHandler::forget_vj(const VehicleJourney* /*unused*/) {
-    // currently we never want to forget VJ
-    // it would be MANDATORY to do it if we added realtime vjs to the headsigns handler,
-    // but for the moment we only index base schedule VJ
-    // if that changes be sure to add the mechanism here to remove the useless VJ before we delete it
+void HeadsignHandler::forget_vj(const VehicleJourney* vj) {
+    // the realtime vjs are not indexed, but the base vjs are forgotten when a delta of the data replaces them
+    auto headsigns = get_all_headsigns(vj);
+    headsigns.insert(vj->headsign);
+    headsign_changes.erase(vj);
+    for (const auto& headsign : headsigns) {
+        update_headsign_mvj_after_remove(*vj, headsign);
+    }
 }
 
 }  // namespace type
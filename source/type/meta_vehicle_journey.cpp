@@ -40,6 +40,7 @@ www.navitia.io
 #include "utils/logger.h"
 
 #include <boost/range/algorithm/find.hpp>
+#include <boost/range/algorithm/remove.hpp>
 
 namespace nt = navitia::type;
 
@@ -86,16 +87,15 @@ std::vector<FrequencyVehicleJourney*>& get_vjs(Route* r) {
     return r->frequency_vehicle_journey_list;
 }
 
-void cleanup_useless_vj_link(const nt::VehicleJourney* vj, nt::PT_Data& pt_data) {
-    // clean all backref to a vehicle journey before deleting it
-    // need to be thorough !!
-    LOG4CPLUS_DEBUG(log4cplus::Logger::getInstance("logger"), "we are going to cleanup the vj " << vj->uri);
-
+// clean all backref to a vehicle journey but the global list/map of the vehicle journeys
+void unlink_vj(const nt::VehicleJourney* vj, nt::PT_Data& pt_data) {
     if (vj->dataset) {
         erase_vj_from_list(vj, vj->dataset->vehiclejourney_list);
     }
     if (vj->physical_mode) {
-        erase_vj_from_list(vj, vj->physical_mode->vehicle_journey_list);
+        // only the vjs created by a disruption are in the list of their physical mode
+        auto& physical_mode_vjs = vj->physical_mode->vehicle_journey_list;
+        physical_mode_vjs.erase(boost::range::remove(physical_mode_vjs, vj), physical_mode_vjs.end());
     }
     if (dynamic_cast<const nt::FrequencyVehicleJourney*>(vj)) {
         erase_vj_from_list(vj, vj->route->frequency_vehicle_journey_list);
@@ -105,6 +105,16 @@ void cleanup_useless_vj_link(const nt::VehicleJourney* vj, nt::PT_Data& pt_data)
 
     pt_data.headsign_handler.forget_vj(vj);
     pt_data.disruption_holder.forget_vj(vj);
+    pt_data.comments.forget_vj(vj);
+    pt_data.codes.forget(vj);
+}
+
+void cleanup_useless_vj_link(const nt::VehicleJourney* vj, nt::PT_Data& pt_data) {
+    // clean all backref to a vehicle journey before deleting it
+    // need to be thorough !!
+    LOG4CPLUS_DEBUG(log4cplus::Logger::getInstance("logger"), "we are going to cleanup the vj " << vj->uri);
+
+    unlink_vj(vj, pt_data);
 
     // remove the vj from the global list/map
     erase_vj_from_list(vj, pt_data.vehicle_journeys);
@@ -137,6 +147,7 @@ void MetaVehicleJourney::clean_up_useless_vjs(nt::PT_Data& pt_data) {
         auto& vj = this->rtlevel_to_vjs_map[rt_level][vj_idx];
 
         cleanup_useless_vj_link(vj.get(), pt_data);
+        pt_data.changes.remove_vehicle_journey(vj.get());
 
         // once all the links to the vj have been cleaned we can destroy the object
         // (by removing the unique_ptr from the vector)
@@ -144,6 +155,22 @@ void MetaVehicleJourney::clean_up_useless_vjs(nt::PT_Data& pt_data) {
     }
 }
 
+std::vector<std::unique_ptr<VehicleJourney>> MetaVehicleJourney::release_vjs(nt::PT_Data& pt_data) {
+    std::vector<std::unique_ptr<VehicleJourney>> vjs;
+    for (const auto level : enum_range<RTLevel>()) {
+        auto& level_vjs = rtlevel_to_vjs_map[level];
+        std::move(level_vjs.begin(), level_vjs.end(), std::back_inserter(vjs));
+        level_vjs.clear();
+    }
+    // the vjs are out of the meta vj, thus its headsigns are forgotten with its last vj
+    for (const auto& vj : vjs) {
+        unlink_vj(vj.get(), pt_data);
+        pt_data.vehicle_journeys_map.erase(vj->uri);
+        pt_data.changes.remove_vehicle_journey(vj.get());
+    }
+    return vjs;
+}
+
 template <typename VJ>
 VJ* MetaVehicleJourney::impl_create_vj(const std::string& uri,
                                        const std::string& name,
@@ -233,6 +260,7 @@ VJ* MetaVehicleJourney::impl_create_vj(const std::string& uri,
     if (route) {
         get_vjs<VJ>(route).push_back(ret);
     }
+    pt_data.changes.add_vehicle_journey(ret);
     rtlevel_to_vjs_map[level].emplace_back(std::move(vj_ptr));
     return ret;
 }
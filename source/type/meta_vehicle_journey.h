@@ -90,6 +90,11 @@ struct MetaVehicleJourney : public Header, HasMessages {
 
     void clean_up_useless_vjs(PT_Data&);
 
+    /// Detaches all the vjs from the other objects and gives them to the caller, that has to
+    /// remove them from pt_data.vehicle_journeys. This way the vjs of many meta vjs can be
+    /// removed with only one reindexing of the vehicle journeys.
+    std::vector<std::unique_ptr<VehicleJourney>> release_vjs(PT_Data&);
+
     template <typename T>
     void for_all_vjs(T fun) const {
         for (const auto rt_vjs : rtlevel_to_vjs_map) {
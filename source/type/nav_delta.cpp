@@ -0,0 +1,572 @@
+/* Copyright © 2001-2014, Canal TP and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+channel `#navitia` on riot https://riot.im/app/#/room/#navitia:matrix.org
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+
+#include "type/nav_delta.h"
+
+#include "fare/fare.h"
+#include "georef/georef.h"
+#include "lz4_filter/filter.h"
+#include "type/comment_container.h"
+#include "type/company.h"
+#include "type/connection.h"
+#include "type/contributor.h"
+#include "type/commercial_mode.h"
+#include "type/data.h"
+#include "type/data_exceptions.h"
+#include "type/dataset.h"
+#include "type/line.h"
+#include "type/meta_data.h"
+#include "type/meta_vehicle_journey.h"
+#include "type/multi_polygon_map.h"
+#include "type/network.h"
+#include "type/physical_mode.h"
+#include "type/pt_data.h"
+#include "type/route.h"
+#include "type/serialization.h"
+#include "type/stop_area.h"
+#include "type/stop_point.h"
+#include "utils/functions.h"
+#include "utils/logger.h"
+
+#include <boost/date_time/gregorian/greg_serialize.hpp>
+#include <boost/date_time/posix_time/time_serialize.hpp>
+#include <boost/iostreams/filtering_streambuf.hpp>
+#include <boost/iostreams/stream.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/serialization/bitset.hpp>
+#include <boost/serialization/map.hpp>
+#include <boost/serialization/string.hpp>
+
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace navitia {
+namespace type {
+
+const unsigned int NavDelta::delta_version = 2;  //< *INCREMENT* every time the serialized delta is modified
+
+template <class Archive>
+void NavDelta::serialize(Archive& ar, const unsigned int version) {
+    if (version != delta_version) {
+        auto msg = boost::format("delta version %u doesn't match the one of kraken %u") % version % delta_version;
+        throw navitia::data::wrong_version(msg.str());
+    }
+    ar& base_hash& target_hash& publication_date& dataset_created_at& removed_meta_vjs& meta_vjs;
+}
+
+void NavDelta::save(const std::string& filename) const {
+    try {
+        std::ofstream ofs(filename.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+        ofs.exceptions(std::ofstream::failbit | std::ofstream::badbit);
+        boost::iostreams::filtering_streambuf<boost::iostreams::output> out;
+        out.push(LZ4Compressor(2048 * 500), 1024 * 500, 1024 * 500);
+        out.push(ofs);
+        eos::portable_oarchive oa(out);
+        oa << *this;
+    } catch (const std::ofstream::failure& e) {
+        throw navitia::exception(std::string("Unable to write file: ") + e.what());
+    }
+}
+
+void NavDelta::load(const std::string& filename) {
+    std::ifstream ifs(filename.c_str(), std::ios::in | std::ios::binary);
+    ifs.exceptions(std::ifstream::failbit | std::ifstream::badbit);
+    boost::iostreams::filtering_streambuf<boost::iostreams::input> in;
+    in.push(LZ4Decompressor(2048 * 500), 8192 * 500, 8192 * 500);
+    in.push(ifs);
+    eos::portable_iarchive ia(in);
+    ia >> *this;
+}
+
+namespace {
+
+// a sink hashing what is written in it, a serialization is hashed without being kept in memory
+class HashSink {
+    ContentHash* hash;
+
+public:
+    using char_type = char;
+    using category = boost::iostreams::sink_tag;
+
+    explicit HashSink(ContentHash* hash) : hash(hash) {}
+    std::streamsize write(const char* s, std::streamsize n) {
+        hash->add(s, n);
+        return n;
+    }
+};
+
+// the comments and the codes are mapped by the address of their objects, they are saved in the order of the objects
+template <typename T>
+void save_comments(boost::archive::binary_oarchive& oa, const std::vector<T*>& objects, const Comments& comments) {
+    for (const auto* obj : objects) {
+        oa << comments.get(obj);
+    }
+}
+
+template <typename T>
+void save_codes(boost::archive::binary_oarchive& oa, const std::vector<T*>& objects, const CodeContainer& codes) {
+    for (const auto* obj : objects) {
+        oa << codes.get_codes(obj);
+    }
+}
+
+template <typename T>
+std::string uri(const T* obj) {
+    return obj ? obj->uri : std::string();
+}
+
+template <typename T>
+std::string to_bytes(const T& obj) {
+    std::ostringstream oss;
+    {
+        boost::archive::binary_oarchive oa(oss, boost::archive::no_header);
+        oa << obj;
+    }
+    return oss.str();
+}
+
+template <typename Map>
+typename Map::mapped_type find_uri(const Map& map, const std::string& uri, const std::string& what) {
+    if (uri.empty()) {
+        return nullptr;
+    }
+    const auto it = map.find(uri);
+    if (it == map.end()) {
+        throw navitia::data::delta_error("unknown " + what + " " + uri);
+    }
+    return it->second;
+}
+
+// a delta only replaces meta vjs that are exactly the ones of the base nav
+bool is_base_schedule(const MetaVehicleJourney& mvj) {
+    if (!mvj.get_impacts().empty() || !mvj.modified_by.empty()) {
+        return false;
+    }
+    if (!mvj.get_adapted_vj().empty() || !mvj.get_rt_vj().empty()) {
+        return false;
+    }
+    for (const auto& vj : mvj.get_base_vj()) {
+        const auto& base_days = vj->base_validity_pattern()->days;
+        if (vj->adapted_validity_pattern()->days != base_days || vj->rt_validity_pattern()->days != base_days) {
+            return false;
+        }
+    }
+    return true;
+}
+
+MetaVehicleJourneyDelta make_meta_vj_delta(const MetaVehicleJourney& mvj, const PT_Data& pt_data) {
+    MetaVehicleJourneyDelta res;
+    res.name = mvj.uri;
+    if (mvj.tz_handler) {
+        res.timezone = mvj.tz_handler->tz_name;
+    }
+    for (const auto& name_cal : mvj.associated_calendars) {
+        auto& cal = res.associated_calendars[name_cal.first];
+        cal.calendar_uri = uri(name_cal.second->calendar);
+        cal.exceptions = name_cal.second->exceptions;
+    }
+    for (const auto& vj : mvj.get_base_vj()) {
+        VehicleJourneyDelta vjd;
+        vjd.uri = vj->uri;
+        vjd.name = vj->name;
+        vjd.headsign = vj->headsign;
+        vjd.route_uri = uri(vj->route);
+        vjd.physical_mode_uri = uri(vj->physical_mode);
+        vjd.company_uri = uri(vj->company);
+        vjd.dataset_uri = uri(vj->dataset);
+        vjd.prev_vj_uri = uri(vj->prev_vj);
+        vjd.next_vj_uri = uri(vj->next_vj);
+        vjd.odt_message = vj->odt_message;
+        vjd.vehicle_journey_type = vj->vehicle_journey_type;
+        vjd.vehicle_properties = vj->vehicles();
+        if (const auto* fvj = dynamic_cast<const FrequencyVehicleJourney*>(vj.get())) {
+            vjd.is_frequency = true;
+            vjd.start_time = fvj->start_time;
+            vjd.end_time = fvj->end_time;
+            vjd.headway_secs = fvj->headway_secs;
+        }
+        vjd.shift = vj->shift;
+        vjd.vp_beginning_date = vj->base_validity_pattern()->beginning_date;
+        vjd.vp_days = vj->base_validity_pattern()->days.to_string();
+        for (const auto& st : vj->stop_time_list) {
+            StopTimeDelta st_delta;
+            st_delta.stop_point_uri = uri(st.stop_point);
+            st_delta.arrival_time = st.arrival_time;
+            st_delta.departure_time = st.departure_time;
+            st_delta.boarding_time = st.boarding_time;
+            st_delta.alighting_time = st.alighting_time;
+            st_delta.properties = st.properties;
+            st_delta.local_traffic_zone = st.local_traffic_zone;
+            if (st.shape_from_prev) {
+                st_delta.shape_from_prev = *st.shape_from_prev;
+            }
+            const auto& headsign = pt_data.headsign_handler.get_headsign(st);
+            if (headsign != vj->headsign) {
+                st_delta.headsign = headsign;
+            }
+            st_delta.comments = pt_data.comments.get(st);
+            vjd.stop_times.push_back(std::move(st_delta));
+        }
+        vjd.comments = pt_data.comments.get(vj.get());
+        vjd.codes = pt_data.codes.get_codes(vj.get());
+        res.vehicle_journeys.push_back(std::move(vjd));
+    }
+    return res;
+}
+
+bool is_base_schedule(const PT_Data& pt_data) {
+    for (const auto& mvj : pt_data.meta_vjs) {
+        if (!is_base_schedule(*mvj)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+VehicleJourney* create_vj(MetaVehicleJourney& mvj, const VehicleJourneyDelta& vjd, PT_Data& pt_data) {
+    std::vector<StopTime> sts;
+    sts.reserve(vjd.stop_times.size());
+    for (const auto& st_delta : vjd.stop_times) {
+        StopTime st;
+        st.arrival_time = st_delta.arrival_time;
+        st.departure_time = st_delta.departure_time;
+        st.boarding_time = st_delta.boarding_time;
+        st.alighting_time = st_delta.alighting_time;
+        st.properties = st_delta.properties;
+        st.local_traffic_zone = st_delta.local_traffic_zone;
+        st.stop_point = pt_data.stop_points_map.at(st_delta.stop_point_uri);
+        if (!st_delta.shape_from_prev.empty()) {
+            st.shape_from_prev = boost::make_shared<LineString>(st_delta.shape_from_prev);
+        }
+        sts.push_back(std::move(st));
+    }
+    auto* route = pt_data.routes_map.at(vjd.route_uri);
+    const ValidityPattern vp(vjd.vp_beginning_date, vjd.vp_days);
+    VehicleJourney* vj = nullptr;
+    if (vjd.is_frequency) {
+        auto* fvj = mvj.create_frequency_vj(vjd.uri, vjd.name, vjd.headsign, RTLevel::Base, vp, route,
+                                            std::move(sts), pt_data);
+        fvj->start_time = vjd.start_time;
+        fvj->end_time = vjd.end_time;
+        fvj->headway_secs = vjd.headway_secs;
+        vj = fvj;
+    } else {
+        vj = mvj.create_discrete_vj(vjd.uri, vjd.name, vjd.headsign, RTLevel::Base, vp, route, std::move(sts),
+                                    pt_data);
+    }
+    // the stop times are already the ones of a vj created at the same level
+    vj->shift = vjd.shift;
+    vj->odt_message = vjd.odt_message;
+    vj->vehicle_journey_type = vjd.vehicle_journey_type;
+    vj->set_vehicles(vjd.vehicle_properties);
+    vj->physical_mode = find_or_default(vjd.physical_mode_uri, pt_data.physical_modes_map);
+    vj->company = find_or_default(vjd.company_uri, pt_data.companies_map);
+    vj->dataset = find_or_default(vjd.dataset_uri, pt_data.datasets_map);
+
+    pt_data.headsign_handler.change_name_and_register_as_headsign(*vj, vjd.headsign);
+    for (size_t i = 0; i < vjd.stop_times.size(); ++i) {
+        const auto& st_delta = vjd.stop_times[i];
+        if (!st_delta.headsign.empty()) {
+            pt_data.headsign_handler.affect_headsign_to_stop_time(vj->stop_time_list[i], st_delta.headsign);
+        }
+        for (const auto& comment : st_delta.comments) {
+            pt_data.comments.add(vj->stop_time_list[i], comment);
+        }
+    }
+    for (const auto& comment : vjd.comments) {
+        pt_data.comments.add(vj, comment);
+    }
+    for (const auto& key_values : vjd.codes) {
+        for (const auto& value : key_values.second) {
+            pt_data.codes.add(vj, key_values.first, value);
+        }
+    }
+    return vj;
+}
+
+}  // anonymous namespace
+
+void ContentHash::add(const char* data, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+        value ^= static_cast<unsigned char>(data[i]);
+        value *= 1099511628211ULL;
+    }
+}
+
+std::string ContentHash::hex() const {
+    std::ostringstream oss;
+    oss << std::hex << std::setw(16) << std::setfill('0') << value;
+    return oss.str();
+}
+
+std::string hash_file(const std::string& filename) {
+    std::ifstream ifs(filename.c_str(), std::ios::in | std::ios::binary);
+    if (!ifs) {
+        throw navitia::exception("Unable to read file " + filename);
+    }
+    ContentHash hash;
+    std::vector<char> buffer(1024 * 1024);
+    while (ifs) {
+        ifs.read(buffer.data(), buffer.size());
+        hash.add(buffer.data(), ifs.gcount());
+    }
+    return hash.hex();
+}
+
+std::string structure_hash(const Data& data) {
+    Data copy;
+    copy.clone_from(data);
+    auto& pt_data = *copy.pt_data;
+    std::vector<std::unique_ptr<VehicleJourney>> vjs;
+    for (const auto& mvj : pt_data.meta_vjs) {
+        auto mvj_vjs = mvj->release_vjs(pt_data);
+        std::move(mvj_vjs.begin(), mvj_vjs.end(), std::back_inserter(vjs));
+    }
+    pt_data.vehicle_journeys.clear();
+    vjs.clear();
+    // the dates of the export are in the delta
+    copy.meta->publication_date = boost::posix_time::not_a_date_time;
+    copy.meta->dataset_created_at = boost::posix_time::not_a_date_time;
+
+    ContentHash hash;
+    {
+        boost::iostreams::stream<HashSink> os(&hash);
+        boost::archive::binary_oarchive oa(os, boost::archive::no_header);
+        // the validity patterns are the ones of the vehicle journeys, the autocompletes and the
+        // proximity lists are built from the other objects
+        oa << pt_data.lines << pt_data.line_groups << pt_data.stop_points << pt_data.stop_areas << pt_data.networks
+           << pt_data.physical_modes << pt_data.commercial_modes << pt_data.companies << pt_data.routes
+           << pt_data.contributors << pt_data.calendars << pt_data.datasets << pt_data.stop_point_connections
+           << pt_data.stop_points_by_area << pt_data.headsign_handler << pt_data.tz_manager;
+        save_comments(oa, pt_data.stop_areas, pt_data.comments);
+        save_comments(oa, pt_data.stop_points, pt_data.comments);
+        save_comments(oa, pt_data.lines, pt_data.comments);
+        save_comments(oa, pt_data.routes, pt_data.comments);
+        save_comments(oa, pt_data.line_groups, pt_data.comments);
+        save_codes(oa, pt_data.stop_areas, pt_data.codes);
+        save_codes(oa, pt_data.networks, pt_data.codes);
+        save_codes(oa, pt_data.companies, pt_data.codes);
+        save_codes(oa, pt_data.lines, pt_data.codes);
+        save_codes(oa, pt_data.routes, pt_data.codes);
+        save_codes(oa, pt_data.stop_points, pt_data.codes);
+        save_codes(oa, pt_data.calendars, pt_data.codes);
+        oa << *copy.geo_ref << *copy.meta << *copy.fare;
+    }
+    return hash.hex();
+}
+
+boost::optional<NavDelta> make_nav_delta(const Data& base, const Data& target) {
+    auto logger = log4cplus::Logger::getInstance("logger");
+    if (structure_hash(base) != structure_hash(target)) {
+        LOG4CPLUS_INFO(logger, "the pt objects, the street network or the fares have changed, no delta possible");
+        return boost::none;
+    }
+    if (!is_base_schedule(*base.pt_data) || !is_base_schedule(*target.pt_data)) {
+        LOG4CPLUS_INFO(logger, "some vehicle journeys are not base schedule ones, no delta possible");
+        return boost::none;
+    }
+
+    // a meta vj without vj, as the ones removed by a previous delta, is as if it didn't exist
+    std::unordered_map<std::string, std::string> base_meta_vjs;
+    for (const auto& mvj : base.pt_data->meta_vjs) {
+        if (!mvj->get_base_vj().empty()) {
+            base_meta_vjs[mvj->uri] = to_bytes(make_meta_vj_delta(*mvj, *base.pt_data));
+        }
+    }
+    NavDelta delta;
+    delta.publication_date = target.meta->publication_date;
+    delta.dataset_created_at = target.meta->dataset_created_at;
+    for (const auto& mvj : target.pt_data->meta_vjs) {
+        if (mvj->get_base_vj().empty()) {
+            continue;
+        }
+        auto mvj_delta = make_meta_vj_delta(*mvj, *target.pt_data);
+        const auto it = base_meta_vjs.find(mvj->uri);
+        if (it != base_meta_vjs.end()) {
+            const bool unchanged = it->second == to_bytes(mvj_delta);
+            base_meta_vjs.erase(it);
+            if (unchanged) {
+                continue;
+            }
+        }
+        delta.meta_vjs.push_back(std::move(mvj_delta));
+    }
+    for (const auto& name_mvj : base_meta_vjs) {
+        delta.removed_meta_vjs.push_back(name_mvj.first);
+    }
+    LOG4CPLUS_INFO(logger, "delta of " << delta.meta_vjs.size() << " added or modified meta vjs and "
+                                       << delta.removed_meta_vjs.size() << " removed meta vjs");
+    return std::move(delta);
+}
+
+void apply_nav_delta(const NavDelta& delta, Data& data) {
+    auto& pt_data = *data.pt_data;
+
+    // first we check that the whole delta can be applied, the data must not be half modified
+    std::unordered_set<MetaVehicleJourney*> replaced;
+    auto replace = [&](const std::string& name) {
+        auto* mvj = pt_data.meta_vjs.get_mut(name);
+        if (!mvj) {
+            return;
+        }
+        if (!is_base_schedule(*mvj)) {
+            throw navitia::data::delta_error("the meta vj " + name + " is impacted by a disruption");
+        }
+        replaced.insert(mvj);
+    };
+    for (const auto& name : delta.removed_meta_vjs) {
+        if (!pt_data.meta_vjs.exists(name)) {
+            throw navitia::data::delta_error("unknown meta vj " + name);
+        }
+        replace(name);
+    }
+    std::unordered_set<std::string> new_vjs;
+    for (const auto& mvjd : delta.meta_vjs) {
+        replace(mvjd.name);
+        if (!mvjd.timezone.empty() && !pt_data.tz_manager.get(mvjd.timezone)) {
+            throw navitia::data::delta_error("unknown timezone " + mvjd.timezone);
+        }
+        for (const auto& name_cal : mvjd.associated_calendars) {
+            find_uri(pt_data.calendars_map, name_cal.second.calendar_uri, "calendar");
+        }
+        for (const auto& vjd : mvjd.vehicle_journeys) {
+            if (!find_uri(pt_data.routes_map, vjd.route_uri, "route")) {
+                throw navitia::data::delta_error("no route for the vj " + vjd.uri);
+            }
+            find_uri(pt_data.physical_modes_map, vjd.physical_mode_uri, "physical mode");
+            find_uri(pt_data.companies_map, vjd.company_uri, "company");
+            find_uri(pt_data.datasets_map, vjd.dataset_uri, "dataset");
+            for (const auto& st_delta : vjd.stop_times) {
+                if (!find_uri(pt_data.stop_points_map, st_delta.stop_point_uri, "stop point")) {
+                    throw navitia::data::delta_error("no stop point for a stop time of the vj " + vjd.uri);
+                }
+            }
+            const auto* vj = find_or_default(vjd.uri, pt_data.vehicle_journeys_map);
+            if (vj && !replaced.count(vj->meta_vj)) {
+                throw navitia::data::delta_error("the vj " + vjd.uri + " already exists");
+            }
+            new_vjs.insert(vjd.uri);
+        }
+    }
+    auto check_link = [&](const std::string& uri) {
+        if (uri.empty() || new_vjs.count(uri)) {
+            return;
+        }
+        const auto* vj = find_or_default(uri, pt_data.vehicle_journeys_map);
+        if (!vj || replaced.count(vj->meta_vj)) {
+            throw navitia::data::delta_error("unknown linked vj " + uri);
+        }
+    };
+    for (const auto& mvjd : delta.meta_vjs) {
+        for (const auto& vjd : mvjd.vehicle_journeys) {
+            check_link(vjd.prev_vj_uri);
+            check_link(vjd.next_vj_uri);
+        }
+    }
+    // the vjs that are kept but linked to a replaced one are linked to its new version
+    std::vector<std::pair<VehicleJourney*, std::string>> prev_links, next_links;
+    for (auto* vj : pt_data.vehicle_journeys) {
+        if (replaced.count(vj->meta_vj)) {
+            continue;
+        }
+        if (vj->prev_vj && replaced.count(vj->prev_vj->meta_vj)) {
+            check_link(vj->prev_vj->uri);
+            prev_links.emplace_back(vj, vj->prev_vj->uri);
+        }
+        if (vj->next_vj && replaced.count(vj->next_vj->meta_vj)) {
+            check_link(vj->next_vj->uri);
+            next_links.emplace_back(vj, vj->next_vj->uri);
+        }
+    }
+
+    // then the vjs of the replaced meta vjs are removed all at once
+    std::vector<std::unique_ptr<VehicleJourney>> removed_vjs;
+    for (auto* mvj : replaced) {
+        auto vjs = mvj->release_vjs(pt_data);
+        std::move(vjs.begin(), vjs.end(), std::back_inserter(removed_vjs));
+        // the associated calendars are still owned by pt_data, they are dropped at the next full load
+        mvj->associated_calendars.clear();
+    }
+    std::unordered_set<const VehicleJourney*> removed_set;
+    for (const auto& vj : removed_vjs) {
+        removed_set.insert(vj.get());
+    }
+    auto& vjs = pt_data.vehicle_journeys;
+    vjs.erase(std::remove_if(vjs.begin(), vjs.end(), [&](const VehicleJourney* vj) { return removed_set.count(vj); }),
+              vjs.end());
+    for (size_t i = 0; i < vjs.size(); ++i) {
+        vjs[i]->idx = i;
+    }
+    removed_vjs.clear();
+
+    // and the new versions are created
+    for (const auto& mvjd : delta.meta_vjs) {
+        auto* mvj = pt_data.meta_vjs.get_or_create(mvjd.name);
+        mvj->tz_handler = mvjd.timezone.empty() ? nullptr : pt_data.tz_manager.get(mvjd.timezone);
+        for (const auto& name_cal : mvjd.associated_calendars) {
+            auto* associated_calendar = new AssociatedCalendar();
+            associated_calendar->calendar = pt_data.calendars_map.at(name_cal.second.calendar_uri);
+            associated_calendar->exceptions = name_cal.second.exceptions;
+            pt_data.associated_calendars.push_back(associated_calendar);
+            mvj->associated_calendars[name_cal.first] = associated_calendar;
+        }
+        for (const auto& vjd : mvjd.vehicle_journeys) {
+            create_vj(*mvj, vjd, pt_data);
+        }
+    }
+    // a vj might have been cleaned by the creation of the next one of its meta vj, it is searched by its uri
+    for (const auto& mvjd : delta.meta_vjs) {
+        for (const auto& vjd : mvjd.vehicle_journeys) {
+            auto* vj = find_or_default(vjd.uri, pt_data.vehicle_journeys_map);
+            if (!vj) {
+                continue;
+            }
+            vj->prev_vj = find_or_default(vjd.prev_vj_uri, pt_data.vehicle_journeys_map);
+            vj->next_vj = find_or_default(vjd.next_vj_uri, pt_data.vehicle_journeys_map);
+        }
+    }
+    for (const auto& vj_uri : prev_links) {
+        vj_uri.first->prev_vj = find_or_default(vj_uri.second, pt_data.vehicle_journeys_map);
+    }
+    for (const auto& vj_uri : next_links) {
+        vj_uri.first->next_vj = find_or_default(vj_uri.second, pt_data.vehicle_journeys_map);
+    }
+    data.meta->publication_date = delta.publication_date;
+    data.meta->dataset_created_at = delta.dataset_created_at;
+}
+
+}  // namespace type
+}  // namespace navitia
+
+BOOST_CLASS_VERSION(navitia::type::NavDelta, navitia::type::NavDelta::delta_version)
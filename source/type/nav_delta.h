@@ -0,0 +1,208 @@
+/* Copyright © 2001-2014, Canal TP and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+channel `#navitia` on riot https://riot.im/app/#/room/#navitia:matrix.org
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+
+#pragma once
+
+#include "type/calendar.h"
+#include "type/code_container.h"
+#include "type/comment.h"
+#include "type/geographical_coord.h"
+#include "type/vehicle_journey.h"
+
+#include <boost/date_time/gregorian/gregorian_types.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <boost/optional.hpp>
+
+#include <bitset>
+#include <limits>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace navitia {
+namespace type {
+
+class Data;
+
+// the objects of a delta are referenced by their uri
+struct StopTimeDelta {
+    std::string stop_point_uri;
+    uint32_t arrival_time = 0;
+    uint32_t departure_time = 0;
+    uint32_t boarding_time = 0;
+    uint32_t alighting_time = 0;
+    std::bitset<8> properties;
+    uint16_t local_traffic_zone = std::numeric_limits<uint16_t>::max();
+    LineString shape_from_prev;
+    // empty when it is the headsign of the vehicle journey
+    std::string headsign;
+    std::vector<Comment> comments;
+
+    template <class Archive>
+    void serialize(Archive& ar, const unsigned int) {
+        ar& stop_point_uri& arrival_time& departure_time& boarding_time& alighting_time& properties&
+            local_traffic_zone& shape_from_prev& headsign& comments;
+    }
+};
+
+struct VehicleJourneyDelta {
+    std::string uri;
+    std::string name;
+    std::string headsign;
+    std::string route_uri;
+    std::string physical_mode_uri;
+    std::string company_uri;
+    std::string dataset_uri;
+    std::string prev_vj_uri;
+    std::string next_vj_uri;
+    std::string odt_message;
+    VehicleJourneyType vehicle_journey_type = VehicleJourneyType::regular;
+    VehicleProperties vehicle_properties;
+    bool is_frequency = false;
+    uint32_t start_time = 0;
+    uint32_t end_time = 0;
+    uint32_t headway_secs = 0;
+    uint32_t shift = 0;
+    // base validity pattern and stop times, as they are in the vehicle journey
+    boost::gregorian::date vp_beginning_date;
+    std::string vp_days;
+    std::vector<StopTimeDelta> stop_times;
+    std::vector<Comment> comments;
+    CodeContainer::Codes codes;
+
+    template <class Archive>
+    void serialize(Archive& ar, const unsigned int) {
+        ar& uri& name& headsign& route_uri& physical_mode_uri& company_uri& dataset_uri& prev_vj_uri& next_vj_uri&
+            odt_message& vehicle_journey_type& vehicle_properties& is_frequency& start_time& end_time& headway_secs&
+                shift& vp_beginning_date& vp_days& stop_times& comments& codes;
+    }
+};
+
+struct AssociatedCalendarDelta {
+    std::string calendar_uri;
+    std::vector<ExceptionDate> exceptions;
+
+    template <class Archive>
+    void serialize(Archive& ar, const unsigned int) {
+        ar& calendar_uri& exceptions;
+    }
+};
+
+struct MetaVehicleJourneyDelta {
+    std::string name;
+    std::string timezone;
+    std::map<std::string, AssociatedCalendarDelta> associated_calendars;
+    std::vector<VehicleJourneyDelta> vehicle_journeys;
+
+    template <class Archive>
+    void serialize(Archive& ar, const unsigned int) {
+        ar& name& timezone& associated_calendars& vehicle_journeys;
+    }
+};
+
+/**
+ * Delta between two nav files
+ *
+ * When a feed is refreshed, most of the time only the timetables of some
+ * networks change. A delta holds the meta vehicle journeys that are added,
+ * modified or removed between a base nav and a target nav, so that kraken can
+ * build the target data from the data loaded from the base nav, without a full
+ * reload.
+ *
+ * A delta is only made when all the other objects (stop points, routes,
+ * calendars, street network, fares, metadata but the dates of the export...)
+ * are the same in both navs. The objects are referenced by their uri, and a
+ * modified meta vehicle journey is replaced with all its vehicle journeys.
+ */
+struct NavDelta {
+    static const unsigned int delta_version;  //< *INCREMENT* in cpp file every time the serialized delta changes
+
+    // content hashes of the nav files, the delta transforms the data of the base into the one of the target
+    std::string base_hash;
+    std::string target_hash;
+    boost::posix_time::ptime publication_date;
+    boost::posix_time::ptime dataset_created_at;
+    std::vector<std::string> removed_meta_vjs;
+    // the added meta vjs and the new version of the modified ones
+    std::vector<MetaVehicleJourneyDelta> meta_vjs;
+
+    bool empty() const { return removed_meta_vjs.empty() && meta_vjs.empty(); }
+
+    /** Save the delta in a compressed binary file using LZ4 */
+    void save(const std::string& filename) const;
+    void load(const std::string& filename);
+
+    template <class Archive>
+    void serialize(Archive& ar, const unsigned int version);
+};
+
+/// 64 bits FNV-1a hash of a content given by chunks, we only need to tell apart versions of the data
+class ContentHash {
+    uint64_t value = 14695981039346656037ULL;
+
+public:
+    void add(const char* data, size_t size);
+    std::string hex() const;
+};
+
+/// content hash of a file, to identify a nav file
+std::string hash_file(const std::string& filename);
+
+/**
+ * Hash of everything a delta can't change
+ *
+ * The meta vehicle journeys are removed from a copy of the data, everything else (the other pt
+ * objects, their comments and codes, the street network, the fares and the metadata but the dates
+ * of the export) is hashed through its serialization.
+ */
+std::string structure_hash(const Data& data);
+
+/**
+ * Computes the delta from base to target
+ *
+ * Returns none if the target can't be obtained with a delta: its structure is not the one
+ * of the base, or some vehicle journeys are not base schedule ones.
+ * The hashes of the nav files are not known here, they are set by the caller.
+ */
+boost::optional<NavDelta> make_nav_delta(const Data& base, const Data& target);
+
+/**
+ * Applies a delta on the data
+ *
+ * All the delta is checked before the data is modified, a navitia::data::delta_error
+ * is thrown if it can't be applied (unknown objects, meta vjs impacted by disruptions...).
+ * The relations and the raptor data are not rebuilt, the changes are tracked in
+ * the journal of pt_data if it is started.
+ */
+void apply_nav_delta(const NavDelta& delta, Data& data);
+
+}  // namespace type
+}  // namespace navitia
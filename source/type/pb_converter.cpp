@@ -869,9 +869,9 @@ void PbCreator::Filler::fill_pb_object(const nt::VehicleJourney* vj, pbnavitia::
         fill_with_creator(vj->adapted_validity_pattern(),
                           [&]() { return vehicle_journey->mutable_adapted_validity_pattern(); });
 
-        const auto& vector_bp = navitia::vptranslator::translate(*vj->base_validity_pattern());
+        const auto vector_bp = navitia::vptranslator::translate_cached(*vj->base_validity_pattern());
 
-        fill(vector_bp, vehicle_journey->mutable_calendars());
+        fill(*vector_bp, vehicle_journey->mutable_calendars());
 
         if (auto* v = dynamic_cast<const nt::FrequencyVehicleJourney*>(vj)) {
             fill_pb_object(v, vehicle_journey);
@@ -1659,7 +1659,7 @@ void PbCreator::Filler::fill_pb_object(const nt::Contributor* c, pbnavitia::Feed
 
 template <typename N>
 void PbCreator::pb_fill(const std::vector<N*>& nav_list, int depth, const DumpMessageOptions& dump_message_options) {
-    auto* pb_object = get_mutable<typename std::remove_cv<N>::type>(response);
+    auto* pb_object = get_mutable<typename std::remove_cv<N>::type>(*response);
     Filler(depth, dump_message_options, *this).fill_pb_object(nav_list, pb_object);
 }
 
@@ -1733,7 +1733,7 @@ void PbCreator::fill_co2_emission(pbnavitia::Section* pb_section, const type::Ve
 void PbCreator::fill_fare_section(pbnavitia::Journey* pb_journey, const fare::results& fare) {
     auto pb_fare = pb_journey->mutable_fare();
 
-    size_t cpt_ticket = response.tickets_size();
+    size_t cpt_ticket = response->tickets_size();
 
     boost::optional<std::string> currency;
     for (const fare::Ticket& ticket : fare.tickets) {
@@ -1749,7 +1749,7 @@ void PbCreator::fill_fare_section(pbnavitia::Journey* pb_journey, const fare::re
 
         pbnavitia::Ticket* pb_ticket = nullptr;
         if (ticket.is_default_ticket()) {
-            pb_ticket = response.add_tickets();
+            pb_ticket = response->add_tickets();
             pb_ticket->set_name(ticket.caption);
             pb_ticket->set_found(false);
             pb_ticket->set_id("unknown_ticket_" + std::to_string(++cpt_ticket));
@@ -1758,7 +1758,7 @@ void PbCreator::fill_fare_section(pbnavitia::Journey* pb_journey, const fare::re
             pb_fare->add_ticket_id(pb_ticket->id());
 
         } else {
-            pb_ticket = response.add_tickets();
+            pb_ticket = response->add_tickets();
 
             pb_ticket->set_name(ticket.caption);
             pb_ticket->set_found(true);
@@ -1884,26 +1884,26 @@ const ng::POI* PbCreator::get_nearest_parking(const nt::GeographicalCoord& coord
 }
 
 pbnavitia::RouteSchedule* PbCreator::add_route_schedules() {
-    return response.add_route_schedules();
+    return response->add_route_schedules();
 }
 
 pbnavitia::StopSchedule* PbCreator::add_stop_schedules() {
-    return response.add_stop_schedules();
+    return response->add_stop_schedules();
 }
 
 pbnavitia::StopSchedule* PbCreator::add_terminus_schedules() {
-    return response.add_terminus_schedules();
+    return response->add_terminus_schedules();
 }
 
 int PbCreator::route_schedules_size() {
-    return response.route_schedules_size();
+    return response->route_schedules_size();
 }
 pbnavitia::Passage* PbCreator::add_next_departures() {
-    return response.add_next_departures();
+    return response->add_next_departures();
 }
 
 pbnavitia::Passage* PbCreator::add_next_arrivals() {
-    return response.add_next_arrivals();
+    return response->add_next_arrivals();
 }
 
 pbnavitia::Section* PbCreator::create_section(pbnavitia::Journey* pb_journey,
@@ -2091,21 +2091,21 @@ void PbCreator::fill_pb_error(const pbnavitia::Error::error_id id,
                               const pbnavitia::ResponseType& resp_type,
                               const std::string& message) {
     fill_pb_error(id, message);
-    response.set_response_type(resp_type);
+    response->set_response_type(resp_type);
 }
 
 void PbCreator::fill_pb_error(const pbnavitia::Error::error_id id, const std::string& message) {
-    pbnavitia::Error* error = response.mutable_error();
+    pbnavitia::Error* error = response->mutable_error();
     error->set_id(id);
     error->set_message(message);
 }
 
 const pbnavitia::Response& PbCreator::get_response() {
-    Filler(0, {DumpMessage::No}, *this).fill_pb_object(contributors, response.mutable_feed_publishers());
+    Filler(0, {DumpMessage::No}, *this).fill_pb_object(contributors, response->mutable_feed_publishers());
     contributors.clear();
-    Filler(0, {DumpMessage::No}, *this).fill_pb_object(impacts, response.mutable_impacts());
+    Filler(0, {DumpMessage::No}, *this).fill_pb_object(impacts, response->mutable_impacts());
     impacts.clear();
-    return response;
+    return *response;
 }
 
 void PbCreator::fill_additional_informations(google::protobuf::RepeatedField<int>* infos,
@@ -2143,82 +2143,82 @@ pbnavitia::GeographicalCoord PbCreator::get_coord(const pbnavitia::PtObject& pt_
 }
 
 pbnavitia::PtObject* PbCreator::add_places_nearby() {
-    return response.add_places_nearby();
+    return response->add_places_nearby();
 }
 
 pbnavitia::PtObject* PbCreator::add_places() {
-    return response.add_places();
+    return response->add_places();
 }
 
 pbnavitia::TrafficReports* PbCreator::add_traffic_reports() {
-    return response.add_traffic_reports();
+    return response->add_traffic_reports();
 }
 
 pbnavitia::LineReport* PbCreator::add_line_reports() {
-    return response.add_line_reports();
+    return response->add_line_reports();
 }
 
 pbnavitia::NearestStopPoint* PbCreator::add_nearest_stop_points() {
-    return response.add_nearest_stop_points();
+    return response->add_nearest_stop_points();
 }
 
 pbnavitia::JourneyPattern* PbCreator::add_journey_patterns() {
-    return response.add_journey_patterns();
+    return response->add_journey_patterns();
 }
 
 pbnavitia::JourneyPatternPoint* PbCreator::add_journey_pattern_points() {
-    return response.add_journey_pattern_points();
+    return response->add_journey_pattern_points();
 }
 
 pbnavitia::Trip* PbCreator::add_trips() {
-    return response.add_trips();
+    return response->add_trips();
 }
 
 pbnavitia::Impact* PbCreator::add_impacts() {
-    return response.add_impacts();
+    return response->add_impacts();
 }
 
 pbnavitia::RoutePoint* PbCreator::add_route_points() {
-    return response.add_route_points();
+    return response->add_route_points();
 }
 
 pbnavitia::Journey* PbCreator::add_journeys() {
-    return response.add_journeys();
+    return response->add_journeys();
 }
 
 pbnavitia::GraphicalIsochrone* PbCreator::add_graphical_isochrones() {
-    return response.add_graphical_isochrones();
+    return response->add_graphical_isochrones();
 }
 
 pbnavitia::HeatMap* PbCreator::add_heat_maps() {
-    return response.add_heat_maps();
+    return response->add_heat_maps();
 }
 
 pbnavitia::EquipmentReport* PbCreator::add_equipment_reports() {
-    return response.add_equipment_reports();
+    return response->add_equipment_reports();
 }
 
 bool PbCreator::has_error() {
-    return response.has_error();
+    return response->has_error();
 }
 
 bool PbCreator::has_response_type(const pbnavitia::ResponseType& resp_type) {
-    return resp_type == response.response_type();
+    return resp_type == response->response_type();
 }
 
 void PbCreator::set_response_type(const pbnavitia::ResponseType& resp_type) {
-    response.set_response_type(resp_type);
+    response->set_response_type(resp_type);
 }
 
 ::google::protobuf::RepeatedPtrField<pbnavitia::PtObject>* PbCreator::get_mutable_places() {
-    return response.mutable_places();
+    return response->mutable_places();
 }
 
 void PbCreator::make_paginate(const int total_result,
                               const int start_page,
                               const int items_per_page,
                               const int items_on_page) {
-    auto pagination = response.mutable_pagination();
+    auto pagination = response->mutable_pagination();
     pagination->set_totalresult(total_result);
     pagination->set_startpage(start_page);
     pagination->set_itemsperpage(items_per_page);
@@ -2226,35 +2226,35 @@ void PbCreator::make_paginate(const int total_result,
 }
 
 int PbCreator::departure_boards_size() {
-    return response.departure_boards_size();
+    return response->departure_boards_size();
 }
 
 int PbCreator::terminus_schedules_size() {
-    return response.terminus_schedules_size();
+    return response->terminus_schedules_size();
 }
 
 int PbCreator::stop_schedules_size() {
-    return response.stop_schedules_size();
+    return response->stop_schedules_size();
 }
 
 int PbCreator::traffic_reports_size() {
-    return response.traffic_reports_size();
+    return response->traffic_reports_size();
 }
 
 int PbCreator::line_reports_size() {
-    return response.line_reports_size();
+    return response->line_reports_size();
 }
 
 int PbCreator::calendars_size() {
-    return response.calendars_size();
+    return response->calendars_size();
 }
 
 int PbCreator::equipment_reports_size() {
-    return response.equipment_reports_size();
+    return response->equipment_reports_size();
 }
 
 void PbCreator::sort_journeys() {
-    std::sort(response.mutable_journeys()->begin(), response.mutable_journeys()->end(),
+    std::sort(response->mutable_journeys()->begin(), response->mutable_journeys()->end(),
               [](const pbnavitia::Journey& journey1, const pbnavitia::Journey& journey2) {
                   auto duration1 = journey1.duration(), duration2 = journey2.duration();
                   if (duration1 != duration2) {
@@ -2265,31 +2265,31 @@ void PbCreator::sort_journeys() {
 }
 
 bool PbCreator::empty_journeys() {
-    return (response.journeys().empty());
+    return (response->journeys().empty());
 }
 
 pbnavitia::GeoStatus* PbCreator::mutable_geo_status() {
-    return response.mutable_geo_status();
+    return response->mutable_geo_status();
 }
 
 pbnavitia::Status* PbCreator::mutable_status() {
-    return response.mutable_status();
+    return response->mutable_status();
 }
 
 pbnavitia::Pagination* PbCreator::mutable_pagination() {
-    return response.mutable_pagination();
+    return response->mutable_pagination();
 }
 
 pbnavitia::Co2Emission* PbCreator::mutable_car_co2_emission() {
-    return response.mutable_car_co2_emission();
+    return response->mutable_car_co2_emission();
 }
 
 pbnavitia::StreetNetworkRoutingMatrix* PbCreator::mutable_sn_routing_matrix() {
-    return response.mutable_sn_routing_matrix();
+    return response->mutable_sn_routing_matrix();
 }
 
 pbnavitia::Metadatas* PbCreator::mutable_metadatas() {
-    return response.mutable_metadatas();
+    return response->mutable_metadatas();
 }
 
 void PbCreator::clear_feed_publishers() {
@@ -2297,15 +2297,15 @@ void PbCreator::clear_feed_publishers() {
 }
 
 pbnavitia::FeedPublisher* PbCreator::add_feed_publishers() {
-    return response.add_feed_publishers();
+    return response->add_feed_publishers();
 }
 
 void PbCreator::set_publication_date(pt::ptime ptime) {
-    response.set_publication_date(navitia::to_posix_timestamp(ptime));
+    response->set_publication_date(navitia::to_posix_timestamp(ptime));
 }
 
 void PbCreator::set_next_request_date_time(uint32_t next_request_date_time) {
-    response.set_next_request_date_time(next_request_date_time);
+    response->set_next_request_date_time(next_request_date_time);
 }
 
 }  // namespace navitia
@@ -43,6 +43,10 @@ www.navitia.io
 #include "ptreferential/ptreferential.h"
 #include "utils/logger.h"
 
+#include <google/protobuf/arena.h>
+
+#include <memory>
+
 namespace pt = boost::posix_time;
 namespace nt = navitia::type;
 namespace ng = navitia::georef;
@@ -207,7 +211,7 @@ struct PbCreator {
     size_t nb_sections = 0;
     std::map<std::pair<pbnavitia::Journey*, size_t>, std::string> routing_section_map;
 
-    PbCreator() = default;
+    PbCreator() : arena(arena_options()), response(new_response()) {}
 
     PbCreator(const nt::Data* data,
               const pt::ptime now,
@@ -220,7 +224,9 @@ struct PbCreator {
           action_period(action_period),
           disable_geojson(disable_geojson),
           disable_feedpublisher(disable_feedpublisher),
-          disable_disruption(disable_disruption) {}
+          disable_disruption(disable_disruption),
+          arena(arena_options()),
+          response(new_response()) {}
 
     void init(const nt::Data* data,
               const pt::ptime now,
@@ -239,7 +245,10 @@ struct PbCreator {
         this->contributors.clear();
         this->impacts.clear();
         this->routing_section_map.clear();
-        this->response.Clear();
+        // the previous response is freed all at once, the arena keeps its first block for the next one
+        this->response = nullptr;
+        this->arena.Reset();
+        this->response = new_response();
     }
 
     PbCreator(const PbCreator&) = delete;
@@ -255,7 +264,7 @@ struct PbCreator {
 
     template <typename N>
     void fill(const N& item, int depth, const DumpMessageOptions& dump_message_options = DumpMessageOptions{}) {
-        Filler(depth, dump_message_options, *this).fill_pb_object(item, &response);
+        Filler(depth, dump_message_options, *this).fill_pb_object(item, response);
     }
 
     template <typename N>
@@ -349,7 +358,24 @@ struct PbCreator {
     void set_next_request_date_time(uint32_t next_request_date_time);
 
 private:
-    pbnavitia::Response response;
+    // Size of the first block of the arena, kept between requests.
+    // The bigger responses get more blocks, given back to the allocator when the arena is reset
+    static constexpr size_t ARENA_INITIAL_BLOCK_SIZE = 1 << 20;
+
+    google::protobuf::ArenaOptions arena_options() {
+        google::protobuf::ArenaOptions options;
+        options.initial_block = arena_initial_block.get();
+        options.initial_block_size = ARENA_INITIAL_BLOCK_SIZE;
+        return options;
+    }
+    pbnavitia::Response* new_response() {
+        return google::protobuf::Arena::CreateMessage<pbnavitia::Response>(&arena);
+    }
+
+    std::unique_ptr<char[]> arena_initial_block{new char[ARENA_INITIAL_BLOCK_SIZE]};
+    // the response and all its sub messages are allocated on this arena
+    google::protobuf::Arena arena;
+    pbnavitia::Response* response;
     struct Filler {
         struct PtObjVisitor;
         const int depth;
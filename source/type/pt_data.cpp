@@ -89,6 +89,7 @@ type::Network* PT_Data::get_or_create_network(const std::string& uri, const std:
     network->idx = networks.size();
     networks.push_back(network);
     networks_map[uri] = network;
+    changes.add_pt_object();
 
     return network;
 }
@@ -106,6 +107,7 @@ type::CommercialMode* PT_Data::get_or_create_commercial_mode(const std::string&
     mode->idx = commercial_modes.size();
     commercial_modes.push_back(mode);
     commercial_modes_map[uri] = mode;
+    changes.add_pt_object();
 
     return mode;
 }
@@ -137,6 +139,7 @@ type::Line* PT_Data::get_or_create_line(const std::string& uri,
     line->idx = lines.size();
     lines.push_back(line);
     lines_map[uri] = line;
+    changes.add_pt_object();
 
     return line;
 }
@@ -163,6 +166,7 @@ type::Route* PT_Data::get_or_create_route(const std::string& uri,
     route->idx = routes.size();
     routes.push_back(route);
     routes_map[uri] = route;
+    changes.add_pt_object();
 
     return route;
 }
@@ -184,10 +188,8 @@ type::MetaVehicleJourney* PT_Data::get_or_create_meta_vehicle_journey(const std:
 }
 
 ValidityPattern* PT_Data::get_or_create_validity_pattern(const ValidityPattern& vp_ref) {
-    for (auto vp : validity_patterns) {
-        if (vp->days == vp_ref.days && vp->beginning_date == vp_ref.beginning_date) {
-            return vp;
-        }
+    if (auto* found = validity_patterns_index.find(validity_patterns, vp_ref)) {
+        return found;
     }
     auto vp = new nt::ValidityPattern();
     vp->idx = validity_patterns.size();
@@ -205,6 +207,7 @@ void PT_Data::sort_and_index() {
     std::for_each(collection_name.begin(), collection_name.end(), Indexer<nt::idx_t>());
     ITERATE_NAVITIA_PT_TYPES(SORT_AND_INDEX)
 #undef SORT_AND_INDEX
+    validity_patterns_index.reset();
 
     std::stable_sort(stop_point_connections.begin(), stop_point_connections.end());
     std::for_each(stop_point_connections.begin(), stop_point_connections.end(), Indexer<idx_t>());
@@ -389,6 +392,80 @@ void PT_Data::clean_weak_impacts() {
     }
 }
 
+void PT_Data::clean_weak_impacts_of_changes() {
+    if (!changes.is_tracking || changes.unknown_objects_with_deleted_impacts) {
+        clean_weak_impacts();
+        return;
+    }
+    for (auto* obj : changes.objects_with_deleted_impacts) {
+        obj->clean_weak_impacts();
+    }
+}
+
+void ChangeJournal::start() {
+    *this = ChangeJournal();
+    is_tracking = true;
+}
+
+void ChangeJournal::add_vehicle_journey(VehicleJourney* vj) {
+    if (!is_tracking) {
+        return;
+    }
+    vehicle_journeys.insert(vj);
+    if (vj->route) {
+        routes.insert(vj->route);
+    }
+}
+
+void ChangeJournal::remove_vehicle_journey(VehicleJourney* vj) {
+    if (!is_tracking) {
+        return;
+    }
+    vehicle_journeys.erase(vj);
+    if (vj->route) {
+        routes.insert(vj->route);
+    }
+}
+
+void ChangeJournal::add_pt_object() {
+    if (is_tracking) {
+        pt_objects_created = true;
+    }
+}
+
+void ChangeJournal::add_stop_point() {
+    if (is_tracking) {
+        stop_points_changed = true;
+    }
+}
+
+namespace {
+struct ObjectsWithImpact : boost::static_visitor<> {
+    ChangeJournal& changes;
+    explicit ObjectsWithImpact(ChangeJournal& changes) : changes(changes) {}
+
+    void operator()(const disruption::UnknownPtObj&) const {}
+    void operator()(const disruption::LineSection&) const {
+        // the impact is linked to the stop points and the vehicle journeys of the section
+        changes.unknown_objects_with_deleted_impacts = true;
+    }
+    template <typename T>
+    void operator()(T* obj) const {
+        changes.objects_with_deleted_impacts.insert(obj);
+    }
+};
+}  // namespace
+
+void ChangeJournal::add_deleted_impact(const disruption::Impact& impact) {
+    if (!is_tracking) {
+        return;
+    }
+    const ObjectsWithImpact visitor(*this);
+    for (const auto& entity : impact.informed_entities()) {
+        boost::apply_visitor(visitor, entity);
+    }
+}
+
 Indexes PT_Data::get_impacts_idx(const std::vector<boost::shared_ptr<disruption::Impact>>& impacts) const {
     Indexes result;
     idx_t i = 0;
@@ -42,7 +42,9 @@ www.navitia.io
 #include "code_container.h"
 #include "headsign_handler.h"
 #include "type/timezone_manager.h"
+#include "type/validity_pattern.h"
 #include <memory>
+#include <unordered_set>
 
 namespace navitia {
 template <>
@@ -53,6 +55,35 @@ namespace type {
 
 typedef std::map<std::string, std::string> code_value_map_type;
 typedef std::map<std::string, code_value_map_type> type_code_codes_map_type;
+
+/*
+ * The objects changed by the realtime updates of a cloned data, so that the rebuild that
+ * follows them only updates what depends on these objects.  Nothing is recorded before start(),
+ * and the journal isn't serialized.
+ */
+struct ChangeJournal {
+    bool is_tracking = false;
+    // the vehicle journeys created, and still alive
+    std::unordered_set<VehicleJourney*> vehicle_journeys;
+    // the routes whose vehicle journeys have been created or deleted
+    std::unordered_set<Route*> routes;
+    // a network, a commercial mode, a line or a route has been created
+    bool pt_objects_created = false;
+    // the objects that may keep a pointer to a deleted impact
+    std::unordered_set<HasMessages*> objects_with_deleted_impacts;
+    // some deleted impacts were linked to objects that are not known, as the ones of a line section
+    bool unknown_objects_with_deleted_impacts = false;
+    // a stop point or a stop area has been created or moved, the proximity lists are then rebuilt
+    bool stop_points_changed = false;
+
+    void start();
+    void add_vehicle_journey(VehicleJourney* vj);
+    void remove_vehicle_journey(VehicleJourney* vj);
+    void add_pt_object();
+    void add_stop_point();
+    void add_deleted_impact(const disruption::Impact& impact);
+};
+
 class PT_Data : boost::noncopyable {
 public:
     PT_Data();
@@ -114,6 +145,12 @@ public:
     // timezone manager
     TimeZoneManager tz_manager;
 
+    // realtime changes, not serialized
+    ChangeJournal changes;
+
+    // validity_patterns by value, not serialized as it indexes the loaded patterns at its first lookup
+    ValidityPatternIndex<ValidityPatternEqual> validity_patterns_index;
+
     template <class Archive>
     void serialize(Archive& ar, const unsigned int);
     /** Construit l'indexe ExternelCode */
@@ -156,6 +193,8 @@ public:
                                                                  const type::TimeZoneHandler* tz);
 
     void clean_weak_impacts();
+    /// Only cleans the objects that may point to the impacts deleted since the journal started
+    void clean_weak_impacts_of_changes();
 
     Indexes get_impacts_idx(const std::vector<boost::shared_ptr<disruption::Impact>>& impacts) const;
 
@@ -0,0 +1,119 @@
+/* Copyright © 2001-2019, Canal TP and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+channel `#navitia` on riot https://riot.im/app/#/room/#navitia:matrix.org
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE arena_test
+
+#include "type/arena.h"
+#include "type/data.h"
+#include "type/pt_data.h"
+#include "type/stop_point.h"
+#include "type/vehicle_journey.h"
+#include "ed/build_helper.h"
+#include "tests/utils_test.h"
+
+#include <boost/test/unit_test.hpp>
+
+using navitia::type::Arena;
+
+struct logger_initialized {
+    logger_initialized() { navitia::init_logger(); }
+};
+BOOST_GLOBAL_FIXTURE(logger_initialized);
+
+BOOST_AUTO_TEST_CASE(objects_allocated_in_the_scope) {
+    Arena arena;
+    navitia::type::StopPoint* in_arena = nullptr;
+    {
+        Arena::Scope scope(&arena);
+        BOOST_CHECK_EQUAL(Arena::current(), &arena);
+        in_arena = new navitia::type::StopPoint();
+        {
+            // a nested scope without arena allocates on the heap
+            Arena::Scope heap_scope(nullptr);
+            auto on_heap = std::make_unique<navitia::type::StopPoint>();
+            BOOST_CHECK(!Arena::owns(on_heap.get()));
+        }
+        BOOST_CHECK_EQUAL(Arena::current(), &arena);
+    }
+    BOOST_CHECK(Arena::current() == nullptr);
+    BOOST_CHECK(Arena::owns(in_arena));
+    BOOST_CHECK_EQUAL(arena.nb_slabs(), 1);
+    BOOST_CHECK_GE(arena.allocated_bytes(), sizeof(navitia::type::StopPoint));
+
+    in_arena->uri = "a string long enough to be allocated on the heap";
+    // only the destructor is run, the memory stays in the arena
+    delete in_arena;
+    BOOST_CHECK_EQUAL(arena.nb_slabs(), 1);
+
+    auto on_heap = std::make_unique<navitia::type::StopPoint>();
+    BOOST_CHECK(!Arena::owns(on_heap.get()));
+}
+
+BOOST_AUTO_TEST_CASE(slabs) {
+    Arena arena;
+    std::vector<void*> objects;
+    // two full slabs and one object in the third one
+    for (size_t i = 0; i < 2 * Arena::slab_size / 1024 + 1; ++i) {
+        objects.push_back(arena.allocate(1024));
+    }
+    BOOST_CHECK_EQUAL(arena.nb_slabs(), 3);
+    BOOST_CHECK_EQUAL(arena.reserved_bytes(), 3 * Arena::slab_size);
+    for (const auto* p : objects) {
+        BOOST_CHECK_EQUAL(reinterpret_cast<uintptr_t>(p) % alignof(std::max_align_t), 0);
+        BOOST_CHECK(Arena::owns(p));
+    }
+    // the big objects are left to the heap
+    BOOST_CHECK(arena.allocate(Arena::slab_size / 2) == nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(cloned_data_in_its_arena) {
+    ed::builder b("20190101");
+    b.vj("A")("stop1", "8:00"_t)("stop2", "9:00"_t);
+    b.make();
+
+    navitia::type::Data clone;
+    clone.clone_from(*b.data);
+    BOOST_REQUIRE(clone.arena());
+    BOOST_CHECK_GE(clone.arena()->nb_slabs(), 1);
+    BOOST_CHECK(Arena::owns(clone.pt_data->stop_points.front()));
+    BOOST_CHECK(Arena::owns(clone.pt_data->vehicle_journeys.front()));
+    BOOST_CHECK_EQUAL(clone.pt_data->vehicle_journeys.front()->uri, b.data->pt_data->vehicle_journeys.front()->uri);
+
+    // the data built outside of a scope stays on the heap
+    BOOST_CHECK(!Arena::owns(b.data->pt_data->stop_points.front()));
+}
+
+BOOST_AUTO_TEST_CASE(disabled_arenas) {
+    Arena::set_enabled(false);
+    navitia::type::Data data;
+    BOOST_CHECK(data.arena() == nullptr);
+    Arena::set_enabled(true);
+}
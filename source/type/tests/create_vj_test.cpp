@@ -261,3 +261,38 @@ BOOST_AUTO_TEST_CASE(create_only_rt_vjs_test) {
     BOOST_CHECK_EQUAL(mvj->get_adapted_vj().size(), 0);
     BOOST_CHECK_EQUAL(mvj->get_rt_vj().size(), 2);
 }
+
+BOOST_AUTO_TEST_CASE(get_or_create_validity_pattern) {
+    using year = navitia::type::ValidityPattern::year_bitset;
+    namespace nt = navitia::type;
+
+    ed::builder b("20120614");
+    b.vj("A", "00111110011111")("stop1", 8000, 8000)("stop2", 8100, 8100).make();
+    auto& pt_data = *b.data->pt_data;
+    const auto begin = b.data->meta->production_date.begin();
+
+    nt::ValidityPattern vp(begin, "0101");
+    auto* created = pt_data.get_or_create_validity_pattern(vp);
+    BOOST_CHECK_EQUAL(created->days, year("0101"));
+    BOOST_CHECK_EQUAL(pt_data.get_or_create_validity_pattern(vp), created);
+    BOOST_CHECK_EQUAL(pt_data.validity_patterns.at(created->idx), created);
+
+    // same days, another beginning date
+    nt::ValidityPattern shifted_vp(begin + boost::gregorian::days(1), "0101");
+    auto* shifted = pt_data.get_or_create_validity_pattern(shifted_vp);
+    BOOST_CHECK_NE(shifted, created);
+    BOOST_CHECK_EQUAL(shifted->beginning_date, begin + boost::gregorian::days(1));
+
+    // a pattern pushed without get_or_create is found too
+    auto* pushed = new nt::ValidityPattern(begin, "0110");
+    pushed->idx = pt_data.validity_patterns.size();
+    pt_data.validity_patterns.push_back(pushed);
+    BOOST_CHECK_EQUAL(pt_data.get_or_create_validity_pattern(nt::ValidityPattern(begin, "0110")), pushed);
+
+    // the index follows the collection once sorted
+    const auto nb_vps = pt_data.validity_patterns.size();
+    pt_data.sort_and_index();
+    BOOST_CHECK_EQUAL(pt_data.get_or_create_validity_pattern(vp), created);
+    BOOST_CHECK_EQUAL(pt_data.get_or_create_validity_pattern(shifted_vp), shifted);
+    BOOST_CHECK_EQUAL(pt_data.validity_patterns.size(), nb_vps);
+}
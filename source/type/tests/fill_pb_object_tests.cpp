@@ -276,3 +276,31 @@ BOOST_AUTO_TEST_CASE(fill_crowfly_section_test) {
     BOOST_CHECK_EQUAL(pt_journey->sections(0).street_network().duration(), 0);
     BOOST_CHECK_EQUAL(pt_journey->sections(0).street_network().mode(), pbnavitia::Walking);
 }
+
+/*
+ * The response is allocated on the arena of the PbCreator, reset by init().
+ * A creator reused for several requests must not leak anything from a response to the next one.
+ */
+BOOST_AUTO_TEST_CASE(pb_creator_reused_between_requests) {
+    ed::builder b("20120614");
+    b.vj("A")("stop1", 8000, 8050)("stop2", 8100, 8150);
+    b.make();
+
+    navitia::PbCreator pb_creator;
+    for (int request = 0; request < 3; ++request) {
+        pb_creator.init(b.data.get(), pt::not_a_date_time, null_time_period);
+        BOOST_CHECK(!pb_creator.get_response().has_error());
+        BOOST_CHECK_EQUAL(pb_creator.get_response().stop_points_size(), 0);
+
+        pb_creator.pb_fill(b.data->pt_data->stop_points, 0);
+        pb_creator.fill_pb_error(pbnavitia::Error::bad_filter, "error " + std::to_string(request));
+
+        const auto& response = pb_creator.get_response();
+        BOOST_CHECK_EQUAL(response.stop_points_size(), 2);
+        BOOST_CHECK_EQUAL(response.error().message(), "error " + std::to_string(request));
+
+        // the response can still be copied out of the arena
+        const pbnavitia::Response copy = response;
+        BOOST_CHECK_EQUAL(copy.SerializeAsString(), response.SerializeAsString());
+    }
+}
@@ -0,0 +1,270 @@
+/* Copyright © 2001-2015, Canal TP and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+channel `#navitia` on riot https://riot.im/app/#/room/#navitia:matrix.org
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE nav_delta_test
+
+#include <boost/test/unit_test.hpp>
+#include <boost/filesystem.hpp>
+#include "ed/build_helper.h"
+#include "georef/georef.h"
+#include "type/data.h"
+#include "type/data_exceptions.h"
+#include "type/dataset.h"
+#include "type/meta_data.h"
+#include "type/meta_vehicle_journey.h"
+#include "type/nav_delta.h"
+#include "type/pt_data.h"
+#include "type/stop_area.h"
+#include "type/stop_point.h"
+#include "tests/utils_test.h"
+#include "utils/logger.h"
+
+#include <functional>
+
+namespace nt = navitia::type;
+
+struct logger_initialized {
+    logger_initialized() { navitia::init_logger(); }
+};
+BOOST_GLOBAL_FIXTURE(logger_initialized);
+
+static void check_indexes(const nt::PT_Data& pt_data) {
+    for (size_t i = 0; i < pt_data.vehicle_journeys.size(); ++i) {
+        BOOST_CHECK_EQUAL(pt_data.vehicle_journeys[i]->idx, i);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(delta_of_modified_and_added_vjs) {
+    ed::builder base("20190101");
+    base.vj("L1").name("vj:1")("A", "8:00"_t)("B", "8:10"_t);
+    base.vj("L2").name("vj:2")("B", "9:00"_t)("C", "9:10"_t);
+    base.make();
+
+    ed::builder target("20190101");
+    target.vj("L1").name("vj:1")("A", "8:00"_t)("B", "8:10"_t);
+    target.vj("L2").name("vj:2")("B", "9:00"_t)("C", "9:20"_t);
+    target.vj("L2").name("vj:3")("B", "10:00"_t)("C", "10:10"_t);
+    target.make();
+
+    const auto delta = nt::make_nav_delta(*base.data, *target.data);
+    BOOST_REQUIRE(delta);
+    BOOST_CHECK(delta->removed_meta_vjs.empty());
+    BOOST_REQUIRE_EQUAL(delta->meta_vjs.size(), 2);
+
+    const auto* unchanged_vj = base.data->pt_data->vehicle_journeys_map.at("vehicle_journey:vj:1");
+    nt::apply_nav_delta(*delta, *base.data);
+
+    const auto& pt_data = *base.data->pt_data;
+    BOOST_REQUIRE_EQUAL(pt_data.vehicle_journeys.size(), 3);
+    check_indexes(pt_data);
+    BOOST_CHECK_EQUAL(pt_data.vehicle_journeys_map.at("vehicle_journey:vj:1"), unchanged_vj);
+    const auto* vj = pt_data.vehicle_journeys_map.at("vehicle_journey:vj:2");
+    BOOST_CHECK_EQUAL(vj->stop_time_list.back().arrival_time, "9:20"_t);
+    BOOST_CHECK_EQUAL(vj->meta_vj->get_base_vj().size(), 1);
+    BOOST_CHECK(navitia::contains(pt_data.vehicle_journeys_map, "vehicle_journey:vj:3"));
+
+    // the data is now the one of the target
+    const auto no_delta = nt::make_nav_delta(*base.data, *target.data);
+    BOOST_REQUIRE(no_delta);
+    BOOST_CHECK(no_delta->empty());
+}
+
+BOOST_AUTO_TEST_CASE(delta_of_removed_vjs_keeps_the_links) {
+    ed::builder base("20190101");
+    base.vj("L1", "11111111", "block1").name("vj:1")("A", "8:00"_t)("B", "8:10"_t);
+    base.vj("L2", "11111111", "block1").name("vj:2")("B", "9:00"_t)("C", "9:10"_t);
+    base.vj("L2").name("vj:4")("C", "11:00"_t)("B", "11:10"_t);
+    base.make();
+
+    ed::builder target("20190101");
+    target.vj("L1", "11111111", "block1").name("vj:1")("A", "8:00"_t)("B", "8:10"_t);
+    target.vj("L2", "11111111", "block1").name("vj:2")("B", "9:05"_t)("C", "9:15"_t);
+    target.make();
+
+    const auto delta = nt::make_nav_delta(*base.data, *target.data);
+    BOOST_REQUIRE(delta);
+    BOOST_REQUIRE_EQUAL(delta->removed_meta_vjs.size(), 1);
+    BOOST_CHECK_EQUAL(delta->removed_meta_vjs.front(), "vj:4");
+    BOOST_REQUIRE_EQUAL(delta->meta_vjs.size(), 1);
+    BOOST_CHECK_EQUAL(delta->meta_vjs.front().name, "vj:2");
+
+    nt::apply_nav_delta(*delta, *base.data);
+
+    const auto& pt_data = *base.data->pt_data;
+    BOOST_REQUIRE_EQUAL(pt_data.vehicle_journeys.size(), 2);
+    check_indexes(pt_data);
+    BOOST_CHECK(!navitia::contains(pt_data.vehicle_journeys_map, "vehicle_journey:vj:4"));
+    const auto* vj1 = pt_data.vehicle_journeys_map.at("vehicle_journey:vj:1");
+    const auto* vj2 = pt_data.vehicle_journeys_map.at("vehicle_journey:vj:2");
+    BOOST_CHECK_EQUAL(vj1->next_vj, vj2);
+    BOOST_CHECK_EQUAL(vj2->prev_vj, vj1);
+    BOOST_CHECK_EQUAL(vj2->stop_time_list.front().departure_time, "9:05"_t);
+
+    const auto no_delta = nt::make_nav_delta(*base.data, *target.data);
+    BOOST_REQUIRE(no_delta);
+    BOOST_CHECK(no_delta->empty());
+}
+
+BOOST_AUTO_TEST_CASE(no_delta_when_the_structure_changes) {
+    ed::builder base("20190101");
+    base.vj("L1").name("vj:1")("A", "8:00"_t)("B", "8:10"_t);
+    base.make();
+
+    ed::builder target("20190101");
+    target.vj("L1").name("vj:1")("A", "8:00"_t)("B", "8:10"_t);
+    target.sa("D", 3, 3);
+    target.make();
+
+    BOOST_CHECK(!nt::make_nav_delta(*base.data, *target.data));
+}
+
+BOOST_AUTO_TEST_CASE(no_delta_when_an_attribute_of_the_structure_changes) {
+    const std::vector<std::function<void(nt::Data&)>> changes = {
+        [](nt::Data& data) { data.pt_data->stop_points_map.at("A")->platform_code = "2"; },
+        [](nt::Data& data) { data.pt_data->stop_points_map.at("A")->fare_zone = "4"; },
+        [](nt::Data& data) { data.pt_data->stop_areas_map.at("B")->visible = false; },
+        [](nt::Data& data) { data.pt_data->lines_map.at("L1")->color = "FF0000"; },
+        [](nt::Data& data) { data.pt_data->lines_map.at("L1")->opening_time = boost::posix_time::hours(5); },
+        [](nt::Data& data) { data.pt_data->datasets.front()->desc = "new"; },
+        [](nt::Data& data) { data.meta->license = "ODbL"; },
+        [](nt::Data& data) {
+            const auto& route = data.pt_data->routes.front();
+            data.pt_data->comments.add(route, nt::Comment("bob is in the kitchen", "information"));
+        },
+        [](nt::Data& data) {
+            auto* way = new navitia::georef::Way();
+            way->idx = data.geo_ref->ways.size();
+            way->name = "rue de la paix";
+            data.geo_ref->ways.push_back(way);
+        },
+    };
+    for (size_t i = 0; i < changes.size(); ++i) {
+        ed::builder base("20190101");
+        base.vj("L1").name("vj:1")("A", "8:00"_t)("B", "8:10"_t);
+        base.make();
+
+        ed::builder target("20190101");
+        target.vj("L1").name("vj:1")("A", "8:00"_t)("B", "8:20"_t);
+        target.make();
+        changes[i](*target.data);
+
+        BOOST_CHECK_MESSAGE(!nt::make_nav_delta(*base.data, *target.data), "change " << i << " is not detected");
+    }
+}
+
+BOOST_AUTO_TEST_CASE(the_dates_of_the_export_are_in_the_delta) {
+    ed::builder base("20190101");
+    base.vj("L1").name("vj:1")("A", "8:00"_t)("B", "8:10"_t);
+    base.make();
+
+    ed::builder target("20190101");
+    target.vj("L1").name("vj:1")("A", "8:00"_t)("B", "8:20"_t);
+    target.make();
+    target.data->meta->publication_date = "20190102T1200"_dt;
+    target.data->meta->dataset_created_at = "20190102T1000"_dt;
+
+    const auto delta = nt::make_nav_delta(*base.data, *target.data);
+    BOOST_REQUIRE(delta);
+    nt::apply_nav_delta(*delta, *base.data);
+    BOOST_CHECK_EQUAL(base.data->meta->publication_date, "20190102T1200"_dt);
+    BOOST_CHECK_EQUAL(base.data->meta->dataset_created_at, "20190102T1000"_dt);
+}
+
+BOOST_AUTO_TEST_CASE(delta_on_a_disrupted_meta_vj_is_refused) {
+    ed::builder base("20190101");
+    base.vj("L1").name("vj:1")("A", "8:00"_t)("B", "8:10"_t);
+    base.make();
+
+    ed::builder target("20190101");
+    target.vj("L1").name("vj:1")("A", "8:00"_t)("B", "8:20"_t);
+    target.make();
+
+    const auto delta = nt::make_nav_delta(*base.data, *target.data);
+    BOOST_REQUIRE(delta);
+
+    // an adapted vj is created on the meta vj after the nav has been loaded
+    auto& pt_data = *base.data->pt_data;
+    auto* base_vj = pt_data.vehicle_journeys_map.at("vehicle_journey:vj:1");
+    auto* mvj = pt_data.meta_vjs.get_mut("vj:1");
+    mvj->create_discrete_vj("vehicle_journey:adapted", "adapted", "adapted", nt::RTLevel::Adapted,
+                            *base_vj->base_validity_pattern(), base_vj->route, base_vj->stop_time_list, pt_data);
+
+    BOOST_CHECK_THROW(nt::apply_nav_delta(*delta, *base.data), navitia::data::delta_error);
+    // nothing has been modified
+    BOOST_CHECK_EQUAL(pt_data.vehicle_journeys.size(), 2);
+    BOOST_CHECK_EQUAL(pt_data.vehicle_journeys_map.at("vehicle_journey:vj:1"), base_vj);
+    BOOST_CHECK_EQUAL(base_vj->stop_time_list.back().arrival_time, "8:10"_t);
+}
+
+BOOST_AUTO_TEST_CASE(save_and_load_delta) {
+    ed::builder base("20190101");
+    base.vj("L1").name("vj:1")("A", "8:00"_t)("B", "8:10"_t);
+    base.make();
+
+    ed::builder target("20190101");
+    target.vj("L1").name("vj:1")("A", "8:00"_t)("B", "8:20"_t);
+    target.make();
+
+    auto delta = nt::make_nav_delta(*base.data, *target.data);
+    BOOST_REQUIRE(delta);
+    delta->base_hash = "base";
+    delta->target_hash = "target";
+    const std::string filename = "nav_delta_test.delta";
+    delta->save(filename);
+
+    nt::NavDelta loaded;
+    loaded.load(filename);
+    BOOST_CHECK_EQUAL(loaded.base_hash, "base");
+    BOOST_CHECK_EQUAL(loaded.target_hash, "target");
+    BOOST_REQUIRE_EQUAL(loaded.meta_vjs.size(), 1);
+    BOOST_REQUIRE_EQUAL(loaded.meta_vjs.front().vehicle_journeys.size(), 1);
+    const auto& vjd = loaded.meta_vjs.front().vehicle_journeys.front();
+    BOOST_CHECK_EQUAL(vjd.uri, "vehicle_journey:vj:1");
+    BOOST_REQUIRE_EQUAL(vjd.stop_times.size(), 2);
+    BOOST_CHECK_EQUAL(vjd.stop_times.back().arrival_time, "8:20"_t);
+    BOOST_CHECK_EQUAL(vjd.stop_times.back().stop_point_uri, "B");
+
+    BOOST_CHECK_EQUAL(nt::hash_file(filename), nt::hash_file(filename));
+    boost::filesystem::remove(filename);
+}
+
+BOOST_AUTO_TEST_CASE(the_nav_is_hashed_while_it_is_loaded) {
+    ed::builder b("20190101");
+    b.vj("L1").name("vj:1")("A", "8:00"_t)("B", "8:10"_t);
+    b.make();
+    const std::string filename = "nav_delta_test.nav.lz4";
+    b.data->save(filename);
+
+    nt::Data data;
+    data.load_nav(filename);
+    BOOST_CHECK_EQUAL(data.nav_hash, nt::hash_file(filename));
+    boost::filesystem::remove(filename);
+}
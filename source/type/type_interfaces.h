@@ -28,6 +28,7 @@ https://groups.google.com/d/forum/navitia
 www.navitia.io
 */
 #pragma once
+#include "type/arena.h"
 #include "utils/flat_enum_map.h"
 #include "utils/idx_map.h"
 #include "type/fwd_type.h"
@@ -127,6 +128,12 @@ struct Header {
     Header() = default;
     Header(idx_t idx, const std::string& uri) : idx(idx), uri(uri) {}
     Indexes get(Type_e, const PT_Data&) const { return Indexes{}; }
+
+    // the objects are allocated in the arena of the Data being built, if any
+    static void* operator new(size_t size) { return Arena::allocate_object(size); }
+    static void* operator new(size_t, void* p) noexcept { return p; }
+    static void operator delete(void* p) noexcept { Arena::deallocate_object(p); }
+    static void operator delete(void*, void*) noexcept {}
 };
 
 typedef std::bitset<10> Properties;
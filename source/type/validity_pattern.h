@@ -33,6 +33,8 @@ www.navitia.io
 #include <boost/date_time/gregorian/gregorian.hpp>
 
 #include <bitset>
+#include <unordered_set>
+#include <vector>
 
 namespace navitia {
 namespace type {
@@ -76,5 +78,47 @@ public:
     }
 };
 
+struct ValidityPatternDaysHash {
+    size_t operator()(const ValidityPattern* vp) const { return std::hash<ValidityPattern::year_bitset>()(vp->days); }
+};
+struct ValidityPatternEqual {
+    bool operator()(const ValidityPattern* a, const ValidityPattern* b) const { return *a == *b; }
+};
+struct ValidityPatternDaysEqual {
+    bool operator()(const ValidityPattern* a, const ValidityPattern* b) const { return a->days == b->days; }
+};
+
+/*
+ * Index by value of the validity patterns of a collection, for the get_or_create_validity_pattern
+ * that would otherwise compare the days of every pattern.
+ *
+ * The collection is only expected to grow: the patterns pushed since the last lookup are indexed
+ * by the next one, whoever pushed them.  The index must be reset when the patterns of the
+ * collection are reordered or modified in place.
+ */
+template <typename Equal>
+class ValidityPatternIndex {
+    std::unordered_set<const ValidityPattern*, ValidityPatternDaysHash, Equal> patterns;
+    size_t nb_indexed = 0;
+
+public:
+    ValidityPattern* find(const std::vector<ValidityPattern*>& collection, const ValidityPattern& vp) {
+        if (collection.size() < nb_indexed) {
+            reset();
+        }
+        for (; nb_indexed < collection.size(); ++nb_indexed) {
+            // for the duplicates, the first one is kept as a scan of the collection would
+            patterns.insert(collection[nb_indexed]);
+        }
+        const auto it = patterns.find(&vp);
+        return it == patterns.end() ? nullptr : const_cast<ValidityPattern*>(*it);
+    }
+
+    void reset() {
+        patterns.clear();
+        nb_indexed = 0;
+    }
+};
+
 }  // namespace type
 }  // namespace navitia
@@ -317,3 +317,32 @@ BOOST_AUTO_TEST_CASE(Su_MoWeSu_Mo) {
     }));
 }
 */
+
+BOOST_AUTO_TEST_CASE(translation_cache) {
+    const auto days =
+        "0011111"
+        "0011111";
+    TranslationCache cache(2);
+    const ValidityPattern vp(date(2012, 7, 2), days);
+    const auto translation = cache.translate(vp);
+    BOOST_REQUIRE_EQUAL(translation->size(), 1);
+    BOOST_CHECK_EQUAL(translation->front().week, Week("0011111"));
+    BOOST_CHECK_EQUAL(translation->front().validity_periods, translate(vp).front().validity_periods);
+
+    // the same days, from another pattern
+    BOOST_CHECK_EQUAL(cache.translate(ValidityPattern(vp)), translation);
+    BOOST_CHECK_EQUAL(cache.size(), 1);
+
+    // the same days, from another beginning date
+    const ValidityPattern other_vp(date(2012, 7, 9), days);
+    const auto other_translation = cache.translate(other_vp);
+    BOOST_CHECK_NE(other_translation, translation);
+    BOOST_CHECK_EQUAL(other_translation->front().validity_periods, translate(other_vp).front().validity_periods);
+    BOOST_CHECK_EQUAL(cache.size(), 2);
+
+    // the cache is emptied when full
+    const auto empty_translation = cache.translate(ValidityPattern(date(2012, 7, 2)));
+    BOOST_CHECK(empty_translation->empty());
+    BOOST_CHECK_EQUAL(cache.size(), 1);
+    BOOST_CHECK_EQUAL(cache.translate(vp)->front().week, Week("0011111"));
+}
@@ -30,6 +30,7 @@ www.navitia.io
 
 #include "vptranslator/vptranslator.h"
 
+#include <boost/functional/hash.hpp>
 #include <boost/range/algorithm/sort.hpp>
 #include <boost/range/algorithm_ext/for_each.hpp>
 
@@ -318,5 +319,39 @@ std::vector<BlockPattern> translate(const navitia::type::ValidityPattern& vp) {
     return {res};
 }
 
+size_t TranslationCache::KeyHash::operator()(const Key& key) const {
+    size_t seed = std::hash<ValidityPattern::year_bitset>()(key.days);
+    boost::hash_combine(seed, key.beginning_date.day_number());
+    return seed;
+}
+
+TranslationCache::Translation TranslationCache::translate(const ValidityPattern& vp) {
+    Key key{vp.beginning_date, vp.days};
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        const auto it = translations.find(key);
+        if (it != translations.end()) {
+            return it->second;
+        }
+    }
+    // computed outside of the lock, two threads may translate the same pattern
+    Translation translation = std::make_shared<const std::vector<BlockPattern>>(vptranslator::translate(vp));
+    std::lock_guard<std::mutex> lock(mutex);
+    if (translations.size() >= max_size) {
+        translations.clear();
+    }
+    return translations.emplace(std::move(key), std::move(translation)).first->second;
+}
+
+size_t TranslationCache::size() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return translations.size();
+}
+
+TranslationCache::Translation translate_cached(const ValidityPattern& vp) {
+    static TranslationCache cache;
+    return cache.translate(vp);
+}
+
 }  // namespace vptranslator
 }  // namespace navitia
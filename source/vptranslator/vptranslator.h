@@ -37,7 +37,12 @@ www.navitia.io
 #include "type/commercial_mode.h"
 #include "type/meta_vehicle_journey.h"
 
+#include <boost/utility.hpp>
+
+#include <memory>
+#include <mutex>
 #include <set>
+#include <unordered_map>
 
 namespace navitia {
 namespace vptranslator {
@@ -74,5 +79,41 @@ std::vector<BlockPattern> translate_no_exception(const navitia::type::ValidityPa
 // validity_period describing the given ValidityPattern.
 std::vector<BlockPattern> translate(const navitia::type::ValidityPattern&);
 
+/*
+ * The translations of the validity patterns, shared by the threads.
+ *
+ * A translation only depends on the beginning date and the days of the pattern, so they are
+ * kept by value: a pattern created by the realtime is a new entry and an entry never has to be
+ * invalidated.  The cache is emptied once it holds max_size translations.
+ */
+class TranslationCache : boost::noncopyable {
+public:
+    using Translation = std::shared_ptr<const std::vector<BlockPattern>>;
+
+    explicit TranslationCache(size_t max_size = 100000) : max_size(max_size) {}
+
+    Translation translate(const navitia::type::ValidityPattern&);
+    size_t size() const;
+
+private:
+    struct Key {
+        boost::gregorian::date beginning_date;
+        navitia::type::ValidityPattern::year_bitset days;
+        bool operator==(const Key& other) const {
+            return beginning_date == other.beginning_date && days == other.days;
+        }
+    };
+    struct KeyHash {
+        size_t operator()(const Key& key) const;
+    };
+
+    const size_t max_size;
+    mutable std::mutex mutex;
+    std::unordered_map<Key, Translation, KeyHash> translations;
+};
+
+// translate(), memoized in the TranslationCache of the process
+TranslationCache::Translation translate_cached(const navitia::type::ValidityPattern&);
+
 }  // namespace vptranslator
 }  // namespace navitia